@@ -9,7 +9,10 @@
 #include "bench/CodecBenchPriv.h"
 #include "include/codec/SkAndroidCodec.h"
 #include "include/core/SkBitmap.h"
+#include "include/core/SkPixmap.h"
+#include "include/core/SkSamplingOptions.h"
 #include "src/core/SkOSFile.h"
+#include "tools/Resources.h"
 #include "tools/flags/CommandLineFlags.h"
 
 AndroidCodecBench::AndroidCodecBench(SkString baseName, SkData* encoded, int sampleSize)
@@ -53,3 +56,65 @@ void AndroidCodecBench::onDraw(int n, SkCanvas* canvas) {
         SkASSERT(result == SkCodec::kSuccess || result == SkCodec::kIncompleteInput);
     }
 }
+
+// Makes a 1/8 size thumbnail of a large PNG, either by decoding it at full size and then calling
+// scalePixels(), or by letting SkAndroidCodec sample or box filter it as it decodes.
+class AndroidCodecThumbnailBench : public Benchmark {
+public:
+    enum class Mode { kScalePixels, kSample, kBoxFilter };
+
+    explicit AndroidCodecThumbnailBench(Mode mode) : fMode(mode) {
+        fName.printf("AndroidCodec_thumbnail_%s",
+                     mode == Mode::kScalePixels ? "scalePixels" :
+                     mode == Mode::kSample      ? "sample"      : "boxFilter");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override { return kNonRendering_Backend == backend; }
+
+    void onDelayedSetup() override {
+        fData = GetResourceAsData("images/mandrill_1600.png");
+        std::unique_ptr<SkAndroidCodec> codec = SkAndroidCodec::MakeFromData(fData);
+        fInfo = codec->getInfo().makeColorType(kN32_SkColorType)
+                                .makeAlphaType(kPremul_SkAlphaType)
+                                .makeDimensions(codec->getSampledDimensions(kSampleSize));
+        fPixelStorage.reset(fInfo.computeMinByteSize());
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const SkPixmap dst(fInfo, fPixelStorage.get(), fInfo.minRowBytes());
+        while (loops-- > 0) {
+            std::unique_ptr<SkAndroidCodec> codec = SkAndroidCodec::MakeFromData(fData);
+            if (fMode == Mode::kScalePixels) {
+                SkBitmap full;
+                full.allocPixels(fInfo.makeDimensions(codec->getInfo().dimensions()));
+                SkAssertResult(codec->getAndroidPixels(full.info(), full.getPixels(),
+                                                       full.rowBytes()) == SkCodec::kSuccess);
+                SkAssertResult(full.pixmap().scalePixels(
+                        dst, SkSamplingOptions(SkFilterMode::kLinear, SkMipmapMode::kLinear)));
+            } else {
+                SkAndroidCodec::AndroidOptions options;
+                options.fSampleSize = kSampleSize;
+                options.fBoxFilter = fMode == Mode::kBoxFilter;
+                SkAssertResult(codec->getAndroidPixels(dst.info(), dst.writable_addr(),
+                                                       dst.rowBytes(), &options) ==
+                               SkCodec::kSuccess);
+            }
+        }
+    }
+
+private:
+    static constexpr int kSampleSize = 8;
+
+    const Mode    fMode;
+    SkString      fName;
+    sk_sp<SkData> fData;
+    SkImageInfo   fInfo;
+    SkAutoMalloc  fPixelStorage;
+};
+
+DEF_BENCH(return new AndroidCodecThumbnailBench(AndroidCodecThumbnailBench::Mode::kScalePixels);)
+DEF_BENCH(return new AndroidCodecThumbnailBench(AndroidCodecThumbnailBench::Mode::kSample);)
+DEF_BENCH(return new AndroidCodecThumbnailBench(AndroidCodecThumbnailBench::Mode::kBoxFilter);)
@@ -84,6 +84,11 @@ public:
                              skia_private::TArray<SkString>* keys,
                              skia_private::TArray<double>* values) {}
 
+    // Metrics other than time that this benchmark measured while it ran, e.g. memory use, to
+    // log alongside its timings.
+    virtual void getMetrics(skia_private::TArray<SkString>* keys,
+                            skia_private::TArray<double>* values) {}
+
     // Replaces the GrRecordingContext's dmsaaStats() with a single frame of this benchmark.
     virtual bool getDMSAAStats(GrRecordingContext*) { return false; }
 
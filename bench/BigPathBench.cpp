@@ -7,6 +7,7 @@
 
 #include "bench/Benchmark.h"
 #include "bench/BigPath.h"
+#include "bench/ScanConverter.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkPath.h"
 #include "tools/ToolUtils.h"
@@ -19,22 +20,31 @@ enum Align {
 
 const char* gAlignName[] = { "left", "middle", "right" };
 
+using BenchUtils::ScanConverter;
+
 // Inspired by crbug.com/455429
 class BigPathBench : public Benchmark {
     SkPath      fPath;
     SkString    fName;
     Align       fAlign;
     bool        fRound;
+    ScanConverter fScanConverter;
 
 public:
-    BigPathBench(Align align, bool round) : fAlign(align), fRound(round) {
+    BigPathBench(Align align, bool round, ScanConverter sc = ScanConverter::kDefault)
+            : fAlign(align), fRound(round), fScanConverter(sc) {
         fName.printf("bigpath_%s", gAlignName[fAlign]);
         if (round) {
             fName.append("_round");
         }
+        fName.append(BenchUtils::ScanConverterSuffix(sc));
     }
 
 protected:
+    bool isSuitableFor(Backend backend) override {
+        return BenchUtils::ScanConverterSuitableFor(fScanConverter, backend);
+    }
+
     const char* onGetName() override {
         return fName.c_str();
     }
@@ -46,6 +56,7 @@ protected:
     void onDelayedSetup() override { fPath = BenchUtils::make_big_path(); }
 
     void onDraw(int loops, SkCanvas* canvas) override {
+        BenchUtils::AutoScanConverter scanConverter(fScanConverter);
         SkPaint paint;
         paint.setAntiAlias(true);
         paint.setStyle(SkPaint::kStroke_Style);
@@ -83,3 +94,7 @@ DEF_BENCH( return new BigPathBench(kRight_Align,    false); )
 DEF_BENCH( return new BigPathBench(kLeft_Align,     true); )
 DEF_BENCH( return new BigPathBench(kMiddle_Align,   true); )
 DEF_BENCH( return new BigPathBench(kRight_Align,    true); )
+
+DEF_BENCH( return new BigPathBench(kMiddle_Align,   false, ScanConverter::kSupersample); )
+DEF_BENCH( return new BigPathBench(kMiddle_Align,   false, ScanConverter::kAnalytic); )
+DEF_BENCH( return new BigPathBench(kMiddle_Align,   false, ScanConverter::kAccumulation); )
@@ -7,12 +7,19 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkColorPriv.h"
 #include "include/core/SkFont.h"
+#include "include/core/SkMatrix.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkString.h"
 #include "include/core/SkTextBlob.h"
+#include "src/base/SkArenaAlloc.h"
 #include "src/base/SkRandom.h"
 #include "src/core/SkBlendModePriv.h"
+#include "src/core/SkOpts.h"
+#include "src/core/SkRasterPipeline.h"
+#include "src/core/SkRasterPipelineOpContexts.h"
+#include "src/core/SkRasterPipelineOpList.h"
 #include "tools/Resources.h"
 
 namespace {
@@ -103,8 +110,81 @@ private:
     using INHERITED = Benchmark;
 };
 
+// Benchmark that runs a bare srcover raster pipeline over 8888 pixels, with no canvas or blitter
+// in the way, so that the cost of the lowp stages themselves (and their width) shows up directly.
+// The source is either another buffer (load_8888) or a 2x upscaled image (bilerp_clamp_8888).
+// The _hsw variants use the 16-lane HSW lowp stages, for comparison with SKX's 32-lane ones.
+class PipelineSrcOverBench : public Benchmark {
+public:
+    PipelineSrcOverBench(bool bilerp, bool hsw) : fBilerp(bilerp), fHSW(hsw) {
+        fName.printf("blendmicro_pipeline_%s_SrcOver%s", bilerp ? "bilerp" : "load",
+                     hsw ? "_hsw" : "");
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend && (!fHSW || SkOpts::just_return_lowp_hsw);
+    }
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkRandom random;
+        for (uint32_t& px : fSrc) {
+            px = SkPreMultiplyColor(random.nextU());
+        }
+        for (uint32_t& px : fDst) {
+            px = SkPreMultiplyColor(random.nextU());
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkRasterPipeline_MemoryCtx src = {fSrc, kW},
+                                   dst = {fDst, kW};
+        SkRasterPipeline_GatherCtx gather;
+        gather.pixels = fSrc;
+        gather.stride = kW;
+        gather.width  = kW;
+        gather.height = kH;
+
+        SkSTArenaAlloc<256> alloc;
+        SkRasterPipeline p(&alloc);
+        p.setUseHSWLowpStagesForTesting(fHSW);
+        if (fBilerp) {
+            p.append(SkRasterPipelineOp::seed_shader);
+            p.append_matrix(&alloc, SkMatrix::Scale(0.5f, 0.5f));
+            p.append(SkRasterPipelineOp::bilerp_clamp_8888, &gather);
+        } else {
+            p.append(SkRasterPipelineOp::load_8888, &src);
+        }
+        p.append(SkRasterPipelineOp::load_8888_dst, &dst);
+        p.append(SkRasterPipelineOp::srcover);
+        p.append(SkRasterPipelineOp::store_8888, &dst);
+        auto fn = p.compile();
+
+        while (loops --> 0) {
+            fn(0,0, kW,kH);
+        }
+    }
+
+private:
+    // A non-multiple of any pipeline width, so every row has a tail.
+    static constexpr int kW = 509,
+                         kH = 64;
+
+    bool     fBilerp;
+    bool     fHSW;
+    SkString fName;
+    uint32_t fSrc[kW * kH];
+    uint32_t fDst[kW * kH];
+};
+
 //////////////////////////////////////////////////////////////////////////////
 
+DEF_BENCH( return new PipelineSrcOverBench(false, false); )
+DEF_BENCH( return new PipelineSrcOverBench(true,  false); )
+DEF_BENCH( return new PipelineSrcOverBench(false, true); )
+DEF_BENCH( return new PipelineSrcOverBench(true,  true); )
+
 #define BENCH(mode)                                      \
     DEF_BENCH( return new XfermodeBench(mode, kText); )  \
     DEF_BENCH( return new XfermodeBench(mode, kRect); )  \
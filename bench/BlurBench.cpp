@@ -5,14 +5,20 @@
  * found in the LICENSE file.
  */
 #include "bench/Benchmark.h"
+#include "include/core/SkBitmap.h"
 #include "include/core/SkBlurTypes.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkMaskFilter.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkString.h"
 #include "src/base/SkRandom.h"
 #include "src/core/SkBlurMask.h"
+#include "src/core/SkMask.h"
+
+#include <cstring>
+#include <memory>
 
 #define MINI    0.01f
 #define SMALL   SkIntToScalar(2)
@@ -76,6 +82,69 @@ private:
     using INHERITED = Benchmark;
 };
 
+// The blur mask filter blurs on the calling thread, so to measure threaded blurs this box blurs
+// the mask of the largest oval BlurBench draws directly, with a thread pool of its own when
+// threads > 0. Compare with blur_100.50_normal_high_quality.
+class BlurOvalMaskBench : public Benchmark {
+public:
+    BlurOvalMaskBench(SkScalar rad, int threads) : fRadius(rad), fThreads(threads) {
+        fName.printf("blur_%.2f_normal_mask", SkScalarToFloat(rad));
+        if (threads > 0) {
+            fName.appendf("_%dthreads", threads);
+        }
+    }
+
+    ~BlurOvalMaskBench() override {
+        SkMask::FreeImage(fSrcMask.fImage);
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        SkBitmap oval;
+        oval.allocPixels(SkImageInfo::MakeA8(400, 400));
+        oval.eraseColor(SK_ColorTRANSPARENT);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        SkCanvas(oval).drawOval(SkRect::MakeWH(400, 400), paint);
+
+        fSrcMask.fBounds = SkIRect::MakeWH(400, 400);
+        fSrcMask.fFormat = SkMask::kA8_Format;
+        fSrcMask.fRowBytes = fSrcMask.fBounds.width();
+        fSrcMask.fImage = SkMask::AllocImage(fSrcMask.computeTotalImageSize());
+        memcpy(fSrcMask.fImage, oval.getPixels(), fSrcMask.computeTotalImageSize());
+
+        if (fThreads > 0) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            SkMask mask;
+            if (!SkBlurMask::BoxBlur(&mask, fSrcMask, SkBlurMask::ConvertRadiusToSigma(fRadius),
+                                     kNormal_SkBlurStyle, nullptr, fExecutor.get())) {
+                return;
+            }
+            SkMask::FreeImage(mask.fImage);
+        }
+    }
+
+private:
+    SkScalar                    fRadius;
+    int                         fThreads;
+    SkString                    fName;
+    SkMask                      fSrcMask;
+    std::unique_ptr<SkExecutor> fExecutor;
+
+    using INHERITED = Benchmark;
+};
+
 DEF_BENCH(return new BlurBench(MINI, kNormal_SkBlurStyle);)
 DEF_BENCH(return new BlurBench(MINI, kSolid_SkBlurStyle);)
 DEF_BENCH(return new BlurBench(MINI, kOuter_SkBlurStyle);)
@@ -96,6 +165,11 @@ DEF_BENCH(return new BlurBench(REALBIG, kSolid_SkBlurStyle);)
 DEF_BENCH(return new BlurBench(REALBIG, kOuter_SkBlurStyle);)
 DEF_BENCH(return new BlurBench(REALBIG, kInner_SkBlurStyle);)
 
+DEF_BENCH(return new BlurOvalMaskBench(REALBIG, 0);)
+DEF_BENCH(return new BlurOvalMaskBench(REALBIG, 2);)
+DEF_BENCH(return new BlurOvalMaskBench(REALBIG, 4);)
+DEF_BENCH(return new BlurOvalMaskBench(REALBIG, 8);)
+
 DEF_BENCH(return new BlurBench(REAL, kNormal_SkBlurStyle);)
 DEF_BENCH(return new BlurBench(REAL, kSolid_SkBlurStyle);)
 DEF_BENCH(return new BlurBench(REAL, kOuter_SkBlurStyle);)
@@ -8,12 +8,15 @@
 #include "bench/Benchmark.h"
 #include "include/core/SkBlurTypes.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkString.h"
 #include "src/base/SkRandom.h"
 #include "src/core/SkBlurMask.h"
 
+#include <memory>
+
 #define SMALL   SkIntToScalar(2)
 #define REAL    1.5f
 static const SkScalar kMedium = SkIntToScalar(5);
@@ -155,6 +158,45 @@ private:
     using INHERITED = BlurRectSeparableBench;
 };
 
+// A mask big enough for BoxBlur to split into bands. With threads > 0, the bands are blurred on a
+// thread pool of this bench's own; otherwise they're all run on this thread.
+class BlurRectBoxFilterLargeBench: public BlurRectSeparableBench {
+public:
+    BlurRectBoxFilterLargeBench(int threads) : INHERITED(REALBIG), fThreads(threads) {
+        SkString name("blurrect_boxfilter_large");
+        if (threads > 0) {
+            name.appendf("_%dthreads", threads);
+        }
+
+        this->setName(name);
+    }
+
+protected:
+    void onDelayedSetup() override {
+        if (fThreads > 0) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+    }
+
+    void preBenchSetup(const SkRect&) override {
+        INHERITED::preBenchSetup(SkRect::MakeWH(1024, 1024));
+    }
+
+    void makeBlurryRect(const SkRect&) override {
+        SkMask mask;
+        if (!SkBlurMask::BoxBlur(&mask, fSrcMask, SkBlurMask::ConvertRadiusToSigma(this->radius()),
+                                 kNormal_SkBlurStyle, nullptr, fExecutor.get())) {
+            return;
+        }
+        SkMask::FreeImage(mask.fImage);
+    }
+private:
+    int                         fThreads;
+    std::unique_ptr<SkExecutor> fExecutor;
+
+    using INHERITED = BlurRectSeparableBench;
+};
+
 class BlurRectGaussianBench: public BlurRectSeparableBench {
 public:
     BlurRectGaussianBench(SkScalar rad) : INHERITED(rad) {
@@ -202,6 +244,11 @@ DEF_BENCH(return new BlurRectDirectBench(kMedBig);)
 DEF_BENCH(return new BlurRectBoxFilterBench(kMedium);)
 DEF_BENCH(return new BlurRectBoxFilterBench(kMedBig);)
 
+DEF_BENCH(return new BlurRectBoxFilterLargeBench(0);)
+DEF_BENCH(return new BlurRectBoxFilterLargeBench(2);)
+DEF_BENCH(return new BlurRectBoxFilterLargeBench(4);)
+DEF_BENCH(return new BlurRectBoxFilterLargeBench(8);)
+
 #if 0
 // disable Gaussian benchmarks; the algorithm works well enough
 // and serves as a baseline for ground truth, but it's too slow
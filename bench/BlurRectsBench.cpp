@@ -6,13 +6,20 @@
 */
 
 #include "bench/Benchmark.h"
+#include "include/core/SkBitmap.h"
 #include "include/core/SkBlurTypes.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkMaskFilter.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPath.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkString.h"
+#include "src/core/SkBlurMask.h"
+#include "src/core/SkMask.h"
+
+#include <cstring>
+#include <memory>
 
 class BlurRectsBench : public Benchmark {
 public:
@@ -73,9 +80,95 @@ private:
     using INHERITED = BlurRectsBench;
 };
 
+// Rects much larger than the canvas, blurred with a large sigma like a big shadow or glow.
+class BlurRectsLargeBench: public BlurRectsBench {
+public:
+    BlurRectsLargeBench()
+        : INHERITED(SkRect::MakeXYWH(-700, -700, 2000, 2000),
+                    SkRect::MakeXYWH(100, 100, 400, 250), 25) {
+        this->setName(SkString("blurrectslarge"));
+    }
+private:
+    using INHERITED = BlurRectsBench;
+};
+
+// The mask blurrectslarge blurs on a 640x480 canvas: its rects, clipped to the canvas outset by
+// three sigma. The blur mask filter blurs on the calling thread, so to measure threaded blurs
+// this box blurs that mask directly, with a thread pool of its own when threads > 0.
+class BlurRectsLargeMaskBench : public Benchmark {
+public:
+    explicit BlurRectsLargeMaskBench(int threads) : fThreads(threads) {
+        fName.set("blurrectslarge_mask");
+        if (threads > 0) {
+            fName.appendf("_%dthreads", threads);
+        }
+    }
+
+    ~BlurRectsLargeMaskBench() override {
+        SkMask::FreeImage(fSrcMask.fImage);
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        const int margin = SkScalarCeilToInt(3 * kSigma);
+        fSrcMask.fBounds = SkIRect::MakeLTRB(-margin, -margin, 640 + margin, 480 + margin);
+        fSrcMask.fFormat = SkMask::kA8_Format;
+        fSrcMask.fRowBytes = fSrcMask.fBounds.width();
+        fSrcMask.fImage = SkMask::AllocImage(fSrcMask.computeTotalImageSize());
+
+        SkBitmap bitmap;
+        bitmap.allocPixels(SkImageInfo::MakeA8(fSrcMask.fBounds.size()));
+        bitmap.eraseColor(SK_ColorTRANSPARENT);
+        SkPath path;
+        path.addRect(SkRect::MakeXYWH(-700, -700, 2000, 2000), SkPathDirection::kCW);
+        path.addRect(SkRect::MakeXYWH(100, 100, 400, 250), SkPathDirection::kCW);
+        SkCanvas canvas(bitmap);
+        canvas.translate(margin, margin);
+        canvas.drawPath(path, SkPaint());
+        memcpy(fSrcMask.fImage, bitmap.getPixels(), fSrcMask.computeTotalImageSize());
+
+        if (fThreads > 0) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            SkMask mask;
+            if (!SkBlurMask::BoxBlur(&mask, fSrcMask, kSigma, kNormal_SkBlurStyle, nullptr,
+                                     fExecutor.get())) {
+                return;
+            }
+            SkMask::FreeImage(mask.fImage);
+        }
+    }
+
+private:
+    static constexpr SkScalar kSigma = 25;
+
+    int                         fThreads;
+    SkString                    fName;
+    SkMask                      fSrcMask;
+    std::unique_ptr<SkExecutor> fExecutor;
+
+    using INHERITED = Benchmark;
+};
+
 DEF_BENCH(return new BlurRectsNinePatchBench(SkRect::MakeXYWH(10, 10, 100, 100),
                                              SkRect::MakeXYWH(20, 20, 60, 60),
                                              2.3f);)
 DEF_BENCH(return new BlurRectsNonNinePatchBench(SkRect::MakeXYWH(10, 10, 100, 100),
                                                 SkRect::MakeXYWH(50, 50, 10, 10),
                                                 4.3f);)
+
+DEF_BENCH(return new BlurRectsLargeBench();)
+DEF_BENCH(return new BlurRectsLargeMaskBench(0);)
+DEF_BENCH(return new BlurRectsLargeMaskBench(2);)
+DEF_BENCH(return new BlurRectsLargeMaskBench(4);)
+DEF_BENCH(return new BlurRectsLargeMaskBench(8);)
@@ -6,9 +6,11 @@
  */
 
 #include "bench/Benchmark.h"
+#include "bench/ScanConverter.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPath.h"
+#include "include/core/SkString.h"
 #include "include/private/base/SkTDArray.h"
 #include "src/base/SkRandom.h"
 
@@ -88,23 +90,27 @@ static void gen_paths(const SkTDArray<SkScalar>& topData,
 // filling
 class ChartBench : public Benchmark {
 public:
-    ChartBench(bool aa) {
+    ChartBench(bool aa,
+               BenchUtils::ScanConverter sc = BenchUtils::ScanConverter::kDefault) {
         fShift = 0;
         fAA = aa;
+        fScanConverter = sc;
         fSize.fWidth = -1;
         fSize.fHeight = -1;
+        fName.printf("chart_%s%s", aa ? "aa" : "bw", BenchUtils::ScanConverterSuffix(sc));
     }
 
 protected:
+    bool isSuitableFor(Backend backend) override {
+        return BenchUtils::ScanConverterSuitableFor(fScanConverter, backend);
+    }
+
     const char* onGetName() override {
-        if (fAA) {
-            return "chart_aa";
-        } else {
-            return "chart_bw";
-        }
+        return fName.c_str();
     }
 
     void onDraw(int loops, SkCanvas* canvas) override {
+        BenchUtils::AutoScanConverter scanConverter(fScanConverter);
         bool sizeChanged = false;
         if (canvas->getBaseLayerSize() != fSize) {
             fSize = canvas->getBaseLayerSize();
@@ -181,6 +187,8 @@ private:
     SkISize             fSize;
     SkTDArray<SkScalar> fData[kNumGraphs];
     bool                fAA;
+    BenchUtils::ScanConverter fScanConverter;
+    SkString            fName;
 
     using INHERITED = Benchmark;
 };
@@ -189,3 +197,7 @@ private:
 
 DEF_BENCH( return new ChartBench(true); )
 DEF_BENCH( return new ChartBench(false); )
+
+DEF_BENCH( return new ChartBench(true, BenchUtils::ScanConverter::kSupersample); )
+DEF_BENCH( return new ChartBench(true, BenchUtils::ScanConverter::kAnalytic); )
+DEF_BENCH( return new ChartBench(true, BenchUtils::ScanConverter::kAccumulation); )
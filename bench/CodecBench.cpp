@@ -9,9 +9,19 @@
 #include "bench/CodecBenchPriv.h"
 #include "include/codec/SkCodec.h"
 #include "include/core/SkBitmap.h"
+#include "include/core/SkColor.h"
+#include "include/core/SkColorPriv.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkStream.h"
+#include "include/encode/SkJpegEncoder.h"
+#include "include/encode/SkPngEncoder.h"
+#include "src/base/SkRandom.h"
 #include "src/core/SkOSFile.h"
+#include "src/core/SkTaskGroup.h"
 #include "tools/flags/CommandLineFlags.h"
 
+#include <vector>
+
 // Actually zeroing the memory would throw off timing, so we just lie.
 static DEFINE_bool(zero_init, false,
                    "Pretend our destination is zero-intialized, simulating Android?");
@@ -64,3 +74,172 @@ void CodecBench::onDraw(int n, SkCanvas* canvas) {
                  || result == SkCodec::kIncompleteInput);
     }
 }
+
+// Decodes a synthetic 12 or 48 megapixel JPEG, with or without a restart marker at the end of
+// each row of MCUs, either serially or with SkCodec::Options::fExecutor.
+class JpegRestartIntervalBench : public Benchmark {
+public:
+    JpegRestartIntervalBench(int megapixels, bool restartMarkers, int threads)
+            : fMegapixels(megapixels)
+            , fRestartMarkers(restartMarkers)
+            , fThreads(threads) {
+        fName.printf("Codec_jpeg_%dMP%s", megapixels, restartMarkers ? "_dri" : "");
+        if (threads > 0) {
+            fName.appendf("_%dthreads", threads);
+        }
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override { return kNonRendering_Backend == backend; }
+
+    void onDelayedSetup() override {
+        // 4:3, like most camera sensors.
+        const int width  = fMegapixels == 48 ? 8000 : 4000,
+                  height = width * 3 / 4;
+        SkBitmap src;
+        src.allocN32Pixels(width, height, /*isOpaque=*/true);
+        SkRandom rand;
+        for (int y = 0; y < height; y++) {
+            uint32_t* row = src.getAddr32(0, y);
+            for (int x = 0; x < width; x++) {
+                row[x] = SkPackARGB32(0xFF, (x + y) / 16 & 0xFF, x * 255 / width,
+                                      rand.nextU() & 0x3F);
+            }
+        }
+
+        SkJpegEncoder::Options options;
+        options.fQuality = 90;
+        if (fRestartMarkers) {
+            options.fRestartInterval = width / 16;  // 4:2:0 MCUs are 16x16.
+        }
+        SkDynamicMemoryWStream stream;
+        SkAssertResult(SkJpegEncoder::Encode(&stream, src.pixmap(), options));
+        fData = stream.detachAsData();
+
+        fInfo = src.info();
+        fPixelStorage.reset(fInfo.computeMinByteSize());
+        if (fThreads > 0) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkCodec::Options options;
+        options.fExecutor = fExecutor.get();
+        while (loops-- > 0) {
+            std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(fData);
+            SkAssertResult(codec->getPixels(fInfo, fPixelStorage.get(), fInfo.minRowBytes(),
+                                            &options) == SkCodec::kSuccess);
+        }
+    }
+
+private:
+    const int                   fMegapixels;
+    const bool                  fRestartMarkers;
+    const int                   fThreads;
+    SkString                    fName;
+    sk_sp<SkData>               fData;
+    SkImageInfo                 fInfo;
+    SkAutoMalloc                fPixelStorage;
+    std::unique_ptr<SkExecutor> fExecutor;
+};
+
+DEF_BENCH(return new JpegRestartIntervalBench(12, false, 0);)
+DEF_BENCH(return new JpegRestartIntervalBench(12, true,  0);)
+DEF_BENCH(return new JpegRestartIntervalBench(12, false, 4);)
+DEF_BENCH(return new JpegRestartIntervalBench(12, true,  4);)
+DEF_BENCH(return new JpegRestartIntervalBench(48, false, 0);)
+DEF_BENCH(return new JpegRestartIntervalBench(48, true,  0);)
+DEF_BENCH(return new JpegRestartIntervalBench(48, false, 8);)
+DEF_BENCH(return new JpegRestartIntervalBench(48, true,  8);)
+
+// Decodes a corpus of small JPEG and PNG thumbnails, like a server generating a page of them.
+// Each loop decodes all kThumbnails images, each with its own SkCodec into its own bitmap, spread
+// across |threads| threads if that's not 0.  Images per second is kThumbnails / time.
+class ThumbnailsBench : public Benchmark {
+public:
+    static constexpr int kThumbnails = 256;
+
+    explicit ThumbnailsBench(int threads) : fThreads(threads) {
+        fName.printf("Codec_thumbnails_%d", kThumbnails);
+        if (threads > 0) {
+            fName.appendf("_%dthreads", threads);
+        }
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override { return kNonRendering_Backend == backend; }
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        for (int i = 0; i < kThumbnails; i++) {
+            const int width  = 48 + rand.nextULessThan(113),
+                      height = 48 + rand.nextULessThan(113);
+            SkBitmap src;
+            src.allocN32Pixels(width, height, /*isOpaque=*/true);
+            const SkColor base = rand.nextU();
+            for (int y = 0; y < height; y++) {
+                uint32_t* row = src.getAddr32(0, y);
+                for (int x = 0; x < width; x++) {
+                    row[x] = SkPackARGB32(0xFF,
+                                          (SkColorGetR(base) + x * 2) & 0xFF,
+                                          (SkColorGetG(base) + y * 2) & 0xFF,
+                                          (SkColorGetB(base) + (rand.nextU() & 0x1F)) & 0xFF);
+                }
+            }
+            // Mostly JPEGs, like photo thumbnails, with some PNGs.
+            SkDynamicMemoryWStream stream;
+            if (i % 4 != 3) {
+                SkJpegEncoder::Options options;
+                options.fQuality = 80;
+                SkAssertResult(SkJpegEncoder::Encode(&stream, src.pixmap(), options));
+            } else {
+                SkAssertResult(SkPngEncoder::Encode(&stream, src.pixmap(), {}));
+            }
+            fThumbnails.push_back({stream.detachAsData(), src.info()});
+        }
+        if (fThreads > 0) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        auto decode = [this](int i) {
+            const Thumbnail& thumbnail = fThumbnails[i];
+            std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(thumbnail.fData);
+            SkBitmap bm;
+            bm.allocPixels(thumbnail.fInfo);
+            SkAssertResult(codec->getPixels(bm.pixmap()) == SkCodec::kSuccess);
+        };
+        while (loops-- > 0) {
+            if (fExecutor) {
+                SkTaskGroup tasks(*fExecutor);
+                tasks.batch(kThumbnails, decode);
+                tasks.wait();
+            } else {
+                for (int i = 0; i < kThumbnails; i++) {
+                    decode(i);
+                }
+            }
+        }
+    }
+
+private:
+    struct Thumbnail {
+        sk_sp<SkData> fData;
+        SkImageInfo   fInfo;
+    };
+
+    const int                   fThreads;
+    SkString                    fName;
+    std::vector<Thumbnail>      fThumbnails;
+    std::unique_ptr<SkExecutor> fExecutor;
+};
+
+DEF_BENCH(return new ThumbnailsBench(0);)
+DEF_BENCH(return new ThumbnailsBench(4);)
+DEF_BENCH(return new ThumbnailsBench(8);)
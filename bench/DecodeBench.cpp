@@ -6,8 +6,10 @@
  */
 
 #include "bench/Benchmark.h"
+#include "include/codec/SkCodec.h"
 #include "include/core/SkBitmap.h"
 #include "include/core/SkPictureRecorder.h"
+#include "include/core/SkStream.h"
 #include "modules/skottie/include/Skottie.h"
 #include "tools/Resources.h"
 
@@ -54,6 +56,40 @@ private:
     using INHERITED = DecodeBench;
 };
 
+// Decodes straight from a stream, either reading the file through an SkFILEStream or from the
+// mapped file in an SkMemoryStream, which codecs can decode in place without copying.
+class StreamDecodeBench final : public DecodeBench {
+public:
+    StreamDecodeBench(const char* name, const char* source, bool memoryBacked)
+        : INHERITED(SkStringPrintf("%s_%s", name, memoryBacked ? "memory" : "file").c_str(),
+                    source)
+        , fPath(GetResourcePath(source))
+        , fMemoryBacked(memoryBacked)
+    {}
+
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops-- > 0) {
+            std::unique_ptr<SkStream> stream;
+            if (fMemoryBacked) {
+                stream = SkMemoryStream::Make(fData);
+            } else {
+                stream = SkFILEStream::Make(fPath.c_str());
+            }
+            std::unique_ptr<SkCodec> codec = SkCodec::MakeFromStream(std::move(stream));
+            SkASSERT(codec);
+            SkBitmap bm;
+            bm.allocPixels(codec->getInfo());
+            SkAssertResult(codec->getPixels(bm.pixmap()) == SkCodec::kSuccess);
+        }
+    }
+
+private:
+    const SkString fPath;
+    const bool     fMemoryBacked;
+
+    using INHERITED = DecodeBench;
+};
+
 
 class SkottieDecodeBench final : public DecodeBench {
 public:
@@ -233,3 +269,8 @@ DEF_BENCH(return new BitmapDecodeBench("png_small"    /*  32x  32*/, "images/man
 DEF_BENCH(return new BitmapDecodeBench("png_phonehub_connecting"   , "images/Connecting.png"));
 DEF_BENCH(return new BitmapDecodeBench("png_phonehub_generic_error", "images/Generic_Error.png"));
 DEF_BENCH(return new BitmapDecodeBench("png_phonehub_onboard"      , "images/Onboard.png"));
+
+DEF_BENCH(return new StreamDecodeBench("png_large",  "images/mandrill_1600.png",  false));
+DEF_BENCH(return new StreamDecodeBench("png_large",  "images/mandrill_1600.png",  true));
+DEF_BENCH(return new StreamDecodeBench("jpeg_large", "images/iphone_13_pro.jpeg", false));
+DEF_BENCH(return new StreamDecodeBench("jpeg_large", "images/iphone_13_pro.jpeg", true));
@@ -7,12 +7,15 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkBitmap.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkStream.h"
 #include "include/encode/SkJpegEncoder.h"
 #include "include/encode/SkPngEncoder.h"
 #include "include/encode/SkWebpEncoder.h"
 #include "tools/Resources.h"
 
+#include <memory>
+
 // Like other Benchmark subclasses, Encoder benchmarks are run by:
 // nanobench --match ^Encode_
 //
@@ -42,14 +45,23 @@ public:
             SkNullWStream dst;
             SkAssertResult(fEncoder(&dst, pixmap));
             SkASSERT(dst.bytesWritten() > 0);
+            fEncodedBytes = dst.bytesWritten();
         }
     }
 
+    // How small each setting makes the file matters as much as how fast it is.
+    void getMetrics(skia_private::TArray<SkString>* keys,
+                    skia_private::TArray<double>* values) override {
+        keys->push_back(SkString("encoded_bytes"));
+        values->push_back(fEncodedBytes);
+    }
+
 private:
     const char* fSourceFilename;
     Encoder     fEncoder;
     SkString    fName;
     SkBitmap    fBitmap;
+    size_t      fEncodedBytes = 0;
 };
 
 static bool encode_jpeg(SkWStream* dst, const SkPixmap& src) {
@@ -75,16 +87,21 @@ static bool encode_webp_lossless(SkWStream* dst, const SkPixmap& src) {
 static bool encode_png(SkWStream* dst,
                        const SkPixmap& src,
                        SkPngEncoder::FilterFlag filters,
-                       int zlibLevel) {
+                       int zlibLevel,
+                       bool sampleFilters = false) {
     SkPngEncoder::Options opts;
     opts.fFilterFlags = filters;
     opts.fZLibLevel = zlibLevel;
+    opts.fSampleFilters = sampleFilters;
     return SkPngEncoder::Encode(dst, src, opts);
 }
 
 #define PNG(FLAG, ZLIBLEVEL) [](SkWStream* d, const SkPixmap& s) { \
            return encode_png(d, s, SkPngEncoder::FilterFlag::FLAG, ZLIBLEVEL); }
 
+#define PNG_SAMPLED(ZLIBLEVEL) [](SkWStream* d, const SkPixmap& s) { \
+           return encode_png(d, s, SkPngEncoder::FilterFlag::kAll, ZLIBLEVEL, true); }
+
 static const char* srcs[2] = {"images/mandrill_512.png", "images/color_wheel.jpg"};
 
 // The Android Photos app uses a quality of 90 on JPEG encodes
@@ -122,4 +139,80 @@ DEF_BENCH(return new EncodeBench(srcs[1], PNG(kNone, 6), "PNG_6n"));
 DEF_BENCH(return new EncodeBench(srcs[1], PNG(kNone, 3), "PNG_3n"));
 DEF_BENCH(return new EncodeBench(srcs[1], PNG(kNone, 1), "PNG_1n"));
 
+// Choosing filters for bands of rows from a sample of them (PNG_6f) should be nearly as small as
+// trying every filter on every row (PNG) and nearly as fast as not filtering (PNG_6n), on both UI
+// screenshots and photos.
+static const char* pngFilterSrcs[] = {
+    "images/text.png",
+    "images/shadowreference.png",
+    "images/iconstrip.png",
+    "images/mandrill_1600.png",
+    "images/dog.jpg",
+    "images/iphone_13_pro.jpeg",
+};
+DEF_BENCH(return new EncodeBench(srcs[0], PNG_SAMPLED(6), "PNG_6f"));
+DEF_BENCH(return new EncodeBench(srcs[1], PNG_SAMPLED(6), "PNG_6f"));
+DEF_BENCH(return new EncodeBench(pngFilterSrcs[0], PNG(kAll, 6), "PNG"));
+DEF_BENCH(return new EncodeBench(pngFilterSrcs[0], PNG(kNone, 6), "PNG_6n"));
+DEF_BENCH(return new EncodeBench(pngFilterSrcs[0], PNG_SAMPLED(6), "PNG_6f"));
+DEF_BENCH(return new EncodeBench(pngFilterSrcs[1], PNG(kAll, 6), "PNG"));
+DEF_BENCH(return new EncodeBench(pngFilterSrcs[1], PNG(kNone, 6), "PNG_6n"));
+DEF_BENCH(return new EncodeBench(pngFilterSrcs[1], PNG_SAMPLED(6), "PNG_6f"));
+DEF_BENCH(return new EncodeBench(pngFilterSrcs[2], PNG(kAll, 6), "PNG"));
+DEF_BENCH(return new EncodeBench(pngFilterSrcs[2], PNG(kNone, 6), "PNG_6n"));
+DEF_BENCH(return new EncodeBench(pngFilterSrcs[2], PNG_SAMPLED(6), "PNG_6f"));
+DEF_BENCH(return new EncodeBench(pngFilterSrcs[3], PNG(kNone, 6), "PNG_6n"));
+DEF_BENCH(return new EncodeBench(pngFilterSrcs[3], PNG_SAMPLED(6), "PNG_6f"));
+DEF_BENCH(return new EncodeBench(pngFilterSrcs[4], PNG(kAll, 6), "PNG"));
+DEF_BENCH(return new EncodeBench(pngFilterSrcs[4], PNG(kNone, 6), "PNG_6n"));
+DEF_BENCH(return new EncodeBench(pngFilterSrcs[4], PNG_SAMPLED(6), "PNG_6f"));
+DEF_BENCH(return new EncodeBench(pngFilterSrcs[5], PNG(kAll, 6), "PNG"));
+DEF_BENCH(return new EncodeBench(pngFilterSrcs[5], PNG(kNone, 6), "PNG_6n"));
+DEF_BENCH(return new EncodeBench(pngFilterSrcs[5], PNG_SAMPLED(6), "PNG_6f"));
+
+
+// Encodes a PNG with SkPngEncoder::Options::fExecutor set to a pool of this many threads.
+class ThreadedPngEncodeBench : public Benchmark {
+public:
+    ThreadedPngEncodeBench(const char* filename, int threads)
+        : fSourceFilename(filename)
+        , fThreads(threads)
+        , fName(SkStringPrintf("Encode_%s_PNG_%dthreads", filename, threads)) {}
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkAssertResult(GetResourceAsBitmap(fSourceFilename, &fBitmap));
+        fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkPngEncoder::Options opts;
+        opts.fExecutor = fExecutor.get();
+        while (loops-- > 0) {
+            SkNullWStream dst;
+            SkAssertResult(SkPngEncoder::Encode(&dst, fBitmap.pixmap(), opts));
+            SkASSERT(dst.bytesWritten() > 0);
+        }
+    }
+
+private:
+    const char*                 fSourceFilename;
+    int                         fThreads;
+    SkString                    fName;
+    SkBitmap                    fBitmap;
+    std::unique_ptr<SkExecutor> fExecutor;
+};
+
+// Compare these with Encode_images/mandrill_1600.png_PNG.
+DEF_BENCH(return new EncodeBench("images/mandrill_1600.png", PNG(kAll, 6), "PNG"));
+DEF_BENCH(return new ThreadedPngEncodeBench("images/mandrill_1600.png",  1));
+DEF_BENCH(return new ThreadedPngEncodeBench("images/mandrill_1600.png",  2));
+DEF_BENCH(return new ThreadedPngEncodeBench("images/mandrill_1600.png",  4));
+DEF_BENCH(return new ThreadedPngEncodeBench("images/mandrill_1600.png",  8));
+DEF_BENCH(return new ThreadedPngEncodeBench("images/mandrill_1600.png", 16));
+
 #undef PNG
+#undef PNG_SAMPLED
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2023 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkString.h"
+#include "src/core/SkTaskGroup.h"
+
+#include <atomic>
+
+// Compares SkExecutor thread pools on fan-out/fan-in task graphs: each loop adds fFanOut tasks,
+// each of which adds fFanOut more small leaf tasks to a nested SkTaskGroup and waits on them.
+class ExecutorBench : public Benchmark {
+public:
+    enum class Pool { kFIFO, kLIFO, kWorkStealing };
+
+    ExecutorBench(Pool pool, int threads, int fanOut)
+        : fPool(pool), fThreads(threads), fFanOut(fanOut) {
+        static const char* kNames[] = { "fifo", "lifo", "workstealing" };
+        fName.printf("executor_fanout_%s_%dthreads_%d", kNames[(int)pool], threads, fanOut);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        switch (fPool) {
+            case Pool::kFIFO:
+                fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+                break;
+            case Pool::kLIFO:
+                fExecutor = SkExecutor::MakeLIFOThreadPool(fThreads);
+                break;
+            case Pool::kWorkStealing:
+                fExecutor = SkExecutor::MakeWorkStealingPool(fThreads);
+                break;
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkExecutor& executor = *fExecutor;
+        for (int i = 0; i < loops; i++) {
+            SkTaskGroup root(executor);
+            root.batch(fFanOut, [&](int) {
+                SkTaskGroup leaves(executor);
+                leaves.batch(fFanOut, [&](int leaf) {
+                    // A little bit of work, about the size of a small deflate or blit.
+                    uint32_t x = leaf;
+                    for (int j = 0; j < 256; j++) {
+                        x = x * 1664525 + 1013904223;
+                    }
+                    fSink.fetch_add(x, std::memory_order_relaxed);
+                });
+                leaves.wait();
+            });
+            root.wait();
+        }
+    }
+
+private:
+    const Pool                  fPool;
+    const int                   fThreads;
+    const int                   fFanOut;
+    SkString                    fName;
+    std::unique_ptr<SkExecutor> fExecutor;
+    std::atomic<uint32_t>       fSink{0};
+};
+
+#define EXECUTOR_BENCHES(threads, fanOut)                                                       \
+    DEF_BENCH(return new ExecutorBench(ExecutorBench::Pool::kFIFO,         threads, fanOut);)  \
+    DEF_BENCH(return new ExecutorBench(ExecutorBench::Pool::kLIFO,         threads, fanOut);)  \
+    DEF_BENCH(return new ExecutorBench(ExecutorBench::Pool::kWorkStealing, threads, fanOut);)
+
+EXECUTOR_BENCHES( 4, 16)
+EXECUTOR_BENCHES( 4, 64)
+EXECUTOR_BENCHES(16, 16)
+EXECUTOR_BENCHES(16, 64)
@@ -6,7 +6,12 @@
  */
 
 #include "bench/Benchmark.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkString.h"
 #include "src/core/SkResourceCache.h"
+#include "src/core/SkTaskGroup.h"
+
+#include <memory>
 
 namespace {
 static void* gGlobalAddress;
@@ -72,6 +77,58 @@ private:
     using INHERITED = Benchmark;
 };
 
+// Lookups alone, from a growing number of threads. Each loop does the same total number of
+// lookups, split between the threads, so this shows how lookup throughput scales with threads.
+// Half the lookups hit and half miss.
+class ImageCacheThreadedBench : public Benchmark {
+public:
+    explicit ImageCacheThreadedBench(int threads)
+            : fCache(kCacheCount * 100)
+            , fThreads(threads) {
+        fName.printf("imagecache_%dthreads", fThreads);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        for (int i = 0; i < kCacheCount; ++i) {
+            fCache.add(new TestRec(TestKey(i), i));
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int work = 0; work < loops; work++) {
+            SkTaskGroup(*fExecutor).batch(fThreads, [&](int threadIndex) {
+                for (int i = threadIndex; i < kLookups; i += fThreads) {
+                    fCache.find(TestKey((i * 7) % (2 * kCacheCount)), TestRec::Visitor, nullptr);
+                }
+            });
+        }
+    }
+
+private:
+    inline static constexpr int kCacheCount = 500;
+    inline static constexpr int kLookups = 64 * 1024;
+
+    SkResourceCache fCache;
+    const int fThreads;
+    SkString fName;
+    std::unique_ptr<SkExecutor> fExecutor;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new ImageCacheBench(); )
+
+DEF_BENCH( return new ImageCacheThreadedBench(1); )
+DEF_BENCH( return new ImageCacheThreadedBench(2); )
+DEF_BENCH( return new ImageCacheThreadedBench(4); )
+DEF_BENCH( return new ImageCacheThreadedBench(8); )
+DEF_BENCH( return new ImageCacheThreadedBench(16); )
+DEF_BENCH( return new ImageCacheThreadedBench(32); )
@@ -8,22 +8,30 @@
 #include "bench/Benchmark.h"
 #include "include/core/SkBitmap.h"
 #include "include/core/SkColorSpace.h"
+#include "include/core/SkExecutor.h"
 #include "src/core/SkMipmap.h"
 
+#include <memory>
+
 class MipmapBench: public Benchmark {
     SkBitmap fBitmap;
     SkString fName;
     const int fW, fH;
     bool fHalfFoat;
+    const int fThreads;
+    std::unique_ptr<SkExecutor> fExecutor;
 
 public:
-    MipmapBench(int w, int h, bool halfFloat = false)
-        : fW(w), fH(h), fHalfFoat(halfFloat)
+    MipmapBench(int w, int h, bool halfFloat = false, int threads = 0)
+        : fW(w), fH(h), fHalfFoat(halfFloat), fThreads(threads)
     {
         fName.printf("mipmap_build_%dx%d", w, h);
         if (halfFloat) {
             fName.append("_f16");
         }
+        if (threads > 0) {
+            fName.appendf("_%dthreads", threads);
+        }
     }
 
 protected:
@@ -39,11 +47,14 @@ protected:
                                              SkColorSpace::MakeSRGB());
         fBitmap.allocPixels(info);
         fBitmap.eraseColor(SK_ColorWHITE);  // so we don't read uninitialized memory
+        if (fThreads > 0) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
     }
 
     void onDraw(int loops, SkCanvas*) override {
         for (int i = 0; i < loops * 4; i++) {
-            SkMipmap::Build(fBitmap, nullptr)->unref();
+            SkMipmap::Build(fBitmap, nullptr, fExecutor.get())->unref();
         }
     }
 
@@ -66,3 +77,12 @@ DEF_BENCH( return new MipmapBench(2048, 2048); )
 DEF_BENCH( return new MipmapBench(2047, 2047); )
 DEF_BENCH( return new MipmapBench(2048, 2047); )
 DEF_BENCH( return new MipmapBench(2047, 2048); )
+
+// Camera and video sized images, where the top levels are big enough to split across threads.
+DEF_BENCH( return new MipmapBench(3840, 2160); )
+DEF_BENCH( return new MipmapBench(3840, 2160, true); )
+DEF_BENCH( return new MipmapBench(3840, 2160, false, 4); )
+DEF_BENCH( return new MipmapBench(3840, 2160, true,  4); )
+DEF_BENCH( return new MipmapBench(7680, 4320); )
+DEF_BENCH( return new MipmapBench(7680, 4320, false, 4); )
+DEF_BENCH( return new MipmapBench(7680, 4320, false, 8); )
@@ -8,18 +8,25 @@
 #include "bench/Benchmark.h"
 
 #include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
 #include "include/core/SkData.h"
 #include "include/core/SkExecutor.h"
+#include "include/core/SkFont.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkPixmap.h"
 #include "include/core/SkStream.h"
+#include "include/core/SkString.h"
 #include "include/effects/SkGradientShader.h"
 #include "include/private/base/SkTo.h"
 #include "src/base/SkRandom.h"
 #include "src/core/SkAutoPixmapStorage.h"
 #include "src/pdf/SkPDFUnion.h"
 #include "src/utils/SkFloatToDecimal.h"
+#include "tools/ProcStats.h"
 #include "tools/Resources.h"
+#include "tools/flags/CommandLineFlags.h"
+
+#include <algorithm>
 
 namespace {
 struct WStreamWriteTextBenchmark : public Benchmark {
@@ -303,6 +310,62 @@ struct PDFClipPathBenchmark : public Benchmark {
     }
 };
 
+static DEFINE_int(pdfManyPages, 1000, "Pages per document written by the PDFManyPages benches.");
+
+/** Writes a long document, like a report generated on a server, and reports how far the resident
+    set grew while writing it (see tools/ProcStats.h) as the "peak_rss_growth_kb" metric, with and
+    without a streaming memory budget.  Run with --pdfManyPages 10000 to see the budget matter. */
+class PDFManyPagesBench : public Benchmark {
+public:
+    explicit PDFManyPagesBench(size_t streamingMemoryBudget)
+        : fStreamingMemoryBudget(streamingMemoryBudget)
+        , fName(streamingMemoryBudget ? "PDFManyPages_streaming" : "PDFManyPages") {}
+
+protected:
+    const char* onGetName() override { return fName; }
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+    void onPerCanvasPreDraw(SkCanvas*) override { fPeakRSSGrowth = 0; }
+    void onDraw(int loops, SkCanvas*) override {
+        const int pageCount = FLAGS_pdfManyPages;
+        const int64_t startRSS = sk_tools::getCurrResidentSetSizeBytes();
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(32, 32);
+        SkFont font(nullptr, 12);
+        while (loops-- > 0) {
+            SkNullWStream wStream;
+            SkPDF::Metadata metadata;
+            metadata.fStreamingMemoryBudget = fStreamingMemoryBudget;
+            auto doc = SkPDF::MakeDocument(&wStream, metadata);
+            for (int page = 0; page < pageCount; page++) {
+                SkCanvas* canvas = doc->beginPage(612, 792);
+                SkString text = SkStringPrintf("Page %d of %d", page + 1, pageCount);
+                canvas->drawString(text, 36, 36, font, SkPaint());
+                // A different small image on each page, like a barcode.
+                bitmap.eraseColor(0xFF000000 | page);
+                canvas->drawImage(bitmap.asImage(), 36, 72);
+                doc->endPage();
+                if (page % 100 == 0) {
+                    fPeakRSSGrowth = std::max(fPeakRSSGrowth,
+                                              sk_tools::getCurrResidentSetSizeBytes() - startRSS);
+                }
+            }
+            doc->close();
+        }
+    }
+    void getMetrics(skia_private::TArray<SkString>* keys,
+                    skia_private::TArray<double>* values) override {
+        keys->push_back(SkString("peak_rss_growth_kb"));
+        values->push_back(fPeakRSSGrowth / 1024.0);
+    }
+
+private:
+    size_t fStreamingMemoryBudget;
+    const char* fName;
+    int64_t fPeakRSSGrowth = 0;
+};
+
 }  // namespace
 DEF_BENCH(return new PDFImageBench;)
 DEF_BENCH(return new PDFJpegImageBench;)
@@ -311,6 +374,8 @@ DEF_BENCH(return new PDFColorComponentBench;)
 DEF_BENCH(return new PDFShaderBench;)
 DEF_BENCH(return new WritePDFTextBenchmark;)
 DEF_BENCH(return new PDFClipPathBenchmark;)
+DEF_BENCH(return new PDFManyPagesBench(0);)
+DEF_BENCH(return new PDFManyPagesBench(4 << 20);)
 
 #ifdef SK_PDF_ENABLE_SLOW_TESTS
 #include "include/core/SkExecutor.h"
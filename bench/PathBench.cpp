@@ -6,6 +6,7 @@
  */
 
 #include "bench/Benchmark.h"
+#include "bench/ScanConverter.h"
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColorPriv.h"
@@ -23,6 +24,7 @@
 #include "src/core/SkMatrixPriv.h"
 
 using namespace skia_private;
+using BenchUtils::ScanConverter;
 
 enum Flags {
     kStroke_Flag = 1 << 0,
@@ -35,11 +37,13 @@ enum Flags {
 #define FLAGS11  Flags(kStroke_Flag | kBig_Flag)
 
 class PathBench : public Benchmark {
-    SkPaint     fPaint;
-    SkString    fName;
-    Flags       fFlags;
+    SkPaint       fPaint;
+    SkString      fName;
+    Flags         fFlags;
+    ScanConverter fScanConverter;
 public:
-    PathBench(Flags flags) : fFlags(flags) {
+    PathBench(Flags flags, ScanConverter sc = ScanConverter::kDefault)
+            : fFlags(flags), fScanConverter(sc) {
         fPaint.setStyle(flags & kStroke_Flag ? SkPaint::kStroke_Style :
                         SkPaint::kFill_Style);
         fPaint.setStrokeWidth(SkIntToScalar(5));
@@ -51,15 +55,21 @@ public:
     virtual int complexity() { return 0; }
 
 protected:
+    bool isSuitableFor(Backend backend) override {
+        return BenchUtils::ScanConverterSuitableFor(fScanConverter, backend);
+    }
+
     const char* onGetName() override {
         fName.printf("path_%s_%s_",
                      fFlags & kStroke_Flag ? "stroke" : "fill",
                      fFlags & kBig_Flag ? "big" : "small");
         this->appendName(&fName);
+        fName.append(BenchUtils::ScanConverterSuffix(fScanConverter));
         return fName.c_str();
     }
 
     void onDraw(int loops, SkCanvas* canvas) override {
+        BenchUtils::AutoScanConverter scanConverter(fScanConverter);
         SkPaint paint(fPaint);
         this->setupPaint(&paint);
 
@@ -162,7 +172,8 @@ private:
 
 class CirclePathBench: public PathBench {
 public:
-    CirclePathBench(Flags flags) : INHERITED(flags) {}
+    CirclePathBench(Flags flags, ScanConverter sc = ScanConverter::kDefault)
+            : INHERITED(flags, sc) {}
 
     void appendName(SkString* name) override {
         name->append("circle");
@@ -235,7 +246,8 @@ private:
 
 class SawToothPathBench : public PathBench {
 public:
-    SawToothPathBench(Flags flags) : INHERITED(flags) {}
+    SawToothPathBench(Flags flags, ScanConverter sc = ScanConverter::kDefault)
+            : INHERITED(flags, sc) {}
 
     void appendName(SkString* name) override {
         name->append("sawtooth");
@@ -265,7 +277,8 @@ private:
 
 class LongCurvedPathBench : public PathBench {
 public:
-    LongCurvedPathBench(Flags flags) : INHERITED(flags) {}
+    LongCurvedPathBench(Flags flags, ScanConverter sc = ScanConverter::kDefault)
+            : INHERITED(flags, sc) {}
 
     void appendName(SkString* name) override {
         name->append("long_curved");
@@ -1199,6 +1212,17 @@ DEF_BENCH( return new LongCurvedPathBench(FLAGS01); )
 DEF_BENCH( return new LongLinePathBench(FLAGS00); )
 DEF_BENCH( return new LongLinePathBench(FLAGS01); )
 
+// Compare the CPU scan converters on the same paths.
+DEF_BENCH( return new CirclePathBench(FLAGS10, ScanConverter::kSupersample); )
+DEF_BENCH( return new CirclePathBench(FLAGS10, ScanConverter::kAnalytic); )
+DEF_BENCH( return new CirclePathBench(FLAGS10, ScanConverter::kAccumulation); )
+DEF_BENCH( return new SawToothPathBench(FLAGS00, ScanConverter::kSupersample); )
+DEF_BENCH( return new SawToothPathBench(FLAGS00, ScanConverter::kAnalytic); )
+DEF_BENCH( return new SawToothPathBench(FLAGS00, ScanConverter::kAccumulation); )
+DEF_BENCH( return new LongCurvedPathBench(FLAGS00, ScanConverter::kSupersample); )
+DEF_BENCH( return new LongCurvedPathBench(FLAGS00, ScanConverter::kAnalytic); )
+DEF_BENCH( return new LongCurvedPathBench(FLAGS00, ScanConverter::kAccumulation); )
+
 DEF_BENCH( return new PathCreateBench(); )
 DEF_BENCH( return new PathCopyBench(); )
 DEF_BENCH( return new PathTransformBench(true); )
@@ -7,9 +7,12 @@
 #include <memory>
 
 #include "bench/Benchmark.h"
+#include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
 #include "include/core/SkPicture.h"
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkPoint.h"
@@ -97,3 +100,66 @@ DEF_BENCH( return new TiledPlaybackBench(kNone,     kRandom); )
 DEF_BENCH( return new TiledPlaybackBench(kNone,     kTiled ); )
 DEF_BENCH( return new TiledPlaybackBench(kRTree,    kRandom); )
 DEF_BENCH( return new TiledPlaybackBench(kRTree,    kTiled ); )
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Measures SkPicture::playbackParallel() against playback() of a full-screen picture of AA paths
+// into a raster canvas.
+class ParallelPlaybackBench : public Benchmark {
+public:
+    explicit ParallelPlaybackBench(int threads) : fThreads(threads) {
+        if (fThreads > 0) {
+            fName.printf("parallel_playback_%dthreads", fThreads);
+        } else {
+            fName.set("parallel_playback_serial");
+        }
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        if (fThreads > 0) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+        fBitmap.allocN32Pixels(1920, 1080);
+
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(1920, 1080);
+            SkRandom rand;
+            SkPaint paint;
+            paint.setAntiAlias(true);
+            for (int i = 0; i < 2000; i++) {
+                SkPath path;
+                path.moveTo(rand.nextRangeScalar(0, 1920), rand.nextRangeScalar(0, 1080));
+                for (int j = 0; j < 3; j++) {
+                    path.quadTo(rand.nextRangeScalar(0, 1920), rand.nextRangeScalar(0, 1080),
+                                rand.nextRangeScalar(0, 1920), rand.nextRangeScalar(0, 1080));
+                }
+                paint.setColor(rand.nextU());
+                canvas->drawPath(path, paint);
+            }
+        fPic = recorder.finishRecordingAsPicture();
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkCanvas canvas(fBitmap);
+        for (int i = 0; i < loops; i++) {
+            if (fExecutor) {
+                fPic->playbackParallel(&canvas, *fExecutor);
+            } else {
+                fPic->playback(&canvas);
+            }
+        }
+    }
+
+private:
+    const int                   fThreads;
+    SkString                    fName;
+    std::unique_ptr<SkExecutor> fExecutor;
+    SkBitmap                    fBitmap;
+    sk_sp<SkPicture>            fPic;
+};
+
+DEF_BENCH( return new ParallelPlaybackBench(0); )
+DEF_BENCH( return new ParallelPlaybackBench(4); )
@@ -6,6 +6,7 @@
  */
 
 #include "bench/SKPBench.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkSurface.h"
 #include "include/gpu/GrDirectContext.h"
 #include "src/gpu/ganesh/GrDirectContextPriv.h"
@@ -21,13 +22,18 @@ static DEFINE_int(GPUbenchTileW, 1600, "Tile width  used for GPU SKP playback.")
 static DEFINE_int(GPUbenchTileH, 512, "Tile height used for GPU SKP playback.");
 
 SKPBench::SKPBench(const char* name, const SkPicture* pic, const SkIRect& clip, SkScalar scale,
-                   bool doLooping)
+                   bool doLooping, SkExecutor* executor)
     : fPic(SkRef(pic))
     , fClip(clip)
     , fScale(scale)
     , fName(name)
-    , fDoLooping(doLooping) {
-    fUniqueName.printf("%s_%.2g", name, scale);  // Scale makes this unqiue for perf.skia.org traces.
+    , fDoLooping(doLooping)
+    , fExecutor(executor) {
+    if (fExecutor) {
+        fName.append("_parallel");
+    }
+    // Scale makes this unqiue for perf.skia.org traces.
+    fUniqueName.printf("%s_%.2g", fName.c_str(), scale);
 }
 
 SKPBench::~SKPBench() {
@@ -58,6 +64,11 @@ void SKPBench::onPerCanvasPreDraw(SkCanvas* canvas) {
     int tileW = gpu ? FLAGS_GPUbenchTileW : FLAGS_CPUbenchTileW,
         tileH = gpu ? FLAGS_GPUbenchTileH : FLAGS_CPUbenchTileH;
 
+    if (fExecutor) {
+        // playbackParallel() does its own splitting.
+        tileW = bounds.width();
+        tileH = bounds.height();
+    }
     tileW = std::min(tileW, bounds.width());
     tileH = std::min(tileH, bounds.height());
 
@@ -101,6 +112,9 @@ void SKPBench::onPerCanvasPostDraw(SkCanvas* canvas) {
 }
 
 bool SKPBench::isSuitableFor(Backend backend) {
+    if (fExecutor) {
+        return backend == kRaster_Backend;
+    }
     return backend != kNonRendering_Backend;
 }
 
@@ -133,6 +147,13 @@ void SKPBench::drawPicture() {
     for (int j = 0; j < fTileRects.size(); ++j) {
         const SkMatrix trans = SkMatrix::Translate(-fTileRects[j].fLeft / fScale,
                                                    -fTileRects[j].fTop / fScale);
+        if (fExecutor) {
+            SkCanvas* canvas = fSurfaces[j]->getCanvas();
+            SkAutoCanvasRestore acr(canvas, true);
+            canvas->concat(trans);
+            fPic->playbackParallel(canvas, *fExecutor);
+            continue;
+        }
         fSurfaces[j]->getCanvas()->drawPicture(fPic.get(), &trans, nullptr);
     }
 
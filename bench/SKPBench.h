@@ -13,15 +13,19 @@
 #include "include/core/SkPicture.h"
 #include "include/private/base/SkTDArray.h"
 
+class SkExecutor;
 class SkSurface;
 
 /**
  * Runs an SkPicture as a benchmark by repeatedly drawing it scaled inside a device clip.
+ *
+ * If given an executor, the picture is instead drawn untiled with SkPicture::playbackParallel(),
+ * on raster backends only.
  */
 class SKPBench : public Benchmark {
 public:
     SKPBench(const char* name, const SkPicture*, const SkIRect& devClip, SkScalar scale,
-             bool doLooping);
+             bool doLooping, SkExecutor* executor = nullptr);
     ~SKPBench() override;
 
     int calculateLoops(int defaultLoops) const override {
@@ -60,6 +64,7 @@ private:
     SkTDArray<SkIRect> fTileRects;     // for MultiPictureDraw
 
     const bool fDoLooping;
+    SkExecutor* const fExecutor;
 
     using INHERITED = Benchmark;
 };
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef ScanConverter_DEFINED
+#define ScanConverter_DEFINED
+
+#include "bench/Benchmark.h"
+#include "src/core/SkScan.h"
+
+namespace BenchUtils {
+
+// Which CPU scan converter anti-aliased path fills use, so benches can compare them.
+enum class ScanConverter {
+    kDefault,       // whatever the flags chose
+    kSupersample,
+    kAnalytic,
+    kAccumulation,
+};
+
+// A suffix for bench names, empty for kDefault.
+inline const char* ScanConverterSuffix(ScanConverter sc) {
+    switch (sc) {
+        case ScanConverter::kDefault:      return "";
+        case ScanConverter::kSupersample:  return "_saa";
+        case ScanConverter::kAnalytic:     return "_aaa";
+        case ScanConverter::kAccumulation: return "_accum";
+    }
+    return "";
+}
+
+// The scan converters only matter when drawing with the CPU.
+inline bool ScanConverterSuitableFor(ScanConverter sc, Benchmark::Backend backend) {
+    return sc == ScanConverter::kDefault || backend == Benchmark::kRaster_Backend;
+}
+
+// Switches to a scan converter, restoring the previous choice when it goes out of scope.
+class AutoScanConverter {
+public:
+    explicit AutoScanConverter(ScanConverter sc)
+            : fUseAnalyticAA(gSkUseAnalyticAA)
+            , fForceAnalyticAA(gSkForceAnalyticAA)
+            , fUseAccumulationAA(gSkUseAccumulationAA) {
+        switch (sc) {
+            case ScanConverter::kDefault:
+                break;
+            case ScanConverter::kSupersample:
+                gSkUseAnalyticAA = gSkForceAnalyticAA = gSkUseAccumulationAA = false;
+                break;
+            case ScanConverter::kAnalytic:
+                gSkUseAnalyticAA = gSkForceAnalyticAA = true;
+                gSkUseAccumulationAA = false;
+                break;
+            case ScanConverter::kAccumulation:
+                gSkUseAccumulationAA = true;
+                break;
+        }
+    }
+
+    ~AutoScanConverter() {
+        gSkUseAnalyticAA     = fUseAnalyticAA;
+        gSkForceAnalyticAA   = fForceAnalyticAA;
+        gSkUseAccumulationAA = fUseAccumulationAA;
+    }
+
+private:
+    const bool fUseAnalyticAA;
+    const bool fForceAnalyticAA;
+    const bool fUseAccumulationAA;
+};
+
+}  // namespace BenchUtils
+
+#endif
@@ -10,10 +10,12 @@
 #include "bench/Benchmark.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColorSpace.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkGraphics.h"
 #include "include/core/SkTypeface.h"
 #include "include/private/chromium/SkChromeRemoteGlyphCache.h"
 #include "src/base/SkTLazy.h"
+#include "src/core/SkStrikeCache.h"
 #include "src/core/SkStrikeSpec.h"
 #include "src/core/SkTaskGroup.h"
 #include "src/core/SkTextBlobTrace.h"
@@ -120,6 +122,65 @@ DEF_BENCH( return new SkGlyphCacheBasic(32 * 1024 * 1024); )
 DEF_BENCH( return new SkGlyphCacheStressTest(256 * 1024); )
 DEF_BENCH( return new SkGlyphCacheStressTest(32 * 1024 * 1024); )
 
+// Strike lookups alone, from a growing number of threads. Each loop does the same total number of
+// lookups, split between the threads, so this shows how lookup throughput scales with threads.
+class SkGlyphCacheContended : public Benchmark {
+public:
+    explicit SkGlyphCacheContended(int threads) : fThreads(threads) {
+        fName.printf("SkGlyphCacheContended_%dthreads", fThreads);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        SkFont font;
+        font.setEdging(SkFont::Edging::kAntiAlias);
+        font.setSubpixel(true);
+        font.setTypeface(ToolUtils::create_portable_typeface("serif", SkFontStyle::Italic()));
+        SkPaint defaultPaint;
+        for (int size = 0; size < kStrikeCount; size++) {
+            font.setSize(8 + size);
+            fSpecs.push_back(SkStrikeSpec::MakeMask(
+                    font, defaultPaint, SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+                    SkScalerContextFlags::kNone, SkMatrix::I()));
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkStrikeCache* cache = SkStrikeCache::GlobalStrikeCache();
+        for (int work = 0; work < loops; work++) {
+            SkTaskGroup(*fExecutor).batch(fThreads, [&](int threadIndex) {
+                for (int i = threadIndex; i < kLookups; i += fThreads) {
+                    sk_sp<SkStrike> strike =
+                            fSpecs[(i * 7) % kStrikeCount].findOrCreateStrike(cache);
+                }
+            });
+        }
+    }
+
+private:
+    inline static constexpr int kStrikeCount = 64;
+    inline static constexpr int kLookups = 64 * 1024;
+
+    const int fThreads;
+    SkString fName;
+    std::unique_ptr<SkExecutor> fExecutor;
+    std::vector<SkStrikeSpec> fSpecs;
+};
+
+DEF_BENCH( return new SkGlyphCacheContended(1); )
+DEF_BENCH( return new SkGlyphCacheContended(2); )
+DEF_BENCH( return new SkGlyphCacheContended(4); )
+DEF_BENCH( return new SkGlyphCacheContended(8); )
+DEF_BENCH( return new SkGlyphCacheContended(16); )
+DEF_BENCH( return new SkGlyphCacheContended(32); )
+
 namespace {
 class DiscardableManager : public SkStrikeServer::DiscardableHandleManager,
                            public SkStrikeClient::DiscardableHandleManager {
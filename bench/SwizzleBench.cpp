@@ -6,7 +6,11 @@
  */
 
 #include "bench/Benchmark.h"
+#include "include/core/SkString.h"
 #include "src/core/SkOpts.h"
+#include "src/core/SkRasterPipeline.h"
+#include "src/core/SkRasterPipelineOpContexts.h"
+#include "src/core/SkRasterPipelineOpList.h"
 
 class SwizzleBench : public Benchmark {
 public:
@@ -30,6 +34,45 @@ private:
     SkOpts::Swizzle_8888_u8  fFn_u8  = nullptr;
 };
 
+// The same sort of swizzle, run through a lowp SkRasterPipeline instead.  This mostly measures
+// load_8888 and store_8888, and how they scale with the width of the lowp stages
+// (16 pixels at a time on HSW, 32 on SKX). The _hsw variants always use the HSW lowp stages.
+class RasterPipelineSwizzleBench : public Benchmark {
+public:
+    RasterPipelineSwizzleBench(const char* name, SkRasterPipelineOp op, bool hsw)
+            : fName(name), fOp(op), fHSW(hsw) {
+        if (hsw) {
+            fName.append("_hsw");
+        }
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend && (!fHSW || SkOpts::just_return_lowp_hsw);
+    }
+    const char* onGetName() override { return fName.c_str(); }
+    void onDraw(int loops, SkCanvas*) override {
+        static const int K = 1023;
+        uint32_t dst[K], src[K];
+        SkRasterPipeline_MemoryCtx srcCtx = {src, 0},
+                                   dstCtx = {dst, 0};
+
+        SkRasterPipeline_<256> p;
+        p.setUseHSWLowpStagesForTesting(fHSW);
+        p.append(SkRasterPipelineOp::load_8888, &srcCtx);
+        p.append(fOp);
+        p.append(SkRasterPipelineOp::store_8888, &dstCtx);
+        auto fn = p.compile();
+
+        while (loops --> 0) {
+            fn(0,0,K,1);
+        }
+    }
+private:
+    SkString           fName;
+    SkRasterPipelineOp fOp;
+    bool               fHSW;
+};
+
 
 DEF_BENCH(return new SwizzleBench("SkOpts::RGBA_to_rgbA", SkOpts::RGBA_to_rgbA));
 DEF_BENCH(return new SwizzleBench("SkOpts::RGBA_to_bgrA", SkOpts::RGBA_to_bgrA));
@@ -41,3 +84,16 @@ DEF_BENCH(return new SwizzleBench("SkOpts::grayA_to_RGBA", SkOpts::grayA_to_RGBA
 DEF_BENCH(return new SwizzleBench("SkOpts::grayA_to_rgbA", SkOpts::grayA_to_rgbA));
 DEF_BENCH(return new SwizzleBench("SkOpts::inverted_CMYK_to_RGB1", SkOpts::inverted_CMYK_to_RGB1));
 DEF_BENCH(return new SwizzleBench("SkOpts::inverted_CMYK_to_BGR1", SkOpts::inverted_CMYK_to_BGR1));
+
+DEF_BENCH(return new RasterPipelineSwizzleBench("SkRasterPipeline::RGBA_to_rgbA",
+                                                SkRasterPipelineOp::premul, false));
+DEF_BENCH(return new RasterPipelineSwizzleBench("SkRasterPipeline::RGBA_to_BGRA",
+                                                SkRasterPipelineOp::swap_rb, false));
+DEF_BENCH(return new RasterPipelineSwizzleBench("SkRasterPipeline::RGBA_to_RGB1",
+                                                SkRasterPipelineOp::force_opaque, false));
+DEF_BENCH(return new RasterPipelineSwizzleBench("SkRasterPipeline::RGBA_to_rgbA",
+                                                SkRasterPipelineOp::premul, true));
+DEF_BENCH(return new RasterPipelineSwizzleBench("SkRasterPipeline::RGBA_to_BGRA",
+                                                SkRasterPipelineOp::swap_rb, true));
+DEF_BENCH(return new RasterPipelineSwizzleBench("SkRasterPipeline::RGBA_to_RGB1",
+                                                SkRasterPipelineOp::force_opaque, true));
@@ -25,6 +25,7 @@
 #include "include/codec/SkCodec.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkGraphics.h"
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkString.h"
@@ -139,6 +140,9 @@ static DEFINE_string(zoom, "1.0,0",
                      "function that ping-pongs between 1.0 and zoomMax.");
 static DEFINE_bool(bbh, true, "Build a BBH for SKPs?");
 static DEFINE_bool(loopSKP, true, "Loop SKPs like we do for micro benches?");
+static DEFINE_int(skpThreads, 0,
+                  "If >0, also bench SKPs drawn with SkPicture::playbackParallel() "
+                  "on this many threads.");
 static DEFINE_int(flushEvery, 10, "Flush --outResultsFile every Nth run.");
 static DEFINE_bool(gpuStats, false, "Print GPU stats after each gpu benchmark?");
 static DEFINE_bool(gpuStatsDump, false, "Dump GPU stats after each benchmark to json");
@@ -958,6 +962,17 @@ public:
 
         // Then once each for each scale as SKPBenches (playback).
         while (fCurrentScale < fScales.size()) {
+            if (fParallelSKP) {
+                // The same SKP we just benched, this time drawn in parallel.
+                sk_sp<SkPicture> pic = std::move(fParallelSKP);
+                if (!fSKPExecutor) {
+                    fSKPExecutor = SkExecutor::MakeFIFOThreadPool(FLAGS_skpThreads);
+                }
+                fSourceType = "skp";
+                fBenchType = "playback";
+                return new SKPBench(fParallelSKPName.c_str(), pic.get(), fClip,
+                                    fScales[fCurrentScale], FLAGS_loopSKP, fSKPExecutor.get());
+            }
             while (fCurrentSKP < fSKPs.size()) {
                 const SkString& path = fSKPs[fCurrentSKP++];
                 sk_sp<SkPicture> pic = ReadPicture(path.c_str());
@@ -975,6 +990,10 @@ public:
                     pic = recorder.finishRecordingAsPicture();
                 }
                 SkString name = SkOSPath::Basename(path.c_str());
+                if (FLAGS_skpThreads > 0) {
+                    fParallelSKP = pic;
+                    fParallelSKPName = name;
+                }
                 fSourceType = "skp";
                 fBenchType = "playback";
                 return new SKPBench(name.c_str(), pic.get(), fClip, fScales[fCurrentScale],
@@ -1281,6 +1300,9 @@ private:
     int fCurrentMSKP = 0;
     int fCurrentScale = 0;
     int fCurrentSKP = 0;
+    sk_sp<SkPicture> fParallelSKP;  // Set when the next bench should be the last SKP, in parallel.
+    SkString fParallelSKPName;
+    std::unique_ptr<SkExecutor> fSKPExecutor;
     int fCurrentSVG = 0;
     int fCurrentTextBlobTrace = 0;
     int fCurrentCodec = 0;
@@ -1526,6 +1548,7 @@ int main(int argc, char** argv) {
                     combinedDMSAAStats.merge(dmsaaStats);
                 }
             }
+            bench->getMetrics(&keys, &values);
 
             bench->perCanvasPostDraw(canvas);
 
@@ -1559,7 +1582,7 @@ int main(int argc, char** argv) {
             log.endArray(); // samples
             benchStream.fillCurrentMetrics(log);
             if (!keys.empty()) {
-                // dump to json, only SKPBench currently returns valid keys / values
+                // dump to json; GPU stats, DMSAA stats, and the bench's own metrics
                 SkASSERT(keys.size() == values.size());
                 for (int j = 0; j < keys.size(); j++) {
                     log.appendMetric(keys[j].c_str(), values[j]);
@@ -1626,6 +1649,9 @@ int main(int argc, char** argv) {
             }
 
             if (FLAGS_verbose) {
+                for (int j = 0; j < keys.size(); j++) {
+                    SkDebugf("%s: %g\n", keys[j].c_str(), values[j]);
+                }
                 SkDebugf("Samples:  ");
                 for (int j = 0; j < samples.size(); j++) {
                     SkDebugf("%s  ", HUMANIZE(samples[j]));
@@ -206,6 +206,7 @@ public:
         AndroidOptions()
             : SkCodec::Options()
             , fSampleSize(1)
+            , fBoxFilter(false)
         {}
 
         /**
@@ -216,6 +217,19 @@ public:
          *  The default is 1, representing no downscaling.
          */
         int fSampleSize;
+
+        /**
+         *  If true, downscaling by fSampleSize that the codec can't do natively averages each
+         *  block of pixels that becomes one output pixel, rather than picking one pixel from
+         *  the block.  Rows are averaged as they are decoded, so for most images (including
+         *  non-interlaced PNGs and baseline JPEGs) the full size image is never in memory.
+         *
+         *  This applies when decoding to kRGBA_8888, kBGRA_8888, or kGray_8, without a subset,
+         *  and not to kUnpremul_SkAlphaType.  Otherwise it is ignored.
+         *
+         *  The default is false.
+         */
+        bool fBoxFilter;
     };
 
     /**
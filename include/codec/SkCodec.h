@@ -27,6 +27,7 @@
 #include <vector>
 
 class SkData;
+class SkExecutor;
 class SkFrameHolder;
 class SkImage;
 class SkPngChunkReader;
@@ -298,6 +299,7 @@ public:
             , fSubset(nullptr)
             , fFrameIndex(0)
             , fPriorFrame(kNoFrame)
+            , fExecutor(nullptr)
         {}
 
         ZeroInitialized            fZeroInitialized;
@@ -341,6 +343,15 @@ public:
          *  If set to kNoFrame, the codec will decode any necessary required frame(s) first.
          */
         int                        fPriorFrame;
+
+        /**
+         *  If not NULL, getPixels() may use this to decode independent parts of the image
+         *  in parallel. The result is the same as decoding without it.
+         *
+         *  Currently only used by JPEGs that contain restart markers. Ignored by scanline
+         *  and incremental decodes.
+         */
+        SkExecutor*                fExecutor;
     };
 
     /**
@@ -891,6 +902,9 @@ protected:
         return 0;
     }
 
+    // Called with each row decoded by decodeRows().  The row is only valid during the call.
+    using RowProc = std::function<void(const void* row)>;
+
 private:
     const SkEncodedInfo                fEncodedInfo;
     XformFormat                        fSrcXformFormat;
@@ -980,6 +994,22 @@ private:
 
     virtual int onGetScanlines(void* /*dst*/, int /*countLines*/, size_t /*rowBytes*/) { return 0; }
 
+    /**
+     *  Decodes the image at dstInfo's size from top to bottom, passing each row to rowProc
+     *  rather than writing them all to memory, so the whole image need never be held at once.
+     *  Used by SkSampledCodec to downscale as it decodes.
+     *
+     *  Uses onDecodeRows() if the codec implements it, or otherwise scanline decoding.  Returns
+     *  kUnimplemented if neither is available for this image.  On an incomplete decode,
+     *  rowsDecoded is set to the number of rows passed to rowProc.
+     */
+    Result decodeRows(const SkImageInfo& dstInfo, const Options&, const RowProc& rowProc,
+                      int* rowsDecoded);
+
+    virtual Result onDecodeRows(const SkImageInfo&, const Options&, const RowProc&, int*) {
+        return kUnimplemented;
+    }
+
     /**
      * On an incomplete decode, getPixels() and getScanlines() will call this function
      * to fill any uinitialized memory.
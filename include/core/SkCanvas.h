@@ -2439,6 +2439,7 @@ private:
     friend class SkNoDrawCanvas;    // needs resetForNextPicture()
     friend class SkNWayCanvas;
     friend class SkPictureRecord;   // predrawNotify (why does it need it? <reed>)
+    friend class SkRecorder;        // predrawNotify, when recording for a surface
     friend class SkOverdrawCanvas;
     friend class SkRasterHandleAllocator;
     friend class SkRecords::Draw;
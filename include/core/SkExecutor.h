@@ -22,6 +22,12 @@ public:
     static std::unique_ptr<SkExecutor> MakeLIFOThreadPool(int threads = 0,
                                                           bool allowBorrowing = true);
 
+    // Create a thread pool SkExecutor where each thread has its own lock-free deque of work.
+    // Work add()ed from a pool thread stays on that thread's deque, and idle threads steal from
+    // the others.  This suits many small, nested tasks (e.g. SkTaskGroups that add more work).
+    static std::unique_ptr<SkExecutor> MakeWorkStealingPool(int threads = 0,
+                                                            bool allowBorrowing = true);
+
     // There is always a default SkExecutor available by calling SkExecutor::GetDefault().
     static SkExecutor& GetDefault();
     static void SetDefault(SkExecutor*);  // Does not take ownership.  Not thread safe.
@@ -154,6 +154,12 @@ public:
      *  Call early in main() to allow Skia to use a JIT to accelerate CPU-bound operations.
      */
     static void AllowJIT();
+
+    /**
+     *  Save the programs the JIT compiles in this directory, and reuse them in later runs rather
+     *  than compiling them again. The directory must already exist. Pass nullptr to stop.
+     */
+    static void SetJITCacheDirectory(const char* dir);
 };
 
 class SkAutoGraphics {
@@ -87,6 +87,18 @@ public:
         return this->getPixels(pm.info(), pm.writable_addr(), pm.rowBytes());
     }
 
+    /**
+     *  Returns the smallest dimensions, at least minSize in both width and height, that
+     *  getPixels() can decode to directly, e.g. using a JPEG decoder's DCT scaling.  Decoding
+     *  this way can be much cheaper than decoding the whole image and then downscaling it.
+     *
+     *  Returns getInfo().dimensions() if the generator cannot decode to a smaller size that is at
+     *  least minSize.
+     */
+    SkISize getScaledDimensionsAtLeast(SkISize minSize) const {
+        return this->onGetScaledDimensionsAtLeast(minSize);
+    }
+
     /**
      *  If decoding to YUV is supported, this returns true. Otherwise, this
      *  returns false and the caller will ignore output parameter yuvaPixmapInfo.
@@ -131,6 +143,7 @@ protected:
     virtual bool onQueryYUVAInfo(const SkYUVAPixmapInfo::SupportedDataTypes&,
                                  SkYUVAPixmapInfo*) const { return false; }
     virtual bool onGetYUVAPlanes(const SkYUVAPixmaps&) { return false; }
+    virtual SkISize onGetScaledDimensionsAtLeast(SkISize) const { return fInfo.dimensions(); }
 
 #if defined(SK_GRAPHITE)
     virtual sk_sp<SkImage> onMakeTextureImage(skgpu::graphite::Recorder*,
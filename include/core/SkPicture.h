@@ -18,6 +18,7 @@
 class SkCanvas;
 class SkData;
 struct SkDeserialProcs;
+class SkExecutor;
 class SkImage;
 class SkMatrix;
 struct SkSerialProcs;
@@ -130,6 +131,24 @@ public:
     */
     virtual void playback(SkCanvas* canvas, AbortCallback* callback = nullptr) const = 0;
 
+    /** Replays the drawing commands on the specified canvas like playback(), but rasterizes
+        them in horizontal bands in parallel, using executor. This returns once all the bands
+        are drawn, and the pixels written are identical to those from playback().
+
+        This only helps when canvas draws into raster pixels with a rectangular clip and no
+        perspective. Otherwise, this is the same as playback(). Only call this on a plain
+        raster SkCanvas: the commands are drawn directly into its pixels, so any SkCanvas
+        subclass overrides are skipped.
+
+        Layers are not split into bands: each outermost saveLayer() through its matching
+        restore() is drawn on the calling thread, after the bands before it finish, so a
+        picture that is mostly one layer gets little from this.
+
+        @param canvas    receiver of drawing commands
+        @param executor  runs the bands
+    */
+    void playbackParallel(SkCanvas* canvas, SkExecutor& executor) const;
+
     /** Returns cull SkRect for this picture, passed in when SkPicture was created.
         Returned SkRect does not specify clipping SkRect for SkPicture; cull is hint
         of SkPicture bounds.
@@ -46,6 +46,7 @@ class SkCanvas;
 class SkCapabilities;
 class SkColorSpace;
 class SkDeferredDisplayList;
+class SkExecutor;
 class SkPaint;
 class SkSurface;
 class SkSurfaceCharacterization;
@@ -103,6 +104,26 @@ inline sk_sp<SkSurface> Raster(const SkImageInfo& imageInfo,
     return Raster(imageInfo, 0, props);
 }
 
+/** Allocates raster SkSurface that rasterizes in parallel on executor. Draws made to its SkCanvas
+    are recorded, then split into tiles and rasterized concurrently whenever the pixels are needed:
+    makeImageSnapshot(), peekPixels(), readPixels(), writePixels(), or draw(). The resulting pixels
+    are identical to those of a surface made by Raster().
+
+    The SkCanvas returned by this SkSurface does not have pixels of its own, so read pixels through
+    the SkSurface rather than the SkCanvas. Pixel memory is zeroed before use, and is deleted when
+    SkSurface is deleted. executor must outlive the SkSurface.
+
+    @param imageInfo  width, height, SkColorType, SkAlphaType, SkColorSpace,
+                      of raster surface; width and height must be greater than zero
+    @param executor   runs tile rasterization tasks
+    @param props      LCD striping orientation and setting for device independent fonts;
+                      may be nullptr
+    @return           SkSurface if parameters are valid and memory was allocated, else nullptr.
+*/
+SK_API sk_sp<SkSurface> RasterThreaded(const SkImageInfo& imageInfo,
+                                       SkExecutor& executor,
+                                       const SkSurfaceProps* props = nullptr);
+
 /** Allocates raster SkSurface. SkCanvas returned by SkSurface draws directly into the
     provided pixels.
 
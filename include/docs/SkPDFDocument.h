@@ -5,10 +5,12 @@
 
 #include "include/core/SkDocument.h"
 
+#include <cstddef>
 #include <vector>
 
 #include "include/core/SkColor.h"
 #include "include/core/SkMilestone.h"
+#include "include/core/SkRefCnt.h"
 #include "include/core/SkScalar.h"
 #include "include/core/SkString.h"
 #include "include/core/SkTime.h"
@@ -63,6 +65,27 @@ struct StructureElementNode {
     SkString fLang;
 };
 
+/** A cache of images' compressed PDF streams, which any number of documents may
+    share, on any number of threads.  An image drawn into each of them is then only
+    encoded and compressed once.  Images are found by a hash of their contents, so
+    equal images are shared even if they come from different SkImage objects.
+
+    Experimental.
+*/
+class SK_API ImageCache : public SkRefCnt {
+public:
+    /** Makes a cache holding up to about |byteLimit| bytes of compressed images,
+        dropping the least recently used ones beyond that.
+    */
+    static sk_sp<ImageCache> Make(size_t byteLimit);
+
+    /** The total size of the compressed images in the cache. */
+    virtual size_t bytesUsed() const = 0;
+
+protected:
+    ImageCache() = default;
+};
+
 /** Optional metadata to be passed into the PDF factory function.
 */
 struct Metadata {
@@ -154,6 +177,21 @@ struct Metadata {
         HighButSlow = 9,
     } fCompressionLevel = CompressionLevel::Default;
 
+    /** If set, used to compress PDF streams instead of zlib, for example with
+        a faster implementation of deflate.
+
+        It is given all of a stream's data at once, and should write it to
+        |dst| compressed in the zlib format (RFC 1950), at about the given
+        level, which is never None.  It may return false to have zlib compress
+        that stream instead.  If fExecutor is set, it may be called from more
+        than one thread at once.
+
+        Experimental.
+    */
+    using DeflateProc = bool (*)(SkWStream* dst, const void* src, size_t size,
+                                 CompressionLevel level);
+    DeflateProc fDeflate = nullptr;
+
     /** Preferred Subsetter. Only respected if both are compiled in.
 
         The Sfntly subsetter is deprecated.
@@ -164,6 +202,28 @@ struct Metadata {
         kHarfbuzz_Subsetter,
         kSfntly_Subsetter,
     } fSubsetter = kHarfbuzz_Subsetter;
+
+    /** If nonzero, write the document in a streaming mode meant for documents
+        with very many pages.
+
+        Each page is written out as soon as it ends, rather than when the
+        document is closed, and the cross-reference table is written as a
+        compressed cross-reference stream (new in PDF 1.5).  When the fonts,
+        images and other resources shared between pages are estimated to take
+        more than this many bytes, the fonts used so far are written out, and
+        none of those resources are shared with later pages.  This bounds
+        memory use, at the cost of a larger file if later pages use them again.
+
+        Experimental.
+    */
+    size_t fStreamingMemoryBudget = 0;
+
+    /** If set, images are looked up in this cache before being encoded, and
+        added to it afterwards.
+
+        Experimental.
+    */
+    sk_sp<ImageCache> fImageCache;
 };
 
 /** Associate a node ID with subsequent drawing commands in an
@@ -86,6 +86,15 @@ struct Options {
      */
     const skcms_ICCProfile* fICCProfile = nullptr;
     const char* fICCProfileDescription = nullptr;
+
+    /**
+     *  If positive, write a restart marker after every |fRestartInterval| MCUs. This makes the
+     *  file slightly larger, but lets decoders resynchronize after corrupt data, and decode
+     *  separate parts of the image in parallel.
+     *
+     *  The default is to write no restart markers.
+     */
+    int fRestartInterval = 0;
 };
 
 /**
@@ -19,6 +19,7 @@
 
 class GrDirectContext;
 class SkData;
+class SkExecutor;
 class SkImage;
 class SkPixmap;
 class SkWStream;
@@ -55,6 +56,16 @@ struct Options {
      */
     FilterFlag fFilterFlags = FilterFlag::kAll;
 
+    /**
+     *  If multiple filters are chosen and this is true, Skia picks one of them for each band of
+     *  a few rows, by estimating how well each compresses a sample of the band's rows, instead
+     *  of libpng trying each of them on every row.
+     *
+     *  This is nearly as fast as using a single filter, and typically compresses almost as
+     *  well as the per row heuristic.
+     */
+    bool fSampleFilters = false;
+
     /**
      *  Must be in [0, 9] where 9 corresponds to maximal compression.  This value is passed
      *  directly to zlib.  0 is a special case to skip zlib entirely, creating dramatically
@@ -80,6 +91,16 @@ struct Options {
      */
     const skcms_ICCProfile* fICCProfile = nullptr;
     const char* fICCProfileDescription = nullptr;
+
+    /**
+     *  If set, an encoder given all of its rows at once (as Encode() does) splits them into
+     *  blocks, and filters and compresses the blocks in parallel on this executor.  The blocks
+     *  are joined into one zlib stream that any PNG decoder can read, a little larger (well
+     *  under 1% in typical cases) than compressing the rows serially.
+     *
+     *  Encoding rows a few at a time through an encoder from Make() ignores this.
+     */
+    SkExecutor* fExecutor = nullptr;
 };
 
 /**
@@ -13,15 +13,33 @@
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkSize.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <vector>
 
+class SkData;
+class SkExecutor;
 class SkImage;
 
 class SkAnimCodecPlayer {
 public:
     SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec);
+
+    /**
+     *  Creates a player for the encoded image in |data|.
+     *
+     *  If |executor| is not null, the frames after the current one are decoded on it ahead of
+     *  time, and frames that don't depend on an earlier frame (see
+     *  SkCodec::FrameInfo::fRequiredFrame) are decoded in parallel, each by its own SkCodec.
+     *  getFrame() waits for its frame if it's still being decoded there, so don't call it from
+     *  one of |executor|'s threads.
+     *
+     *  Decoded frames are kept until they take up more than |cacheBytes|, and then the least
+     *  recently used are dropped.  The current frame is always kept.
+     */
+    SkAnimCodecPlayer(sk_sp<SkData> data, SkExecutor* executor, size_t cacheBytes = SIZE_MAX);
+
     ~SkAnimCodecPlayer();
 
     /**
@@ -53,14 +71,25 @@ public:
 
 
 private:
+    class FrameCache;
+
+    SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec, sk_sp<SkData> data, SkExecutor* executor,
+                      size_t cacheBytes);
+
     std::unique_ptr<SkCodec>        fCodec;
     SkImageInfo                     fImageInfo;
     std::vector<SkCodec::FrameInfo> fFrameInfos;
-    std::vector<sk_sp<SkImage> >    fImages;
+    sk_sp<SkImage>                  fStaticImage;
+    sk_sp<SkImage>                  fCurrImage;
     int                             fCurrIndex = 0;
-    uint32_t                        fTotalDuration;
+    uint32_t                        fTotalDuration = 0;
+
+    // Decoded frames, and the frames being decoded ahead of time.
+    std::unique_ptr<FrameCache>     fFrameCache;
 
     sk_sp<SkImage> getFrameAt(int index);
+    sk_sp<SkImage> decodeFrame(SkCodec* codec, int index) const;
+    void prefetchFrames();
 };
 
 #endif
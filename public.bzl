@@ -623,6 +623,7 @@ BASE_SRCS_ALL = [
     "src/core/SkScan.h",
     "src/core/SkScanPriv.h",
     "src/core/SkScan_AAAPath.cpp",
+    "src/core/SkScan_AccumulationPath.cpp",
     "src/core/SkScan_AntiPath.cpp",
     "src/core/SkScan_Antihair.cpp",
     "src/core/SkScan_Hairline.cpp",
@@ -1251,6 +1252,7 @@ BASE_SRCS_ALL = [
     "src/image/SkSurface_Null.cpp",
     "src/image/SkSurface_Raster.cpp",
     "src/image/SkSurface_Raster.h",
+    "src/image/SkSurface_RasterThreaded.cpp",
     "src/opts/SkBitmapProcState_opts.h",
     "src/opts/SkBlitMask_opts.h",
     "src/opts/SkBlitRow_opts.h",
@@ -1342,6 +1344,8 @@ BASE_SRCS_ALL = [
     "src/pdf/SkPDFGraphicStackState.h",
     "src/pdf/SkPDFGraphicState.cpp",
     "src/pdf/SkPDFGraphicState.h",
+    "src/pdf/SkPDFImageCache.cpp",
+    "src/pdf/SkPDFImageCache.h",
     "src/pdf/SkPDFMakeCIDGlyphWidthsArray.cpp",
     "src/pdf/SkPDFMakeCIDGlyphWidthsArray.h",
     "src/pdf/SkPDFMakeToUnicodeCmap.cpp",
@@ -637,6 +637,33 @@ int SkCodec::getScanlines(void* dst, int countLines, size_t rowBytes) {
     return linesDecoded;
 }
 
+SkCodec::Result SkCodec::decodeRows(const SkImageInfo& dstInfo, const Options& options,
+                                    const RowProc& rowProc, int* rowsDecoded) {
+    *rowsDecoded = 0;
+    Result result = this->onDecodeRows(dstInfo, options, rowProc, rowsDecoded);
+    if (result != kUnimplemented) {
+        return result;
+    }
+
+    result = this->startScanlineDecode(dstInfo, &options);
+    if (result != kSuccess) {
+        return result;
+    }
+    if (this->getScanlineOrder() != kTopDown_SkScanlineOrder) {
+        return kUnimplemented;
+    }
+    const size_t rowBytes = dstInfo.minRowBytes();
+    skia_private::AutoTMalloc<uint8_t> row(rowBytes);
+    for (int y = 0; y < dstInfo.height(); y++) {
+        if (this->getScanlines(row.get(), 1, rowBytes) != 1) {
+            return kIncompleteInput;
+        }
+        rowProc(row.get());
+        *rowsDecoded = y + 1;
+    }
+    return kSuccess;
+}
+
 bool SkCodec::skipScanlines(int countLines) {
     if (fCurrScanline < 0) {
         return false;
@@ -12,9 +12,11 @@
 #include "include/core/SkAlphaType.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkPixmap.h"
+#include "include/core/SkSize.h"
 #include "include/core/SkTypes.h"
 #include "src/codec/SkPixmapUtilsPriv.h"
 
+#include <algorithm>
 #include <utility>
 
 
@@ -109,3 +111,30 @@ SkISize SkCodecImageGenerator::getScaledDimensions(float desiredScale) const {
     }
     return size;
 }
+
+SkISize SkCodecImageGenerator::onGetScaledDimensionsAtLeast(SkISize minSize) const {
+    const SkISize fullSize = this->getInfo().dimensions();
+    minSize = {std::max(minSize.width(), 1), std::max(minSize.height(), 1)};
+    if (minSize.width() >= fullSize.width() || minSize.height() >= fullSize.height()) {
+        return fullSize;
+    }
+
+    // Codecs round the scale we ask for to one they support: any scale for WebP, but only
+    // multiples of 1/8 for JPEG, which may round down.  So we try the exact scale we'd like
+    // and each of the eighths, and keep the smallest that is still big enough.
+    SkISize best = fullSize;
+    auto consider = [&](float scale) {
+        const SkISize size = this->getScaledDimensions(scale);
+        if (size.width()  >= minSize.width()  &&
+            size.height() >= minSize.height() &&
+            size.area() < best.area()) {
+            best = size;
+        }
+    };
+    consider(std::max((float)minSize.width()  / fullSize.width(),
+                      (float)minSize.height() / fullSize.height()));
+    for (int eighths = 1; eighths < 8; eighths++) {
+        consider(eighths / 8.0f);
+    }
+    return best;
+}
@@ -114,6 +114,8 @@ protected:
 
     bool onGetYUVAPlanes(const SkYUVAPixmaps& yuvaPixmaps) override;
 
+    SkISize onGetScaledDimensionsAtLeast(SkISize minSize) const override;
+
 private:
     /*
      * Takes ownership of codec
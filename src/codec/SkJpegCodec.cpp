@@ -14,6 +14,7 @@
 #include "include/core/SkAlphaType.h"
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkPixmap.h"
 #include "include/core/SkRefCnt.h"
@@ -28,20 +29,24 @@
 #include "src/codec/SkJpegConstants.h"
 #include "src/codec/SkJpegDecoderMgr.h"
 #include "src/codec/SkJpegPriv.h"
+#include "src/codec/SkJpegSegmentScan.h"
 #include "src/codec/SkParseEncodedOrigin.h"
 #include "src/codec/SkSwizzler.h"
+#include "src/core/SkTaskGroup.h"
 
 #ifdef SK_CODEC_DECODES_JPEG_GAINMAPS
 #include "include/private/SkGainmapInfo.h"
 #include "include/private/SkJpegMetadataDecoder.h"
 #include "src/codec/SkJpegMultiPicture.h"
-#include "src/codec/SkJpegSegmentScan.h"
 #include "src/codec/SkJpegXmp.h"
 #endif  // SK_CODEC_DECODES_JPEG_GAINMAPS
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <csetjmp>
 #include <cstring>
+#include <numeric>
 #include <utility>
 #include <vector>
 
@@ -645,6 +650,11 @@ SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo,
         return kUnimplemented;
     }
 
+    if (options.fExecutor &&
+        this->decodeRestartIntervalsInParallel(dstInfo, dst, dstRowBytes, options)) {
+        return kSuccess;
+    }
+
     // Get a pointer to the decompress info since we will use it quite frequently
     jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
 
@@ -680,6 +690,182 @@ SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo,
     return kSuccess;
 }
 
+/*
+ * A restart marker resets the entropy decoder, so the data between two of them can be decoded
+ * without any of the data before it. When restart intervals line up with rows of MCUs, we can cut
+ * the image into bands of rows and decode each band as a JPEG of its own: the header, with the
+ * image height patched to the band's height, followed by the band's restart intervals (with their
+ * restart markers renumbered from zero), and an EndOfImage marker.
+ *
+ * Vertically subsampled chroma is upsampled using the rows above and below, so each band also
+ * decodes the rows of MCUs on either side of it, and skips them. That way the bands match a serial
+ * decode exactly.
+ */
+static constexpr int kMinParallelBandPixels = 1 << 20;
+
+static bool is_start_of_frame(uint8_t marker) {
+    // SOF0 through SOF15, except for DHT (0xC4), JPG (0xC8), and DAC (0xCC).
+    return marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC;
+}
+
+static bool is_restart(uint8_t marker) {
+    return marker >= 0xD0 && marker <= 0xD7;
+}
+
+// The bands don't need metadata we've already read. libjpeg does read JFIF (APP0) and Adobe's
+// color transform (APP14), so we keep those.
+static bool is_skippable_metadata(uint8_t marker) {
+    constexpr uint8_t kComment = 0xFE;
+    return (marker > kJpegMarkerAPP0 && marker <= kJpegMarkerAPP0 + 15 &&
+            marker != kJpegMarkerAPP0 + 14) ||
+           marker == kComment;
+}
+
+bool SkJpegCodec::decodeRestartIntervalsInParallel(const SkImageInfo& dstInfo, void* dst,
+                                                   size_t rowBytes, const Options& options) {
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    skjpeg_error_mgr::AutoPushJmpBuf jmp(fDecoderMgr->errorMgr());
+    if (setjmp(jmp)) {
+        return false;
+    }
+    if (dstInfo.dimensions() != this->dimensions() || dinfo->restart_interval == 0 ||
+        dinfo->progressive_mode || jpeg_has_multiple_scans(dinfo) ||
+        dinfo->comps_in_scan != dinfo->num_components) {
+        return false;
+    }
+
+    // We need all of the encoded data, and only look for it in memory.
+    SkStream* stream = this->stream();
+    const uint8_t* data = static_cast<const uint8_t*>(stream->getMemoryBase());
+    if (!data || !stream->hasLength()) {
+        return false;
+    }
+
+    // An MCU of an interleaved scan covers max_*_samp_factor blocks of each component, and one of
+    // a single component scan is a single block.
+    const bool interleaved = dinfo->comps_in_scan > 1;
+    const int width     = this->dimensions().width(),
+              height    = this->dimensions().height(),
+              mcuWidth  = DCTSIZE * (interleaved ? dinfo->max_h_samp_factor : 1),
+              mcuHeight = DCTSIZE * (interleaved ? dinfo->max_v_samp_factor : 1),
+              mcusPerRow = (width  + mcuWidth  - 1) / mcuWidth,
+              mcuRows    = (height + mcuHeight - 1) / mcuHeight,
+              interval   = dinfo->restart_interval;
+
+    // Rows of MCUs that are multiples of unitMCURows start a restart interval. Bands are made of
+    // whole units.
+    const int unitMCURows = interval / std::gcd(interval, mcusPerRow),
+              unitRows    = unitMCURows * mcuHeight,
+              units       = (mcuRows + unitMCURows - 1) / unitMCURows;
+    const int bands = (int)std::min<int64_t>(units,
+                                             (int64_t)width * height / kMinParallelBandPixels);
+    if (bands < 2) {
+        return false;
+    }
+    const int64_t intervalCount = ((int64_t)mcusPerRow * mcuRows + interval - 1) / interval;
+    auto intervalOfUnit = [&](int unit) {
+        return unit == units ? intervalCount : (int64_t)unit * unitMCURows * mcusPerRow / interval;
+    };
+
+    // Find the header segments, and where each restart interval's data starts and ends.
+    SkJpegSegmentScanner scanner;
+    scanner.onBytes(data, stream->getLength());
+    if (!scanner.isDone()) {
+        return false;
+    }
+    std::vector<SkJpegSegment> header;
+    std::vector<size_t> intervalStarts, intervalEnds;
+    for (const SkJpegSegment& segment : scanner.getSegments()) {
+        if (intervalStarts.empty()) {
+            if (!is_skippable_metadata(segment.marker)) {
+                header.push_back(segment);
+            }
+            if (segment.marker == kJpegMarkerStartOfScan) {
+                intervalStarts.push_back(segment.offset + kJpegMarkerCodeSize +
+                                         segment.parameterLength);
+            }
+        } else if (is_restart(segment.marker)) {
+            intervalEnds.push_back(segment.offset);
+            intervalStarts.push_back(segment.offset + kJpegMarkerCodeSize);
+        } else if (segment.marker == kJpegMarkerEndOfImage) {
+            intervalEnds.push_back(segment.offset);
+        } else {
+            return false;  // e.g. a DefineNumberOfLines marker
+        }
+    }
+    if ((int64_t)intervalEnds.size() != intervalCount) {
+        return false;
+    }
+    size_t headerSize = 0;
+    for (const SkJpegSegment& segment : header) {
+        headerSize += kJpegMarkerCodeSize + segment.parameterLength;
+    }
+
+    const int contextUnits = dinfo->max_v_samp_factor > 1 ? 1 : 0;
+    const skcms_ICCProfile* profile = this->getEncodedInfo().profile();
+
+    std::atomic<bool> failed{false};
+    SkTaskGroup taskGroup(*options.fExecutor);
+    for (int band = 0; band < bands; ++band) {
+        taskGroup.add([&, band] {
+            const int firstUnit  = (int64_t)units *  band      / bands,
+                      endUnit    = (int64_t)units * (band + 1) / bands,
+                      decodeFirst = std::max(0,     firstUnit - contextUnits),
+                      decodeEnd   = std::min(units, endUnit   + contextUnits);
+            const int64_t firstInterval = intervalOfUnit(decodeFirst),
+                          endInterval   = intervalOfUnit(decodeEnd);
+            const int decodeTop    = decodeFirst * unitRows,
+                      decodeBottom = std::min(height, decodeEnd * unitRows),
+                      top          = firstUnit * unitRows,
+                      bottom       = std::min(height, endUnit * unitRows);
+
+            size_t size = headerSize + kJpegMarkerCodeSize * (endInterval - firstInterval);
+            for (int64_t i = firstInterval; i < endInterval; ++i) {
+                size += intervalEnds[i] - intervalStarts[i];
+            }
+            sk_sp<SkData> bandData = SkData::MakeUninitialized(size);
+            uint8_t* ptr = static_cast<uint8_t*>(bandData->writable_data());
+            for (const SkJpegSegment& segment : header) {
+                const size_t segmentSize = kJpegMarkerCodeSize + segment.parameterLength;
+                memcpy(ptr, data + segment.offset, segmentSize);
+                if (is_start_of_frame(segment.marker)) {
+                    // The height follows the length and the sample precision.
+                    uint8_t* bandHeight = ptr + kJpegMarkerCodeSize +
+                                          kJpegSegmentParameterLengthSize + 1;
+                    bandHeight[0] = (decodeBottom - decodeTop) >> 8;
+                    bandHeight[1] = (decodeBottom - decodeTop) & 0xFF;
+                }
+                ptr += segmentSize;
+            }
+            for (int64_t i = firstInterval; i < endInterval; ++i) {
+                memcpy(ptr, data + intervalStarts[i], intervalEnds[i] - intervalStarts[i]);
+                ptr += intervalEnds[i] - intervalStarts[i];
+                *ptr++ = 0xFF;
+                *ptr++ = i + 1 < endInterval ? 0xD0 + (i - firstInterval) % 8
+                                             : kJpegMarkerEndOfImage;
+            }
+            SkASSERT(ptr == bandData->bytes() + size);
+
+            Result result;
+            std::unique_ptr<SkCodec> codec = SkJpegCodec::MakeFromStream(
+                    SkMemoryStream::Make(std::move(bandData)), &result,
+                    profile ? SkEncodedInfo::ICCProfile::Make(*profile) : nullptr);
+            Options bandOptions;
+            bandOptions.fZeroInitialized = options.fZeroInitialized;
+            if (!codec ||
+                codec->startScanlineDecode(dstInfo.makeWH(width, decodeBottom - decodeTop),
+                                           &bandOptions) != kSuccess ||
+                !codec->skipScanlines(top - decodeTop) ||
+                codec->getScanlines(SkTAddOffset<void>(dst, top * rowBytes), bottom - top,
+                                    rowBytes) != bottom - top) {
+                failed = true;
+            }
+        });
+    }
+    taskGroup.wait();
+    return !failed;
+}
+
 bool SkJpegCodec::allocateStorage(const SkImageInfo& dstInfo) {
     int dstWidth = dstInfo.width();
 
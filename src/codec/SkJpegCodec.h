@@ -126,6 +126,14 @@ private:
                 JpegDecoderMgr* decoderMgr,
                 SkEncodedOrigin origin);
 
+    /*
+     * If options.fExecutor is set and the image has restart markers that line up with rows of
+     * MCUs, decodes bands of rows in parallel on it. Returns false without touching fDecoderMgr
+     * if the image can't be decoded this way, or if any band fails to decode.
+     */
+    bool decodeRestartIntervalsInParallel(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                                          const Options& options);
+
     void initializeSwizzler(const SkImageInfo& dstInfo, const Options& options,
                             bool needsCMYKToRGB);
     bool SK_WARN_UNUSED_RESULT allocateStorage(const SkImageInfo& dstInfo);
@@ -20,7 +20,9 @@
 #include "include/private/SkEncodedInfo.h"
 #include "include/private/base/SkNoncopyable.h"
 #include "include/private/base/SkTemplates.h"
+#include "include/private/base/SkTo.h"
 #include "modules/skcms/skcms.h"
+#include "src/base/SkVx.h"
 #include "src/codec/SkCodecPriv.h"
 #include "src/codec/SkColorTable.h"
 #include "src/codec/SkPngPriv.h"
@@ -30,10 +32,12 @@
 #include <csetjmp>
 #include <algorithm>
 #include <cstring>
+#include <memory>
 #include <utility>
 
 #include <png.h>
 #include <pngconf.h>
+#include <zlib.h>
 
 using namespace skia_private;
 
@@ -148,6 +152,20 @@ static inline bool is_chunk(const png_byte* chunk, const char* tag) {
 
 static inline bool process_data(png_structp png_ptr, png_infop info_ptr,
         SkStream* stream, void* buffer, size_t bufferSize, size_t length) {
+    if (const void* base = stream->getMemoryBase(); base && stream->hasLength()) {
+        // The data is already in memory (often mapped from a file), so hand it to libpng in place
+        // rather than copying it through buffer. Like read(), move past it before processing it,
+        // since processing may longjmp.
+        const size_t position = stream->getPosition(),
+                     available = std::min(length, stream->getLength() - position);
+        SkAssertResult(stream->skip(available) == available);
+        // libpng only reads from the buffer, despite taking a non-const pointer.
+        png_process_data(png_ptr, info_ptr,
+                         const_cast<png_bytep>(static_cast<const png_byte*>(base) + position),
+                         available);
+        return available == length;
+    }
+
     while (length > 0) {
         const size_t bytesToProcess = std::min(bufferSize, length);
         const size_t bytesRead = stream->read(buffer, bytesToProcess);
@@ -503,6 +521,324 @@ static SkCodec::Result log_and_return_error(bool success) {
     return SkCodec::kErrorInInput;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Reading IDAT directly
+///////////////////////////////////////////////////////////////////////////////
+
+// Undoes the PNG filter on one row of bytesPerPixel-byte pixels, given the previous (already
+// unfiltered) row.  Sub, Avg and Paeth depend on the pixel to the left, so those work a pixel at
+// a time, with all of its channels in one vector.  Returns false for an unknown filter.
+template <int kBytesPerPixel>
+static bool unfilter_row(png_byte filter, png_bytep row, png_const_bytep prev, size_t rowBytes) {
+    constexpr int N = kBytesPerPixel == 3 ? 4 : kBytesPerPixel;
+    using U8  = skvx::Vec<N, uint8_t>;
+    using I16 = skvx::Vec<N, int16_t>;
+    auto load = [](const png_byte* p) {
+        U8 v = 0;
+        memcpy(&v, p, kBytesPerPixel);
+        return v;
+    };
+    auto store = [](png_byte* p, const U8& v) { memcpy(p, &v, kBytesPerPixel); };
+
+    switch (filter) {
+        case PNG_FILTER_VALUE_NONE:
+            return true;
+        case PNG_FILTER_VALUE_SUB: {
+            U8 left = 0;
+            for (size_t i = 0; i < rowBytes; i += kBytesPerPixel) {
+                left += load(row + i);
+                store(row + i, left);
+            }
+            return true;
+        }
+        case PNG_FILTER_VALUE_UP: {
+            size_t i = 0;
+            for (; i + 16 <= rowBytes; i += 16) {
+                (skvx::byte16::Load(row + i) + skvx::byte16::Load(prev + i)).store(row + i);
+            }
+            for (; i < rowBytes; i++) {
+                row[i] += prev[i];
+            }
+            return true;
+        }
+        case PNG_FILTER_VALUE_AVG: {
+            U8 left = 0;
+            for (size_t i = 0; i < rowBytes; i += kBytesPerPixel) {
+                const U8 up = load(prev + i);
+                // The average of left and up, rounded down, without overflowing a byte.
+                left = load(row + i) + ((left & up) + ((left ^ up) >> 1));
+                store(row + i, left);
+            }
+            return true;
+        }
+        case PNG_FILTER_VALUE_PAETH: {
+            I16 a = 0, c = 0;
+            for (size_t i = 0; i < rowBytes; i += kBytesPerPixel) {
+                const I16 b = skvx::cast<int16_t>(load(prev + i));
+                // These are |p - a|, |p - b| and |p - c| for the Paeth estimate p = a + b - c.
+                const I16 pa = skvx::max(b - c, c - b),
+                          pb = skvx::max(a - c, c - a),
+                          pc = skvx::max(a + b - c - c, c + c - a - b);
+                const I16 predictor = skvx::if_then_else((pa <= pb) & (pa <= pc), a,
+                                      skvx::if_then_else(pb <= pc, b, c));
+                const U8 x = load(row + i) + skvx::cast<uint8_t>(predictor);
+                store(row + i, x);
+                a = skvx::cast<int16_t>(x);
+                c = b;
+            }
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+// Inflates and unfilters the IDAT chunks of a non-interlaced PNG with 8 bits per channel that
+// needs none of libpng's transforms, handing each row off while it's still in cache.  This
+// replaces libpng's progressive reader, which would inflate, unfilter and copy each row before
+// calling us with it, with one pass that does the same checks (chunk CRCs, zlib errors, filter
+// types).  Chunks after the IDATs are skipped, so this is only used without an
+// SkPngChunkReader.
+class SkPngIdatReader : SkNoncopyable {
+public:
+    static std::unique_ptr<SkPngIdatReader> Make(png_structp png_ptr, png_infop info_ptr,
+                                                 size_t idatLength) {
+        png_uint_32 width, height;
+        int bitDepth, colorType, interlaceType;
+        png_get_IHDR(png_ptr, info_ptr, &width, &height, &bitDepth, &colorType, &interlaceType,
+                     nullptr, nullptr);
+        if (bitDepth != 8 || interlaceType != PNG_INTERLACE_NONE) {
+            return nullptr;
+        }
+        switch (colorType) {
+            case PNG_COLOR_TYPE_GRAY:
+            case PNG_COLOR_TYPE_RGB:
+                // These are expanded to add an alpha channel when there is a tRNS chunk.
+                if (png_get_valid(png_ptr, info_ptr, PNG_INFO_tRNS)) {
+                    return nullptr;
+                }
+                break;
+            case PNG_COLOR_TYPE_GRAY_ALPHA:
+            case PNG_COLOR_TYPE_RGBA:
+                break;
+            default:
+                return nullptr;
+        }
+
+        auto reader = std::unique_ptr<SkPngIdatReader>(new SkPngIdatReader(
+                png_get_channels(png_ptr, info_ptr), width, height, idatLength));
+        if (inflateInit(&reader->fZStream) != Z_OK) {
+            return nullptr;
+        }
+        reader->fInflating = true;
+        return reader;
+    }
+
+    ~SkPngIdatReader() {
+        if (fInflating) {
+            inflateEnd(&fZStream);
+        }
+    }
+
+    // How many bytes read() can use next, so that it never reads past the IEND chunk.
+    size_t bytesWanted() const {
+        switch (fState) {
+            case State::kChunkHeader: return kChunkHeaderSize - fBytesHeld;
+            case State::kChunkData:   return fChunkBytesLeft;
+            case State::kChunkCrc:    return kCrcSize - fBytesHeld;
+            case State::kDone:        return 0;
+        }
+        SkUNREACHABLE;
+    }
+
+    enum class Result {
+        kContinue,  // Ready for more data.
+        kStop,      // Done, either at IEND or because a row callback said so.
+        kError,
+    };
+
+    // Consumes up to bytesWanted() bytes of data, calling rowProc(row, rowNum) for each row it
+    // finishes.  rowProc returns false to stop reading.
+    template <typename RowProc>
+    Result read(const png_byte* data, size_t length, RowProc&& rowProc) {
+        SkASSERT(length <= this->bytesWanted());
+        switch (fState) {
+            case State::kChunkHeader:
+                memcpy(fHeld + fBytesHeld, data, length);
+                fBytesHeld += length;
+                if (fBytesHeld == kChunkHeaderSize) {
+                    this->startChunk(png_get_uint_32(fHeld), fHeld + 4);
+                }
+                return Result::kContinue;
+            case State::kChunkData:
+                fCrc = crc32(fCrc, data, SkToUInt(length));
+                fChunkBytesLeft -= length;
+                if (fChunkIsIdat && fInflating) {
+                    Result result = this->inflate(data, length, rowProc);
+                    if (result != Result::kContinue) {
+                        return result;
+                    }
+                }
+                if (!fChunkBytesLeft) {
+                    fState = State::kChunkCrc;
+                    fBytesHeld = 0;
+                }
+                return Result::kContinue;
+            case State::kChunkCrc:
+                memcpy(fHeld + fBytesHeld, data, length);
+                fBytesHeld += length;
+                if (fBytesHeld == kCrcSize) {
+                    // Like libpng, we only insist on correct CRCs for critical chunks.
+                    if (fChunkIsCritical && png_get_uint_32(fHeld) != fCrc) {
+                        return Result::kError;
+                    }
+                    if (fChunkIsIend) {
+                        fState = State::kDone;
+                        return Result::kStop;
+                    }
+                    fState = State::kChunkHeader;
+                    fBytesHeld = 0;
+                }
+                return Result::kContinue;
+            case State::kDone:
+                return Result::kStop;
+        }
+        SkUNREACHABLE;
+    }
+
+private:
+    static constexpr size_t kChunkHeaderSize = 8;
+    static constexpr size_t kCrcSize = 4;
+    static constexpr png_byte kIdat[] = {'I', 'D', 'A', 'T'};
+
+    enum class State {
+        kChunkHeader,
+        kChunkData,
+        kChunkCrc,
+        kDone,
+    };
+
+    SkPngIdatReader(int bytesPerPixel, png_uint_32 width, png_uint_32 height, size_t idatLength)
+            : fBytesPerPixel(bytesPerPixel)
+            , fRowBytes(static_cast<size_t>(width) * bytesPerPixel)
+            , fHeight(height)
+            , fRows(2 * (fRowBytes + 1)) {
+        // The previous row of the first row is all zeros.
+        sk_bzero(fRows.get(), 2 * (fRowBytes + 1));
+        fRow = fRows.get();
+        fPrevRow = fRow + fRowBytes + 1;
+
+        // SkPngCodec has already read the header of the first IDAT chunk.
+        this->startChunk(idatLength, kIdat);
+    }
+
+    void startChunk(size_t length, const png_byte type[4]) {
+        fChunkIsIdat = !memcmp(type, kIdat, 4);
+        fChunkIsIend = !memcmp(type, "IEND", 4);
+        // Ancillary chunks have a lowercase first letter.
+        fChunkIsCritical = !(type[0] & 0x20);
+        fCrc = crc32(crc32(0, nullptr, 0), type, 4);
+        fChunkBytesLeft = length;
+        fState = length ? State::kChunkData : State::kChunkCrc;
+        fBytesHeld = 0;
+
+        if (!fChunkIsIdat && fInflating && fRowNum < fHeight) {
+            // The image data ended early.  Later IDAT chunks are an error to libpng, so ignore
+            // them as well, and leave the caller with the rows it has.
+            this->finishInflating();
+        }
+    }
+
+    void finishInflating() {
+        inflateEnd(&fZStream);
+        fInflating = false;
+    }
+
+    template <typename RowProc>
+    Result inflate(const png_byte* data, size_t length, RowProc&& rowProc) {
+        fZStream.next_in = const_cast<png_bytep>(data);
+        fZStream.avail_in = SkToUInt(length);
+        const size_t rowSize = fRowBytes + 1;  // Including the filter type.
+        while (true) {
+            fZStream.next_out = fRow + fRowBytesFilled;
+            fZStream.avail_out = SkToUInt(rowSize - fRowBytesFilled);
+            const int ret = ::inflate(&fZStream, Z_NO_FLUSH);
+            fRowBytesFilled = rowSize - fZStream.avail_out;
+
+            const bool finishedRow = fRowBytesFilled == rowSize;
+            if (finishedRow) {
+                if (!this->unfilterRow()) {
+                    return Result::kError;
+                }
+                const png_uint_32 rowNum = fRowNum++;
+                std::swap(fRow, fPrevRow);
+                fRowBytesFilled = 0;
+                if (fRowNum == fHeight) {
+                    // libpng ignores anything after the last row, including a bad checksum.
+                    this->finishInflating();
+                }
+                if (!rowProc(fPrevRow + 1, rowNum)) {
+                    fState = State::kDone;
+                    return Result::kStop;
+                }
+                if (!fInflating) {
+                    break;
+                }
+            }
+
+            if (ret == Z_STREAM_END) {
+                // The image data ended before the last row.
+                this->finishInflating();
+                break;
+            }
+            if (ret != Z_OK && ret != Z_BUF_ERROR) {
+                return Result::kError;
+            }
+            if (ret == Z_BUF_ERROR || (!finishedRow && !fZStream.avail_in)) {
+                // We need more data.
+                break;
+            }
+        }
+        return Result::kContinue;
+    }
+
+    bool unfilterRow() {
+        const png_byte filter = fRow[0];
+        png_bytep row = fRow + 1;
+        png_const_bytep prev = fPrevRow + 1;
+        switch (fBytesPerPixel) {
+            case 1: return unfilter_row<1>(filter, row, prev, fRowBytes);
+            case 2: return unfilter_row<2>(filter, row, prev, fRowBytes);
+            case 3: return unfilter_row<3>(filter, row, prev, fRowBytes);
+            case 4: return unfilter_row<4>(filter, row, prev, fRowBytes);
+        }
+        SkUNREACHABLE;
+    }
+
+    const int                 fBytesPerPixel;
+    const size_t              fRowBytes;
+    const png_uint_32         fHeight;
+
+    // Each row starts with its filter type.  fPrevRow is the last row we finished.
+    AutoTMalloc<png_byte>     fRows;
+    png_bytep                 fRow;
+    png_bytep                 fPrevRow;
+    size_t                    fRowBytesFilled = 0;
+    png_uint_32               fRowNum = 0;
+
+    z_stream                  fZStream = {};
+    bool                      fInflating = false;
+
+    State                     fState;
+    png_byte                  fHeld[kChunkHeaderSize];  // A partially read chunk header or CRC.
+    size_t                    fBytesHeld;
+    size_t                    fChunkBytesLeft;
+    uLong                     fCrc;
+    bool                      fChunkIsIdat;
+    bool                      fChunkIsIend;
+    bool                      fChunkIsCritical;
+};
+
 class SkPngNormalDecoder : public SkPngCodec {
 public:
     SkPngNormalDecoder(SkEncodedInfo&& info, std::unique_ptr<SkStream> stream,
@@ -520,7 +856,10 @@ public:
     }
 
     static void RowCallback(png_structp png_ptr, png_bytep row, png_uint_32 rowNum, int /*pass*/) {
-        GetDecoder(png_ptr)->rowCallback(row, rowNum);
+        if (!GetDecoder(png_ptr)->rowCallback(row, rowNum)) {
+            // Fake error to stop decoding scanlines.
+            longjmp(PNG_JMPBUF(png_ptr), kStopDecoding);
+        }
     }
 
 private:
@@ -533,12 +872,61 @@ private:
     int                         fLastRow;
     int                         fRowsNeeded;
 
+    // Set during onDecodeRows(), which has each row written over the last.
+    const RowProc*              fRowProc = nullptr;
+
+    std::unique_ptr<SkPngIdatReader> fIdatReader;
+
     using INHERITED = SkPngCodec;
 
     static SkPngNormalDecoder* GetDecoder(png_structp png_ptr) {
         return static_cast<SkPngNormalDecoder*>(png_get_progressive_ptr(png_ptr));
     }
 
+    // Read the image data ourselves rather than through libpng, if we can.  See SkPngIdatReader.
+    void makeIdatReader() {
+        fIdatReader = fPngChunkReader ? nullptr
+                                      : SkPngIdatReader::Make(this->png_ptr(), this->info_ptr(),
+                                                              this->idatLength());
+    }
+
+    // Like processData(), but passing the image data through fIdatReader, which calls
+    // rowProc(row, rowNum) for each row.
+    template <typename RowProc>
+    bool readIdat(RowProc&& rowProc) {
+        SkStream* stream = this->stream();
+        const void* memoryBase = stream->hasLength() ? stream->getMemoryBase() : nullptr;
+
+        // Arbitrary buffer size, matching processData().
+        constexpr size_t kBufferSize = 4096;
+        png_byte buffer[kBufferSize];
+
+        while (const size_t bytesWanted = fIdatReader->bytesWanted()) {
+            const png_byte* data;
+            size_t length;
+            if (memoryBase) {
+                const size_t position = stream->getPosition();
+                data = static_cast<const png_byte*>(memoryBase) + position;
+                length = stream->skip(std::min(bytesWanted, stream->getLength() - position));
+            } else {
+                data = buffer;
+                length = stream->read(buffer, std::min(bytesWanted, kBufferSize));
+            }
+            if (!length) {
+                break;
+            }
+            switch (fIdatReader->read(data, length, rowProc)) {
+                case SkPngIdatReader::Result::kContinue:
+                    break;
+                case SkPngIdatReader::Result::kStop:
+                    return true;
+                case SkPngIdatReader::Result::kError:
+                    return false;
+            }
+        }
+        return true;
+    }
+
     Result decodeAllRows(void* dst, size_t rowBytes, int* rowsDecoded) override {
         const int height = this->dimensions().height();
         png_set_progressive_read_fn(this->png_ptr(), this, nullptr, AllRowsCallback, nullptr);
@@ -549,7 +937,13 @@ private:
         fFirstRow = 0;
         fLastRow = height - 1;
 
-        const bool success = this->processData();
+        this->makeIdatReader();
+        const bool success = fIdatReader
+                ? this->readIdat([this](png_bytep row, int rowNum) {
+                      this->allRowsCallback(row, rowNum);
+                      return true;
+                  })
+                : this->processData();
         if (success && fRowsWrittenToOutput == height) {
             return kSuccess;
         }
@@ -576,6 +970,7 @@ private:
         fRowBytes = rowBytes;
         fRowsWrittenToOutput = 0;
         fRowsNeeded = fLastRow - fFirstRow + 1;
+        this->makeIdatReader();
     }
 
     Result decode(int* rowsDecoded) override {
@@ -584,7 +979,11 @@ private:
             fRowsNeeded = get_scaled_dimension(fLastRow - fFirstRow + 1, sampleY);
         }
 
-        const bool success = this->processData();
+        const bool success = fIdatReader
+                ? this->readIdat([this](png_bytep row, int rowNum) {
+                      return this->rowCallback(row, rowNum);
+                  })
+                : this->processData();
         if (success && fRowsWrittenToOutput == fRowsNeeded) {
             return kSuccess;
         }
@@ -596,10 +995,11 @@ private:
         return log_and_return_error(success);
     }
 
-    void rowCallback(png_bytep row, int rowNum) {
+    // Returns false once we have all the rows we need.
+    bool rowCallback(png_bytep row, int rowNum) {
         if (rowNum < fFirstRow) {
             // Ignore this row.
-            return;
+            return true;
         }
 
         SkASSERT(rowNum <= fLastRow);
@@ -608,14 +1008,33 @@ private:
         // If there is no swizzler, all rows are needed.
         if (!this->swizzler() || this->swizzler()->rowNeeded(rowNum - fFirstRow)) {
             this->applyXformRow(fDst, row);
+            if (fRowProc) {
+                (*fRowProc)(fDst);
+            }
             fDst = SkTAddOffset<void>(fDst, fRowBytes);
             fRowsWrittenToOutput++;
         }
 
-        if (fRowsWrittenToOutput == fRowsNeeded) {
-            // Fake error to stop decoding scanlines.
-            longjmp(PNG_JMPBUF(this->png_ptr()), kStopDecoding);
+        return fRowsWrittenToOutput != fRowsNeeded;
+    }
+
+    Result onDecodeRows(const SkImageInfo& dstInfo, const Options& options,
+                        const RowProc& rowProc, int* rowsDecoded) override {
+        // Decode incrementally into a single row, handing it to rowProc each time it's filled.
+        const size_t rowBytes = dstInfo.minRowBytes();
+        AutoTMalloc<uint8_t> row(rowBytes);
+        Result result = this->startIncrementalDecode(dstInfo, row.get(), rowBytes, &options);
+        if (result != kSuccess) {
+            return result;
+        }
+        fRowBytes = 0;
+        fRowProc = &rowProc;
+        result = this->incrementalDecode(rowsDecoded);
+        fRowProc = nullptr;
+        if (result == kSuccess) {
+            *rowsDecoded = dstInfo.height();
         }
+        return result;
     }
 };
 
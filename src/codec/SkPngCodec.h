@@ -78,6 +78,9 @@ protected:
      */
     bool processData();
 
+    // The length of the first IDAT chunk, whose header has already been read from the stream.
+    size_t idatLength() const { return fIdatLength; }
+
     Result onStartIncrementalDecode(const SkImageInfo& dstInfo, void* pixels, size_t rowBytes,
             const SkCodec::Options&) override;
     Result onIncrementalDecode(int*) override;
@@ -10,13 +10,102 @@
 #include "include/codec/SkCodec.h"
 #include "include/codec/SkEncodedImageFormat.h"
 #include "include/core/SkImageInfo.h"
+#include "include/core/SkPixmap.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkTypes.h"
 #include "include/private/base/SkTemplates.h"
 #include "src/base/SkMathPriv.h"
+#include "src/base/SkVx.h"
 #include "src/codec/SkCodecPriv.h"
 #include "src/codec/SkSampler.h"
 
+#include <cstdint>
+#include <cstring>
+
+using namespace skia_private;
+
+namespace {
+
+// Whether boxFilterDecode() can decode to info.
+bool can_box_filter(const SkImageInfo& info) {
+    if (info.alphaType() == kUnpremul_SkAlphaType) {
+        // Averaging unpremultiplied colors would give transparent pixels too much weight.
+        return false;
+    }
+    switch (info.colorType()) {
+        case kRGBA_8888_SkColorType:
+        case kBGRA_8888_SkColorType:
+        case kGray_8_SkColorType:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Averages each sampleX x sampleY block of the rows it's given into one pixel of dst.  Like
+// sampling, this ignores any columns or rows past the last whole block.
+class BoxFilter {
+public:
+    BoxFilter(const SkPixmap& dst, int sampleX, int sampleY)
+            : fDst(dst)
+            , fSampleX(sampleX)
+            , fSampleY(sampleY)
+            , fChannels(dst.info().bytesPerPixel())
+            , fSums(dst.width() * fChannels) {
+        memset(fSums.get(), 0, dst.width() * fChannels * sizeof(uint32_t));
+    }
+
+    // Rows of dst that have been written.
+    int rowsWritten() const { return fDstY; }
+
+    void addRow(const void* row) {
+        if (fDstY == fDst.height()) {
+            return;
+        }
+        const uint8_t* src = static_cast<const uint8_t*>(row);
+        uint32_t* sums = fSums.get();
+        if (fChannels == 4) {
+            for (int x = 0; x < fDst.width(); x++) {
+                skvx::uint4 sum = skvx::uint4::Load(sums + 4 * x);
+                for (int i = 0; i < fSampleX; i++) {
+                    sum += skvx::cast<uint32_t>(skvx::byte4::Load(src));
+                    src += 4;
+                }
+                sum.store(sums + 4 * x);
+            }
+        } else {
+            SkASSERT(fChannels == 1);
+            for (int x = 0; x < fDst.width(); x++) {
+                for (int i = 0; i < fSampleX; i++) {
+                    sums[x] += *src++;
+                }
+            }
+        }
+
+        if (++fRowsInBlock == fSampleY) {
+            const uint32_t area = fSampleX * fSampleY;
+            uint8_t* dst = static_cast<uint8_t*>(fDst.writable_addr(0, fDstY));
+            for (int i = 0; i < fDst.width() * fChannels; i++) {
+                dst[i] = (sums[i] + area / 2) / area;
+                sums[i] = 0;
+            }
+            fRowsInBlock = 0;
+            fDstY++;
+        }
+    }
+
+private:
+    const SkPixmap        fDst;
+    const int             fSampleX;
+    const int             fSampleY;
+    const int             fChannels;
+    AutoTMalloc<uint32_t> fSums;
+    int                   fRowsInBlock = 0;
+    int                   fDstY = 0;
+};
+
+}  // namespace
+
 SkSampledCodec::SkSampledCodec(SkCodec* codec)
     : INHERITED(codec)
 {}
@@ -84,6 +173,9 @@ SkCodec::Result SkSampledCodec::onGetAndroidPixels(const SkImageInfo& info, void
         }
 
         // If the native codec does not support the requested scale, scale by sampling.
+        if (options.fBoxFilter && can_box_filter(info)) {
+            return this->boxFilterDecode(info, pixels, rowBytes, options);
+        }
         return this->sampledDecode(info, pixels, rowBytes, options);
     }
 
@@ -351,3 +443,58 @@ SkCodec::Result SkSampledCodec::sampledDecode(const SkImageInfo& info, void* pix
             return SkCodec::kUnimplemented;
     }
 }
+
+SkCodec::Result SkSampledCodec::boxFilterDecode(const SkImageInfo& info, void* pixels,
+        size_t rowBytes, const AndroidOptions& options) {
+    SkASSERT(options.fSampleSize > 1);
+
+    int sampleSize = options.fSampleSize;
+    const SkISize nativeSize = this->accountForNativeScaling(&sampleSize);
+    const SkImageInfo nativeInfo = info.makeDimensions(nativeSize);
+
+    // As in sampledDecode(), the output dimensions determine the sample size we really use.
+    const int sampleX = nativeSize.width() / info.width();
+    const int sampleY = nativeSize.height() / info.height();
+    if (sampleX < 1 || get_scaled_dimension(nativeSize.width(), sampleX) != info.width() ||
+        sampleY < 1 || get_scaled_dimension(nativeSize.height(), sampleY) != info.height()) {
+        return SkCodec::kInvalidScale;
+    }
+
+    SkCodec::Options codecOptions = options;
+    codecOptions.fSubset = nullptr;
+    BoxFilter box(SkPixmap(info, pixels, rowBytes), sampleX, sampleY);
+
+    int rowsDecoded = 0;
+    SkCodec::Result result = this->codec()->decodeRows(
+            nativeInfo, codecOptions, [&box](const void* row) { box.addRow(row); },
+            &rowsDecoded);
+    if (result == SkCodec::kUnimplemented) {
+        // The codec can't hand us rows as it goes (e.g. interlaced PNGs and bottom-up BMPs), so
+        // decode the whole image, then average it.
+        const size_t nativeRowBytes = nativeInfo.minRowBytes();
+        AutoTMalloc<uint8_t> storage(nativeInfo.computeMinByteSize());
+        result = this->codec()->getPixels(nativeInfo, storage.get(), nativeRowBytes,
+                                          &codecOptions);
+        switch (result) {
+            case SkCodec::kSuccess:
+            case SkCodec::kIncompleteInput:
+            case SkCodec::kErrorInInput:
+                // getPixels() has filled in any rows it could not decode.
+                for (int y = 0; y < nativeSize.height(); y++) {
+                    box.addRow(storage.get() + y * nativeRowBytes);
+                }
+                break;
+            default:
+                break;
+        }
+        return result;
+    }
+
+    if (result == SkCodec::kIncompleteInput || result == SkCodec::kErrorInInput) {
+        const int rowsWritten = box.rowsWritten();
+        SkSampler::Fill(info.makeWH(info.width(), info.height() - rowsWritten),
+                        SkTAddOffset<void>(pixels, rowsWritten * rowBytes), rowBytes,
+                        options.fZeroInitialized);
+    }
+    return result;
+}
@@ -60,6 +60,13 @@ private:
     SkCodec::Result sampledDecode(const SkImageInfo& info, void* pixels, size_t rowBytes,
             const AndroidOptions& options);
 
+    /**
+     *  Like sampledDecode(), but for options.fBoxFilter: each output pixel is the average of
+     *  the block of pixels it covers, which we accumulate row by row as fCodec decodes them.
+     */
+    SkCodec::Result boxFilterDecode(const SkImageInfo& info, void* pixels, size_t rowBytes,
+            const AndroidOptions& options);
+
     using INHERITED = SkAndroidCodec;
 };
 #endif // SkSampledCodec_DEFINED
@@ -13,6 +13,7 @@
 #include "include/core/SkBitmap.h"
 #include "include/core/SkColorType.h"
 #include "include/core/SkImageInfo.h"
+#include "include/core/SkPixmap.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkSize.h"
 #include "include/core/SkStream.h"
@@ -60,14 +61,17 @@ std::unique_ptr<SkCodec> SkWebpCodec::MakeFromStream(std::unique_ptr<SkStream> s
                                                      Result* result) {
     // Webp demux needs a contiguous data buffer.
     sk_sp<SkData> data = nullptr;
+    std::unique_ptr<SkStream> unreadStream;
     if (stream->getMemoryBase()) {
         // It is safe to make without copy because we'll hold onto the stream.
         data = SkData::MakeWithoutCopy(stream->getMemoryBase(), stream->getLength());
     } else {
         data = SkCopyStreamToData(stream.get());
 
-        // If we are forced to copy the stream to a data, we can go ahead and delete the stream.
-        stream.reset(nullptr);
+        // If we are forced to copy the stream to a data, SkCodec never needs to rewind the
+        // stream. But we hold onto the rest of it, in case more data arrives for an incremental
+        // decode.
+        unreadStream = std::move(stream);
     }
 
     // It's a little strange that the |demux| will outlive |webpData|, though it needs the
@@ -188,7 +192,9 @@ std::unique_ptr<SkCodec> SkWebpCodec::MakeFromStream(std::unique_ptr<SkStream> s
     *result = kSuccess;
     SkEncodedInfo info = SkEncodedInfo::Make(width, height, color, alpha, 8, std::move(profile));
     return std::unique_ptr<SkCodec>(new SkWebpCodec(std::move(info), std::move(stream),
-                                                    demux.release(), std::move(data), origin));
+                                                    demux.release(), WEBP_DEMUX_DONE == state,
+                                                    std::move(data), origin,
+                                                    std::move(unreadStream)));
 }
 
 static WEBP_CSP_MODE webp_decode_mode(SkColorType dstCT, bool premultiply) {
@@ -204,6 +210,25 @@ static WEBP_CSP_MODE webp_decode_mode(SkColorType dstCT, bool premultiply) {
     }
 }
 
+struct SkWebpCodec::IncrementalDecode {
+    ~IncrementalDecode() {
+        // The decoder points into fConfig, so it has to go first.
+        fDecoder.reset();
+        WebPFreeDecBuffer(&fConfig.output);
+    }
+
+    WebPDecoderConfig                           fConfig;
+    SkAutoTCallVProc<WebPIDecoder, WebPIDelete> fDecoder;
+
+    // Holds the decoded rows when we can't decode directly into fDst.
+    SkBitmap                                    fBuffer;
+    void*                                       fDst = nullptr;
+    size_t                                      fRowBytes = 0;
+
+    // How many rows we've finished with, i.e. color transformed.
+    int                                         fRowsDone = 0;
+};
+
 SkWebpCodec::Frame* SkWebpCodec::FrameHolder::appendNewFrame(bool hasAlpha) {
     const int i = this->size();
     fFrames.emplace_back(i, hasAlpha ? SkEncodedInfo::kUnpremul_Alpha
@@ -563,14 +588,185 @@ SkCodec::Result SkWebpCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst,
     return result;
 }
 
+SkCodec::Result SkWebpCodec::onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst,
+                                                      size_t rowBytes, const Options& options) {
+    // The frames of an animation may need blending with earlier frames, and libwebp only
+    // reports them once they are complete, so we only decode still images incrementally.
+    if (WebPDemuxGetI(fDemux, WEBP_FF_FORMAT_FLAGS) & ANIMATION_FLAG) {
+        return kUnimplemented;
+    }
+    if (options.fSubset) {
+        return kUnimplemented;
+    }
+    SkASSERT(0 == options.fFrameIndex);
+
+    auto incremental = std::make_unique<IncrementalDecode>();
+    WebPDecoderConfig& config = incremental->fConfig;
+    if (0 == WebPInitDecoderConfig(&config)) {
+        // ABI mismatch.
+        return kInvalidInput;
+    }
+
+    WebPIterator frame;
+    SkAutoTCallVProc<WebPIterator, WebPDemuxReleaseIterator> autoFrame(&frame);
+    // If this succeeded in MakeFromStream(), it should succeed again here.
+    SkAssertResult(WebPDemuxGetFrame(fDemux, 1, &frame));
+
+    if (this->dimensions() != dstInfo.dimensions()) {
+        config.options.use_scaling = 1;
+        config.options.scaled_width = dstInfo.width();
+        config.options.scaled_height = dstInfo.height();
+    }
+
+    // As in onGetPixels(), except that a still image never blends with a prior frame.
+    auto webpInfo = dstInfo;
+    if (!frame.has_alpha) {
+        webpInfo = webpInfo.makeAlphaType(kOpaque_SkAlphaType);
+    } else if (this->colorXform()) {
+        webpInfo = webpInfo.makeAlphaType(kUnpremul_SkAlphaType);
+    }
+    if (this->colorXform()) {
+        webpInfo = webpInfo.makeColorType(kBGRA_8888_SkColorType);
+    }
+
+    SkPixmap webpDst;
+    if (this->colorXform() && !is_8888(dstInfo.colorType())) {
+        incremental->fBuffer.allocPixels(webpInfo);
+        webpDst = incremental->fBuffer.pixmap();
+    } else {
+        webpDst.reset(webpInfo, dst, rowBytes);
+    }
+
+    config.output.colorspace = webp_decode_mode(webpInfo.colorType(),
+            webpInfo.alphaType() == kPremul_SkAlphaType);
+    config.output.is_external_memory = 1;
+
+    config.output.u.RGBA.rgba = reinterpret_cast<uint8_t*>(webpDst.writable_addr());
+    config.output.u.RGBA.stride = static_cast<int>(webpDst.rowBytes());
+    config.output.u.RGBA.size = webpDst.computeByteSize();
+
+    // We pass libwebp the whole file rather than just the frame, since the frame may be
+    // incomplete, and libwebp knows how to skip the container's other chunks.
+    incremental->fDecoder.reset(WebPIDecode(nullptr, 0, &config));
+    if (!incremental->fDecoder) {
+        return kInvalidInput;
+    }
+
+    incremental->fDst = dst;
+    incremental->fRowBytes = rowBytes;
+    fIncrementalDecode = std::move(incremental);
+    return kSuccess;
+}
+
+SkCodec::Result SkWebpCodec::onIncrementalDecode(int* rowsDecodedPtr) {
+    SkASSERT(fIncrementalDecode);
+    IncrementalDecode* incremental = fIncrementalDecode.get();
+
+    this->readAvailableData();
+    // Unlike WebPIAppend(), WebPIUpdate() reads the data in place, so we only keep one copy of it.
+    // fData may have moved since the last call, but that's allowed, as it still starts with the
+    // bytes libwebp has already seen.
+    const VP8StatusCode status = WebPIUpdate(incremental->fDecoder, fData->bytes(), fData->size());
+
+    int rowsDecoded = 0;
+    if (!WebPIDecGetRGB(incremental->fDecoder, &rowsDecoded, nullptr, nullptr, nullptr)) {
+        rowsDecoded = 0;
+    }
+
+    // Like SkPngCodec, transform each row as it is decoded, so the rows reported are final.
+    if (this->colorXform()) {
+        const WebPRGBABuffer& webpDst = incremental->fConfig.output.u.RGBA;
+        const int width = this->dstInfo().width();
+        for (int y = incremental->fRowsDone; y < rowsDecoded; y++) {
+            this->applyColorXform(SkTAddOffset<void>(incremental->fDst,
+                                                     incremental->fRowBytes * y),
+                                  webpDst.rgba + SkToSizeT(webpDst.stride) * y, width);
+        }
+    }
+    incremental->fRowsDone = std::max(incremental->fRowsDone, rowsDecoded);
+
+    switch (status) {
+        case VP8_STATUS_OK:
+            return kSuccess;
+        case VP8_STATUS_SUSPENDED:
+            if (rowsDecodedPtr) {
+                *rowsDecodedPtr = incremental->fRowsDone;
+            }
+            return kIncompleteInput;
+        default:
+            if (rowsDecodedPtr) {
+                *rowsDecodedPtr = incremental->fRowsDone;
+            }
+            return kErrorInInput;
+    }
+}
+
+void SkWebpCodec::readAvailableData() {
+    if (!fUnreadStream || fDemuxDone) {
+        return;
+    }
+
+    // Read straight into the spare capacity at the end of fBuffer. Growing it geometrically means
+    // streaming in a file costs amortized linear time, rather than a copy of all the data so far
+    // on every call.
+    const size_t oldSize = fData->size();
+    size_t size = oldSize;
+    sk_sp<SkData> oldBuffer;  // fDemux may point into this until it has been rebuilt.
+    while (true) {
+        if (!fBuffer || size == fBuffer->size()) {
+            constexpr size_t kMinGrowth = 4096;
+            sk_sp<SkData> grown = SkData::MakeUninitialized(std::max(2 * size, size + kMinGrowth));
+            memcpy(grown->writable_data(), fBuffer ? fBuffer->data() : fData->data(), size);
+            if (!oldBuffer) {
+                oldBuffer = std::move(fBuffer);
+            }
+            fBuffer = std::move(grown);
+        }
+        const size_t bytesRead = fUnreadStream->read(
+                SkTAddOffset<void>(fBuffer->writable_data(), size), fBuffer->size() - size);
+        if (0 == bytesRead) {
+            break;
+        }
+        size += bytesRead;
+    }
+    if (size == oldSize) {
+        if (oldBuffer) {
+            fBuffer = std::move(oldBuffer);
+        }
+        return;
+    }
+
+    // fDemux points into fData, so it has to be rebuilt over the new data.
+    sk_sp<SkData> data = SkData::MakeWithoutCopy(fBuffer->data(), size);
+    WebPData webpData = { data->bytes(), data->size() };
+    WebPDemuxState state;
+    SkAutoTCallVProc<WebPDemuxer, WebPDemuxDelete> demux(WebPDemuxPartial(&webpData, &state));
+    if (!demux || WEBP_DEMUX_PARSE_ERROR == state) {
+        // No amount of further data will fix this, so keep decoding what we had.
+        if (oldBuffer) {
+            fBuffer = std::move(oldBuffer);
+        }
+        fUnreadStream.reset();
+        return;
+    }
+    fDemux.reset(demux.release());
+    fDemuxDone = WEBP_DEMUX_DONE == state;
+    fData = std::move(data);
+}
+
 SkWebpCodec::SkWebpCodec(SkEncodedInfo&& info, std::unique_ptr<SkStream> stream,
-                         WebPDemuxer* demux, sk_sp<SkData> data, SkEncodedOrigin origin)
+                         WebPDemuxer* demux, bool demuxDone, sk_sp<SkData> data,
+                         SkEncodedOrigin origin, std::unique_ptr<SkStream> unreadStream)
     : INHERITED(std::move(info), skcms_PixelFormat_BGRA_8888, std::move(stream),
                 origin)
     , fDemux(demux)
+    , fDemuxDone(demuxDone)
     , fData(std::move(data))
+    , fUnreadStream(std::move(unreadStream))
     , fFailed(false)
 {
     const auto& eInfo = this->getEncodedInfo();
     fFrameHolder.setScreenSize(eInfo.width(), eInfo.height());
 }
+
+SkWebpCodec::~SkWebpCodec() = default;
@@ -37,8 +37,14 @@ public:
     // Assumes IsWebp was called and returned true.
     static std::unique_ptr<SkCodec> MakeFromStream(std::unique_ptr<SkStream>, Result*);
     static bool IsWebp(const void*, size_t);
+
+    ~SkWebpCodec() override;
+
 protected:
     Result onGetPixels(const SkImageInfo&, void*, size_t, const Options&, int*) override;
+    Result onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                                    const Options&) override;
+    Result onIncrementalDecode(int* rowsDecoded) override;
     SkEncodedImageFormat onGetEncodedFormat() const override { return SkEncodedImageFormat::kWEBP; }
 
     bool onGetValidSubset(SkIRect* /* desiredSubset */) const override;
@@ -52,15 +58,33 @@ protected:
     }
 
 private:
-    SkWebpCodec(SkEncodedInfo&&, std::unique_ptr<SkStream>, WebPDemuxer*, sk_sp<SkData>,
-                SkEncodedOrigin);
+    SkWebpCodec(SkEncodedInfo&&, std::unique_ptr<SkStream>, WebPDemuxer*, bool demuxDone,
+                sk_sp<SkData>, SkEncodedOrigin, std::unique_ptr<SkStream> unreadStream);
+
+    // Appends anything that has since arrived in fUnreadStream to fData.
+    void readAvailableData();
 
     SkAutoTCallVProc<WebPDemuxer, WebPDemuxDelete> fDemux;
 
+    // Whether fDemux has parsed the whole file, in which case there is nothing left to read.
+    bool fDemuxDone;
+
     // fDemux has a pointer into this data.
     // This should not be freed until the decode is completed.
     sk_sp<SkData> fData;
 
+    // If we had to copy the stream into fData, this is the rest of the stream, which may
+    // receive more data during an incremental decode.
+    std::unique_ptr<SkStream> fUnreadStream;
+
+    // Once more data has arrived, fData is a prefix of this buffer, and the spare capacity after
+    // it is where the next read goes.
+    sk_sp<SkData> fBuffer;
+
+    // libwebp's incremental decoder, and the state it points into.
+    struct IncrementalDecode;
+    std::unique_ptr<IncrementalDecode> fIncrementalDecode;
+
     class Frame : public SkFrame {
     public:
         Frame(int i, SkEncodedInfo::Alpha alpha)
@@ -44,6 +44,7 @@ public:
                                         drawCoverage,
                                         draw.fRC->clipShader(),
                                         SkSurfacePropsCopyOrDefault(draw.fProps));
+        fBlitter = draw.clipToBlitBounds(fBlitter, &fAlloc);
         return fBlitter;
     }
 
@@ -8,8 +8,12 @@
 #include "src/core/SkBigPicture.h"
 
 #include "include/core/SkBBHFactory.h"
+#include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkPixmap.h"
 #include "include/private/base/SkAssert.h"
+#include "src/core/SkCanvasPriv.h"
+#include "src/core/SkDevice.h"
 #include "src/core/SkRecord.h"
 #include "src/core/SkRecordDraw.h"
 #include "src/core/SkRecords.h"
@@ -43,6 +47,45 @@ void SkBigPicture::playback(SkCanvas* canvas, AbortCallback* callback) const {
                  callback);
 }
 
+bool SkBigPicture::playbackParallel(SkCanvas* canvas, SkExecutor& executor) const {
+    SkASSERT(canvas);
+
+    // We draw straight into the pixels of the canvas' current layer, so it needs to be raster,
+    // and we need to be able to express its matrix and clip to the canvases drawing each band.
+    SkBaseDevice* device = SkCanvasPriv::TopDevice(canvas);
+    SkPixmap pm;
+    if (!canvas->isClipRect() ||
+        device->localToDevice().hasPerspective() ||
+        !device->localToDevice().invert(nullptr) ||
+        !device->peekPixels(&pm)) {
+        return false;
+    }
+    // Like any draw, give a surface the chance to copy its pixels if a snapshot shares them.
+    // (That may change the pixels we draw into.)
+    if (!SkCanvasPriv::PredrawNotify(canvas) || !device->peekPixels(&pm)) {
+        return false;
+    }
+    SkBitmap dst;
+    if (!dst.installPixels(pm)) {
+        return false;
+    }
+
+    // Bound each op to what's visible through the clip, rather than to our cull rect: playback()
+    // draws anything reaching outside the cull rect (e.g. drawPaint()) in full, and so must we.
+    const int count = fRecord->count();
+    skia_private::AutoTMalloc<SkRect>                   bounds(count);
+    skia_private::AutoTMalloc<SkBBoxHierarchy::Metadata> meta(count);
+    SkRecordFillBounds(canvas->getLocalClipBounds(), *fRecord, bounds, meta);
+
+    // Full width bands, so only draws that are tall are rasterized more than once.
+    constexpr int kBandHeight = 128;
+    SkRecordDrawTiled(*fRecord, 0, count, {}, bounds,
+                      this->drawablePicts(), this->drawableCount(),
+                      dst, device->surfaceProps(), device->localToDevice44(),
+                      device->devClipBounds(), {dst.width(), kBandHeight}, executor);
+    return true;
+}
+
 struct NestedApproxOpCounter {
     int fCount = 0;
 
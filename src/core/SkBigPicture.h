@@ -20,6 +20,7 @@
 #include <memory>
 
 class SkCanvas;
+class SkExecutor;
 
 // An implementation of SkPicture supporting an arbitrary number of drawing commands.
 // This is called "big" because there used to be a "mini" that only supported a subset of the
@@ -53,6 +54,9 @@ public:
     size_t approximateBytesUsed() const override;
     const SkBigPicture* asSkBigPicture() const override { return this; }
 
+    // Implements SkPicture::playbackParallel(), returning false if canvas doesn't support it.
+    bool playbackParallel(SkCanvas*, SkExecutor&) const;
+
 // Used by GrRecordReplaceDraw
     const SkBBoxHierarchy* bbh() const { return fBBH.get(); }
     const SkRecord*     record() const { return fRecord.get(); }
@@ -43,7 +43,13 @@ void SkNotifyBitmapGenIDIsStale(uint32_t bitmapGenID) {
 SkBitmapCacheDesc SkBitmapCacheDesc::Make(uint32_t imageID, const SkIRect& subset) {
     SkASSERT(imageID);
     SkASSERT(subset.width() > 0 && subset.height() > 0);
-    return { imageID, subset };
+    return { imageID, subset, 0 };
+}
+
+SkBitmapCacheDesc SkBitmapCacheDesc::MakeScaled(uint32_t imageID, const SkISize& scaledSize) {
+    SkASSERT(imageID);
+    SkASSERT(!scaledSize.isEmpty());
+    return { imageID, SkIRect::MakeSize(scaledSize), 1 };
 }
 
 SkBitmapCacheDesc SkBitmapCacheDesc::Make(const SkImage* image) {
@@ -301,9 +307,14 @@ const SkMipmap* SkMipmapCache::AddAndRef(const SkImage_Base* image, SkResourceCa
         return nullptr;
     }
 
+    return AddAndRef(image, SkBitmapCacheDesc::Make(image), src.pixmap(), localCache);
+}
+
+const SkMipmap* SkMipmapCache::AddAndRef(const SkImage_Base* image, const SkBitmapCacheDesc& desc,
+                                         const SkPixmap& src, SkResourceCache* localCache) {
     SkMipmap* mipmap = SkMipmap::Build(src, get_fact(localCache));
     if (mipmap) {
-        MipMapRec* rec = new MipMapRec(SkBitmapCacheDesc::Make(image), mipmap);
+        MipMapRec* rec = new MipMapRec(desc, mipmap);
         CHECK_LOCAL(localCache, add, Add, rec);
         image->notifyAddedToRasterCache();
     }
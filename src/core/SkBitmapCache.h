@@ -29,6 +29,8 @@ void SkNotifyBitmapGenIDIsStale(uint32_t bitmapGenID);
 struct SkBitmapCacheDesc {
     uint32_t    fImageID;       // != 0
     SkIRect     fSubset;        // always set to a valid rect (entire or subset)
+    uint32_t    fScaled;        // != 0 if the pixels are the entire image, decoded at the size
+                                // of fSubset (which is then at the origin)
 
     void validate() const {
         SkASSERT(fImageID);
@@ -38,6 +40,7 @@ struct SkBitmapCacheDesc {
 
     static SkBitmapCacheDesc Make(const SkImage*);
     static SkBitmapCacheDesc Make(uint32_t genID, const SkIRect& subset);
+    static SkBitmapCacheDesc MakeScaled(uint32_t genID, const SkISize& scaledSize);
 };
 
 class SkBitmapCache {
@@ -65,6 +68,10 @@ public:
                                       SkResourceCache* localCache = nullptr);
     static const SkMipmap* AddAndRef(const SkImage_Base*,
                                      SkResourceCache* localCache = nullptr);
+    // Builds the mipmap from src, which holds the pixels described by desc (e.g. a scaled
+    // decode of image), rather than from the image's own pixels.
+    static const SkMipmap* AddAndRef(const SkImage_Base*, const SkBitmapCacheDesc&,
+                                     const SkPixmap& src, SkResourceCache* localCache = nullptr);
 };
 
 #endif
@@ -24,10 +24,12 @@
 #include "include/core/SkRegion.h"
 #include "include/core/SkScalar.h"
 #include "include/core/SkShader.h"
+#include "include/core/SkSize.h"
 #include "include/core/SkSurface.h"
 #include "include/core/SkSurfaceProps.h"
 #include "include/core/SkTileMode.h"
 #include "include/private/base/SkAssert.h"
+#include "include/private/base/SkFloatingPoint.h"
 #include "include/private/base/SkTo.h"
 #include "src/base/SkTLazy.h"
 #include "src/core/SkDraw.h"
@@ -75,6 +77,7 @@ class SkDrawTiler {
     // fCurr... are only used if fNeedTiling
     SkTLazy<SkPostTranslateMatrixProvider> fTileMatrixProvider;
     SkRasterClip                           fTileRC;
+    SkIRect                                fTileBlitBounds;
     SkIPoint                               fOrigin;
 
     bool            fDone, fNeedsTiling;
@@ -133,6 +136,7 @@ public:
             fDraw.fDst = fRootPixmap;
             fDraw.fMatrixProvider = dev;
             fDraw.fRC = &dev->fRCStack.rc();
+            fDraw.fBlitBounds = dev->fBlitBounds ? &*dev->fBlitBounds : nullptr;
             fOrigin.set(0, 0);
         }
 
@@ -189,6 +193,14 @@ private:
         fDevice->fRCStack.rc().translate(-fOrigin.x(), -fOrigin.y(), &fTileRC);
         fTileRC.op(SkIRect::MakeWH(fDraw.fDst.width(), fDraw.fDst.height()),
                    SkClipOp::kIntersect);
+
+        if (fDevice->fBlitBounds) {
+            fTileBlitBounds = fDevice->fBlitBounds->makeOffset(-fOrigin.x(), -fOrigin.y());
+            if (!fTileBlitBounds.intersect(SkIRect::MakeSize(fDraw.fDst.dimensions()))) {
+                fTileRC.setEmpty();  // Nothing we may write in this tile, so skip it.
+            }
+            fDraw.fBlitBounds = &fTileBlitBounds;
+        }
     }
 };
 
@@ -213,6 +225,7 @@ public:
         }
         fMatrixProvider = dev;
         fRC = &dev->fRCStack.rc();
+        fBlitBounds = dev->fBlitBounds ? &*dev->fBlitBounds : nullptr;
     }
 };
 
@@ -425,9 +438,29 @@ void SkBitmapDevice::drawImageRect(const SkImage* image, const SkRect* src, cons
     SkASSERT(dst.isSorted());
 
     SkBitmap bitmap;
+    SkRect scaledSrc;
+    if (sampling.mipmap != SkMipmapMode::kNone) {
+        // A lazy image drawn smaller than its full size may be able to decode at a smaller size
+        // that still covers the draw (e.g. with JPEG's DCT scaling), much more cheaply than at
+        // full size. If so, we draw from that instead, mapping src onto it.
+        const SkRect srcRect = src ? *src : SkRect::Make(image->bounds());
+        SkSize scale;
+        if (SkMatrix::Concat(this->localToDevice(), SkMatrix::RectToRect(srcRect, dst))
+                    .decomposeScale(&scale, nullptr) &&
+            scale.width() < 1 && scale.height() < 1) {
+            const SkISize minSize = {sk_float_ceil2int(image->width()  * scale.width()),
+                                     sk_float_ceil2int(image->height() * scale.height())};
+            if (as_IB(image)->getScaledROPixels(minSize, &bitmap) && src) {
+                scaledSrc = SkMatrix::Scale(SkIntToScalar(bitmap.width())  / image->width(),
+                                            SkIntToScalar(bitmap.height()) / image->height())
+                                    .mapRect(*src);
+                src = &scaledSrc;
+            }
+        }
+    }
     // TODO: Elevate direct context requirement to public API and remove cheat.
     auto dContext = as_IB(image)->directContext();
-    if (!as_IB(image)->getROPixels(dContext, &bitmap)) {
+    if (!bitmap.getPixels() && !as_IB(image)->getROPixels(dContext, &bitmap)) {
         return;
     }
 
@@ -601,6 +634,7 @@ void SkBitmapDevice::drawSpecial(SkSpecialImage* src,
         }
         draw.fMatrixProvider = &matrixProvider;
         draw.fRC = &fRCStack.rc();
+        draw.fBlitBounds = fBlitBounds ? &*fBlitBounds : nullptr;
         draw.drawBitmap(resultBM, SkMatrix::I(), nullptr, sampling, paint);
     }
 }
@@ -20,6 +20,7 @@
 #include "src/core/SkRasterClipStack.h"
 
 #include <cstddef>
+#include <optional>
 
 class SkBlender;
 class SkImage;
@@ -72,6 +73,13 @@ public:
     static SkBitmapDevice* Create(const SkImageInfo&, const SkSurfaceProps&,
                                   SkRasterHandleAllocator* = nullptr);
 
+    /**
+     *  Only write pixels inside bounds. Unlike a clip, this does not change how anything is
+     *  rasterized (or how big layers are), so whatever pixels are written come out exactly as
+     *  they would without it. Layers made by this device are not restricted.
+     */
+    void setBlitBounds(const SkIRect& bounds) { fBlitBounds = bounds; }
+
 protected:
     void* getRasterHandle() const override { return fRasterHandle; }
 
@@ -170,6 +178,7 @@ private:
     void*       fRasterHandle = nullptr;
     SkRasterClipStack  fRCStack;
     SkGlyphRunListPainterCPU fGlyphPainter;
+    std::optional<SkIRect> fBlitBounds;
 
 
     using INHERITED = SkBaseDevice;
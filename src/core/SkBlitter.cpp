@@ -443,6 +443,42 @@ void SkRectClipBlitter::blitRect(int left, int y, int width, int height) {
     }
 }
 
+void SkRectClipBlitter::blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) {
+    if (!y_in_rect(y, fClipRect)) {
+        return;
+    }
+    const bool in0 = x_in_rect(x,     fClipRect),
+               in1 = x_in_rect(x + 1, fClipRect);
+    if (in0 && in1) {
+        fBlitter->blitAntiH2(x, y, a0, a1);
+    } else if (in0) {
+        fBlitter->blitAntiPixel(x, y, a0);
+    } else if (in1) {
+        fBlitter->blitAntiPixel(x + 1, y, a1);
+    }
+}
+
+void SkRectClipBlitter::blitAntiV2(int x, int y, U8CPU a0, U8CPU a1) {
+    if (!x_in_rect(x, fClipRect)) {
+        return;
+    }
+    const bool in0 = y_in_rect(y,     fClipRect),
+               in1 = y_in_rect(y + 1, fClipRect);
+    if (in0 && in1) {
+        fBlitter->blitAntiV2(x, y, a0, a1);
+    } else if (in0) {
+        fBlitter->blitAntiPixel(x, y, a0);
+    } else if (in1) {
+        fBlitter->blitAntiPixel(x, y + 1, a1);
+    }
+}
+
+void SkRectClipBlitter::blitAntiPixel(int x, int y, U8CPU a) {
+    if (x_in_rect(x, fClipRect) && y_in_rect(y, fClipRect)) {
+        fBlitter->blitAntiPixel(x, y, a);
+    }
+}
+
 void SkRectClipBlitter::blitAntiRect(int left, int y, int width, int height,
                                      SkAlpha leftAlpha, SkAlpha rightAlpha) {
     SkIRect    r;
@@ -855,4 +891,9 @@ void SkRectClipCheckBlitter::blitAntiV2(int x, int y, U8CPU a0, U8CPU a1) {
     fBlitter->blitAntiV2(x, y, a0, a1);
 }
 
+void SkRectClipCheckBlitter::blitAntiPixel(int x, int y, U8CPU a) {
+    SkASSERT(fClipRect.contains(x, y));
+    fBlitter->blitAntiPixel(x, y, a);
+}
+
 #endif
@@ -105,6 +105,18 @@ public:
         this->blitAntiH(x, y + 1, aa, runs);
     }
 
+    // (x, y) alone, blended exactly as one pixel of blitAntiH2() or blitAntiV2() would be.
+    // Clipping blitters use this when only half of one of those pairs is inside the clip.
+    virtual void blitAntiPixel(int x, int y, U8CPU a) {
+        int16_t runs[2];
+        uint8_t aa[1];
+
+        runs[0] = 1;
+        runs[1] = 0;
+        aa[0] = SkToU8(a);
+        this->blitAntiH(x, y, aa, runs);
+    }
+
     /**
      *  Special method just to identify the null blitter, which is returned
      *  from Choose() if the request cannot be fulfilled. Default impl
@@ -193,6 +205,9 @@ public:
     void blitAntiRect(int x, int y, int width, int height,
                       SkAlpha leftAlpha, SkAlpha rightAlpha) override;
     void blitMask(const SkMask&, const SkIRect& clip) override;
+    void blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) override;
+    void blitAntiV2(int x, int y, U8CPU a0, U8CPU a1) override;
+    void blitAntiPixel(int x, int y, U8CPU a) override;
 
     int requestRowsPreserved() const override {
         return fBlitter->requestRowsPreserved();
@@ -259,6 +274,7 @@ public:
     void blitMask(const SkMask&, const SkIRect& clip) override;
     void blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) override;
     void blitAntiV2(int x, int y, U8CPU a0, U8CPU a1) override;
+    void blitAntiPixel(int x, int y, U8CPU a) override;
 
     int requestRowsPreserved() const override {
         return fBlitter->requestRowsPreserved();
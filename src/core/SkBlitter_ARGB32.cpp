@@ -757,6 +757,11 @@ void SkARGB32_Blitter::blitAntiV2(int x, int y, U8CPU a0, U8CPU a1) {
     device[0] = SkBlendARGB32(fPMColor, device[0], a1);
 }
 
+void SkARGB32_Blitter::blitAntiPixel(int x, int y, U8CPU a) {
+    uint32_t* device = fDevice.writable_addr32(x, y);
+    device[0] = SkBlendARGB32(fPMColor, device[0], a);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////
 
 #define solid_8_pixels(mask, dst, color)    \
@@ -858,6 +863,11 @@ void SkARGB32_Opaque_Blitter::blitAntiV2(int x, int y, U8CPU a0, U8CPU a1) {
     device[0] = SkFastFourByteInterp(fPMColor, device[0], a1);
 }
 
+void SkARGB32_Opaque_Blitter::blitAntiPixel(int x, int y, U8CPU a) {
+    uint32_t* device = fDevice.writable_addr32(x, y);
+    device[0] = SkFastFourByteInterp(fPMColor, device[0], a);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void SkARGB32_Blitter::blitV(int x, int y, int height, SkAlpha alpha) {
@@ -955,6 +965,11 @@ void SkARGB32_Black_Blitter::blitAntiV2(int x, int y, U8CPU a0, U8CPU a1) {
     device[0] = (a1 << SK_A32_SHIFT) + SkAlphaMulQ(device[0], 256 - a1);
 }
 
+void SkARGB32_Black_Blitter::blitAntiPixel(int x, int y, U8CPU a) {
+    uint32_t* device = fDevice.writable_addr32(x, y);
+    device[0] = (a << SK_A32_SHIFT) + SkAlphaMulQ(device[0], 256 - a);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 SkARGB32_Shader_Blitter::SkARGB32_Shader_Blitter(const SkPixmap& device,
@@ -113,7 +113,7 @@ void SkMask_FreeImage(uint8_t* image) {
 }
 
 bool SkBlurMask::BoxBlur(SkMask* dst, const SkMask& src, SkScalar sigma, SkBlurStyle style,
-                         SkIPoint* margin) {
+                         SkIPoint* margin, SkExecutor* executor) {
     if (src.fFormat != SkMask::kBW_Format &&
         src.fFormat != SkMask::kA8_Format &&
         src.fFormat != SkMask::kARGB32_Format &&
@@ -141,7 +141,7 @@ bool SkBlurMask::BoxBlur(SkMask* dst, const SkMask& src, SkScalar sigma, SkBlurS
         }
         return false;
     }
-    const SkIPoint border = blurFilter.blur(src, dst);
+    const SkIPoint border = blurFilter.blur(src, dst, executor);
     // If src.fImage is null, then this call is only to calculate the border.
     if (src.fImage != nullptr && dst->fImage == nullptr) {
         return false;
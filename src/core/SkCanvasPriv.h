@@ -71,6 +71,11 @@ public:
         return canvas->topDevice();
     }
 
+    // For code that draws directly into the top device's pixels.
+    static bool PredrawNotify(SkCanvas* canvas) {
+        return canvas->predrawNotify();
+    }
+
 #if GR_TEST_UTILS && defined(SK_GANESH)
     static skgpu::ganesh::SurfaceDrawContext* TopDeviceSurfaceDrawContext(SkCanvas*);
     static skgpu::ganesh::SurfaceFillContext* TopDeviceSurfaceFillContext(SkCanvas*);
@@ -62,6 +62,7 @@ public:
     void blitMask(const SkMask&, const SkIRect&) override;
     void blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) override;
     void blitAntiV2(int x, int y, U8CPU a0, U8CPU a1) override;
+    void blitAntiPixel(int x, int y, U8CPU a) override;
 
 protected:
     SkColor                fColor;
@@ -83,6 +84,7 @@ public:
     void blitMask(const SkMask&, const SkIRect&) override;
     void blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) override;
     void blitAntiV2(int x, int y, U8CPU a0, U8CPU a1) override;
+    void blitAntiPixel(int x, int y, U8CPU a) override;
 
 private:
     using INHERITED = SkARGB32_Blitter;
@@ -95,6 +97,7 @@ public:
     void blitAntiH(int x, int y, const SkAlpha antialias[], const int16_t runs[]) override;
     void blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) override;
     void blitAntiV2(int x, int y, U8CPU a0, U8CPU a1) override;
+    void blitAntiPixel(int x, int y, U8CPU a) override;
 
 private:
     using INHERITED = SkARGB32_Opaque_Blitter;
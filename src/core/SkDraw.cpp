@@ -343,6 +343,7 @@ void SkDraw::drawBitmap(const SkBitmap& bitmap, const SkMatrix& prematrix,
             SkBlitter* blitter = SkBlitter::ChooseSprite(fDst, *paint, pmap, ix, iy, &allocator,
                                                          fRC->clipShader());
             if (blitter) {
+                blitter = this->clipToBlitBounds(blitter, &allocator);
                 SkScan::FillIRect(SkIRect::MakeXYWH(ix, iy, pmap.width(), pmap.height()),
                                   *fRC, blitter);
                 return;
@@ -405,6 +406,7 @@ void SkDraw::drawSprite(const SkBitmap& bitmap, int x, int y, const SkPaint& ori
         SkBlitter* blitter = SkBlitter::ChooseSprite(fDst, paint, pmap, x, y, &allocator,
                                                      fRC->clipShader());
         if (blitter) {
+            blitter = this->clipToBlitBounds(blitter, &allocator);
             SkScan::FillIRect(bounds, *fRC, blitter);
             return;
         }
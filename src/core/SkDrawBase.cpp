@@ -21,10 +21,12 @@
 #include "include/private/base/SkCPUTypes.h"
 #include "include/private/base/SkDebug.h"
 #include "include/private/base/SkTemplates.h"
+#include "src/base/SkArenaAlloc.h"
 #include "src/base/SkTLazy.h"
 #include "src/base/SkZip.h"
 #include "src/core/SkAutoBlitterChoose.h"
 #include "src/core/SkBlendModePriv.h"
+#include "src/core/SkBlitter.h"
 #include "src/core/SkBlitter_A8.h"
 #include "src/core/SkDevice.h"
 #include "src/core/SkDrawBase.h"
@@ -52,6 +54,15 @@ using namespace skia_private;
 
 SkDrawBase::SkDrawBase() {}
 
+SkBlitter* SkDrawBase::clipToBlitBounds(SkBlitter* blitter, SkArenaAlloc* alloc) const {
+    if (!blitter || !fBlitBounds) {
+        return blitter;
+    }
+    SkRectClipBlitter* clipped = alloc->make<SkRectClipBlitter>();
+    clipped->init(blitter, *fBlitBounds);
+    return clipped;
+}
+
 bool SkDrawBase::computeConservativeLocalClipBounds(SkRect* localBounds) const {
     if (fRC->isEmpty()) {
         return false;
@@ -118,6 +118,11 @@ public:
                                        sk_sp<SkShader> clipShader,
                                        const SkSurfaceProps&);
 
+    /**
+     *  If fBlitBounds is set, returns a blitter (allocated in alloc) that passes along only the
+     *  parts of each blit inside them. Otherwise returns blitter as-is.
+     */
+    SkBlitter* clipToBlitBounds(SkBlitter* blitter, SkArenaAlloc* alloc) const;
 
 private:
     // not supported
@@ -156,6 +161,10 @@ public:
     const SkRasterClip*     fRC{nullptr};              // required
     const SkSurfaceProps*   fProps{nullptr};           // optional
 
+    // Limits the pixels written to fDst without changing how anything is rasterized: unlike
+    // fRC, geometry is never clipped to these bounds, only the blits that result from it.
+    const SkIRect*          fBlitBounds{nullptr};      // optional
+
 #ifdef SK_DEBUG
     void validate() const;
 #else
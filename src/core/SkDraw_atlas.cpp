@@ -182,6 +182,7 @@ void SkDraw::drawAtlas(const SkRSXform xform[],
         if (!blitter) {
             return false;
         }
+        blitter = this->clipToBlitBounds(blitter, &alloc);
         SkPath scratchPath;
 
         for (int i = 0; i < count; ++i) {
@@ -215,11 +216,12 @@ void SkDraw::drawAtlas(const SkRSXform xform[],
         }
         p.setShader(std::move(shader));
         // We use identity here and fold the CTM into the update matrix.
-        if (auto blitter = SkVMBlitter::Make(fDst,
-                                             p,
-                                             SkMatrix::I(),
-                                             &alloc,
-                                             fRC->clipShader())) {
+        if (SkBlitter* blitter = SkVMBlitter::Make(fDst,
+                                                   p,
+                                                   SkMatrix::I(),
+                                                   &alloc,
+                                                   fRC->clipShader())) {
+            blitter = this->clipToBlitBounds(blitter, &alloc);
             SkPath scratchPath;
             for (int i = 0; i < count; ++i) {
                 if (colorShader) {
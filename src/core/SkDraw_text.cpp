@@ -60,6 +60,7 @@ void SkDraw::paintMasks(SkZip<const SkGlyph*, SkPoint> accepted, const SkPaint&
                                            false,
                                            fRC->clipShader(),
                                            SkSurfacePropsCopyOrDefault(fProps));
+    blitter = this->clipToBlitBounds(blitter, &alloc);
 
     SkAAClipBlitterWrapper wrapper{*fRC, blitter};
     blitter = wrapper.getBlitter();
@@ -464,6 +464,7 @@ void SkDraw::drawFixedVertices(const SkVertices* vertices,
         if (!blitter) {
             return false;
         }
+        blitter = this->clipToBlitBounds(blitter, outerAlloc);
         while (vertProc(&state)) {
             if (triColorShader && !triColorShader->update(ctmInverse, positions, dstColors,
                                                           state.f0, state.f1, state.f2)) {
@@ -483,14 +484,15 @@ void SkDraw::drawFixedVertices(const SkVertices* vertices,
         VertState state(vertexCount, indices, indexCount);
         VertState::Proc vertProc = state.chooseProc(info.mode());
 
-        auto blitter = SkVMBlitter::Make(fDst,
-                                         finalPaint,
-                                         matrixProvider->localToDevice(),
-                                         outerAlloc,
-                                         this->fRC->clipShader());
+        SkBlitter* blitter = SkVMBlitter::Make(fDst,
+                                               finalPaint,
+                                               matrixProvider->localToDevice(),
+                                               outerAlloc,
+                                               this->fRC->clipShader());
         if (!blitter) {
             return;
         }
+        blitter = this->clipToBlitBounds(blitter, outerAlloc);
         while (vertProc(&state)) {
             SkMatrix localM;
             if (transformShader && !(texture_to_matrix(state, positions, texCoords, &localM) &&
@@ -11,8 +11,11 @@
 #include "include/private/base/SkTArray.h"
 #include "src/base/SkNoDestructor.h"
 #include "src/base/SkSpinlock.h"
+#include <atomic>
+#include <cstdint>
 #include <deque>
 #include <thread>
+#include <vector>
 
 using namespace skia_private;
 
@@ -142,6 +145,235 @@ private:
     bool                  fAllowBorrowing;
 };
 
+// A Chase-Lev work-stealing deque, following
+//     'Correct and Efficient Work-Stealing for Weak Memory Models' (Le, Pop, Cohen, Zappa Nardelli)
+// The owning thread push()es and pop()s at the bottom, LIFO.  Any thread may steal() from the top.
+// Neither side ever takes a lock; only push() ever allocates, when the ring buffer must grow.
+template <typename T>
+class SkWorkStealingDeque {
+public:
+    SkWorkStealingDeque() : fTop(0), fBottom(0) {
+        fRings.push_back(std::make_unique<Ring>(kInitialCapacity));
+        fRing.store(fRings.back().get(), std::memory_order_relaxed);
+    }
+
+    // Owner only.
+    void push(T item) {
+        int64_t b = fBottom.load(std::memory_order_relaxed),
+                t = fTop   .load(std::memory_order_acquire);
+        Ring* ring = fRing.load(std::memory_order_relaxed);
+        if (b - t > ring->fMask) {
+            ring = this->grow(ring, t, b);
+        }
+        ring->put(b, item);
+        fBottom.store(b + 1, std::memory_order_release);
+    }
+
+    // Owner only.  Returns nullptr if the deque is empty.
+    T pop() {
+        int64_t b = fBottom.load(std::memory_order_relaxed) - 1;
+        Ring* ring = fRing.load(std::memory_order_relaxed);
+        // This store and the load of fTop must not be reordered; see the matching pair in steal().
+        fBottom.store(b, std::memory_order_seq_cst);
+        int64_t t = fTop.load(std::memory_order_seq_cst);
+
+        if (t > b) {
+            // Empty.
+            fBottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        T item = ring->get(b);
+        if (t == b) {
+            // This is the last item, so we race any thieves for it.
+            if (!fTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                         std::memory_order_relaxed)) {
+                item = nullptr;
+            }
+            fBottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    // Any thread.  Returns nullptr if the deque is empty or we lost a race with another thread.
+    T steal() {
+        int64_t t = fTop   .load(std::memory_order_seq_cst),
+                b = fBottom.load(std::memory_order_seq_cst);
+
+        if (t >= b) {
+            return nullptr;
+        }
+        T item = fRing.load(std::memory_order_acquire)->get(t);
+        if (!fTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                     std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return item;
+    }
+
+private:
+    static constexpr int64_t kInitialCapacity = 64;
+
+    struct Ring {
+        explicit Ring(int64_t capacity)
+            : fMask(capacity - 1)
+            , fItems(new std::atomic<T>[capacity]) {}
+
+        T    get(int64_t i) const { return fItems[i & fMask].load(std::memory_order_relaxed); }
+        void put(int64_t i, T item) {  fItems[i & fMask].store(item, std::memory_order_relaxed); }
+
+        const int64_t                   fMask;
+        std::unique_ptr<std::atomic<T>[]> fItems;
+    };
+
+    Ring* grow(Ring* ring, int64_t t, int64_t b) {
+        auto bigger = std::make_unique<Ring>(2 * (ring->fMask + 1));
+        for (int64_t i = t; i < b; i++) {
+            bigger->put(i, ring->get(i));
+        }
+        // Thieves may still be reading from the old ring, so keep it alive until we're destroyed.
+        fRings.push_back(std::move(bigger));
+        fRing.store(fRings.back().get(), std::memory_order_release);
+        return fRings.back().get();
+    }
+
+    alignas(64) std::atomic<int64_t> fTop;
+    alignas(64) std::atomic<int64_t> fBottom;
+    std::atomic<Ring*>                fRing;
+    std::vector<std::unique_ptr<Ring>> fRings;
+};
+
+// Set on each SkWorkStealingPool thread, so add() and borrow() can find that thread's own deque.
+struct SkWorkStealingPoolThread {
+    const SkExecutor* pool  = nullptr;
+    int               index = -1;
+};
+static thread_local SkWorkStealingPoolThread gCurrentPoolThread;
+
+// An SkWorkStealingPool gives each of its threads its own deque.  Work added from one of those
+// threads goes onto that thread's deque; work added from any other thread goes onto a shared,
+// locked FIFO.  Threads looking for work try their own deque first (LIFO, so nested
+// SkTaskGroup::wait() calls tend to pick up the work they just added), then the shared FIFO,
+// then steal from the other threads' deques (FIFO, taking the oldest, biggest work first).
+//
+// Like SkThreadPool, fWorkAvailable counts queued work, and anyone who decrements it is
+// guaranteed that some work is available to them somewhere.
+class SkWorkStealingPool final : public SkExecutor {
+public:
+    explicit SkWorkStealingPool(int threads, bool allowBorrowing)
+            : fAllowBorrowing(allowBorrowing) {
+        // All the deques must exist before any thread goes looking through them for work.
+        for (int i = 0; i < threads; i++) {
+            fDeques.push_back(std::make_unique<SkWorkStealingDeque<Work*>>());
+        }
+        for (int i = 0; i < threads; i++) {
+            fThreads.emplace_back(&Loop, this, i);
+        }
+    }
+
+    ~SkWorkStealingPool() override {
+        // Signal each thread that it's time to shut down.
+        for (int i = 0; i < fThreads.size(); i++) {
+            this->add(nullptr);
+        }
+        // Wait for each thread to shut down.
+        for (int i = 0; i < fThreads.size(); i++) {
+            fThreads[i].join();
+        }
+        // Clean up any work that was never run.
+        for (auto& deque : fDeques) {
+            while (Work* work = deque->pop()) {
+                delete work;
+            }
+        }
+        for (Work* work : fSharedWork) {
+            delete work;
+        }
+    }
+
+    void add(std::function<void(void)> fn) override {
+        auto work = new Work(std::move(fn));
+        if (int index = this->currentThreadIndex(); index >= 0) {
+            fDeques[index]->push(work);
+        } else {
+            SkAutoMutexExclusive lock(fSharedWorkLock);
+            fSharedWork.push_back(work);
+        }
+        fWorkAvailable.signal(1);
+    }
+
+    void borrow() override {
+        // If there is work waiting and we're allowed to borrow work, do it.
+        if (fAllowBorrowing && fWorkAvailable.try_wait()) {
+            SkAssertResult(this->do_work(this->currentThreadIndex()));
+        }
+    }
+
+private:
+    using Work = std::function<void(void)>;
+
+    int currentThreadIndex() const {
+        return gCurrentPoolThread.pool == this ? gCurrentPoolThread.index : -1;
+    }
+
+    Work* find_work(int index) {
+        if (index >= 0) {
+            if (Work* work = fDeques[index]->pop()) {
+                return work;
+            }
+        }
+        {
+            SkAutoMutexExclusive lock(fSharedWorkLock);
+            if (!fSharedWork.empty()) {
+                Work* work = fSharedWork.front();
+                fSharedWork.pop_front();
+                return work;
+            }
+        }
+        const int n = fDeques.size();
+        for (int i = 1; i <= n; i++) {
+            int victim = (index + i) % n;
+            if (victim != index) {
+                if (Work* work = fDeques[victim]->steal()) {
+                    return work;
+                }
+            }
+        }
+        return nullptr;
+    }
+
+    // This method should be called only when fWorkAvailable indicates there's work to do.
+    bool do_work(int index) {
+        Work* work;
+        while (!(work = this->find_work(index))) {
+            // The work we're owed is somewhere, but we raced another thread to it.  Look again.
+            std::this_thread::yield();
+        }
+        std::unique_ptr<Work> owned(work);
+
+        if (!*owned) {
+            return false;  // This is Loop()'s signal to shut down.
+        }
+
+        (*owned)();
+        return true;
+    }
+
+    static void Loop(SkWorkStealingPool* pool, int index) {
+        gCurrentPoolThread = {pool, index};
+        do {
+            pool->fWorkAvailable.wait();
+        } while (pool->do_work(index));
+        gCurrentPoolThread = {};
+    }
+
+    TArray<std::unique_ptr<SkWorkStealingDeque<Work*>>> fDeques;
+    TArray<std::thread>                                 fThreads;
+    std::deque<Work*>                                   fSharedWork;
+    SkMutex                                             fSharedWorkLock;
+    SkSemaphore                                         fWorkAvailable;
+    bool                                                fAllowBorrowing;
+};
+
 std::unique_ptr<SkExecutor> SkExecutor::MakeFIFOThreadPool(int threads, bool allowBorrowing) {
     using WorkList = std::deque<std::function<void(void)>>;
     return std::make_unique<SkThreadPool<WorkList>>(threads > 0 ? threads : num_cores(),
@@ -152,3 +384,7 @@ std::unique_ptr<SkExecutor> SkExecutor::MakeLIFOThreadPool(int threads, bool all
     return std::make_unique<SkThreadPool<WorkList>>(threads > 0 ? threads : num_cores(),
                                                     allowBorrowing);
 }
+std::unique_ptr<SkExecutor> SkExecutor::MakeWorkStealingPool(int threads, bool allowBorrowing) {
+    return std::make_unique<SkWorkStealingPool>(threads > 0 ? threads : num_cores(),
+                                                allowBorrowing);
+}
@@ -27,6 +27,7 @@
 #include "src/core/SkScalerContext.h"
 #include "src/core/SkStrikeCache.h"
 #include "src/core/SkTypefaceCache.h"
+#include "src/core/SkVM.h"
 
 #include <stdlib.h>
 
@@ -102,3 +103,9 @@ extern bool gSkVMAllowJIT;
 void SkGraphics::AllowJIT() {
     gSkVMAllowJIT = true;
 }
+
+void SkGraphics::SetJITCacheDirectory(const char* dir) {
+#if defined(SK_ENABLE_SKVM)
+    skvm::SetJITCacheDirectory(dir);
+#endif
+}
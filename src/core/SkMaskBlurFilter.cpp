@@ -8,6 +8,7 @@
 #include "src/core/SkMaskBlurFilter.h"
 
 #include "include/core/SkColorPriv.h"
+#include "include/core/SkExecutor.h"
 #include "include/private/base/SkMalloc.h"
 #include "include/private/base/SkTPin.h"
 #include "include/private/base/SkTemplates.h"
@@ -15,9 +16,13 @@
 #include "src/base/SkArenaAlloc.h"
 #include "src/base/SkVx.h"
 #include "src/core/SkGaussFilter.h"
+#include "src/core/SkTaskGroup.h"
 
 #include <cmath>
 #include <climits>
+#include <cstddef>
+#include <functional>
+#include <utility>
 
 namespace {
 static const double kPi = 3.14159265358979323846264338327950288;
@@ -227,6 +232,72 @@ public:
             buffer2, buffer2End);
     }
 
+    // Blur N scans at once, one per lane, producing exactly what N Scan::blur() calls would.
+    // Lane i reads its scan starting at src + i*srcLaneStride, and writes it starting at dst + i,
+    // so the N scans land in N neighboring bytes of each destination row. The buffer must hold
+    // bufferSize() values.
+    template <int N>
+    void blurLanes(const uint8_t* src, ptrdiff_t srcStride, ptrdiff_t srcLaneStride, int srcCount,
+                   uint8_t* dst, ptrdiff_t dstStride, int dstCount,
+                   skvx::Vec<N, uint32_t>* buffer) const {
+        using V = skvx::Vec<N, uint32_t>;
+        V* const buffer0 = buffer;
+        V* const buffer1 = buffer0 + fPass0Size;
+        V* const buffer2 = buffer1 + fPass1Size;
+        int cursor0 = 0, cursor1 = 0, cursor2 = 0;
+        V sum0, sum1, sum2;
+
+        auto reset = [&] {
+            std::fill(buffer, buffer + this->bufferSize(), V(0));
+            sum0 = sum1 = sum2 = V(0);
+        };
+        // The same steps as Scan::blur(), just on N scans side by side.
+        auto step = [&](const V& leadingEdge, uint8_t* out) {
+            sum0 += leadingEdge;
+            sum1 += sum0;
+            sum2 += sum1;
+
+            const uint64_t kHalf = static_cast<uint64_t>(1) << 31;
+            skvx::cast<uint8_t>((skvx::cast<uint64_t>(sum2) * fWeight + kHalf) >> 32).store(out);
+
+            sum2 -= buffer2[cursor2];
+            buffer2[cursor2] = sum1;
+            cursor2 = cursor2 + 1 < fPass2Size ? cursor2 + 1 : 0;
+
+            sum1 -= buffer1[cursor1];
+            buffer1[cursor1] = sum0;
+            cursor1 = cursor1 + 1 < fPass1Size ? cursor1 + 1 : 0;
+
+            sum0 -= buffer0[cursor0];
+            buffer0[cursor0] = leadingEdge;
+            cursor0 = cursor0 + 1 < fPass0Size ? cursor0 + 1 : 0;
+        };
+        auto load = [&](const uint8_t* from) {
+            V v;
+            for (int i = 0; i < N; ++i) {
+                v[i] = from[i * srcLaneStride];
+            }
+            return v;
+        };
+
+        // Consume the source generating pixels, and keep going until the leading edge is off the
+        // end of the scan.
+        const int noChangeCount = fSlidingWindow > srcCount ? fSlidingWindow - srcCount : 0;
+        reset();
+        for (int i = 0; i < srcCount; ++i) {
+            step(load(src + i * srcStride), dst + i * dstStride);
+        }
+        for (int i = srcCount; i < srcCount + noChangeCount; ++i) {
+            step(V(0), dst + i * dstStride);
+        }
+
+        // Starting from the end, fill in the rest.
+        reset();
+        for (int i = dstCount - 1, j = srcCount - 1; i >= srcCount + noChangeCount; --i, --j) {
+            step(load(src + j * srcStride), dst + i * dstStride);
+        }
+    }
+
     uint64_t fWeight;
     int      fBorder;
     int      fSlidingWindow;
@@ -952,7 +1023,7 @@ static SkIPoint small_blur(double sigmaX, double sigmaY, const SkMask& src, SkMa
 
 // TODO: assuming sigmaW = sigmaH. Allow different sigmas. Right now the
 // API forces the sigmas to be the same.
-SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMask* dst) const {
+SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMask* dst, SkExecutor* executor) const {
 
     if (fSigmaW < 2.0 && fSigmaH < 2.0) {
         return small_blur(fSigmaW, fSigmaH, src, dst);
@@ -983,9 +1054,6 @@ SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMask* dst) const {
         dstH = dst->fBounds.height();
     SkASSERT(srcW >= 0 && srcH >= 0 && dstW >= 0 && dstH >= 0);
 
-    auto bufferSize = std::max(planW.bufferSize(), planH.bufferSize());
-    auto buffer = alloc.makeArrayDefault<uint32_t>(bufferSize);
-
     // Blur both directions.
     int tmpW = srcH,
         tmpH = dstW;
@@ -996,59 +1064,115 @@ SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMask* dst) const {
     }
     auto tmp = alloc.makeArrayDefault<uint8_t>(tmpW * tmpH);
 
-    // Blur horizontally, and transpose.
-    const PlanGauss::Scan& scanW = planW.makeBlurScan(srcW, buffer);
-    switch (src.fFormat) {
-        case SkMask::kBW_Format: {
-            const uint8_t* bwStart = src.fImage;
-            auto start = SkMask::AlphaIter<SkMask::kBW_Format>(bwStart, 0);
-            auto end = SkMask::AlphaIter<SkMask::kBW_Format>(bwStart + (srcW / 8), srcW % 8);
-            for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
-            }
-        } break;
-        case SkMask::kA8_Format: {
-            const uint8_t* a8Start = src.fImage;
-            auto start = SkMask::AlphaIter<SkMask::kA8_Format>(a8Start);
-            auto end = SkMask::AlphaIter<SkMask::kA8_Format>(a8Start + srcW);
-            for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
-            }
-        } break;
-        case SkMask::kARGB32_Format: {
-            const uint32_t* argbStart = reinterpret_cast<const uint32_t*>(src.fImage);
-            auto start = SkMask::AlphaIter<SkMask::kARGB32_Format>(argbStart);
-            auto end = SkMask::AlphaIter<SkMask::kARGB32_Format>(argbStart + srcW);
-            for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
-            }
-        } break;
-        case SkMask::kLCD16_Format: {
-            const uint16_t* lcdStart = reinterpret_cast<const uint16_t*>(src.fImage);
-            auto start = SkMask::AlphaIter<SkMask::kLCD16_Format>(lcdStart);
-            auto end = SkMask::AlphaIter<SkMask::kLCD16_Format>(lcdStart + srcW);
-            for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
-            }
-        } break;
-        default:
-            SK_ABORT("Unhandled format.");
+    // Each pass blurs kLanes scans at a time, with one scan per lane, and any scans left over one
+    // at a time. With an executor, a large mask is split into bands of scans, each a multiple of
+    // kLanes, and each band is blurred in parallel with its own buffers.
+    //
+    // Four lanes keeps the sums in one 128-bit register and the 64-bit products for the final
+    // scale in one 256-bit register; eight lanes measured slower on both SSE2 and AVX2.
+    static constexpr int kLanes = 4;
+    static constexpr int kMinBandPixels = 64 * 1024;
+    using Lanes = skvx::Vec<kLanes, uint32_t>;
+
+    int bands = 1;
+    if (executor) {
+        bands = SkToInt(std::min<int64_t>((int64_t)dstW * dstH / kMinBandPixels,
+                                          std::min(srcH, dstW) / kLanes));
+        bands = std::max(bands, 1);
     }
+    auto bandScans = [&](int scans, int band) {
+        int groups = (scans + kLanes - 1) / kLanes;
+        return std::make_pair(std::min(scans, kLanes * (groups *  band      / bands)),
+                              std::min(scans, kLanes * (groups * (band + 1) / bands)));
+    };
+    auto forEachBand = [&](const std::function<void(int)>& blurBand) {
+        if (bands > 1) {
+            SkTaskGroup tg(*executor);
+            tg.batch(bands, blurBand);
+            tg.wait();
+        } else {
+            blurBand(0);
+        }
+    };
+
+    auto bufferSize = std::max(planW.bufferSize(), planH.bufferSize());
+    auto buffers = alloc.makeArrayDefault<uint32_t>(bufferSize * bands);
+    auto laneBuffers = alloc.makeArrayDefault<Lanes>(bufferSize * bands);
+
+    // Blur horizontally, and transpose.
+    forEachBand([&](int band) {
+        const auto [top, bottom] = bandScans(srcH, band);
+        const PlanGauss::Scan& scanW = planW.makeBlurScan(srcW, &buffers[bufferSize * band]);
+        const size_t rowBytes = src.fRowBytes;
+        int y = top;
+        switch (src.fFormat) {
+            case SkMask::kBW_Format: {
+                const uint8_t* bwStart = src.fImage + y * rowBytes;
+                auto start = SkMask::AlphaIter<SkMask::kBW_Format>(bwStart, 0);
+                auto end = SkMask::AlphaIter<SkMask::kBW_Format>(bwStart + (srcW / 8), srcW % 8);
+                for (; y < bottom; ++y, start >>= rowBytes, end >>= rowBytes) {
+                    auto tmpStart = &tmp[y];
+                    scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
+                }
+            } break;
+            case SkMask::kA8_Format: {
+                // Rows next to each other land in neighboring bytes of tmp.
+                for (; !fUseScalarScans && y + kLanes <= bottom; y += kLanes) {
+                    planW.blurLanes(src.fImage + y * rowBytes, 1, rowBytes, srcW,
+                                    &tmp[y], tmpW, tmpH, &laneBuffers[bufferSize * band]);
+                }
+                const uint8_t* a8Start = src.fImage + y * rowBytes;
+                auto start = SkMask::AlphaIter<SkMask::kA8_Format>(a8Start);
+                auto end = SkMask::AlphaIter<SkMask::kA8_Format>(a8Start + srcW);
+                for (; y < bottom; ++y, start >>= rowBytes, end >>= rowBytes) {
+                    auto tmpStart = &tmp[y];
+                    scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
+                }
+            } break;
+            case SkMask::kARGB32_Format: {
+                const uint32_t* argbStart =
+                        reinterpret_cast<const uint32_t*>(src.fImage + y * rowBytes);
+                auto start = SkMask::AlphaIter<SkMask::kARGB32_Format>(argbStart);
+                auto end = SkMask::AlphaIter<SkMask::kARGB32_Format>(argbStart + srcW);
+                for (; y < bottom; ++y, start >>= rowBytes, end >>= rowBytes) {
+                    auto tmpStart = &tmp[y];
+                    scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
+                }
+            } break;
+            case SkMask::kLCD16_Format: {
+                const uint16_t* lcdStart =
+                        reinterpret_cast<const uint16_t*>(src.fImage + y * rowBytes);
+                auto start = SkMask::AlphaIter<SkMask::kLCD16_Format>(lcdStart);
+                auto end = SkMask::AlphaIter<SkMask::kLCD16_Format>(lcdStart + srcW);
+                for (; y < bottom; ++y, start >>= rowBytes, end >>= rowBytes) {
+                    auto tmpStart = &tmp[y];
+                    scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
+                }
+            } break;
+            default:
+                SK_ABORT("Unhandled format.");
+        }
+    });
 
     // Blur vertically (scan in memory order because of the transposition),
     // and transpose back to the original orientation.
-    const PlanGauss::Scan& scanH = planH.makeBlurScan(tmpW, buffer);
-    for (int y = 0; y < tmpH; y++) {
-        auto tmpStart = &tmp[y * tmpW];
-        auto dstStart = &dst->fImage[y];
+    forEachBand([&](int band) {
+        const auto [top, bottom] = bandScans(tmpH, band);
+        const PlanGauss::Scan& scanH = planH.makeBlurScan(tmpW, &buffers[bufferSize * band]);
+        int y = top;
+        for (; !fUseScalarScans && y + kLanes <= bottom; y += kLanes) {
+            planH.blurLanes(&tmp[y * tmpW], 1, tmpW, tmpW,
+                            &dst->fImage[y], dst->fRowBytes, dstH,
+                            &laneBuffers[bufferSize * band]);
+        }
+        for (; y < bottom; y++) {
+            auto tmpStart = &tmp[y * tmpW];
+            auto dstStart = &dst->fImage[y];
 
-        scanH.blur(tmpStart, tmpStart + tmpW,
-                   dstStart, dst->fRowBytes, dstStart + dst->fRowBytes * dstH);
-    }
+            scanH.blur(tmpStart, tmpStart + tmpW,
+                       dstStart, dst->fRowBytes, dstStart + dst->fRowBytes * dstH);
+        }
+    });
 
     return {SkTo<int32_t>(borderW), SkTo<int32_t>(borderH)};
 }
@@ -15,6 +15,8 @@
 #include "include/core/SkTypes.h"
 #include "src/core/SkMask.h"
 
+class SkExecutor;
+
 // Implement a single channel Gaussian blur. The specifics for implementation are taken from:
 // https://drafts.fxtf.org/filters/#feGaussianBlurElement
 class SkMaskBlurFilter {
@@ -27,11 +29,17 @@ public:
     bool hasNoBlur() const;
 
     // Given a src SkMask, generate dst SkMask returning the border width and height.
-    SkIPoint blur(const SkMask& src, SkMask* dst) const;
+    // If an executor is given, large masks are split into bands of rows and columns that are
+    // blurred on it in parallel. The result is the same either way.
+    SkIPoint blur(const SkMask& src, SkMask* dst, SkExecutor* executor = nullptr) const;
+
+    // Blur every scan on its own rather than several at once, so tests can check the two agree.
+    void setUseScalarScansForTesting(bool useScalarScans) { fUseScalarScans = useScalarScans; }
 
 private:
     const double fSigmaW;
     const double fSigmaH;
+    bool         fUseScalarScans = false;
 };
 
 #endif  // SkBlurMaskFilter_DEFINED
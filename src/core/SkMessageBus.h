@@ -8,6 +8,7 @@
 #ifndef SkMessageBus_DEFINED
 #define SkMessageBus_DEFINED
 
+#include <atomic>
 #include <type_traits>
 
 #include "include/core/SkRefCnt.h"
@@ -57,6 +58,9 @@ public:
         SkMutex                       fMessagesMutex;
         const IDType                  fUniqueID;
 
+        // Lets poll() skip taking fMessagesMutex when there's nothing to receive.
+        std::atomic<bool>             fHasMessages{false};
+
         friend class SkMessageBus;
         void receive(Message m);  // SkMessageBus is a friend only to call this.
     };
@@ -110,6 +114,7 @@ template <typename Message, typename IDType, bool AllowCopyableMessage>
 void SkMessageBus<Message, IDType, AllowCopyableMessage>::Inbox::receive(Message m) {
     SkAutoMutexExclusive lock(fMessagesMutex);
     fMessages.push_back(std::move(m));
+    fHasMessages.store(true, std::memory_order_relaxed);
 }
 
 template <typename Message, typename IDType, bool AllowCopyableMessage>
@@ -117,8 +122,12 @@ void SkMessageBus<Message, IDType, AllowCopyableMessage>::Inbox::poll(
         skia_private::TArray<Message>* messages) {
     SkASSERT(messages);
     messages->clear();
+    if (!fHasMessages.load(std::memory_order_relaxed)) {
+        return;
+    }
     SkAutoMutexExclusive lock(fMessagesMutex);
     fMessages.swap(*messages);
+    fHasMessages.store(false, std::memory_order_relaxed);
 }
 
 //   ----------------------- Implementation of SkMessageBus -----------------------
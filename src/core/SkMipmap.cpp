@@ -8,6 +8,7 @@
 
 #include "include/core/SkBitmap.h"
 #include "include/core/SkColorSpace.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkTypes.h"
 #include "include/private/SkColorData.h"
 #include "include/private/base/SkTo.h"
@@ -16,6 +17,7 @@
 #include "src/base/SkVx.h"
 #include "src/core/SkImageInfoPriv.h"
 #include "src/core/SkMipmapBuilder.h"
+#include "src/core/SkTaskGroup.h"
 
 #include <new>
 
@@ -383,6 +385,201 @@ template <typename F> void downsample_3_3(void* dst, const void* src, size_t src
     }
 }
 
+//  The filters above work one pixel at a time. For the most common formats and filters, these
+//  produce several dst pixels at a time with wider skvx vectors, and then finish off any leftover
+//  pixels with the filters above. They do exactly the same math, so the results are identical.
+
+template <typename T, int N>
+static skvx::Vec<N/2,T> even_lanes(const skvx::Vec<N,T>& v) {
+    if constexpr (N == 8) {
+        return skvx::shuffle<0,2,4,6>(v);
+    } else {
+        static_assert(N == 32);
+        return skvx::shuffle<0,2,4,6,8,10,12,14,16,18,20,22,24,26,28,30>(v);
+    }
+}
+
+template <typename T, int N>
+static skvx::Vec<N/2,T> odd_lanes(const skvx::Vec<N,T>& v) {
+    if constexpr (N == 8) {
+        return skvx::shuffle<1,3,5,7>(v);
+    } else {
+        static_assert(N == 32);
+        return skvx::shuffle<1,3,5,7,9,11,13,15,17,19,21,23,25,27,29,31>(v);
+    }
+}
+
+// 8888, 4 dst pixels at a time.
+static skvx::Vec<16,uint16_t> expand_8888(const skvx::Vec<4,uint32_t>& px) {
+    return skvx::cast<uint16_t>(skvx::bit_pun<skvx::Vec<16,uint8_t>>(px));
+}
+
+static skvx::Vec<4,uint32_t> compact_8888(const skvx::Vec<16,uint16_t>& x) {
+    return skvx::bit_pun<skvx::Vec<4,uint32_t>>(skvx::cast<uint8_t>(x));
+}
+
+static void downsample_2_2_8888(void* dst, const void* src, size_t srcRB, int count) {
+    SkASSERT(count > 0);
+    auto p0 = static_cast<const uint32_t*>(src);
+    auto p1 = (const uint32_t*)((const char*)p0 + srcRB);
+    auto d = static_cast<uint32_t*>(dst);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        auto r0 = skvx::Vec<8,uint32_t>::Load(p0 + 2*i),
+             r1 = skvx::Vec<8,uint32_t>::Load(p1 + 2*i);
+
+        auto c = expand_8888(even_lanes(r0)) + expand_8888(even_lanes(r1)) +
+                 expand_8888( odd_lanes(r0)) + expand_8888( odd_lanes(r1));
+        compact_8888(c >> 2).store(d + i);
+    }
+    if (i < count) {
+        downsample_2_2<ColorTypeFilter_8888>(d + i, p0 + 2*i, srcRB, count - i);
+    }
+}
+
+static void downsample_3_3_8888(void* dst, const void* src, size_t srcRB, int count) {
+    SkASSERT(count > 0);
+    auto p0 = static_cast<const uint32_t*>(src);
+    auto d = static_cast<uint32_t*>(dst);
+
+    // Each row contributes (a + 2*b + c), where a, b, c are the pixels at 2i, 2i+1, and 2i+2.
+    auto row = [](const uint32_t* p) {
+        auto ab = skvx::Vec<8,uint32_t>::Load(p),
+             bc = skvx::Vec<8,uint32_t>::Load(p + 1);
+        return add_121(expand_8888(even_lanes(ab)),
+                       expand_8888( odd_lanes(ab)),
+                       expand_8888( odd_lanes(bc)));
+    };
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        auto r0 = p0 + 2*i,
+             r1 = (const uint32_t*)((const char*)r0 + srcRB),
+             r2 = (const uint32_t*)((const char*)r1 + srcRB);
+
+        auto c = add_121(row(r0), row(r1), row(r2));
+        compact_8888(c >> 4).store(d + i);
+    }
+    if (i < count) {
+        downsample_3_3<ColorTypeFilter_8888>(d + i, p0 + 2*i, srcRB, count - i);
+    }
+}
+
+// A8 and other single byte formats, 16 dst pixels at a time.
+static void downsample_2_2_8(void* dst, const void* src, size_t srcRB, int count) {
+    SkASSERT(count > 0);
+    auto p0 = static_cast<const uint8_t*>(src);
+    auto p1 = p0 + srcRB;
+    auto d = static_cast<uint8_t*>(dst);
+
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        auto r0 = skvx::Vec<32,uint8_t>::Load(p0 + 2*i),
+             r1 = skvx::Vec<32,uint8_t>::Load(p1 + 2*i);
+
+        auto c = skvx::cast<uint16_t>(even_lanes(r0)) + skvx::cast<uint16_t>(even_lanes(r1)) +
+                 skvx::cast<uint16_t>( odd_lanes(r0)) + skvx::cast<uint16_t>( odd_lanes(r1));
+        skvx::cast<uint8_t>(c >> 2).store(d + i);
+    }
+    if (i < count) {
+        downsample_2_2<ColorTypeFilter_8>(d + i, p0 + 2*i, srcRB, count - i);
+    }
+}
+
+static void downsample_3_3_8(void* dst, const void* src, size_t srcRB, int count) {
+    SkASSERT(count > 0);
+    auto p0 = static_cast<const uint8_t*>(src);
+    auto d = static_cast<uint8_t*>(dst);
+
+    auto row = [](const uint8_t* p) {
+        auto ab = skvx::Vec<32,uint8_t>::Load(p),
+             bc = skvx::Vec<32,uint8_t>::Load(p + 1);
+        return add_121(skvx::cast<uint16_t>(even_lanes(ab)),
+                       skvx::cast<uint16_t>( odd_lanes(ab)),
+                       skvx::cast<uint16_t>( odd_lanes(bc)));
+    };
+
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        auto r0 = p0 + 2*i,
+             r1 = r0 + srcRB,
+             r2 = r1 + srcRB;
+
+        auto c = add_121(row(r0), row(r1), row(r2));
+        skvx::cast<uint8_t>(c >> 4).store(d + i);
+    }
+    if (i < count) {
+        downsample_3_3<ColorTypeFilter_8>(d + i, p0 + 2*i, srcRB, count - i);
+    }
+}
+
+// RGBA F16, 4 dst pixels at a time. We convert to and from half floats one pixel at a time,
+// like ColorTypeFilter_RGBA_F16 does, since skvx may convert wider vectors differently.
+static skvx::Vec<16,float> expand_f16(const skvx::Vec<4,uint64_t>& px) {
+    auto h = skvx::bit_pun<skvx::Vec<16,uint16_t>>(px);
+    return skvx::join(skvx::join(skvx::from_half(h.lo.lo), skvx::from_half(h.lo.hi)),
+                      skvx::join(skvx::from_half(h.hi.lo), skvx::from_half(h.hi.hi)));
+}
+
+static skvx::Vec<4,uint64_t> compact_f16(const skvx::Vec<16,float>& x) {
+    auto h = skvx::join(skvx::join(skvx::to_half(x.lo.lo), skvx::to_half(x.lo.hi)),
+                        skvx::join(skvx::to_half(x.hi.lo), skvx::to_half(x.hi.hi)));
+    return skvx::bit_pun<skvx::Vec<4,uint64_t>>(h);
+}
+
+static void downsample_2_2_f16(void* dst, const void* src, size_t srcRB, int count) {
+    SkASSERT(count > 0);
+    auto p0 = static_cast<const uint64_t*>(src);
+    auto p1 = (const uint64_t*)((const char*)p0 + srcRB);
+    auto d = static_cast<uint64_t*>(dst);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        auto r0 = skvx::Vec<8,uint64_t>::Load(p0 + 2*i),
+             r1 = skvx::Vec<8,uint64_t>::Load(p1 + 2*i);
+
+        // Same order as downsample_2_2(): c00 + c10 + c01 + c11.
+        auto c = expand_f16(even_lanes(r0)) + expand_f16(even_lanes(r1)) +
+                 expand_f16( odd_lanes(r0)) + expand_f16( odd_lanes(r1));
+        compact_f16(c * (1.0f / 4)).store(d + i);
+    }
+    if (i < count) {
+        downsample_2_2<ColorTypeFilter_RGBA_F16>(d + i, p0 + 2*i, srcRB, count - i);
+    }
+}
+
+static void downsample_3_3_f16(void* dst, const void* src, size_t srcRB, int count) {
+    SkASSERT(count > 0);
+    auto p0 = static_cast<const uint64_t*>(src);
+    auto d = static_cast<uint64_t*>(dst);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        auto r0 = p0 + 2*i,
+             r1 = (const uint64_t*)((const char*)r0 + srcRB),
+             r2 = (const uint64_t*)((const char*)r1 + srcRB);
+        auto ab0 = skvx::Vec<8,uint64_t>::Load(r0), bc0 = skvx::Vec<8,uint64_t>::Load(r0 + 1),
+             ab1 = skvx::Vec<8,uint64_t>::Load(r1), bc1 = skvx::Vec<8,uint64_t>::Load(r1 + 1),
+             ab2 = skvx::Vec<8,uint64_t>::Load(r2), bc2 = skvx::Vec<8,uint64_t>::Load(r2 + 1);
+
+        // Same order as downsample_3_3(): columns first, then (a + 2*b) + c.
+        auto a = add_121(expand_f16(even_lanes(ab0)),
+                         expand_f16(even_lanes(ab1)),
+                         expand_f16(even_lanes(ab2)));
+        auto b = add_121(expand_f16(odd_lanes(ab0)),
+                         expand_f16(odd_lanes(ab1)),
+                         expand_f16(odd_lanes(ab2))) * 2.0f;
+        auto c = add_121(expand_f16(odd_lanes(bc0)),
+                         expand_f16(odd_lanes(bc1)),
+                         expand_f16(odd_lanes(bc2)));
+        compact_f16((a + b + c) * (1.0f / 16)).store(d + i);
+    }
+    if (i < count) {
+        downsample_3_3<ColorTypeFilter_RGBA_F16>(d + i, p0 + 2*i, srcRB, count - i);
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 SkMipmap::SkMipmap(void* malloc, size_t size) : SkCachedData(malloc, size) {}
@@ -401,8 +598,11 @@ size_t SkMipmap::AllocLevelsSize(int levelCount, size_t pixelSize) {
     return SkTo<int32_t>(size);
 }
 
+// When building with an SkExecutor, we split each level into bands of at least this many pixels.
+static constexpr int kMinBandPixels = 64 * 1024;
+
 SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
-                          bool computeContents) {
+                          bool computeContents, SkExecutor* executor) {
     typedef void FilterProc(void*, const void* srcPtr, size_t srcRB, int count);
 
     FilterProc* proc_1_2 = nullptr;
@@ -423,11 +623,11 @@ SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
             proc_1_2 = downsample_1_2<ColorTypeFilter_8888>;
             proc_1_3 = downsample_1_3<ColorTypeFilter_8888>;
             proc_2_1 = downsample_2_1<ColorTypeFilter_8888>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_8888>;
+            proc_2_2 = downsample_2_2_8888;
             proc_2_3 = downsample_2_3<ColorTypeFilter_8888>;
             proc_3_1 = downsample_3_1<ColorTypeFilter_8888>;
             proc_3_2 = downsample_3_2<ColorTypeFilter_8888>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_8888>;
+            proc_3_3 = downsample_3_3_8888;
             break;
         case kRGB_565_SkColorType:
             proc_1_2 = downsample_1_2<ColorTypeFilter_565>;
@@ -455,22 +655,22 @@ SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
             proc_1_2 = downsample_1_2<ColorTypeFilter_8>;
             proc_1_3 = downsample_1_3<ColorTypeFilter_8>;
             proc_2_1 = downsample_2_1<ColorTypeFilter_8>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_8>;
+            proc_2_2 = downsample_2_2_8;
             proc_2_3 = downsample_2_3<ColorTypeFilter_8>;
             proc_3_1 = downsample_3_1<ColorTypeFilter_8>;
             proc_3_2 = downsample_3_2<ColorTypeFilter_8>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_8>;
+            proc_3_3 = downsample_3_3_8;
             break;
         case kRGBA_F16Norm_SkColorType:
         case kRGBA_F16_SkColorType:
             proc_1_2 = downsample_1_2<ColorTypeFilter_RGBA_F16>;
             proc_1_3 = downsample_1_3<ColorTypeFilter_RGBA_F16>;
             proc_2_1 = downsample_2_1<ColorTypeFilter_RGBA_F16>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_RGBA_F16>;
+            proc_2_2 = downsample_2_2_f16;
             proc_2_3 = downsample_2_3<ColorTypeFilter_RGBA_F16>;
             proc_3_1 = downsample_3_1<ColorTypeFilter_RGBA_F16>;
             proc_3_2 = downsample_3_2<ColorTypeFilter_RGBA_F16>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_RGBA_F16>;
+            proc_3_3 = downsample_3_3_f16;
             break;
         case kR8G8_unorm_SkColorType:
             proc_1_2 = downsample_1_2<ColorTypeFilter_88>;
@@ -645,14 +845,28 @@ SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
 
         const SkPixmap& dstPM = levels[i].fPixmap;
         if (computeContents) {
-            const void* srcBasePtr = srcPM.addr();
-            void* dstBasePtr = dstPM.writable_addr();
-
-            const size_t srcRB = srcPM.rowBytes();
-            for (int y = 0; y < height; y++) {
-                proc(dstBasePtr, srcBasePtr, srcRB, width);
-                srcBasePtr = (char*)srcBasePtr + srcRB * 2; // jump two rows
-                dstBasePtr = (char*)dstBasePtr + dstPM.rowBytes();
+            auto downsampleRows = [&](int top, int bottom) {
+                const size_t srcRB = srcPM.rowBytes();
+                for (int y = top; y < bottom; y++) {
+                    // Each dst row reads the src rows starting at 2*y.
+                    proc(dstPM.writable_addr(0, y), srcPM.addr(0, 2*y), srcRB, width);
+                }
+            };
+
+            // Levels depend on the one before, but the rows within each are independent, so we
+            // can split big levels into bands of rows to downsample in parallel.
+            const int bands = executor ? SkToInt(std::min<int64_t>(
+                                                 height, (int64_t)width * height / kMinBandPixels))
+                                       : 0;
+            if (bands > 1) {
+                SkTaskGroup tg(*executor);
+                tg.batch(bands, [&](int band) {
+                    downsampleRows(height *  band      / bands,
+                                   height * (band + 1) / bands);
+                });
+                tg.wait();
+            } else {
+                downsampleRows(0, height);
             }
         }
         srcPM = dstPM;
@@ -798,12 +1012,13 @@ bool SkMipmap::validForRootLevel(const SkImageInfo& root) const {
 
 // Helper which extracts a pixmap from the src bitmap
 //
-SkMipmap* SkMipmap::Build(const SkBitmap& src, SkDiscardableFactoryProc fact) {
+SkMipmap* SkMipmap::Build(const SkBitmap& src, SkDiscardableFactoryProc fact,
+                          SkExecutor* executor) {
     SkPixmap srcPixmap;
     if (!src.peekPixels(&srcPixmap)) {
         return nullptr;
     }
-    return Build(srcPixmap, fact);
+    return Build(srcPixmap, fact, /*computeContents=*/true, executor);
 }
 
 int SkMipmap::countLevels() const {
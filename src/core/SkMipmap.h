@@ -18,6 +18,7 @@
 class SkBitmap;
 class SkData;
 class SkDiscardableMemory;
+class SkExecutor;
 class SkMipmapBuilder;
 
 typedef SkDiscardableMemory* (*SkDiscardableFactoryProc)(size_t bytes);
@@ -34,10 +35,12 @@ public:
     ~SkMipmap() override;
     // Allocate and fill-in a mipmap. If computeContents is false, we just allocated
     // and compute the sizes/rowbytes, but leave the pixel-data uninitialized.
+    // If an executor is given, large levels are split into bands of rows computed in parallel on
+    // it. Build() still returns only once every level is complete.
     static SkMipmap* Build(const SkPixmap& src, SkDiscardableFactoryProc,
-                           bool computeContents = true);
+                           bool computeContents = true, SkExecutor* = nullptr);
 
-    static SkMipmap* Build(const SkBitmap& src, SkDiscardableFactoryProc);
+    static SkMipmap* Build(const SkBitmap& src, SkDiscardableFactoryProc, SkExecutor* = nullptr);
 
     // Determines how many levels a SkMipmap will have without creating that mipmap.
     // This does not include the base mipmap level that the user provided when
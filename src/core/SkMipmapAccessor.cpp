@@ -18,6 +18,8 @@
 #include "src/core/SkMipmap.h"
 #include "src/image/SkImage_Base.h"
 
+#include <algorithm>
+
 class SkImage;
 
 // Try to load from the base image, or from the cache
@@ -47,12 +49,12 @@ SkMipmapAccessor::SkMipmapAccessor(const SkImage_Base* image, const SkMatrix& in
     };
 
     float level = 0;
+    SkSize invScale = {1, 1};
     if (requestedMode != SkMipmapMode::kNone) {
-        SkSize scale;
-        if (!inv.decomposeScale(&scale, nullptr)) {
+        if (!inv.decomposeScale(&invScale, nullptr)) {
             resolvedMode = SkMipmapMode::kNone;
         } else {
-            level = SkMipmap::ComputeLevel({1/scale.width(), 1/scale.height()});
+            level = SkMipmap::ComputeLevel({1/invScale.width(), 1/invScale.height()});
             if (level <= 0) {
                 resolvedMode = SkMipmapMode::kNone;
                 level = 0;
@@ -72,6 +74,48 @@ SkMipmapAccessor::SkMipmapAccessor(const SkImage_Base* image, const SkMatrix& in
     float lowerWeight = level - levelNum;   // fract(level)
     SkASSERT(levelNum >= 0);
 
+    // Some lazy images can decode a smaller version of themselves directly (e.g. JPEG's DCT
+    // scaling), much more cheaply than decoding at full size to build mipmaps. If so, we start
+    // from that, building whatever smaller levels we still need from it.
+    if (levelNum > 0) {
+        const SkISize minSize = {std::max(image->width()  >> levelNum, 1),
+                                 std::max(image->height() >> levelNum, 1)};
+        if (image->getScaledROPixels(minSize, &fBaseStorage)) {
+            fUpper = fBaseStorage.pixmap();
+            const float subLevel = std::max(SkMipmap::ComputeLevel(
+                    {image->width()  / (invScale.width()  * fUpper.width()),
+                     image->height() / (invScale.height() * fUpper.height())}), 0.f);
+            const int subLevelNum = resolvedMode == SkMipmapMode::kNearest
+                                            ? sk_float_round2int(subLevel)
+                                            : sk_float_floor2int(subLevel);
+            const float subWeight = subLevel - subLevelNum;
+
+            if (subLevelNum > 0 || (resolvedMode == SkMipmapMode::kLinear && subWeight > 0)) {
+                const auto desc = SkBitmapCacheDesc::MakeScaled(image->uniqueID(),
+                                                                fUpper.dimensions());
+                fCurrMip.reset(SkMipmapCache::FindAndRef(desc));
+                if (!fCurrMip) {
+                    fCurrMip.reset(SkMipmapCache::AddAndRef(image, desc, fUpper));
+                }
+                SkMipmap::Level levelRec;
+                if (fCurrMip && (subLevelNum == 0 ||
+                                 fCurrMip->getLevel(subLevelNum - 1, &levelRec))) {
+                    if (subLevelNum > 0) {
+                        fUpper = levelRec.fPixmap;
+                    }
+                    if (resolvedMode == SkMipmapMode::kLinear &&
+                        fCurrMip->getLevel(subLevelNum, &levelRec)) {
+                        fLower = levelRec.fPixmap;
+                        fLowerWeight = subWeight;
+                        fLowerInv = scale(fLower);
+                    }
+                }
+            }
+            fUpperInv = scale(fUpper);
+            return;
+        }
+    }
+
     if (levelNum == 0) {
         load_upper_from_base();
     }
@@ -103,6 +103,11 @@ namespace SkOpts {
             SK_OPTS_NS::lowp::start_pipeline;
 #undef M
 
+    StageFn ops_lowp_hsw[kNumRasterPipelineLowpOps] = {};
+    StageFn just_return_lowp_hsw = nullptr;
+    void (*start_pipeline_lowp_hsw)(size_t, size_t, size_t, size_t, SkRasterPipelineStage*) =
+            nullptr;
+
     // Each Init_foo() is defined in src/opts/SkOpts_foo.cpp.
     void Init_ssse3();
     void Init_sse42();
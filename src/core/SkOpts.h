@@ -122,6 +122,12 @@ namespace SkOpts {
     extern size_t raster_pipeline_lowp_stride;
     extern size_t raster_pipeline_highp_stride;
 
+    // Init_skx() replaces the lowp stages above with 32-lane ones. Init_hsw() also keeps its
+    // 16-lane lowp stages here, so tests and benches can compare the two on SKX machines.
+    // These are null unless Init_hsw() has run.
+    extern StageFn ops_lowp_hsw[kNumRasterPipelineLowpOps], just_return_lowp_hsw;
+    extern void (*start_pipeline_lowp_hsw)(size_t,size_t,size_t,size_t, SkRasterPipelineStage*);
+
 #if defined(SK_ENABLE_SKVM)
     extern void (*interpret_skvm)(const skvm::InterpreterInstruction insts[], int ninsts,
                                   int nregs, int loop, const int strides[],
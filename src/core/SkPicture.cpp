@@ -12,6 +12,7 @@
 #include "include/core/SkSerialProcs.h"
 #include "include/private/base/SkTo.h"
 #include "src/base/SkMathPriv.h"
+#include "src/core/SkBigPicture.h"
 #include "src/core/SkCanvasPriv.h"
 #include "src/core/SkPictureData.h"
 #include "src/core/SkPicturePlayback.h"
@@ -240,6 +241,13 @@ SkPictureData* SkPicture::backport() const {
     return new SkPictureData(rec, info);
 }
 
+void SkPicture::playbackParallel(SkCanvas* canvas, SkExecutor& executor) const {
+    const SkBigPicture* bp = this->asSkBigPicture();
+    if (!bp || !bp->playbackParallel(canvas, executor)) {
+        this->playback(canvas);
+    }
+}
+
 void SkPicture::serialize(SkWStream* stream, const SkSerialProcs* procs) const {
     this->serialize(stream, procs, nullptr);
 }
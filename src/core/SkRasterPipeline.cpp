@@ -25,7 +25,7 @@ using Op = SkRasterPipelineOp;
 
 bool gForceHighPrecisionRasterPipeline;
 
-SkRasterPipeline::SkRasterPipeline(SkArenaAlloc* alloc) : fAlloc(alloc) {
+SkRasterPipeline::SkRasterPipeline(SkArenaAlloc* alloc) : fAlloc(alloc), fUseHSWLowpStages(false) {
     this->reset();
 }
 void SkRasterPipeline::reset() {
@@ -415,16 +415,22 @@ bool SkRasterPipeline::build_lowp_pipeline(SkRasterPipelineStage* ip) const {
     if (gForceHighPrecisionRasterPipeline || fRewindCtx) {
         return false;
     }
+    SkOpts::StageFn* ops = fUseHSWLowpStages ? SkOpts::ops_lowp_hsw : SkOpts::ops_lowp;
+    SkOpts::StageFn just_return = fUseHSWLowpStages ? SkOpts::just_return_lowp_hsw
+                                                    : SkOpts::just_return_lowp;
+    if (!just_return) {
+        return false;
+    }
     // Stages are stored backwards in fStages; to compensate, we assemble the pipeline in reverse
     // here, back to front.
-    prepend_to_pipeline(ip, SkOpts::just_return_lowp, /*ctx=*/nullptr);
+    prepend_to_pipeline(ip, just_return, /*ctx=*/nullptr);
     for (const StageList* st = fStages; st; st = st->prev) {
         int opIndex = (int)st->stage;
-        if (opIndex >= kNumRasterPipelineLowpOps || !SkOpts::ops_lowp[opIndex]) {
+        if (opIndex >= kNumRasterPipelineLowpOps || !ops[opIndex]) {
             // This program contains a stage that doesn't exist in lowp.
             return false;
         }
-        prepend_to_pipeline(ip, SkOpts::ops_lowp[opIndex], st->ctx);
+        prepend_to_pipeline(ip, ops[opIndex], st->ctx);
     }
     return true;
 }
@@ -451,7 +457,7 @@ SkRasterPipeline::StartPipelineFn SkRasterPipeline::build_pipeline(
         SkRasterPipelineStage* ip) const {
     // We try to build a lowp pipeline first; if that fails, we fall back to a highp float pipeline.
     if (this->build_lowp_pipeline(ip)) {
-        return SkOpts::start_pipeline_lowp;
+        return fUseHSWLowpStages ? SkOpts::start_pipeline_lowp_hsw : SkOpts::start_pipeline_lowp;
     }
 
     this->build_highp_pipeline(ip);
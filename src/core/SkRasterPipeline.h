@@ -128,6 +128,11 @@ public:
 
     bool empty() const { return fStages == nullptr; }
 
+    // Builds lowp pipelines from the 16-lane HSW stages (SkOpts::ops_lowp_hsw) instead of the
+    // default lowp stages, falling back to highp if they're unavailable. For tests and benches
+    // that compare the SKX lowp stages against HSW.
+    void setUseHSWLowpStagesForTesting(bool use) { fUseHSWLowpStages = use; }
+
 private:
     bool build_lowp_pipeline(SkRasterPipelineStage* ip) const;
     void build_highp_pipeline(SkRasterPipelineStage* ip) const;
@@ -142,6 +147,7 @@ private:
     SkRasterPipeline_RewindCtx* fRewindCtx;
     StageList*                  fStages;
     int                         fNumStages;
+    bool                        fUseHSWLowpStages;
 };
 
 template <size_t bytes>
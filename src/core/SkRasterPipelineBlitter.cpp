@@ -47,6 +47,7 @@ public:
     void blitAntiH (int x, int y, const SkAlpha[], const int16_t[]) override;
     void blitAntiH2(int x, int y, U8CPU a0, U8CPU a1)               override;
     void blitAntiV2(int x, int y, U8CPU a0, U8CPU a1)               override;
+    void blitAntiPixel(int x, int y, U8CPU a)                       override;
     void blitMask  (const SkMask&, const SkIRect& clip)             override;
     void blitRect  (int x, int y, int width, int height)            override;
     void blitV     (int x, int y, int height, SkAlpha alpha)        override;
@@ -469,6 +470,19 @@ void SkRasterPipelineBlitter::blitAntiV2(int x, int y, U8CPU a0, U8CPU a1) {
     this->blitMask(mask, clip);
 }
 
+void SkRasterPipelineBlitter::blitAntiPixel(int x, int y, U8CPU a) {
+    SkIRect clip = {x,y, x+1,y+1};
+    uint8_t coverage = (uint8_t)a;
+
+    SkMask mask;
+    mask.fImage    = &coverage;
+    mask.fBounds   = clip;
+    mask.fRowBytes = 1;
+    mask.fFormat   = SkMask::kA8_Format;
+
+    this->blitMask(mask, clip);
+}
+
 void SkRasterPipelineBlitter::blitV(int x, int y, int height, SkAlpha alpha) {
     SkIRect clip = {x,y, x+1,y+height};
 
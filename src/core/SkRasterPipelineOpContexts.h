@@ -16,7 +16,12 @@ namespace SkSL { class TraceHook; }
 // of pixels we handle in the highp pipeline. Many of the context structs in this file are only used
 // by stages that have no lowp implementation. They can therefore use the (smaller) highp value to
 // save memory in the arena.
-inline static constexpr int SkRasterPipeline_kMaxStride = 16;
+//
+// The lowp stages run 32 pixels at a time on SKX. The only users of SkRasterPipeline_kMaxStride are
+// SkRasterPipeline_DecalTileCtx, SkRasterPipelineBlitter's clip shader buffer and SkShader_Blend's
+// scratch space; these are allocated once per draw in the arena, so doubling it from 16 costs at
+// most a few hundred bytes per draw.
+inline static constexpr int SkRasterPipeline_kMaxStride = 32;
 inline static constexpr int SkRasterPipeline_kMaxStride_highp = 8;
 
 // These structs hold the context data for many of the Raster Pipeline ops.
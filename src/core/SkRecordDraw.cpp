@@ -6,14 +6,21 @@
  */
 
 #include "include/core/SkBBHFactory.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
+#include "include/private/base/SkTArray.h"
 #include "include/private/base/SkTDArray.h"
+#include "src/core/SkBitmapDevice.h"
 #include "src/core/SkCanvasPriv.h"
 #include "src/core/SkColorFilterBase.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkRecordDraw.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/utils/SkPatchUtils.h"
 
+#include <memory>
+
 void SkRecordDraw(const SkRecord& record,
                   SkCanvas* canvas,
                   SkPicture const* const drawablePicts[],
@@ -575,3 +582,178 @@ void SkRecordFillBounds(const SkRect& cullRect, const SkRecord& record,
         }
     }
 }
+
+namespace SkRecords {
+
+namespace {
+struct ClassifyOp {
+    template <typename T>
+    OpKind operator()(const T&) {
+        return (T::kTags & kDraw_Tag) ? OpKind::kDraw : OpKind::kState;
+    }
+    OpKind operator()(const Save&)       { return OpKind::kSave; }
+    OpKind operator()(const SaveBehind&) { return OpKind::kSaveLayer; }
+    OpKind operator()(const SaveLayer&)  { return OpKind::kSaveLayer; }
+    OpKind operator()(const Restore&)    { return OpKind::kRestore; }
+};
+}  // namespace
+
+OpKind Classify(const SkRecord& record, int i) {
+    return record.visit(i, ClassifyOp());
+}
+
+}  // namespace SkRecords
+
+void SkRecordDrawTiled(const SkRecord& record, int start, int stop,
+                       SkSpan<const int> liveStateOps,
+                       const SkRect bounds[],
+                       SkPicture const* const drawablePicts[],
+                       int drawableCount,
+                       const SkBitmap& dst,
+                       const SkSurfaceProps& props,
+                       const SkM44& ctm,
+                       const SkIRect& clip,
+                       SkISize tileSize,
+                       SkExecutor& executor) {
+    using SkRecords::OpKind;
+    SkASSERT(!tileSize.isEmpty());
+    SkASSERT(!ctm.asM33().hasPerspective());
+    SkASSERT(SkIRect::MakeSize(dst.dimensions()).contains(clip));
+
+    const SkIRect dstBounds = SkIRect::MakeSize(dst.dimensions());
+    const int tilesX = (dst.width()  + tileSize.width()  - 1) / tileSize.width(),
+              tilesY = (dst.height() + tileSize.height() - 1) / tileSize.height();
+    const SkMatrix ctm33 = ctm.asM33();
+
+    // The ops before each run of ops we draw: liveStateOps, then the state ops we've passed.
+    skia_private::TArray<int> prefixOps;
+    prefixOps.push_back_n(liveStateOps.size(), liveStateOps.data());
+
+    auto makeCanvas = [&](sk_sp<SkBaseDevice> device) {
+        auto canvas = std::make_unique<SkCanvas>(std::move(device));
+        if (clip != dstBounds) {
+            canvas->clipIRect(clip);
+        }
+        canvas->setMatrix(ctm);
+        return canvas;
+    };
+
+    // Draw ops [from, to) on this thread, into all of dst.
+    auto drawSerially = [&](int from, int to) {
+        std::unique_ptr<SkCanvas> canvas = makeCanvas(sk_make_sp<SkBitmapDevice>(dst, props));
+        SkRecords::Draw draw(canvas.get(), drawablePicts, nullptr, drawableCount);
+        for (int op : prefixOps) {
+            record.visit(op, draw);
+        }
+        for (int i = from; i < to; i++) {
+            record.visit(i, draw);
+        }
+    };
+
+    // Draw ops [from, to), none of which is a saveLayer(), one tile at a time on executor.
+    auto drawTiled = [&](int from, int to) {
+        // Bin each draw into the tiles its bounds touch.
+        skia_private::TArray<int> stateOps;
+        skia_private::TArray<skia_private::TArray<int>> bins;
+        bins.push_back_n(tilesX * tilesY);
+        for (int i = from; i < to; i++) {
+            if (SkRecords::Classify(record, i) != OpKind::kDraw) {
+                stateOps.push_back(i);
+                continue;
+            }
+            // Outset by a pixel in case our mapping rounds differently than the draw's.
+            SkIRect r = ctm33.mapRect(bounds[i]).roundOut();
+            if (!ctm33.isIdentity()) {
+                r.outset(1, 1);
+            }
+            if (!r.intersect(clip)) {
+                continue;
+            }
+            const int tx0 = r.fLeft / tileSize.width(),  tx1 = (r.fRight  - 1) / tileSize.width(),
+                      ty0 = r.fTop  / tileSize.height(), ty1 = (r.fBottom - 1) / tileSize.height();
+            for (int ty = ty0; ty <= ty1; ty++) {
+                for (int tx = tx0; tx <= tx1; tx++) {
+                    bins[ty * tilesX + tx].push_back(i);
+                }
+            }
+        }
+
+        SkTaskGroup tiles(executor);
+        tiles.batch(tilesX * tilesY, [&](int t) {
+            const skia_private::TArray<int>& bin = bins[t];
+            if (bin.empty()) {
+                return;
+            }
+            SkIRect tile = SkIRect::MakeXYWH((t % tilesX) * tileSize.width(),
+                                             (t / tilesX) * tileSize.height(),
+                                             tileSize.width(), tileSize.height());
+            if (!SkIRect::Intersects(tile, clip)) {
+                return;
+            }
+
+            // Each tile draws into all of dst, clipped only as asked, so everything is rasterized
+            // exactly as it would be on one canvas.  (Clipping to the tile would change where
+            // path edges start and end, and so their AA coverage.)  Only the blits are limited to
+            // the tile.
+            auto device = sk_make_sp<SkBitmapDevice>(dst, props);
+            device->setBlitBounds(tile);
+            std::unique_ptr<SkCanvas> canvas = makeCanvas(std::move(device));
+
+            SkRecords::Draw draw(canvas.get(), drawablePicts, nullptr, drawableCount);
+            for (int op : prefixOps) {
+                record.visit(op, draw);
+            }
+            // Merge the state ops and this tile's draws back into record order.
+            int s = 0, d = 0;
+            while (s < stateOps.size() || d < bin.size()) {
+                if (d == bin.size() || (s < stateOps.size() && stateOps[s] < bin[d])) {
+                    record.visit(stateOps[s++], draw);
+                } else {
+                    record.visit(bin[d++], draw);
+                }
+            }
+        });
+        tiles.wait();
+
+        prefixOps.push_back_n(stateOps.size(), stateOps.data());
+    };
+
+    // A layer still open from before start would be copied into every tile.
+    for (int op : liveStateOps) {
+        if (SkRecords::Classify(record, op) == OpKind::kSaveLayer) {
+            drawSerially(start, stop);
+            return;
+        }
+    }
+
+    // Each tile would make its own copy of a full size layer, and filter and composite all of it,
+    // so each outermost saveLayer() through its restore() is drawn on this thread, in order with
+    // the tiled runs of ops between them.  A layer never restored runs through stop.
+    for (int i = start; i < stop;) {
+        const int runStart = i;
+        while (i < stop && SkRecords::Classify(record, i) != OpKind::kSaveLayer) {
+            i++;
+        }
+        if (i > runStart) {
+            drawTiled(runStart, i);
+        }
+        if (i == stop) {
+            break;
+        }
+
+        const int layerStart = i;
+        for (int depth = 0; i < stop; ) {
+            switch (SkRecords::Classify(record, i++)) {
+                case OpKind::kSave:
+                case OpKind::kSaveLayer: depth++; break;
+                case OpKind::kRestore:   depth--; break;
+                case OpKind::kState:
+                case OpKind::kDraw:      break;
+            }
+            if (depth == 0) {
+                break;
+            }
+        }
+        drawSerially(layerStart, i);
+    }
+}
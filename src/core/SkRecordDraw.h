@@ -11,11 +11,15 @@
 #include "include/core/SkBBHFactory.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkMatrix.h"
+#include "include/core/SkSpan.h"
 #include "src/core/SkBigPicture.h"
 #include "src/core/SkRecord.h"
 
+class SkBitmap;
 class SkDrawable;
+class SkExecutor;
 class SkLayerInfo;
+class SkSurfaceProps;
 
 // Calculate conservative identity space bounds for each op in the record.
 void SkRecordFillBounds(const SkRect& cullRect, const SkRecord&,
@@ -26,8 +30,29 @@ void SkRecordDraw(const SkRecord&, SkCanvas*, SkPicture const* const drawablePic
                   SkDrawable* const drawables[], int drawableCount,
                   const SkBBoxHierarchy*, SkPicture::AbortCallback*);
 
+// Draw ops [start, stop) of an SkRecord into dst, one tile at a time in parallel on executor.
+//
+// Every tile replays liveStateOps (the state ops before start still in effect there) and all the
+// state ops in [start, stop), but only the draws whose bounds touch it.  bounds are those from
+// SkRecordFillBounds(), and ctm and clip are the device space matrix and rect clip to draw with.
+// Each tile draws into all of dst but only writes its own pixels, so the result is exactly what
+// drawing the ops in order on one raster canvas with that matrix and clip would produce.
+// Layers don't split into tiles, so each outermost saveLayer() through its restore() is drawn on
+// this thread, between the tiled runs of ops around it.  If liveStateOps holds a saveLayer(), all
+// the ops are drawn on this thread.
+void SkRecordDrawTiled(const SkRecord&, int start, int stop, SkSpan<const int> liveStateOps,
+                       const SkRect bounds[], SkPicture const* const drawablePicts[],
+                       int drawableCount, const SkBitmap& dst, const SkSurfaceProps&,
+                       const SkM44& ctm, const SkIRect& clip, SkISize tileSize, SkExecutor&);
+
 namespace SkRecords {
 
+// How an op affects the ops after it: kState covers everything other than saves and restores
+// that changes the matrix or clip.  SaveBehind counts as kSaveLayer: like a layer, it reads and
+// writes pixels outside any one tile.
+enum class OpKind { kSave, kSaveLayer, kRestore, kState, kDraw };
+OpKind Classify(const SkRecord&, int i);
+
 // This is an SkRecord visitor that will draw that SkRecord to an SkCanvas.
 class Draw : SkNoncopyable {
 public:
@@ -112,6 +112,7 @@ void SkRecorder::reset(SkRecord* record, const SkRect& bounds) {
     this->forgetRecord();
     fRecord = record;
     this->resetCanvas(safe_picture_bounds(bounds));
+    fLayerSaveCount = 0;
     SkASSERT(this->imageInfo().width() >= 0 && this->imageInfo().height() >= 0);
 }
 
@@ -124,6 +125,26 @@ void SkRecorder::forgetRecord() {
 // To make appending to fRecord a little less verbose.
 template<typename T, typename... Args>
 void SkRecorder::append(Args&&... args) {
+    if constexpr ((T::kTags & SkRecords::kDraw_Tag) != 0) {
+        // When we're recording for a surface (SkSurfaces::RasterThreaded), that surface needs to
+        // know its contents are about to change, just as if we were drawing directly into it.
+        if (!this->predrawNotify()) {
+            return;
+        }
+    }
+    new (fRecord->append<T>()) T{std::forward<Args>(args)...};
+}
+
+template<typename T, typename... Args>
+void SkRecorder::appendMayOverwrite(const SkRect* rect, const SkPaint* paint,
+                                    ShaderOverrideOpacity overrideOpacity, Args&&... args) {
+    // As SkCanvas does, let the surface know when a draw replaces all of its pixels, so it can
+    // drop them rather than copy them for an outstanding snapshot.  Inside a layer, it doesn't.
+    const bool notified = fLayerSaveCount ? this->predrawNotify()
+                                          : this->predrawNotify(rect, paint, overrideOpacity);
+    if (!notified) {
+        return;
+    }
     new (fRecord->append<T>()) T{std::forward<Args>(args)...};
 }
 
@@ -174,7 +195,8 @@ char* SkRecorder::copy(const char* src) {
 }
 
 void SkRecorder::onDrawPaint(const SkPaint& paint) {
-    this->append<SkRecords::DrawPaint>(paint);
+    this->appendMayOverwrite<SkRecords::DrawPaint>(nullptr, &paint, kNone_ShaderOverrideOpacity,
+                                                   paint);
 }
 
 void SkRecorder::onDrawBehind(const SkPaint& paint) {
@@ -189,7 +211,8 @@ void SkRecorder::onDrawPoints(PointMode mode,
 }
 
 void SkRecorder::onDrawRect(const SkRect& rect, const SkPaint& paint) {
-    this->append<SkRecords::DrawRect>(paint, rect);
+    this->appendMayOverwrite<SkRecords::DrawRect>(&rect, &paint, kNone_ShaderOverrideOpacity,
+                                                  paint, rect);
 }
 
 void SkRecorder::onDrawRegion(const SkRegion& region, const SkPaint& paint) {
@@ -233,8 +256,10 @@ void SkRecorder::onDrawImage2(const SkImage* image, SkScalar x, SkScalar y,
 void SkRecorder::onDrawImageRect2(const SkImage* image, const SkRect& src, const SkRect& dst,
                                   const SkSamplingOptions& sampling, const SkPaint* paint,
                                   SrcRectConstraint constraint) {
-    this->append<SkRecords::DrawImageRect>(this->copy(paint), sk_ref_sp(image), src, dst,
-                                           sampling, constraint);
+    this->appendMayOverwrite<SkRecords::DrawImageRect>(
+            &dst, paint,
+            image->isOpaque() ? kOpaque_ShaderOverrideOpacity : kNotOpaque_ShaderOverrideOpacity,
+            this->copy(paint), sk_ref_sp(image), src, dst, sampling, constraint);
 }
 
 void SkRecorder::onDrawImageLattice2(const SkImage* image, const Lattice& lattice, const SkRect& dst,
@@ -352,6 +377,9 @@ void SkRecorder::willSave() {
 }
 
 SkCanvas::SaveLayerStrategy SkRecorder::getSaveLayerStrategy(const SaveLayerRec& rec) {
+    if (!fLayerSaveCount) {
+        fLayerSaveCount = this->getSaveCount();
+    }
     this->append<SkRecords::SaveLayer>(this->copy(rec.fBounds)
                     , this->copy(rec.fPaint)
                     , sk_ref_sp(rec.fBackdrop)
@@ -361,11 +389,17 @@ SkCanvas::SaveLayerStrategy SkRecorder::getSaveLayerStrategy(const SaveLayerRec&
 }
 
 bool SkRecorder::onDoSaveBehind(const SkRect* subset) {
+    if (!fLayerSaveCount) {
+        fLayerSaveCount = this->getSaveCount();
+    }
     this->append<SkRecords::SaveBehind>(this->copy(subset));
     return false;
 }
 
 void SkRecorder::didRestore() {
+    if (this->getSaveCount() <= fLayerSaveCount) {
+        fLayerSaveCount = 0;
+    }
     this->append<SkRecords::Restore>(this->getTotalMatrix());
 }
 
@@ -171,9 +171,17 @@ private:
     template<typename T, typename... Args>
     void append(Args&&...);
 
+    // append() for draws that may cover the whole surface we're recording for (if any).
+    template<typename T, typename... Args>
+    void appendMayOverwrite(const SkRect*, const SkPaint*, ShaderOverrideOpacity, Args&&...);
+
     size_t fApproxBytesUsedBySubPictures;
     SkRecord* fRecord;
     std::unique_ptr<SkDrawableList> fDrawableList;
+
+    // The save count just before the outermost saveLayer() still open, or 0 if there is none.
+    // We never make layers, so SkCanvas can't tell whether a draw lands in one.
+    int fLayerSaveCount = 0;
 };
 
 #endif//SkRecorder_DEFINED
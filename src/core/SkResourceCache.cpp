@@ -8,14 +8,17 @@
 #include "src/core/SkResourceCache.h"
 
 #include "include/core/SkTraceMemoryDump.h"
-#include "include/private/base/SkMutex.h"
+#include "include/private/base/SkMath.h"
+#include "include/private/base/SkOnce.h"
 #include "include/private/base/SkTo.h"
 #include "include/private/chromium/SkDiscardableMemory.h"
+#include "src/base/SkMathPriv.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkMessageBus.h"
 #include "src/core/SkMipmap.h"
 #include "src/core/SkOpts.h"
 
+#include <algorithm>
 #include <stddef.h>
 #include <stdlib.h>
 
@@ -81,15 +84,12 @@ class SkResourceCache::Hash :
 ///////////////////////////////////////////////////////////////////////////////
 
 void SkResourceCache::init() {
-    fHead = nullptr;
-    fTail = nullptr;
-    fHash = new Hash;
-    fTotalBytesUsed = 0;
-    fCount = 0;
-    fSingleAllocationByteLimit = 0;
+    for (Shard& shard : fShards) {
+        SkAutoSharedMutexExclusive lock(shard.fLock);
+        shard.fHash = new Hash;
+    }
 
     // One of these should be explicit set by the caller after we return.
-    fTotalByteLimit = 0;
     fDiscardableFactory = nullptr;
 }
 
@@ -102,17 +102,27 @@ SkResourceCache::SkResourceCache(DiscardableFactory factory)
 SkResourceCache::SkResourceCache(size_t byteLimit)
         : fPurgeSharedIDInbox(SK_InvalidUniqueID) {
     this->init();
-    fTotalByteLimit = byteLimit;
+    fTotalByteLimit.store(byteLimit, std::memory_order_relaxed);
 }
 
 SkResourceCache::~SkResourceCache() {
-    Rec* rec = fHead;
-    while (rec) {
-        Rec* next = rec->fNext;
-        delete rec;
-        rec = next;
+    for (Shard& shard : fShards) {
+        SkAutoSharedMutexExclusive lock(shard.fLock);
+        Rec* rec = shard.fHead;
+        while (rec) {
+            Rec* next = rec->fNext;
+            delete rec;
+            rec = next;
+        }
+        delete shard.fHash;
     }
-    delete fHash;
+}
+
+auto SkResourceCache::shardFor(const Key& key) -> Shard& {
+    // The low bits of the hash pick a slot in the shard's Hash, so use the high bits here.
+    static_assert(SkIsPow2(kShardCount));
+    static constexpr int kShardShift = 32 - SkNextLog2_portable(kShardCount);
+    return fShards[key.hash() >> kShardShift];
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -120,15 +130,31 @@ SkResourceCache::~SkResourceCache() {
 bool SkResourceCache::find(const Key& key, FindVisitor visitor, void* context) {
     this->checkMessages();
 
-    if (auto found = fHash->find(key)) {
+    Shard& shard = this->shardFor(key);
+    Rec* stale;
+    {
+        SkAutoSharedMutexShared lock(shard.fLock);
+        Rec* const* found = shard.fHash->find(key);
+        if (!found) {
+            return false;
+        }
         Rec* rec = *found;
         if (visitor(*rec, context)) {
-            this->moveToHead(rec);  // for our LRU
+            // For our LRU. We can't move rec to the head of the list while other threads may be
+            // reading it, so we mark it instead and let purgeShard() move it.
+            if (!rec->fRecentlyUsed.load(std::memory_order_relaxed)) {
+                rec->fRecentlyUsed.store(true, std::memory_order_relaxed);
+            }
             return true;
-        } else {
-            this->remove(rec);  // stale
-            return false;
         }
+        stale = rec;
+    }
+
+    // Another thread may have removed it (or even replaced it) while we weren't holding the lock.
+    SkAutoSharedMutexExclusive lock(shard.fLock);
+    Rec** found = shard.fHash->find(key);
+    if (found && *found == stale && stale->canBePurged()) {
+        this->remove(&shard, *found);
     }
     return false;
 }
@@ -149,61 +175,68 @@ void SkResourceCache::add(Rec* rec, void* payload) {
     this->checkMessages();
 
     SkASSERT(rec);
-    // See if we already have this key (racy inserts, etc.)
-    if (Rec** preexisting = fHash->find(rec->getKey())) {
-        Rec* prev = *preexisting;
-        if (prev->canBePurged()) {
-            // if it can be purged, the install may fail, so we have to remove it
-            this->remove(prev);
-        } else {
-            // if it cannot be purged, we reuse it and delete the new one
-            prev->postAddInstall(payload);
-            delete rec;
-            return;
+    Shard& shard = this->shardFor(rec->getKey());
+    {
+        SkAutoSharedMutexExclusive lock(shard.fLock);
+
+        // See if we already have this key (racy inserts, etc.)
+        if (Rec** preexisting = shard.fHash->find(rec->getKey())) {
+            Rec* prev = *preexisting;
+            if (prev->canBePurged()) {
+                // if it can be purged, the install may fail, so we have to remove it
+                this->remove(&shard, prev);
+            } else {
+                // if it cannot be purged, we reuse it and delete the new one
+                prev->postAddInstall(payload);
+                delete rec;
+                return;
+            }
         }
-    }
-
-    this->addToHead(rec);
-    fHash->set(rec);
-    rec->postAddInstall(payload);
 
-    if (gDumpCacheTransactions) {
-        SkString bytesStr, totalStr;
-        make_size_str(rec->bytesUsed(), &bytesStr);
-        make_size_str(fTotalBytesUsed, &totalStr);
-        SkDebugf("RC:    add %5s %12p key %08x -- total %5s, count %d\n",
-                 bytesStr.c_str(), rec, rec->getHash(), totalStr.c_str(), fCount);
+        this->addToHead(&shard, rec);
+        shard.fHash->set(rec);
+        rec->postAddInstall(payload);
+
+        if (gDumpCacheTransactions) {
+            SkString bytesStr, totalStr;
+            make_size_str(rec->bytesUsed(), &bytesStr);
+            make_size_str(this->getTotalBytesUsed(), &totalStr);
+            SkDebugf("RC:    add %5s %12p key %08x -- total %5s, count %d\n",
+                     bytesStr.c_str(), rec, rec->getHash(), totalStr.c_str(),
+                     fCount.load(std::memory_order_relaxed));
+        }
     }
 
     // since the new rec may push us over-budget, we perform a purge check now
-    this->purgeAsNeeded();
+    this->purgeAsNeeded(&shard);
 }
 
-void SkResourceCache::remove(Rec* rec) {
+void SkResourceCache::remove(Shard* shard, Rec* rec) {
     SkASSERT(rec->canBePurged());
     size_t used = rec->bytesUsed();
-    SkASSERT(used <= fTotalBytesUsed);
+    SkASSERT(used <= shard->fTotalBytesUsed);
 
-    this->release(rec);
-    fHash->remove(rec->getKey());
+    this->release(shard, rec);
+    shard->fHash->remove(rec->getKey());
 
-    fTotalBytesUsed -= used;
-    fCount -= 1;
-
-    //SkDebugf("-RC count [%3d] bytes %d\n", fCount, fTotalBytesUsed);
+    shard->fTotalBytesUsed -= used;
+    shard->fCount -= 1;
+    fTotalBytesUsed.fetch_sub(used, std::memory_order_relaxed);
+    fCount.fetch_sub(1, std::memory_order_relaxed);
 
     if (gDumpCacheTransactions) {
         SkString bytesStr, totalStr;
         make_size_str(used, &bytesStr);
-        make_size_str(fTotalBytesUsed, &totalStr);
+        make_size_str(this->getTotalBytesUsed(), &totalStr);
         SkDebugf("RC: remove %5s %12p key %08x -- total %5s, count %d\n",
-                 bytesStr.c_str(), rec, rec->getHash(), totalStr.c_str(), fCount);
+                 bytesStr.c_str(), rec, rec->getHash(), totalStr.c_str(),
+                 fCount.load(std::memory_order_relaxed));
     }
 
     delete rec;
 }
 
-void SkResourceCache::purgeAsNeeded(bool forcePurge) {
+bool SkResourceCache::purgeNeeded(size_t* bytesNeeded, int* countNeeded) const {
     size_t byteLimit;
     int    countLimit;
 
@@ -212,23 +245,87 @@ void SkResourceCache::purgeAsNeeded(bool forcePurge) {
         byteLimit = UINT32_MAX;  // no limit based on bytes
     } else {
         countLimit = SK_MaxS32; // no limit based on count
-        byteLimit = fTotalByteLimit;
+        byteLimit = this->getTotalByteLimit();
     }
 
-    Rec* rec = fTail;
-    while (rec) {
-        if (!forcePurge && fTotalBytesUsed < byteLimit && fCount < countLimit) {
-            break;
-        }
-
+    // We're within budget while we're strictly under both limits.
+    const size_t bytesUsed = this->getTotalBytesUsed();
+    const int    count     = fCount.load(std::memory_order_relaxed);
+    *bytesNeeded = bytesUsed >= byteLimit  ? bytesUsed - byteLimit + 1 : 0;
+    *countNeeded = count     >= countLimit ? count - countLimit + 1    : 0;
+    return *bytesNeeded || *countNeeded;
+}
+
+void SkResourceCache::purgeShard(Shard* shard,
+                                 size_t* bytesNeeded,
+                                 int* countNeeded,
+                                 const Rec* stopAt) {
+    // Recs that have been found since we last came across them get moved to the head instead of
+    // purged. We may come across them again (unless we stop at stopAt), but not a third time.
+    int visits = 2 * shard->fCount;
+    Rec* rec = shard->fTail;
+    while (rec && rec != stopAt && visits-- > 0 && (*bytesNeeded || *countNeeded)) {
         Rec* prev = rec->fPrev;
+        if (rec->fRecentlyUsed.exchange(false, std::memory_order_relaxed)) {
+            this->moveToHead(shard, rec);
+            // If rec was already the head, there's nothing left to visit before it comes round.
+            rec = prev ? prev : rec;
+            continue;
+        }
         if (rec->canBePurged()) {
-            this->remove(rec);
+            *bytesNeeded -= std::min(*bytesNeeded, rec->bytesUsed());
+            *countNeeded -= std::min(*countNeeded, 1);
+            this->remove(shard, rec);
         }
         rec = prev;
     }
 }
 
+void SkResourceCache::purgeAsNeeded(Shard* shard) {
+    size_t bytesNeeded;
+    int countNeeded;
+    if (!this->purgeNeeded(&bytesNeeded, &countNeeded)) {
+        return;
+    }
+
+    // Try the shard we just added to first; it's the only lock we know is likely free. Its head is
+    // what we just added, which we'd rather keep if anything else can go instead.
+    {
+        SkAutoSharedMutexExclusive lock(shard->fLock);
+        this->purgeShard(shard, &bytesNeeded, &countNeeded, shard->fHead);
+    }
+    if (!bytesNeeded && !countNeeded) {
+        return;
+    }
+
+    // Only one thread needs to purge the other shards. If one already is, leave it to them.
+    if (fPurgingOtherShards.exchange(true, std::memory_order_acquire)) {
+        return;
+    }
+    this->purgeShards(shard, bytesNeeded, countNeeded);
+    fPurgingOtherShards.store(false, std::memory_order_release);
+}
+
+void SkResourceCache::purgeShards(const Shard* start, size_t bytesNeeded, int countNeeded) {
+    // Start after start, so purges triggered from different shards spread across the others.
+    // start itself comes last.
+    const int first = start ? SkToInt(start - fShards) + 1 : 0;
+    for (int i = 0; i < kShardCount && (bytesNeeded || countNeeded); i++) {
+        Shard* shard = &fShards[(first + i) % kShardCount];
+        SkAutoSharedMutexExclusive lock(shard->fLock);
+        this->purgeShard(shard, &bytesNeeded, &countNeeded, nullptr);
+    }
+}
+
+void SkResourceCache::purgeAll() {
+    for (Shard& shard : fShards) {
+        SkAutoSharedMutexExclusive lock(shard.fLock);
+        size_t bytesNeeded = SIZE_MAX;
+        int countNeeded = SK_MaxS32;
+        this->purgeShard(&shard, &bytesNeeded, &countNeeded, nullptr);
+    }
+}
+
 //#define SK_TRACK_PURGE_SHAREDID_HITRATE
 
 #ifdef SK_TRACK_PURGE_SHAREDID_HITRATE
@@ -245,22 +342,27 @@ void SkResourceCache::purgeSharedID(uint64_t sharedID) {
     gPurgeCallCounter += 1;
     bool found = false;
 #endif
-    // go backwards, just like purgeAsNeeded, just to make the code similar.
-    // could iterate either direction and still be correct.
-    Rec* rec = fTail;
-    while (rec) {
-        Rec* prev = rec->fPrev;
-        if (rec->getKey().getSharedID() == sharedID) {
-            // even though the "src" is now dead, caches could still be in-flight, so
-            // we have to check if it can be removed.
-            if (rec->canBePurged()) {
-                this->remove(rec);
-            }
+    // Recs are sharded by their whole key, so any shard could have Recs with this sharedID.
+    for (Shard& shard : fShards) {
+        SkAutoSharedMutexExclusive lock(shard.fLock);
+
+        // go backwards, just like purgeShard, just to make the code similar.
+        // could iterate either direction and still be correct.
+        Rec* rec = shard.fTail;
+        while (rec) {
+            Rec* prev = rec->fPrev;
+            if (rec->getKey().getSharedID() == sharedID) {
+                // even though the "src" is now dead, caches could still be in-flight, so
+                // we have to check if it can be removed.
+                if (rec->canBePurged()) {
+                    this->remove(&shard, rec);
+                }
 #ifdef SK_TRACK_PURGE_SHAREDID_HITRATE
-            found = true;
+                found = true;
 #endif
+            }
+            rec = prev;
         }
-        rec = prev;
     }
 
 #ifdef SK_TRACK_PURGE_SHAREDID_HITRATE
@@ -274,22 +376,27 @@ void SkResourceCache::purgeSharedID(uint64_t sharedID) {
 }
 
 void SkResourceCache::visitAll(Visitor visitor, void* context) {
-    // go backwards, just like purgeAsNeeded, just to make the code similar.
-    // could iterate either direction and still be correct.
-    Rec* rec = fTail;
-    while (rec) {
-        visitor(*rec, context);
-        rec = rec->fPrev;
+    for (Shard& shard : fShards) {
+        SkAutoSharedMutexShared lock(shard.fLock);
+
+        // go backwards, just like purgeShard, just to make the code similar.
+        // could iterate either direction and still be correct.
+        Rec* rec = shard.fTail;
+        while (rec) {
+            visitor(*rec, context);
+            rec = rec->fPrev;
+        }
     }
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 size_t SkResourceCache::setTotalByteLimit(size_t newLimit) {
-    size_t prevLimit = fTotalByteLimit;
-    fTotalByteLimit = newLimit;
-    if (newLimit < prevLimit) {
-        this->purgeAsNeeded();
+    size_t prevLimit = fTotalByteLimit.exchange(newLimit, std::memory_order_relaxed);
+    size_t bytesNeeded;
+    int countNeeded;
+    if (newLimit < prevLimit && this->purgeNeeded(&bytesNeeded, &countNeeded)) {
+        this->purgeShards(nullptr, bytesNeeded, countNeeded);
     }
     return prevLimit;
 }
@@ -307,19 +414,19 @@ SkCachedData* SkResourceCache::newCachedData(size_t bytes) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void SkResourceCache::release(Rec* rec) {
+void SkResourceCache::release(Shard* shard, Rec* rec) {
     Rec* prev = rec->fPrev;
     Rec* next = rec->fNext;
 
     if (!prev) {
-        SkASSERT(fHead == rec);
-        fHead = next;
+        SkASSERT(shard->fHead == rec);
+        shard->fHead = next;
     } else {
         prev->fNext = next;
     }
 
     if (!next) {
-        fTail = prev;
+        shard->fTail = prev;
     } else {
         next->fPrev = prev;
     }
@@ -327,77 +434,81 @@ void SkResourceCache::release(Rec* rec) {
     rec->fNext = rec->fPrev = nullptr;
 }
 
-void SkResourceCache::moveToHead(Rec* rec) {
-    if (fHead == rec) {
+void SkResourceCache::moveToHead(Shard* shard, Rec* rec) {
+    if (shard->fHead == rec) {
         return;
     }
 
-    SkASSERT(fHead);
-    SkASSERT(fTail);
+    SkASSERT(shard->fHead);
+    SkASSERT(shard->fTail);
 
-    this->validate();
+    this->validate(shard);
 
-    this->release(rec);
+    this->release(shard, rec);
 
-    fHead->fPrev = rec;
-    rec->fNext = fHead;
-    fHead = rec;
+    shard->fHead->fPrev = rec;
+    rec->fNext = shard->fHead;
+    shard->fHead = rec;
 
-    this->validate();
+    this->validate(shard);
 }
 
-void SkResourceCache::addToHead(Rec* rec) {
-    this->validate();
+void SkResourceCache::addToHead(Shard* shard, Rec* rec) {
+    this->validate(shard);
 
     rec->fPrev = nullptr;
-    rec->fNext = fHead;
-    if (fHead) {
-        fHead->fPrev = rec;
+    rec->fNext = shard->fHead;
+    if (shard->fHead) {
+        shard->fHead->fPrev = rec;
     }
-    fHead = rec;
-    if (!fTail) {
-        fTail = rec;
+    shard->fHead = rec;
+    if (!shard->fTail) {
+        shard->fTail = rec;
     }
-    fTotalBytesUsed += rec->bytesUsed();
-    fCount += 1;
+    shard->fTotalBytesUsed += rec->bytesUsed();
+    shard->fCount += 1;
+    fTotalBytesUsed.fetch_add(rec->bytesUsed(), std::memory_order_relaxed);
+    fCount.fetch_add(1, std::memory_order_relaxed);
 
-    this->validate();
+    this->validate(shard);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 #ifdef SK_DEBUG
-void SkResourceCache::validate() const {
-    if (nullptr == fHead) {
-        SkASSERT(nullptr == fTail);
-        SkASSERT(0 == fTotalBytesUsed);
+void SkResourceCache::validate(const Shard* shard) const {
+    const Rec* head = shard->fHead;
+    const Rec* tail = shard->fTail;
+    if (nullptr == head) {
+        SkASSERT(nullptr == tail);
+        SkASSERT(0 == shard->fTotalBytesUsed);
         return;
     }
 
-    if (fHead == fTail) {
-        SkASSERT(nullptr == fHead->fPrev);
-        SkASSERT(nullptr == fHead->fNext);
-        SkASSERT(fHead->bytesUsed() == fTotalBytesUsed);
+    if (head == tail) {
+        SkASSERT(nullptr == head->fPrev);
+        SkASSERT(nullptr == head->fNext);
+        SkASSERT(head->bytesUsed() == shard->fTotalBytesUsed);
         return;
     }
 
-    SkASSERT(nullptr == fHead->fPrev);
-    SkASSERT(fHead->fNext);
-    SkASSERT(nullptr == fTail->fNext);
-    SkASSERT(fTail->fPrev);
+    SkASSERT(nullptr == head->fPrev);
+    SkASSERT(head->fNext);
+    SkASSERT(nullptr == tail->fNext);
+    SkASSERT(tail->fPrev);
 
     size_t used = 0;
     int count = 0;
-    const Rec* rec = fHead;
+    const Rec* rec = head;
     while (rec) {
         count += 1;
         used += rec->bytesUsed();
-        SkASSERT(used <= fTotalBytesUsed);
+        SkASSERT(used <= shard->fTotalBytesUsed);
         rec = rec->fNext;
     }
-    SkASSERT(fCount == count);
+    SkASSERT(shard->fCount == count);
 
-    rec = fTail;
+    rec = tail;
     while (rec) {
         SkASSERT(count > 0);
         count -= 1;
@@ -412,33 +523,35 @@ void SkResourceCache::validate() const {
 #endif
 
 void SkResourceCache::dump() const {
-    this->validate();
+    for (const Shard& shard : fShards) {
+        SkAutoSharedMutexShared lock(shard.fLock);
+        this->validate(&shard);
+    }
 
     SkDebugf("SkResourceCache: count=%d bytes=%zu %s\n",
-             fCount, fTotalBytesUsed, fDiscardableFactory ? "discardable" : "malloc");
+             fCount.load(std::memory_order_relaxed), this->getTotalBytesUsed(),
+             fDiscardableFactory ? "discardable" : "malloc");
 }
 
 size_t SkResourceCache::setSingleAllocationByteLimit(size_t newLimit) {
-    size_t oldLimit = fSingleAllocationByteLimit;
-    fSingleAllocationByteLimit = newLimit;
-    return oldLimit;
+    return fSingleAllocationByteLimit.exchange(newLimit, std::memory_order_relaxed);
 }
 
 size_t SkResourceCache::getSingleAllocationByteLimit() const {
-    return fSingleAllocationByteLimit;
+    return fSingleAllocationByteLimit.load(std::memory_order_relaxed);
 }
 
 size_t SkResourceCache::getEffectiveSingleAllocationByteLimit() const {
     // fSingleAllocationByteLimit == 0 means the caller is asking for our default
-    size_t limit = fSingleAllocationByteLimit;
+    size_t limit = this->getSingleAllocationByteLimit();
 
     // if we're not discardable (i.e. we are fixed-budget) then cap the single-limit
     // to our budget.
     if (nullptr == fDiscardableFactory) {
         if (0 == limit) {
-            limit = fTotalByteLimit;
+            limit = this->getTotalByteLimit();
         } else {
-            limit = std::min(limit, fTotalByteLimit);
+            limit = std::min(limit, this->getTotalByteLimit());
         }
     }
     return limit;
@@ -454,93 +567,72 @@ void SkResourceCache::checkMessages() {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-static SkResourceCache* gResourceCache = nullptr;
-static SkMutex& resource_cache_mutex() {
-    static SkMutex& mutex = *(new SkMutex);
-    return mutex;
-}
-
-/** Must hold resource_cache_mutex() when calling. */
 static SkResourceCache* get_cache() {
-    // resource_cache_mutex() is always held when this is called, so we don't need to be fancy in here.
-    resource_cache_mutex().assertHeld();
-    if (nullptr == gResourceCache) {
+    static SkOnce once;
+    static SkResourceCache* cache;
+    once([] {
 #ifdef SK_USE_DISCARDABLE_SCALEDIMAGECACHE
-        gResourceCache = new SkResourceCache(SkDiscardableMemory::Create);
+        cache = new SkResourceCache(SkDiscardableMemory::Create);
 #else
-        gResourceCache = new SkResourceCache(SK_DEFAULT_IMAGE_CACHE_LIMIT);
+        cache = new SkResourceCache(SK_DEFAULT_IMAGE_CACHE_LIMIT);
 #endif
-    }
-    return gResourceCache;
+    });
+    return cache;
 }
 
 size_t SkResourceCache::GetTotalBytesUsed() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     return get_cache()->getTotalBytesUsed();
 }
 
 size_t SkResourceCache::GetTotalByteLimit() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     return get_cache()->getTotalByteLimit();
 }
 
 size_t SkResourceCache::SetTotalByteLimit(size_t newLimit) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     return get_cache()->setTotalByteLimit(newLimit);
 }
 
 SkResourceCache::DiscardableFactory SkResourceCache::GetDiscardableFactory() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     return get_cache()->discardableFactory();
 }
 
 SkCachedData* SkResourceCache::NewCachedData(size_t bytes) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     return get_cache()->newCachedData(bytes);
 }
 
 void SkResourceCache::Dump() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     get_cache()->dump();
 }
 
 size_t SkResourceCache::SetSingleAllocationByteLimit(size_t size) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     return get_cache()->setSingleAllocationByteLimit(size);
 }
 
 size_t SkResourceCache::GetSingleAllocationByteLimit() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     return get_cache()->getSingleAllocationByteLimit();
 }
 
 size_t SkResourceCache::GetEffectiveSingleAllocationByteLimit() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     return get_cache()->getEffectiveSingleAllocationByteLimit();
 }
 
 void SkResourceCache::PurgeAll() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     return get_cache()->purgeAll();
 }
 
 void SkResourceCache::CheckMessages() {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     return get_cache()->checkMessages();
 }
 
 bool SkResourceCache::Find(const Key& key, FindVisitor visitor, void* context) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     return get_cache()->find(key, visitor, context);
 }
 
 void SkResourceCache::Add(Rec* rec, void* payload) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     get_cache()->add(rec, payload);
 }
 
 void SkResourceCache::VisitAll(Visitor visitor, void* context) {
-    SkAutoMutexExclusive am(resource_cache_mutex());
     get_cache()->visitAll(visitor, context);
 }
 
@@ -10,8 +10,12 @@
 
 #include "include/core/SkBitmap.h"
 #include "include/private/base/SkTDArray.h"
+#include "include/private/base/SkThreadAnnotations.h"
+#include "src/base/SkSharedMutex.h"
 #include "src/core/SkMessageBus.h"
 
+#include <atomic>
+
 class SkCachedData;
 class SkDiscardableMemory;
 class SkTraceMemoryDump;
@@ -19,12 +23,14 @@ class SkTraceMemoryDump;
 /**
  *  Cache object for bitmaps (with possible scale in X Y as part of the key).
  *
- *  Multiple caches can be instantiated, but each instance is not implicitly
- *  thread-safe, so if a given instance is to be shared across threads, the
- *  caller must manage the access itself (e.g. via a mutex).
+ *  Multiple caches can be instantiated, and each instance is thread-safe. Recs are spread across
+ *  kShardCount shards by key hash, each with its own LRU list, lookup table, and reader/writer
+ *  lock. find() only takes its shard's lock for reading, so lookups on different threads don't
+ *  wait on each other; adding, purging, and removing stale Recs take it for writing. The byte and
+ *  count budgets are shared by all the shards.
  *
- *  As a convenience, a global instance is also defined, which can be safely
- *  access across threads via the static methods (e.g. FindAndLock, etc.).
+ *  As a convenience, a global instance is also defined, which can be accessed via the static
+ *  methods (e.g. Find, Add, etc.).
  */
 class SkResourceCache {
 public:
@@ -106,6 +112,9 @@ public:
         Rec*    fNext;
         Rec*    fPrev;
 
+        // Set when find() hits this Rec, cleared when a purge gives it another trip round the LRU.
+        std::atomic<bool> fRecentlyUsed{false};
+
         friend class SkResourceCache;
     };
 
@@ -126,6 +135,9 @@ public:
      *  The return value determines what the cache will do with the Rec. If the function returns
      *  true, then the Rec is considered "valid". If false is returned, the Rec will be considered
      *  "stale" and will be purged from the cache.
+     *
+     *  Several threads may visit the same Rec at once, so the function must not modify the Rec or
+     *  anything it shares with other threads without its own synchronization.
      */
     typedef bool (*FindVisitor)(const Rec&, void* context);
 
@@ -221,8 +233,8 @@ public:
     void add(Rec*, void* payload = nullptr);
     void visitAll(Visitor, void* context);
 
-    size_t getTotalBytesUsed() const { return fTotalBytesUsed; }
-    size_t getTotalByteLimit() const { return fTotalByteLimit; }
+    size_t getTotalBytesUsed() const { return fTotalBytesUsed.load(std::memory_order_relaxed); }
+    size_t getTotalByteLimit() const { return fTotalByteLimit.load(std::memory_order_relaxed); }
 
     /**
      *  This is respected by SkBitmapProcState::possiblyScaleImage.
@@ -244,9 +256,7 @@ public:
 
     void purgeSharedID(uint64_t sharedID);
 
-    void purgeAll() {
-        this->purgeAsNeeded(true);
-    }
+    void purgeAll();
 
     DiscardableFactory discardableFactory() const { return fDiscardableFactory; }
 
@@ -258,36 +268,69 @@ public:
     void dump() const;
 
 private:
-    Rec*    fHead;
-    Rec*    fTail;
+    static constexpr int kShardCount = 16;
 
     class Hash;
-    Hash*   fHash;
+
+    struct Shard {
+        mutable SkSharedMutex fLock;
+        Rec*   fHead SK_GUARDED_BY(fLock) = nullptr;
+        Rec*   fTail SK_GUARDED_BY(fLock) = nullptr;
+        Hash*  fHash SK_GUARDED_BY(fLock) = nullptr;
+
+        size_t fTotalBytesUsed SK_GUARDED_BY(fLock) = 0;
+        int    fCount SK_GUARDED_BY(fLock) = 0;
+    };
+
+    Shard fShards[kShardCount];
 
     DiscardableFactory  fDiscardableFactory;
 
-    size_t  fTotalBytesUsed;
-    size_t  fTotalByteLimit;
-    size_t  fSingleAllocationByteLimit;
-    int     fCount;
+    // The sums of each shard's totals. Each shard adds its changes while holding its own lock, so
+    // these lag behind slightly while other threads are adding or removing Recs.
+    std::atomic<size_t> fTotalBytesUsed{0};
+    std::atomic<int>    fCount{0};
+
+    std::atomic<size_t> fTotalByteLimit{0};
+    std::atomic<size_t> fSingleAllocationByteLimit{0};
+
+    // Set while one thread is purging other shards, so others needn't pile in behind it.
+    std::atomic<bool>   fPurgingOtherShards{false};
 
     SkMessageBus<PurgeSharedIDMessage, uint32_t>::Inbox fPurgeSharedIDInbox;
 
+    Shard& shardFor(const Key&);
+
     void checkMessages();
-    void purgeAsNeeded(bool forcePurge = false);
+
+    // How much has to be purged to get back under budget. Returns false if nothing does.
+    bool purgeNeeded(size_t* bytesNeeded, int* countNeeded) const;
+
+    // Purge Recs from the LRU end of shard, stopping at stopAt, until bytesNeeded and countNeeded
+    // have been freed. Decrements bytesNeeded and countNeeded by what was purged.
+    void purgeShard(Shard* shard, size_t* bytesNeeded, int* countNeeded, const Rec* stopAt)
+            SK_REQUIRES(shard->fLock);
+
+    // Having just added to shard, purge it to get back under budget if needed. If that's not
+    // enough, purge the other shards too, unless another thread is already doing so.
+    void purgeAsNeeded(Shard* shard) SK_EXCLUDES(shard->fLock);
+
+    // Purge each shard in turn, starting after start, until bytesNeeded and countNeeded have
+    // been freed.
+    void purgeShards(const Shard* start, size_t bytesNeeded, int countNeeded);
 
     // linklist management
-    void moveToHead(Rec*);
-    void addToHead(Rec*);
-    void release(Rec*);
-    void remove(Rec*);
+    void moveToHead(Shard* shard, Rec*) SK_REQUIRES(shard->fLock);
+    void addToHead(Shard* shard, Rec*) SK_REQUIRES(shard->fLock);
+    void release(Shard* shard, Rec*) SK_REQUIRES(shard->fLock);
+    void remove(Shard* shard, Rec*) SK_REQUIRES(shard->fLock);
 
     void init();    // called by constructors
 
 #ifdef SK_DEBUG
-    void validate() const;
+    void validate(const Shard* shard) const SK_REQUIRES_SHARED(shard->fLock);
 #else
-    void validate() const {}
+    void validate(const Shard*) const {}
 #endif
 };
 #endif
@@ -25,6 +25,9 @@ typedef SkIRect SkXRect;
 
 extern std::atomic<bool> gSkUseAnalyticAA;
 extern std::atomic<bool> gSkForceAnalyticAA;
+// Fill anti-aliased paths (other than inverse fills) with the accumulation buffer scan converter
+// instead of analytic AA or supersampling.
+extern std::atomic<bool> gSkUseAccumulationAA;
 
 class AdditiveBlitter;
 
@@ -76,6 +79,12 @@ public:
     // Needed by SkRegion::setPath
     static void FillPath(const SkPath&, const SkRegion& clip, SkBlitter*);
 
+    // Lets tests run the accumulation scan converter without setting gSkUseAccumulationAA.
+    static void AccumulationFillPathForTesting(const SkPath& path, SkBlitter* blitter,
+                                               const SkIRect& pathIR, const SkIRect& clipBounds) {
+        AccumulationFillPath(path, blitter, pathIR, clipBounds);
+    }
+
 private:
     friend class SkAAClip;
     friend class SkRegion;
@@ -96,6 +105,8 @@ private:
                             const SkIRect& clipBounds, bool forceRLE);
     static void SAAFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& pathIR,
                             const SkIRect& clipBounds, bool forceRLE);
+    static void AccumulationFillPath(const SkPath& path, SkBlitter* blitter,
+                                     const SkIRect& pathIR, const SkIRect& clipBounds);
 };
 
 /** Assign an SkXRect from a SkIRect, by promoting the src rect's coordinates
@@ -0,0 +1,446 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkScanPriv.h"
+
+#include "include/core/SkPath.h"
+#include "include/core/SkPathTypes.h"
+#include "include/core/SkPoint.h"
+#include "include/core/SkRect.h"
+#include "include/private/base/SkAlign.h"
+#include "include/private/base/SkTArray.h"
+#include "include/private/base/SkTPin.h"
+#include "include/private/base/SkTemplates.h"
+#include "include/private/base/SkTo.h"
+#include "src/base/SkMathPriv.h"
+#include "src/base/SkVx.h"
+#include "src/core/SkBlitter.h"
+#include "src/core/SkGeometry.h"
+#include "src/core/SkLineClipper.h"
+#include "src/core/SkPathPriv.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace skia_private;
+
+/** @file
+    An accumulation buffer scan converter, in the style of many font rasterizers.
+
+    The path is flattened into lines, and each line adds the signed area it sweeps out to the
+    cells of an accumulation buffer, one row at a time. The coverage of a pixel is then the sum of
+    the cells up to and including it in its row, so a prefix sum across each row turns the buffer
+    into coverage.
+
+    We work on strips of kStripRows rows, and for each row keep a bitmask of the blocks of 8 cells
+    any line touched. Only those blocks are summed, converted to alpha, and cleared, 8 cells at a
+    time. Every cell between them is zero, so the pixels there all share the coverage at the end of
+    the last touched block, and go straight into the row's runs as a single run. That keeps the
+    cost of a row proportional to its edges rather than its width, like the other scan converters.
+
+    Unlike supersampling and analytic AA, coverage comes from the summed signed area rather than
+    from the winding number of each sample, so where contours overlap it's only approximate.
+ */
+
+namespace {
+
+constexpr int   kStripRows = 16;
+constexpr float kFlattenTolerance = 0.125f;  // in pixels
+constexpr int   kMaxSubdivisions = 256;
+
+using float8 = skvx::Vec<8, float>;
+
+struct Line {
+    float fX0, fY0, fX1, fY1;  // fY0 < fY1, with x relative to the left of the clip
+    float fDir;                // +1 if the line pointed down, -1 if up
+};
+
+// Flattens a path into Lines, clipped to the clip rect.
+class LineBuilder {
+public:
+    LineBuilder(const SkIRect& clip) : fClip(SkRect::Make(clip)) {}
+
+    void addPath(const SkPath& path) {
+        SkPoint start = {0, 0},
+                last  = {0, 0};
+        for (auto [verb, pts, w] : SkPathPriv::Iterate(path)) {
+            switch (verb) {
+                case SkPathVerb::kMove:
+                    this->addLine(last, start);
+                    start = last = pts[0];
+                    break;
+                case SkPathVerb::kLine:
+                    this->addLine(pts[0], pts[1]);
+                    last = pts[1];
+                    break;
+                case SkPathVerb::kQuad:
+                    this->addQuad(pts);
+                    last = pts[2];
+                    break;
+                case SkPathVerb::kConic: {
+                    SkAutoConicToQuads quadder;
+                    const SkPoint* quads = quadder.computeQuads(pts, *w, kFlattenTolerance);
+                    for (int i = 0; i < quadder.countQuads(); ++i) {
+                        this->addQuad(quads + 2 * i);
+                    }
+                    last = pts[2];
+                } break;
+                case SkPathVerb::kCubic:
+                    this->addCubic(pts);
+                    last = pts[3];
+                    break;
+                case SkPathVerb::kClose:
+                    break;
+            }
+        }
+        // Fills implicitly close every contour.
+        this->addLine(last, start);
+    }
+
+    TArray<Line>& lines() { return fLines; }
+
+private:
+    // Curves entirely above, below, or right of the clip can't affect it, and curves entirely
+    // left of it only matter through how far they move up or down.
+    bool cullCurve(const SkPoint pts[], int count) {
+        SkRect bounds;
+        bounds.setBounds(pts, count);
+        if (bounds.fBottom <= fClip.fTop || bounds.fTop >= fClip.fBottom ||
+            bounds.fLeft >= fClip.fRight) {
+            return true;
+        }
+        if (bounds.fRight <= fClip.fLeft) {
+            this->addLine(pts[0], pts[count - 1]);
+            return true;
+        }
+        return false;
+    }
+
+    static int subdivisions(float errorScale) {
+        return SkTPin(SkScalarCeilToInt(std::sqrt(errorScale / kFlattenTolerance)),
+                      1, kMaxSubdivisions);
+    }
+
+    void addQuad(const SkPoint pts[3]) {
+        if (this->cullCurve(pts, 3)) {
+            return;
+        }
+        // Flattening into n lines is off by at most |p0 - 2p1 + p2| / (4n^2).
+        const int n = subdivisions((pts[0] - pts[1] * 2 + pts[2]).length() / 4);
+        SkQuadCoeff quad(pts);
+        SkPoint prev = pts[0];
+        for (int i = 1; i < n; ++i) {
+            SkPoint next = to_point(quad.eval(skvx::float2(i / (float)n)));
+            this->addLine(prev, next);
+            prev = next;
+        }
+        this->addLine(prev, pts[2]);
+    }
+
+    void addCubic(const SkPoint pts[4]) {
+        if (this->cullCurve(pts, 4)) {
+            return;
+        }
+        // Flattening into n lines is off by at most 3*max(|p0 - 2p1 + p2|, |p1 - 2p2 + p3|)/(4n^2).
+        const float dd = std::max((pts[0] - pts[1] * 2 + pts[2]).length(),
+                                  (pts[1] - pts[2] * 2 + pts[3]).length());
+        const int n = subdivisions(3 * dd / 4);
+        SkCubicCoeff cubic(pts);
+        SkPoint prev = pts[0];
+        for (int i = 1; i < n; ++i) {
+            SkPoint next = to_point(cubic.eval(skvx::float2(i / (float)n)));
+            this->addLine(prev, next);
+            prev = next;
+        }
+        this->addLine(prev, pts[3]);
+    }
+
+    void addLine(SkPoint p0, SkPoint p1) {
+        // The parts of lines left of the clip become vertical lines along its left edge, and we
+        // can drop the parts right of it: those only change coverage further right.
+        SkPoint src[2] = {p0, p1},
+                clipped[SkLineClipper::kMaxPoints];
+        int count = SkLineClipper::ClipLine(src, fClip, clipped, /*canCullToTheRight=*/true);
+        for (int i = 0; i < count; ++i) {
+            SkPoint a = clipped[i],
+                    b = clipped[i + 1];
+            if (a.fY == b.fY) {
+                continue;
+            }
+            float dir = 1;
+            if (a.fY > b.fY) {
+                std::swap(a, b);
+                dir = -1;
+            }
+            fLines.push_back({a.fX - fClip.fLeft, a.fY, b.fX - fClip.fLeft, b.fY, dir});
+        }
+    }
+
+    const SkRect fClip;
+    TArray<Line> fLines;
+};
+
+// Sums v across its lanes, so lane i holds v[0] + ... + v[i].
+static float8 prefix_sum(float8 v) {
+    const float8 zero = 0;
+    v += skvx::shuffle<7,8,9,10,11,12,13,14>(skvx::join(zero, v));
+    v += skvx::shuffle<6,7,8,9,10,11,12,13>(skvx::join(zero, v));
+    v += skvx::shuffle<4,5,6,7,8,9,10,11>(skvx::join(zero, v));
+    return v;
+}
+
+template <typename T>
+static T coverage(const T& area, bool evenOdd) {
+    T a = abs(area);
+    if (evenOdd) {
+        a = a - 2 * floor(a * 0.5f);
+        return min(a, 2 - a);
+    }
+    return min(a, 1);
+}
+
+static SkAlpha to_alpha(float area, bool evenOdd) {
+    return SkTo<SkAlpha>((int)(coverage(skvx::Vec<1, float>(area), evenOdd)[0] * 255 + 0.5f));
+}
+
+class AccumulationRasterizer {
+public:
+    AccumulationRasterizer(const SkIRect& bounds, bool evenOdd, SkBlitter* blitter)
+            : fBounds(bounds)
+            , fWidth(bounds.width())
+            // Lines touch cells [0, fWidth + 1], and we sum 8 cells at a time.
+            , fStride(SkAlign8(fWidth + 2))
+            , fBlockWords((fStride / 8 + 31) / 32)
+            , fEvenOdd(evenOdd)
+            , fBlitter(blitter)
+            , fCells(kStripRows * fStride)
+            , fTouched(kStripRows * fBlockWords)
+            , fRunAlphas(fWidth + 1)
+            , fRuns(fWidth + 1) {
+        sk_bzero(fCells.get(),   kStripRows * fStride     * sizeof(float));
+        sk_bzero(fTouched.get(), kStripRows * fBlockWords * sizeof(uint32_t));
+    }
+
+    void draw(TArray<Line>& lines) {
+        std::sort(lines.begin(), lines.end(), [](const Line& a, const Line& b) {
+            return a.fY0 < b.fY0;
+        });
+
+        TArray<int> active;
+        int next = 0;
+        int stripTop = fBounds.fTop;
+        while (stripTop < fBounds.fBottom) {
+            if (active.empty()) {
+                if (next == lines.size()) {
+                    break;
+                }
+                // Skip ahead to the next line.
+                stripTop = std::max(stripTop, (int)std::floor(lines[next].fY0));
+            }
+            const int stripBottom = std::min(fBounds.fBottom, stripTop + kStripRows);
+            while (next < lines.size() && lines[next].fY0 < stripBottom) {
+                active.push_back(next++);
+            }
+
+            int keep = 0;
+            for (int index : active) {
+                const Line& line = lines[index];
+                this->accumulate(line, stripTop, stripBottom);
+                if (line.fY1 > stripBottom) {
+                    active[keep++] = index;
+                }
+            }
+            active.resize(keep);
+
+            for (int y = stripTop; y < stripBottom; ++y) {
+                this->resolveRow(y, y - stripTop);
+            }
+            stripTop = stripBottom;
+        }
+    }
+
+private:
+    // Adds the signed area of line between rows top and bottom to the cells.
+    void accumulate(const Line& line, int top, int bottom) {
+        const int rowTop    = std::max(top,    (int)std::floor(line.fY0)),
+                  rowBottom = std::min(bottom, (int)std::ceil (line.fY1));
+        const float dxdy = (line.fX1 - line.fX0) / (line.fY1 - line.fY0);
+        const float maxX = (float)fWidth;
+
+        for (int y = rowTop; y < rowBottom; ++y) {
+            const float y0 = std::max((float)y,       line.fY0),
+                        y1 = std::min((float)(y + 1), line.fY1);
+            if (y0 >= y1) {
+                continue;
+            }
+            float x0 = SkTPin(line.fX0 + (y0 - line.fY0) * dxdy, 0.0f, maxX),
+                  x1 = SkTPin(line.fX0 + (y1 - line.fY0) * dxdy, 0.0f, maxX);
+            if (x0 > x1) {
+                std::swap(x0, x1);
+            }
+            this->accumulateRow(y - top, x0, x1, (y1 - y0) * line.fDir);
+        }
+    }
+
+    // Adds the area to the right of the segment from x0 to x1 (x0 <= x1) within one row, scaled
+    // by the signed height d it spans.
+    void accumulateRow(int row, float x0, float x1, float d) {
+        float* cells = fCells.get() + row * fStride;
+        const int i0 = (int)std::floor(x0),
+                  i1 = (int)std::ceil (x1);
+
+        if (i1 <= i0 + 1) {
+            // The segment is within one pixel: split its area between it and the next cell.
+            const float mid = 0.5f * (x0 + x1) - i0;
+            cells[i0]     += d * (1 - mid);
+            cells[i0 + 1] += d * mid;
+            this->touch(row, i0, i0 + 1);
+            return;
+        }
+
+        // The segment crosses several pixels: the first and last get a triangle of area, and the
+        // rest each get an equal slice.
+        const float s  = 1 / (x1 - x0),
+                    f0 = x0 - i0,
+                    f1 = x1 - (i1 - 1),
+                    a0 = 0.5f * s * (1 - f0) * (1 - f0),
+                    am = 0.5f * s * f1 * f1;
+        cells[i0] += d * a0;
+        if (i1 == i0 + 2) {
+            cells[i0 + 1] += d * (1 - a0 - am);
+        } else {
+            const float a1 = s * (1.5f - f0);
+            cells[i0 + 1] += d * (a1 - a0);
+
+            const float ds = d * s;
+            int i = i0 + 2;
+            for (; i + 8 <= i1 - 1; i += 8) {
+                (float8::Load(cells + i) + ds).store(cells + i);
+            }
+            for (; i < i1 - 1; ++i) {
+                cells[i] += ds;
+            }
+
+            const float a2 = a1 + (i1 - i0 - 3) * s;
+            cells[i1 - 1] += d * (1 - a2 - am);
+        }
+        cells[i1] += d * am;
+        this->touch(row, i0, i1);
+    }
+
+    // Marks the blocks holding cells [left, right] of the row as touched.
+    void touch(int row, int left, int right) {
+        uint32_t* touched = fTouched.get() + row * fBlockWords;
+        for (int block = left / 8; block <= right / 8; ++block) {
+            touched[block / 32] |= 1u << (block % 32);
+        }
+    }
+
+    // Turns the accumulated area for one row into coverage and blits it, clearing the cells.
+    void resolveRow(int y, int row) {
+        float*    cells   = fCells.get()   + row * fStride;
+        uint32_t* touched = fTouched.get() + row * fBlockWords;
+        fRunLeft = -1;
+
+        float sum = 0;
+        int x = 0;  // Pixels left of x are in the runs.
+        for (int word = 0; word < fBlockWords; ++word) {
+            for (uint32_t bits = touched[word]; bits; bits &= bits - 1) {
+                const int blockX = (word * 32 + SkCTZ(bits)) * 8;
+                if (blockX > x) {
+                    this->addRun(x, blockX - x, to_alpha(sum, fEvenOdd));
+                }
+
+                float8 area = prefix_sum(float8::Load(cells + blockX)) + sum;
+                sum = area[7];
+                float8(0).store(cells + blockX);
+
+                SkAlpha alphas[8];
+                skvx::cast<uint8_t>(skvx::cast<int32_t>(coverage(area, fEvenOdd) * 255 + 0.5f))
+                        .store(alphas);
+                for (int i = 0; i < 8; ++i) {
+                    this->addRun(blockX + i, 1, alphas[i]);
+                }
+                x = blockX + 8;
+            }
+            touched[word] = 0;
+        }
+        if (x < fWidth) {
+            this->addRun(x, fWidth - x, to_alpha(sum, fEvenOdd));
+        }
+
+        if (fRunLeft < 0) {
+            return;  // Nothing but zero coverage.
+        }
+        // Drop any zero coverage on the right; the runs end where it starts.
+        const int end = fRunAlphas[fLastRun] == 0 ? fLastRun : fRunRight - fRunLeft;
+        fRuns[end] = 0;
+        fBlitter->blitAntiH(fBounds.fLeft + fRunLeft, y, fRunAlphas.get(), fRuns.get());
+    }
+
+    // Appends n pixels of alpha at x to the row's runs, skipping zero coverage on the left and
+    // merging with the last run when the alphas match.
+    void addRun(int x, int n, SkAlpha alpha) {
+        n = std::min(n, fWidth - x);
+        if (n <= 0) {
+            return;
+        }
+        if (fRunLeft < 0) {
+            if (alpha == 0) {
+                return;
+            }
+            fRunLeft = x;
+            fLastRun = -1;
+        }
+        SkASSERT(x == fRunRight || fLastRun < 0);
+        if (fLastRun >= 0 && fRunAlphas[fLastRun] == alpha) {
+            fRuns[fLastRun] = SkToS16(fRuns[fLastRun] + n);
+        } else {
+            fLastRun = x - fRunLeft;
+            fRuns     [fLastRun] = SkToS16(n);
+            fRunAlphas[fLastRun] = alpha;
+        }
+        fRunRight = x + n;
+    }
+
+    const SkIRect   fBounds;
+    const int       fWidth;
+    const int       fStride;
+    const int       fBlockWords;  // uint32_t per row of fTouched
+    const bool      fEvenOdd;
+    SkBlitter*      fBlitter;
+
+    AutoTMalloc<float>    fCells;      // kStripRows rows of fStride cells
+    AutoTMalloc<uint32_t> fTouched;    // kStripRows rows of bits, one per block of 8 cells
+    AutoTMalloc<SkAlpha>  fRunAlphas;  // the current row, run length encoded
+    AutoTMalloc<int16_t>  fRuns;
+
+    // The current row's runs cover pixels [fRunLeft, fRunRight), and the last starts at fLastRun
+    // (relative to fRunLeft). fRunLeft is -1 until we see some coverage.
+    int fRunLeft  = -1,
+        fRunRight = 0,
+        fLastRun  = -1;
+};
+
+}  // namespace
+
+void SkScan::AccumulationFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& ir,
+                                  const SkIRect& clipBounds) {
+    SkASSERT(!path.isInverseFillType());
+
+    SkIRect bounds;
+    if (!bounds.intersect(ir, clipBounds)) {
+        return;
+    }
+
+    LineBuilder builder(bounds);
+    builder.addPath(path);
+
+    const bool evenOdd = path.getFillType() == SkPathFillType::kEvenOdd;
+    AccumulationRasterizer(bounds, evenOdd, blitter).draw(builder.lines());
+}
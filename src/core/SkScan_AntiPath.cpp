@@ -146,7 +146,9 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
         sk_blit_above(blitter, ir, *clipRgn);
     }
 
-    if (ShouldUseAAA(path)) {
+    if (gSkUseAccumulationAA && !isInverse) {
+        SkScan::AccumulationFillPath(path, blitter, ir, clipRgn->getBounds());
+    } else if (ShouldUseAAA(path)) {
         // Do not use AAA if path is too complicated:
         // there won't be any speedup or significant visual improvement.
         SkScan::AAAFillPath(path, blitter, ir, clipRgn->getBounds(), forceRLE);
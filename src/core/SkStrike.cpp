@@ -445,12 +445,14 @@ SkSpan<const SkGlyph*> SkStrike::internalPrepare(
 
 void SkStrike::updateMemoryUsage(size_t increase) {
     if (increase > 0) {
-        // fRemoved and the cache's total memory are managed under the cache's lock. This allows
+        // fRemoved and the shard's total memory are managed under the shard's lock. This allows
         // them to be accessed under LRU operation.
-        SkAutoMutexExclusive lock{fStrikeCache->fLock};
+        SkStrikeCache::Shard& shard = fStrikeCache->shardFor(this->getDescriptor());
+        SkAutoMutexExclusive lock{shard.fLock};
         fMemoryUsed += increase;
         if (!fRemoved) {
-            fStrikeCache->fTotalMemoryUsed += increase;
+            shard.fTotalMemoryUsed += increase;
+            fStrikeCache->fTotalMemoryUsed.fetch_add(increase, std::memory_order_relaxed);
         }
     }
 }
@@ -197,7 +197,7 @@ private:
 
     SkArenaAlloc            fAlloc SK_GUARDED_BY(fStrikeLock) {kMinAllocAmount};
 
-    // The following are protected by the SkStrikeCache's mutex.
+    // The following are protected by the mutex of this strike's SkStrikeCache shard.
     SkStrike*                       fNext{nullptr};
     SkStrike*                       fPrev{nullptr};
     std::unique_ptr<SkStrikePinner> fPinner;
@@ -12,7 +12,10 @@
 #include "include/core/SkTraceMemoryDump.h"
 #include "include/private/base/SkAssert.h"
 #include "include/private/base/SkDebug.h"
+#include "include/private/base/SkMath.h"
 #include "include/private/base/SkMutex.h"
+#include "include/private/base/SkTo.h"
+#include "src/base/SkMathPriv.h"
 #include "src/core/SkDescriptor.h"
 #include "src/core/SkStrike.h"
 #include "src/core/SkStrikeSpec.h"
@@ -37,12 +40,16 @@ SkStrikeCache* SkStrikeCache::GlobalStrikeCache() {
 }
 
 auto SkStrikeCache::findOrCreateStrike(const SkStrikeSpec& strikeSpec) -> sk_sp<SkStrike> {
-    SkAutoMutexExclusive ac(fLock);
-    sk_sp<SkStrike> strike = this->internalFindStrikeOrNull(strikeSpec.descriptor());
-    if (strike == nullptr) {
-        strike = this->internalCreateStrike(strikeSpec);
+    Shard& shard = this->shardFor(strikeSpec.descriptor());
+    sk_sp<SkStrike> strike;
+    {
+        SkAutoMutexExclusive ac(shard.fLock);
+        strike = this->internalFindStrikeOrNull(&shard, strikeSpec.descriptor());
+        if (strike == nullptr) {
+            strike = this->internalCreateStrike(&shard, strikeSpec);
+        }
     }
-    this->internalPurge();
+    this->purge(&shard);
     return strike;
 }
 
@@ -90,34 +97,47 @@ void SkStrikeCache::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
 }
 
 sk_sp<SkStrike> SkStrikeCache::findStrike(const SkDescriptor& desc) {
-    SkAutoMutexExclusive ac(fLock);
-    sk_sp<SkStrike> result = this->internalFindStrikeOrNull(desc);
-    this->internalPurge();
+    Shard& shard = this->shardFor(desc);
+    sk_sp<SkStrike> result;
+    {
+        SkAutoMutexExclusive ac(shard.fLock);
+        result = this->internalFindStrikeOrNull(&shard, desc);
+    }
+    this->purge(&shard);
     return result;
 }
 
-auto SkStrikeCache::internalFindStrikeOrNull(const SkDescriptor& desc) -> sk_sp<SkStrike> {
+auto SkStrikeCache::shardFor(const SkDescriptor& desc) -> Shard& {
+    // The lookup tables index with the low bits of the checksum, so shard with the high bits.
+    static_assert(SkIsPow2(kShardCount));
+    static constexpr int kShardShift = 32 - SkNextLog2_portable(kShardCount);
+    return fShards[desc.getChecksum() >> kShardShift];
+}
+
+auto SkStrikeCache::internalFindStrikeOrNull(Shard* shard, const SkDescriptor& desc)
+        -> sk_sp<SkStrike> {
 
     // Check head because it is likely the strike we are looking for.
-    if (fHead != nullptr && fHead->getDescriptor() == desc) { return sk_ref_sp(fHead); }
+    SkStrike* head = shard->fHead;
+    if (head != nullptr && head->getDescriptor() == desc) { return sk_ref_sp(head); }
 
     // Do the heavy search looking for the strike.
-    sk_sp<SkStrike>* strikeHandle = fStrikeLookup.find(desc);
+    sk_sp<SkStrike>* strikeHandle = shard->fStrikeLookup.find(desc);
     if (strikeHandle == nullptr) { return nullptr; }
     SkStrike* strikePtr = strikeHandle->get();
     SkASSERT(strikePtr != nullptr);
-    if (fHead != strikePtr) {
+    if (head != strikePtr) {
         // Make most recently used
         strikePtr->fPrev->fNext = strikePtr->fNext;
         if (strikePtr->fNext != nullptr) {
             strikePtr->fNext->fPrev = strikePtr->fPrev;
         } else {
-            fTail = strikePtr->fPrev;
+            shard->fTail = strikePtr->fPrev;
         }
-        fHead->fPrev = strikePtr;
-        strikePtr->fNext = fHead;
+        head->fPrev = strikePtr;
+        strikePtr->fNext = head;
         strikePtr->fPrev = nullptr;
-        fHead = strikePtr;
+        shard->fHead = strikePtr;
     }
     return sk_ref_sp(strikePtr);
 }
@@ -126,58 +146,66 @@ sk_sp<SkStrike> SkStrikeCache::createStrike(
         const SkStrikeSpec& strikeSpec,
         SkFontMetrics* maybeMetrics,
         std::unique_ptr<SkStrikePinner> pinner) {
-    SkAutoMutexExclusive ac(fLock);
-    return this->internalCreateStrike(strikeSpec, maybeMetrics, std::move(pinner));
+    Shard& shard = this->shardFor(strikeSpec.descriptor());
+    SkAutoMutexExclusive ac(shard.fLock);
+    return this->internalCreateStrike(&shard, strikeSpec, maybeMetrics, std::move(pinner));
 }
 
 auto SkStrikeCache::internalCreateStrike(
+        Shard* shard,
         const SkStrikeSpec& strikeSpec,
         SkFontMetrics* maybeMetrics,
         std::unique_ptr<SkStrikePinner> pinner) -> sk_sp<SkStrike> {
     std::unique_ptr<SkScalerContext> scaler = strikeSpec.createScalerContext();
     auto strike =
         sk_make_sp<SkStrike>(this, strikeSpec, std::move(scaler), maybeMetrics, std::move(pinner));
-    this->internalAttachToHead(strike);
+    this->internalAttachToHead(shard, strike);
     return strike;
 }
 
 void SkStrikeCache::purgePinned(size_t minBytesNeeded) {
-    SkAutoMutexExclusive ac(fLock);
-    this->internalPurge(minBytesNeeded, /* checkPinners= */ true);
+    size_t bytesNeeded;
+    int countNeeded;
+    if (this->purgeNeeded(minBytesNeeded, &bytesNeeded, &countNeeded)) {
+        this->purgeShards(nullptr, bytesNeeded, countNeeded, /* checkPinners= */ true);
+    }
+}
+
+void SkStrikeCache::purgeToBudget() {
+    size_t bytesNeeded;
+    int countNeeded;
+    if (this->purgeNeeded(0, &bytesNeeded, &countNeeded)) {
+        this->purgeShards(nullptr, bytesNeeded, countNeeded, /* checkPinners= */ false);
+    }
 }
 
 void SkStrikeCache::purgeAll() {
-    SkAutoMutexExclusive ac(fLock);
-    this->internalPurge(fTotalMemoryUsed, /* checkPinners= */ true);
+    for (Shard& shard : fShards) {
+        SkAutoMutexExclusive ac(shard.fLock);
+        this->internalPurge(&shard, shard.fTotalMemoryUsed, 0, /* checkPinners= */ true);
+    }
 }
 
 size_t SkStrikeCache::getTotalMemoryUsed() const {
-    SkAutoMutexExclusive ac(fLock);
-    return fTotalMemoryUsed;
+    return fTotalMemoryUsed.load(std::memory_order_relaxed);
 }
 
 int SkStrikeCache::getCacheCountUsed() const {
-    SkAutoMutexExclusive ac(fLock);
-    return fCacheCount;
+    return fCacheCount.load(std::memory_order_relaxed);
 }
 
 int SkStrikeCache::getCacheCountLimit() const {
-    SkAutoMutexExclusive ac(fLock);
-    return fCacheCountLimit;
+    return fCacheCountLimit.load(std::memory_order_relaxed);
 }
 
 size_t SkStrikeCache::setCacheSizeLimit(size_t newLimit) {
-    SkAutoMutexExclusive ac(fLock);
-
-    size_t prevLimit = fCacheSizeLimit;
-    fCacheSizeLimit = newLimit;
-    this->internalPurge();
+    size_t prevLimit = fCacheSizeLimit.exchange(newLimit, std::memory_order_relaxed);
+    this->purgeToBudget();
     return prevLimit;
 }
 
 size_t  SkStrikeCache::getCacheSizeLimit() const {
-    SkAutoMutexExclusive ac(fLock);
-    return fCacheSizeLimit;
+    return fCacheSizeLimit.load(std::memory_order_relaxed);
 }
 
 int SkStrikeCache::setCacheCountLimit(int newCount) {
@@ -185,50 +213,109 @@ int SkStrikeCache::setCacheCountLimit(int newCount) {
         newCount = 0;
     }
 
-    SkAutoMutexExclusive ac(fLock);
-
-    int prevCount = fCacheCountLimit;
-    fCacheCountLimit = newCount;
-    this->internalPurge();
+    int prevCount = fCacheCountLimit.exchange(newCount, std::memory_order_relaxed);
+    this->purgeToBudget();
     return prevCount;
 }
 
 void SkStrikeCache::forEachStrike(std::function<void(const SkStrike&)> visitor) const {
-    SkAutoMutexExclusive ac(fLock);
+    for (const Shard& shard : fShards) {
+        SkAutoMutexExclusive ac(shard.fLock);
 
-    this->validate();
+        this->validate(&shard);
 
-    for (SkStrike* strike = fHead; strike != nullptr; strike = strike->fNext) {
-        visitor(*strike);
+        for (SkStrike* strike = shard.fHead; strike != nullptr; strike = strike->fNext) {
+            visitor(*strike);
+        }
     }
 }
 
-size_t SkStrikeCache::internalPurge(size_t minBytesNeeded, bool checkPinners) {
-#ifndef SK_STRIKE_CACHE_DOESNT_AUTO_CHECK_PINNERS
-    // Temporarily default to checking pinners, for staging.
-    checkPinners = true;
-#endif
-
-    if (fPinnerCount == fCacheCount && !checkPinners)
-        return 0;
-
-    size_t bytesNeeded = 0;
-    if (fTotalMemoryUsed > fCacheSizeLimit) {
-        bytesNeeded = fTotalMemoryUsed - fCacheSizeLimit;
+bool SkStrikeCache::purgeNeeded(size_t minBytesNeeded,
+                                size_t* bytesNeeded,
+                                int* countNeeded) const {
+    const size_t totalMemoryUsed = fTotalMemoryUsed.load(std::memory_order_relaxed),
+                 cacheSizeLimit  = fCacheSizeLimit .load(std::memory_order_relaxed);
+    const int32_t cacheCount      = fCacheCount     .load(std::memory_order_relaxed),
+                  cacheCountLimit = fCacheCountLimit.load(std::memory_order_relaxed);
+
+    *bytesNeeded = 0;
+    if (totalMemoryUsed > cacheSizeLimit) {
+        *bytesNeeded = totalMemoryUsed - cacheSizeLimit;
     }
-    bytesNeeded = std::max(bytesNeeded, minBytesNeeded);
-    if (bytesNeeded) {
+    *bytesNeeded = std::max(*bytesNeeded, minBytesNeeded);
+    if (*bytesNeeded) {
         // no small purges!
-        bytesNeeded = std::max(bytesNeeded, fTotalMemoryUsed >> 2);
+        *bytesNeeded = std::max(*bytesNeeded, totalMemoryUsed >> 2);
     }
 
-    int countNeeded = 0;
-    if (fCacheCount > fCacheCountLimit) {
-        countNeeded = fCacheCount - fCacheCountLimit;
+    *countNeeded = 0;
+    if (cacheCount > cacheCountLimit) {
+        *countNeeded = cacheCount - cacheCountLimit;
         // no small purges!
-        countNeeded = std::max(countNeeded, fCacheCount >> 2);
+        *countNeeded = std::max(*countNeeded, cacheCount >> 2);
     }
 
+    return *bytesNeeded || *countNeeded;
+}
+
+void SkStrikeCache::purge(Shard* shard) {
+    size_t bytesNeeded;
+    int countNeeded;
+    if (!this->purgeNeeded(0, &bytesNeeded, &countNeeded)) {
+        return;
+    }
+
+    // Try the shard we just used first; it's the only lock we know is likely free.
+    {
+        SkAutoMutexExclusive ac(shard->fLock);
+        const int countBefore = shard->fCacheCount;
+        bytesNeeded -= std::min(bytesNeeded, this->internalPurge(shard, bytesNeeded, countNeeded,
+                                                                 /* checkPinners= */ false));
+        countNeeded -= std::min(countNeeded, countBefore - shard->fCacheCount);
+    }
+    if (!bytesNeeded && !countNeeded) {
+        return;
+    }
+
+    // Only one thread needs to purge the other shards. If one already is, leave it to them.
+    if (fPurgingOtherShards.exchange(true, std::memory_order_acquire)) {
+        return;
+    }
+    this->purgeShards(shard, bytesNeeded, countNeeded, /* checkPinners= */ false);
+    fPurgingOtherShards.store(false, std::memory_order_release);
+}
+
+void SkStrikeCache::purgeShards(const Shard* skip,
+                                size_t bytesNeeded,
+                                int countNeeded,
+                                bool checkPinners) {
+    // Start after skip, so purges triggered from different shards spread across the others.
+    const int start = skip ? SkToInt(skip - fShards) + 1 : 0;
+    for (int i = 0; i < kShardCount && (bytesNeeded || countNeeded); i++) {
+        Shard* shard = &fShards[(start + i) % kShardCount];
+        if (shard == skip) {
+            continue;
+        }
+        SkAutoMutexExclusive ac(shard->fLock);
+        const int countBefore = shard->fCacheCount;
+        bytesNeeded -= std::min(bytesNeeded, this->internalPurge(shard, bytesNeeded, countNeeded,
+                                                                 checkPinners));
+        countNeeded -= std::min(countNeeded, countBefore - shard->fCacheCount);
+    }
+}
+
+size_t SkStrikeCache::internalPurge(Shard* shard,
+                                    size_t bytesNeeded,
+                                    int countNeeded,
+                                    bool checkPinners) {
+#ifndef SK_STRIKE_CACHE_DOESNT_AUTO_CHECK_PINNERS
+    // Temporarily default to checking pinners, for staging.
+    checkPinners = true;
+#endif
+
+    if (shard->fPinnerCount == shard->fCacheCount && !checkPinners)
+        return 0;
+
     // early exit
     if (!countNeeded && !bytesNeeded) {
         return 0;
@@ -239,7 +326,7 @@ size_t SkStrikeCache::internalPurge(size_t minBytesNeeded, bool checkPinners) {
 
     // Start at the tail and proceed backwards deleting; the list is in LRU
     // order, with unimportant entries at the tail.
-    SkStrike* strike = fTail;
+    SkStrike* strike = shard->fTail;
     while (strike != nullptr && (bytesFreed < bytesNeeded || countFreed < countNeeded)) {
         SkStrike* prev = strike->fPrev;
 
@@ -247,12 +334,12 @@ size_t SkStrikeCache::internalPurge(size_t minBytesNeeded, bool checkPinners) {
         if (strike->fPinner == nullptr || (checkPinners && strike->fPinner->canDelete())) {
             bytesFreed += strike->fMemoryUsed;
             countFreed += 1;
-            this->internalRemoveStrike(strike);
+            this->internalRemoveStrike(shard, strike);
         }
         strike = prev;
     }
 
-    this->validate();
+    this->validate(shard);
 
 #ifdef SPEW_PURGE_STATUS
     if (countFreed) {
@@ -264,69 +351,74 @@ size_t SkStrikeCache::internalPurge(size_t minBytesNeeded, bool checkPinners) {
     return bytesFreed;
 }
 
-void SkStrikeCache::internalAttachToHead(sk_sp<SkStrike> strike) {
-    SkASSERT(fStrikeLookup.find(strike->getDescriptor()) == nullptr);
+void SkStrikeCache::internalAttachToHead(Shard* shard, sk_sp<SkStrike> strike) {
+    SkASSERT(shard->fStrikeLookup.find(strike->getDescriptor()) == nullptr);
     SkStrike* strikePtr = strike.get();
-    fStrikeLookup.set(std::move(strike));
+    shard->fStrikeLookup.set(std::move(strike));
     SkASSERT(nullptr == strikePtr->fPrev && nullptr == strikePtr->fNext);
 
-    fCacheCount += 1;
-    fPinnerCount += strikePtr->fPinner != nullptr ? 1 : 0;
-    fTotalMemoryUsed += strikePtr->fMemoryUsed;
+    shard->fCacheCount += 1;
+    shard->fPinnerCount += strikePtr->fPinner != nullptr ? 1 : 0;
+    shard->fTotalMemoryUsed += strikePtr->fMemoryUsed;
+    fCacheCount.fetch_add(1, std::memory_order_relaxed);
+    fTotalMemoryUsed.fetch_add(strikePtr->fMemoryUsed, std::memory_order_relaxed);
 
-    if (fHead != nullptr) {
-        fHead->fPrev = strikePtr;
-        strikePtr->fNext = fHead;
+    if (shard->fHead != nullptr) {
+        shard->fHead->fPrev = strikePtr;
+        strikePtr->fNext = shard->fHead;
     }
 
-    if (fTail == nullptr) {
-        fTail = strikePtr;
+    if (shard->fTail == nullptr) {
+        shard->fTail = strikePtr;
     }
 
-    fHead = strikePtr; // Transfer ownership of strike to the cache list.
+    shard->fHead = strikePtr; // Transfer ownership of strike to the cache list.
 }
 
-void SkStrikeCache::internalRemoveStrike(SkStrike* strike) {
-    SkASSERT(fCacheCount > 0);
-    fCacheCount -= 1;
-    fPinnerCount -= strike->fPinner != nullptr ? 1 : 0;
-    fTotalMemoryUsed -= strike->fMemoryUsed;
+void SkStrikeCache::internalRemoveStrike(Shard* shard, SkStrike* strike) {
+    SkASSERT(shard->fCacheCount > 0);
+    shard->fCacheCount -= 1;
+    shard->fPinnerCount -= strike->fPinner != nullptr ? 1 : 0;
+    shard->fTotalMemoryUsed -= strike->fMemoryUsed;
+    fCacheCount.fetch_sub(1, std::memory_order_relaxed);
+    fTotalMemoryUsed.fetch_sub(strike->fMemoryUsed, std::memory_order_relaxed);
 
     if (strike->fPrev) {
         strike->fPrev->fNext = strike->fNext;
     } else {
-        fHead = strike->fNext;
+        shard->fHead = strike->fNext;
     }
     if (strike->fNext) {
         strike->fNext->fPrev = strike->fPrev;
     } else {
-        fTail = strike->fPrev;
+        shard->fTail = strike->fPrev;
     }
 
     strike->fPrev = strike->fNext = nullptr;
     strike->fRemoved = true;
-    fStrikeLookup.remove(strike->getDescriptor());
+    shard->fStrikeLookup.remove(strike->getDescriptor());
 }
 
-void SkStrikeCache::validate() const {
+void SkStrikeCache::validate(const Shard* shard) const {
 #ifdef SK_DEBUG
     size_t computedBytes = 0;
     int computedCount = 0;
 
-    const SkStrike* strike = fHead;
+    const SkStrike* strike = shard->fHead;
     while (strike != nullptr) {
         computedBytes += strike->fMemoryUsed;
         computedCount += 1;
-        SkASSERT(fStrikeLookup.findOrNull(strike->getDescriptor()) != nullptr);
+        SkASSERT(shard->fStrikeLookup.findOrNull(strike->getDescriptor()) != nullptr);
         strike = strike->fNext;
     }
 
-    if (fCacheCount != computedCount) {
-        SkDebugf("fCacheCount: %d, computedCount: %d", fCacheCount, computedCount);
+    if (shard->fCacheCount != computedCount) {
+        SkDebugf("fCacheCount: %d, computedCount: %d", shard->fCacheCount, computedCount);
         SK_ABORT("fCacheCount != computedCount");
     }
-    if (fTotalMemoryUsed != computedBytes) {
-        SkDebugf("fTotalMemoryUsed: %zu, computedBytes: %zu", fTotalMemoryUsed, computedBytes);
+    if (shard->fTotalMemoryUsed != computedBytes) {
+        SkDebugf("fTotalMemoryUsed: %zu, computedBytes: %zu",
+                 shard->fTotalMemoryUsed, computedBytes);
         SK_ABORT("fTotalMemoryUsed == computedBytes");
     }
 #endif
@@ -16,6 +16,7 @@
 #include "src/core/SkTHash.h"
 #include "src/text/StrikeForGPU.h"
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
@@ -38,23 +39,28 @@ struct SkFontMetrics;
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// Strikes are spread across kShardCount shards by descriptor hash, each with its own lock, LRU
+// list, and lookup table, so threads working with different strikes rarely contend. The size and
+// count budgets are global: each shard keeps exact totals for itself, and adds them into global
+// totals that are only approximately up to date. A shard purges its own LRU strikes when the
+// global totals are over budget, and only if that isn't enough does it purge other shards.
 class SkStrikeCache final : public sktext::StrikeForGPUCacheInterface {
 public:
     SkStrikeCache() = default;
 
     static SkStrikeCache* GlobalStrikeCache();
 
-    sk_sp<SkStrike> findStrike(const SkDescriptor& desc) SK_EXCLUDES(fLock);
+    sk_sp<SkStrike> findStrike(const SkDescriptor& desc);
 
     sk_sp<SkStrike> createStrike(
             const SkStrikeSpec& strikeSpec,
             SkFontMetrics* maybeMetrics = nullptr,
-            std::unique_ptr<SkStrikePinner> = nullptr) SK_EXCLUDES(fLock);
+            std::unique_ptr<SkStrikePinner> = nullptr);
 
-    sk_sp<SkStrike> findOrCreateStrike(const SkStrikeSpec& strikeSpec) SK_EXCLUDES(fLock);
+    sk_sp<SkStrike> findOrCreateStrike(const SkStrikeSpec& strikeSpec);
 
     sk_sp<sktext::StrikeForGPU> findOrCreateScopedStrike(
-            const SkStrikeSpec& strikeSpec) override SK_EXCLUDES(fLock);
+            const SkStrikeSpec& strikeSpec) override;
 
     static void PurgeAll();
     static void Dump();
@@ -63,55 +69,89 @@ public:
     // SkTraceMemoryDump interface.
     static void DumpMemoryStatistics(SkTraceMemoryDump* dump);
 
-    void purgeAll() SK_EXCLUDES(fLock); // does not change budget
-    void purgePinned(size_t minBytesNeeded = 0) SK_EXCLUDES(fLock);
+    void purgeAll(); // does not change budget
+    void purgePinned(size_t minBytesNeeded = 0);
 
-    int getCacheCountLimit() const SK_EXCLUDES(fLock);
-    int setCacheCountLimit(int limit) SK_EXCLUDES(fLock);
-    int getCacheCountUsed() const SK_EXCLUDES(fLock);
+    int getCacheCountLimit() const;
+    int setCacheCountLimit(int limit);
+    int getCacheCountUsed() const;
 
-    size_t getCacheSizeLimit() const SK_EXCLUDES(fLock);
-    size_t setCacheSizeLimit(size_t limit) SK_EXCLUDES(fLock);
-    size_t getTotalMemoryUsed() const SK_EXCLUDES(fLock);
+    size_t getCacheSizeLimit() const;
+    size_t setCacheSizeLimit(size_t limit);
+    size_t getTotalMemoryUsed() const;
 
 private:
-    friend class SkStrike;  // for SkStrike::updateDelta
+    friend class SkStrike;  // for SkStrike::updateMemoryUsage
     static constexpr char kGlyphCacheDumpName[] = "skia/sk_glyph_cache";
-    sk_sp<SkStrike> internalFindStrikeOrNull(const SkDescriptor& desc) SK_REQUIRES(fLock);
+    static constexpr int kShardCount = 16;
+
+    struct StrikeTraits {
+        static const SkDescriptor& GetKey(const sk_sp<SkStrike>& strike);
+        static uint32_t Hash(const SkDescriptor& descriptor);
+    };
+
+    struct Shard {
+        mutable SkMutex fLock;
+        SkStrike* fHead SK_GUARDED_BY(fLock) {nullptr};
+        SkStrike* fTail SK_GUARDED_BY(fLock) {nullptr};
+        skia_private::THashTable<sk_sp<SkStrike>, SkDescriptor, StrikeTraits> fStrikeLookup
+                SK_GUARDED_BY(fLock);
+
+        size_t  fTotalMemoryUsed SK_GUARDED_BY(fLock) {0};
+        int32_t fCacheCount SK_GUARDED_BY(fLock) {0};
+        int32_t fPinnerCount SK_GUARDED_BY(fLock) {0};
+    };
+
+    Shard& shardFor(const SkDescriptor& desc);
+
+    sk_sp<SkStrike> internalFindStrikeOrNull(Shard* shard, const SkDescriptor& desc)
+            SK_REQUIRES(shard->fLock);
     sk_sp<SkStrike> internalCreateStrike(
+            Shard* shard,
             const SkStrikeSpec& strikeSpec,
             SkFontMetrics* maybeMetrics = nullptr,
-            std::unique_ptr<SkStrikePinner> = nullptr) SK_REQUIRES(fLock);
+            std::unique_ptr<SkStrikePinner> = nullptr) SK_REQUIRES(shard->fLock);
+
+    // The following methods can only be called when the shard's mutex is already held.
+    void internalRemoveStrike(Shard* shard, SkStrike* strike) SK_REQUIRES(shard->fLock);
+    void internalAttachToHead(Shard* shard, sk_sp<SkStrike> strike) SK_REQUIRES(shard->fLock);
 
-    // The following methods can only be called when mutex is already held.
-    void internalRemoveStrike(SkStrike* strike) SK_REQUIRES(fLock);
-    void internalAttachToHead(sk_sp<SkStrike> strike) SK_REQUIRES(fLock);
+    // How much has to be purged to get back under budget, if anything, given that the caller
+    // needs at least minBytesNeeded freed. Returns false if nothing needs to be purged.
+    bool purgeNeeded(size_t minBytesNeeded, size_t* bytesNeeded, int* countNeeded) const;
 
-    // Checkout budgets, modulated by the specified min-bytes-needed-to-purge,
-    // and attempt to purge caches to match.
+    // Purge up to bytesNeeded and countNeeded from the LRU end of the shard.
     // Returns number of bytes freed.
-    size_t internalPurge(size_t minBytesNeeded = 0, bool checkPinners = false) SK_REQUIRES(fLock);
+    size_t internalPurge(Shard* shard, size_t bytesNeeded, int countNeeded, bool checkPinners)
+            SK_REQUIRES(shard->fLock);
 
-    // A simple accounting of what each glyph cache reports and the strike cache total.
-    void validate() const SK_REQUIRES(fLock);
+    // Having just used shard, purge it to get back under budget if needed. If that's not enough,
+    // purge the other shards too, unless another thread is already doing so.
+    void purge(Shard* shard) SK_EXCLUDES(shard->fLock);
 
-    void forEachStrike(std::function<void(const SkStrike&)> visitor) const SK_EXCLUDES(fLock);
+    // Purge each shard but skip in turn until bytesNeeded and countNeeded have been freed.
+    void purgeShards(const Shard* skip, size_t bytesNeeded, int countNeeded, bool checkPinners);
 
-    mutable SkMutex fLock;
-    SkStrike* fHead SK_GUARDED_BY(fLock) {nullptr};
-    SkStrike* fTail SK_GUARDED_BY(fLock) {nullptr};
-    struct StrikeTraits {
-        static const SkDescriptor& GetKey(const sk_sp<SkStrike>& strike);
-        static uint32_t Hash(const SkDescriptor& descriptor);
-    };
-    skia_private::THashTable<sk_sp<SkStrike>, SkDescriptor, StrikeTraits> fStrikeLookup
-            SK_GUARDED_BY(fLock);
-
-    size_t  fCacheSizeLimit{SK_DEFAULT_FONT_CACHE_LIMIT};
-    size_t  fTotalMemoryUsed SK_GUARDED_BY(fLock) {0};
-    int32_t fCacheCountLimit{SK_DEFAULT_FONT_CACHE_COUNT_LIMIT};
-    int32_t fCacheCount SK_GUARDED_BY(fLock) {0};
-    int32_t fPinnerCount SK_GUARDED_BY(fLock) {0};
+    // Purge any shards needed to get back under budget.
+    void purgeToBudget();
+
+    // A simple accounting of what each glyph cache reports and the shard's total.
+    void validate(const Shard* shard) const SK_REQUIRES(shard->fLock);
+
+    void forEachStrike(std::function<void(const SkStrike&)> visitor) const;
+
+    Shard fShards[kShardCount];
+
+    // The sums of each shard's totals. Each shard adds its changes while holding its own lock, so
+    // these lag behind slightly while other threads are adding or removing strikes.
+    std::atomic<size_t>  fTotalMemoryUsed{0};
+    std::atomic<int32_t> fCacheCount{0};
+
+    std::atomic<size_t>  fCacheSizeLimit{SK_DEFAULT_FONT_CACHE_LIMIT};
+    std::atomic<int32_t> fCacheCountLimit{SK_DEFAULT_FONT_CACHE_COUNT_LIMIT};
+
+    // Set while one thread is purging other shards, so others needn't pile in behind it.
+    std::atomic<bool>    fPurgingOtherShards{false};
 };
 
 #endif  // SkStrikeCache_DEFINED
@@ -7,6 +7,8 @@
 
 #include "include/core/SkStream.h"
 #include "include/core/SkString.h"
+#include "include/core/SkTime.h"
+#include "include/private/base/SkMutex.h"
 #include "include/private/base/SkTFitsIn.h"
 #include "include/private/base/SkThreadID.h"
 #include "src/base/SkHalf.h"
@@ -52,7 +54,10 @@ bool gSkVMAllowJIT{false};
         }
     #else
         #include <dlfcn.h>
+        #include <fcntl.h>
         #include <sys/mman.h>
+        #include <sys/stat.h>
+        #include <stdlib.h>
 
         static void* alloc_jit_buffer(size_t* len) {
             // While mprotect and VirtualAlloc both work at page granularity,
@@ -119,6 +124,30 @@ namespace skvm {
         return { fma, fp16 };
     }
 
+    static SkMutex& jit_cache_mutex() {
+        static SkMutex& mutex = *(new SkMutex);
+        return mutex;
+    }
+    static SkString* gJITCacheDir = nullptr;  // Guarded by jit_cache_mutex().
+
+    static std::atomic<int64_t> gJITCacheHits{0},
+                                gJITCacheMisses{0},
+                                gJITCompileNanos{0};
+
+    void SetJITCacheDirectory(const char* dir) {
+        SkAutoMutexExclusive lock(jit_cache_mutex());
+        delete gJITCacheDir;
+        gJITCacheDir = (dir && *dir) ? new SkString(dir) : nullptr;
+    }
+
+    JITCacheStats GetJITCacheStats() {
+        JITCacheStats stats;
+        stats.hits      = gJITCacheHits.load();
+        stats.misses    = gJITCacheMisses.load();
+        stats.compileMs = gJITCompileNanos.load() * 1e-6;
+        return stats;
+    }
+
     Builder::Builder(bool createDuplicates)
         : fFeatures(detect_features()), fCreateDuplicates(createDuplicates) {}
     Builder::Builder(Features features, bool createDuplicates)
@@ -3964,8 +3993,186 @@ namespace skvm {
         return true;
     }
 
+#if !defined(SK_BUILD_FOR_WIN)
+    // The on-disk JIT cache holds one file per program, named by a hash of its key.  The key is
+    // everything that determines the code jit() emits: the optimized instructions, each
+    // argument's stride (jit() bakes these into its pointer arithmetic), and the CPU features
+    // jit() might look at.  Each file holds
+    //
+    //     JITCacheHeader | key | padding to a page boundary | code
+    //
+    // so the code can be mapped straight from the file, and we compare the whole key on load
+    // rather than trusting the hash.
+    //
+    // jit() addresses its constant pool pc-relatively and all other memory through its arguments,
+    // so its code runs unchanged at any address and needs no relocations.  We still record the
+    // count, so code that does need them can never be mistaken for code that doesn't.
+
+    static SkString jit_cache_directory() {
+        SkAutoMutexExclusive lock(jit_cache_mutex());
+        return gJITCacheDir ? *gJITCacheDir : SkString();
+    }
+
+    // Bump this whenever jit() changes the code it emits for a given key.
+    static constexpr uint32_t kJITCacheVersion = 2;
+    static constexpr uint32_t kJITCacheMagic   = 0x6d766b73;  // 'skvm'
+
+    struct JITCacheHeader {
+        uint32_t magic;
+        uint32_t keyWords;     // Size of the key following this header, in uint32_t.
+        uint32_t relocations;  // Always 0 today.
+        uint32_t unused;
+        uint64_t codeOffset;   // A multiple of the page size.
+        uint64_t codeSize;
+    };
+
+    static std::vector<uint32_t> jit_cache_key(
+            const std::vector<OptimizedInstruction>& instructions,
+            const std::vector<int>& strides) {
+        uint32_t features = 0;
+        for (int bit = 0; bit < 32; bit++) {
+            if (SkCpu::Supports(1u << bit)) {
+                features |= 1u << bit;
+            }
+        }
+
+        std::vector<uint32_t> key = { kJITCacheVersion, features, (uint32_t)strides.size() };
+        key.reserve(key.size() + strides.size() + 10 * instructions.size());
+        for (int stride : strides) {
+            key.push_back((uint32_t)stride);
+        }
+        for (const OptimizedInstruction& inst : instructions) {
+            key.insert(key.end(), {
+                (uint32_t)inst.op,
+                (uint32_t)inst.x, (uint32_t)inst.y, (uint32_t)inst.z, (uint32_t)inst.w,
+                (uint32_t)inst.immA, (uint32_t)inst.immB, (uint32_t)inst.immC,
+                (uint32_t)inst.death, (uint32_t)inst.can_hoist,
+            });
+        }
+        return key;
+    }
+
+    static SkString jit_cache_path(const SkString& dir, const std::vector<uint32_t>& key) {
+        const size_t bytes = key.size() * sizeof(uint32_t);
+        uint32_t lo = SkOpts::hash(key.data(), bytes, 0),
+                 hi = SkOpts::hash(key.data(), bytes, 1);
+        return SkStringPrintf("%s/%08x%08x.skvm", dir.c_str(), hi, lo);
+    }
+
+    static bool read_fully(int fd, void* dst, size_t len, off_t offset) {
+        for (char* p = (char*)dst; len > 0;) {
+            ssize_t n = pread(fd, p, len, offset);
+            if (n <= 0) {
+                return false;
+            }
+            p += n; len -= n; offset += n;
+        }
+        return true;
+    }
+
+    static bool write_fully(int fd, const void* src, size_t len, off_t offset) {
+        for (const char* p = (const char*)src; len > 0;) {
+            ssize_t n = pwrite(fd, p, len, offset);
+            if (n <= 0) {
+                return false;
+            }
+            p += n; len -= n; offset += n;
+        }
+        return true;
+    }
+
+    // Returns executable code mapped from the cache file at path, or nullptr if it's not there.
+    static void* map_cached_jit(const char* path, const std::vector<uint32_t>& key, size_t* size) {
+        int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return nullptr;
+        }
+
+        void* code = nullptr;
+        JITCacheHeader header;
+        struct stat st;
+        const size_t page = sysconf(_SC_PAGESIZE);
+        if (read_fully(fd, &header, sizeof(header), 0) &&
+            header.magic       == kJITCacheMagic &&
+            header.keyWords    == key.size() &&
+            header.relocations == 0 &&
+            header.codeSize    >  0 &&
+            header.codeOffset % page == 0 &&
+            fstat(fd, &st) == 0 &&
+            (uint64_t)st.st_size >= header.codeOffset + header.codeSize) {
+
+            std::vector<uint32_t> stored(key.size());
+            if (read_fully(fd, stored.data(), key.size() * sizeof(uint32_t), sizeof(header)) &&
+                stored == key) {
+                code = mmap(nullptr, header.codeSize, PROT_READ|PROT_EXEC, MAP_PRIVATE,
+                            fd, header.codeOffset);
+                if (code == MAP_FAILED) {
+                    code = nullptr;
+                } else {
+                    *size = header.codeSize;
+                }
+            }
+        }
+        close(fd);
+        return code;
+    }
+
+    // Writes code to the cache file at path.  This is best-effort; on any failure we just don't.
+    static void save_cached_jit(const char* path, const std::vector<uint32_t>& key,
+                                const void* code, size_t size) {
+        // Write to a temporary file first and rename() it into place, so concurrent processes
+        // never see a partial file, and anyone who has mapped an older file keeps it intact.
+        // mkstemp() gives each writer its own file, whichever process or thread it's on.
+        SkString tmp = SkStringPrintf("%s.XXXXXX", path);
+        int fd = mkstemp(tmp.data());
+        if (fd < 0) {
+            return;
+        }
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+        fchmod(fd, 0644);  // mkstemp() creates files only we can read.
+
+        const size_t page = sysconf(_SC_PAGESIZE),
+                     keyBytes = key.size() * sizeof(uint32_t);
+        JITCacheHeader header;
+        header.magic       = kJITCacheMagic;
+        header.keyWords    = (uint32_t)key.size();
+        header.relocations = 0;
+        header.unused      = 0;
+        header.codeOffset  = (sizeof(header) + keyBytes + page - 1) / page * page;
+        header.codeSize    = size;
+
+        bool ok = write_fully(fd, &header, sizeof(header), 0)
+               && write_fully(fd, key.data(), keyBytes, sizeof(header))
+               && write_fully(fd, code, size, header.codeOffset);
+        ok = (close(fd) == 0) && ok;
+        if (!ok || rename(tmp.c_str(), path) != 0) {
+            unlink(tmp.c_str());
+        }
+    }
+#endif
+
     void Program::setupJIT(const std::vector<OptimizedInstruction>& instructions,
                            const char* debug_name) {
+    #if !defined(SK_BUILD_FOR_WIN)
+        // If there's a cache, look there first for code an earlier Program JIT'd for us.
+        std::vector<uint32_t> cacheKey;
+        SkString cachePath;
+        if (SkString dir = jit_cache_directory(); !dir.isEmpty()) {
+            cacheKey  = jit_cache_key(instructions, fImpl->strides);
+            cachePath = jit_cache_path(dir, cacheKey);
+
+            size_t size;
+            if (void* jit_entry = map_cached_jit(cachePath.c_str(), cacheKey, &size)) {
+                fImpl->jit_size = size;
+                fImpl->jit_entry.store(jit_entry);
+                gJITCacheHits++;
+                return;
+            }
+            gJITCacheMisses++;
+        }
+    #endif
+        const double start = SkTime::GetNSecs();
+
         // Assemble with no buffer to determine a.size() (the number of bytes we'll assemble)
         // and stack_hint/registers_used to feed forward into the next jit() call.
         Assembler a{nullptr};
@@ -3986,6 +4193,14 @@ namespace skvm {
 
         // Remap as executable, and flush caches on platforms that need that.
         remap_as_executable(jit_entry, fImpl->jit_size);
+
+        gJITCompileNanos += (int64_t)(SkTime::GetNSecs() - start);
+
+    #if !defined(SK_BUILD_FOR_WIN)
+        if (!cachePath.isEmpty()) {
+            save_cached_jit(cachePath.c_str(), cacheKey, jit_entry, a.size());
+        }
+    #endif
     }
 
     void Program::disassemble(SkWStream* o) const {
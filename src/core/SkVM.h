@@ -1077,6 +1077,18 @@ namespace skvm {
         std::unique_ptr<Impl> fImpl;
     };
 
+    // Programs JIT'd while a cache directory is set are saved there, and any later Program with
+    // the same optimized instructions on a CPU with the same features (in this process or another)
+    // maps that code back in instead of JIT'ing it again.  nullptr turns the cache off (default).
+    void SetJITCacheDirectory(const char* dir);
+
+    struct JITCacheStats {
+        int64_t hits      = 0;  // Programs whose code was found in the cache.
+        int64_t misses    = 0;  // Programs looked for in the cache but not found.
+        double  compileMs = 0;  // Total time spent JIT'ing Programs, cache or no cache.
+    };
+    JITCacheStats GetJITCacheStats();
+
     // TODO: control flow
     // TODO: 64-bit values?
 
@@ -30,6 +30,7 @@
 #include "src/encode/SkJPEGWriteUtility.h"
 #include "src/image/SkImage_Base.h"
 
+#include <algorithm>
 #include <csetjmp>
 #include <cstdint>
 #include <cstring>
@@ -293,6 +294,9 @@ static std::unique_ptr<SkEncoder> Make(SkWStream* dst,
     }
 
     jpeg_set_quality(encoderMgr->cinfo(), options.fQuality, TRUE);
+    if (options.fRestartInterval > 0) {
+        encoderMgr->cinfo()->restart_interval = std::min(options.fRestartInterval, 0xFFFF);
+    }
     jpeg_start_compress(encoderMgr->cinfo(), TRUE);
 
     // Write XMP metadata. This will only write the standard XMP segment.
@@ -13,6 +13,7 @@
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
 #include "include/core/SkDataTable.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkPixmap.h"
 #include "include/core/SkRefCnt.h"
@@ -24,9 +25,13 @@
 #include "include/private/base/SkDebug.h"
 #include "include/private/base/SkNoncopyable.h"
 #include "include/private/base/SkTemplates.h"
+#include "include/private/base/SkTo.h"
 #include "modules/skcms/skcms.h"
 #include "src/base/SkMSAN.h"
+#include "src/base/SkMathPriv.h"
+#include "src/base/SkVx.h"
 #include "src/codec/SkPngPriv.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/encode/SkImageEncoderFns.h"
 #include "src/encode/SkImageEncoderPriv.h"
 #include "src/image/SkImage_Base.h"
@@ -41,6 +46,7 @@
 
 #include <png.h>
 #include <pngconf.h>
+#include <zlib.h>
 
 class GrDirectContext;
 class SkImage;
@@ -82,6 +88,15 @@ public:
     bool writeInfo(const SkImageInfo& srcInfo);
     void chooseProc(const SkImageInfo& srcInfo);
 
+    // Limits libpng to the filter chosen for row y's band, if fSampleFilters is set and y starts
+    // a band.
+    void setFiltersForRow(const SkPixmap& src, int y);
+
+    // Whether all of src's rows can be written at once with writeRowsInParallel().
+    bool canWriteRowsInParallel(const SkPixmap& src);
+    // Filters and compresses all of src's rows on fExecutor, and finishes the PNG.
+    bool writeRowsInParallel(const SkPixmap& src);
+
     png_structp pngPtr() { return fPngPtr; }
     png_infop infoPtr() { return fInfoPtr; }
     int pngBytesPerPixel() const { return fPngBytesPerPixel; }
@@ -92,10 +107,19 @@ public:
 private:
     SkPngEncoderMgr(png_structp pngPtr, png_infop infoPtr) : fPngPtr(pngPtr), fInfoPtr(infoPtr) {}
 
+    // Writes row y of src as PNG pixels to dst.
+    void transformRow(const SkPixmap& src, int y, uint8_t* dst) const;
+    // Returns the filter (a PNG_FILTER_VALUE_*) for the band of rows holding row y.
+    int chooseBandFilter(const SkPixmap& src, int y) const;
+
     png_structp fPngPtr;
     png_infop fInfoPtr;
     int fPngBytesPerPixel;
     transform_scanline_proc fProc;
+    int fFilters;
+    bool fSampleFilters;
+    int fZLibLevel;
+    SkExecutor* fExecutor;
 };
 
 std::unique_ptr<SkPngEncoderMgr> SkPngEncoderMgr::Make(SkWStream* stream) {
@@ -224,6 +248,15 @@ bool SkPngEncoderMgr::setHeader(const SkImageInfo& srcInfo, const SkPngEncoder::
     SkASSERT(zlibLevel == options.fZLibLevel);
     png_set_compression_level(fPngPtr, zlibLevel);
 
+    // libpng treats no filters as its default: kNone below 8 bits per channel, or kAll.
+    fFilters = filters ? filters : bitDepth < 8 ? PNG_FILTER_NONE : PNG_ALL_FILTERS;
+    // libpng may rule out some filters for images one pixel wide or tall, so we don't try to
+    // pick them for it.
+    fSampleFilters = options.fSampleFilters && (fFilters & (fFilters - 1)) &&
+                     srcInfo.width() > 1 && srcInfo.height() > 1;
+    fZLibLevel = zlibLevel;
+    fExecutor = options.fExecutor;
+
     // Set comments in tEXt chunk
     const sk_sp<SkDataTable>& comments = options.fComments;
     if (comments != nullptr) {
@@ -427,6 +460,306 @@ bool SkPngEncoderMgr::writeInfo(const SkImageInfo& srcInfo) {
 
 void SkPngEncoderMgr::chooseProc(const SkImageInfo& srcInfo) { fProc = choose_proc(srcInfo); }
 
+///////////////////////////////////////////////////////////////////////////////
+// Filtering rows
+///////////////////////////////////////////////////////////////////////////////
+
+// With fSampleFilters, rows share a filter in bands of this many, chosen by trying each allowed
+// filter on a few rows spread through the band.  Neighboring rows usually favor the same filter,
+// so this compresses nearly as well as trying every filter on every row, for a fraction of the
+// work.
+static constexpr int kRowsPerFilterBand = 16;
+static constexpr int kSampledRowsPerFilterBand = 2;
+
+// Predicts each byte from the ones to its left (a), above (b), and above and left (c), as the
+// PNG filter does.
+template <int N>
+static skvx::Vec<N, uint8_t> filter_predictor(int filter,
+                                              const skvx::Vec<N, uint8_t>& a,
+                                              const skvx::Vec<N, uint8_t>& b,
+                                              const skvx::Vec<N, uint8_t>& c) {
+    switch (filter) {
+        case PNG_FILTER_VALUE_SUB:
+            return a;
+        case PNG_FILTER_VALUE_UP:
+            return b;
+        case PNG_FILTER_VALUE_AVG:
+            // The average of a and b, rounded down, without overflowing a byte.
+            return (a & b) + ((a ^ b) >> 1);
+        case PNG_FILTER_VALUE_PAETH: {
+            using I16 = skvx::Vec<N, int16_t>;
+            const I16 a16 = skvx::cast<int16_t>(a),
+                      b16 = skvx::cast<int16_t>(b),
+                      c16 = skvx::cast<int16_t>(c);
+            // These are |p - a|, |p - b| and |p - c| for the Paeth estimate p = a + b - c.
+            const I16 pa = skvx::max(b16 - c16, c16 - b16),
+                      pb = skvx::max(a16 - c16, c16 - a16),
+                      pc = skvx::max(a16 + b16 - c16 - c16, c16 + c16 - a16 - b16);
+            return skvx::if_then_else(skvx::cast<uint8_t>((pa <= pb) & (pa <= pc)), a,
+                   skvx::if_then_else(skvx::cast<uint8_t>(pb <= pc), b, c));
+        }
+        default:
+            return 0;
+    }
+}
+
+// Filters row against prev with the given filter type, writing rowBytes bytes to dst.
+// row and prev must each be preceded by bytesPerPixel zeros, the pixel left of the first.
+static void filter_row(int filter, const uint8_t* row, const uint8_t* prev, size_t rowBytes,
+                       int bytesPerPixel, uint8_t* dst) {
+    using U8 = skvx::Vec<16, uint8_t>;
+    size_t i = 0;
+    for (; i + 16 <= rowBytes; i += 16) {
+        const U8 a = U8::Load(row + i - bytesPerPixel),
+                 b = U8::Load(prev + i),
+                 c = U8::Load(prev + i - bytesPerPixel);
+        (U8::Load(row + i) - filter_predictor(filter, a, b, c)).store(dst + i);
+    }
+    for (; i < rowBytes; i++) {
+        const skvx::Vec<1, uint8_t> a = row[i - bytesPerPixel],
+                                    b = prev[i],
+                                    c = prev[i - bytesPerPixel];
+        dst[i] = row[i] - filter_predictor(filter, a, b, c)[0];
+    }
+}
+
+// libpng's measure of how well a filtered row will compress: the sum of its bytes' magnitudes,
+// reading them as signed.
+static uint32_t filtered_row_cost(const uint8_t* row, size_t rowBytes) {
+    using U8 = skvx::Vec<16, uint8_t>;
+    uint32_t sum = 0;
+    size_t i = 0;
+    while (i + 16 <= rowBytes) {
+        // Each magnitude is at most 128, so 16-bit lanes can add up 256 of them at a time.
+        skvx::Vec<16, uint16_t> sums = 0;
+        for (int n = 0; n < 256 && i + 16 <= rowBytes; n++, i += 16) {
+            const U8 v = U8::Load(row + i);
+            sums += skvx::cast<uint16_t>(skvx::min(v, U8(0) - v));
+        }
+        for (int lane = 0; lane < 16; lane++) {
+            sum += sums[lane];
+        }
+    }
+    for (; i < rowBytes; i++) {
+        sum += std::min<uint32_t>(row[i], 256 - row[i]);
+    }
+    return sum;
+}
+
+void SkPngEncoderMgr::transformRow(const SkPixmap& src, int y, uint8_t* dst) const {
+    const void* srcRow = src.addr(0, y);
+    sk_msan_assert_initialized(srcRow,
+                               (const uint8_t*)srcRow + (src.width() << src.shiftPerPixel()));
+    fProc((char*)dst, (const char*)srcRow, src.width(), SkColorTypeBytesPerPixel(src.colorType()));
+}
+
+int SkPngEncoderMgr::chooseBandFilter(const SkPixmap& src, int y) const {
+    SkASSERT(fSampleFilters);
+    const int bpp = fPngBytesPerPixel;
+    const size_t rowBytes = (size_t)bpp * src.width(),
+                 paddedRowBytes = bpp + rowBytes;
+
+    // A sampled row and the row above it, each preceded by a pixel of zeros, and a filtered row.
+    skia_private::AutoTMalloc<uint8_t> storage(2 * paddedRowBytes + rowBytes);
+    sk_bzero(storage.get(), 2 * paddedRowBytes);
+    uint8_t* row = storage.get() + bpp;
+    uint8_t* prev = row + paddedRowBytes;
+    uint8_t* filtered = prev + rowBytes;
+
+    const int bandStart = y - y % kRowsPerFilterBand,
+              bandRows = std::min(kRowsPerFilterBand, src.height() - bandStart);
+    uint64_t costs[PNG_FILTER_VALUE_LAST] = {};
+    for (int i = 0; i < kSampledRowsPerFilterBand; i++) {
+        const int sample = bandStart + (2 * i + 1) * bandRows / (2 * kSampledRowsPerFilterBand);
+        this->transformRow(src, sample, row);
+        if (sample > 0) {
+            this->transformRow(src, sample - 1, prev);
+        } else {
+            sk_bzero(prev, rowBytes);
+        }
+        for (int filter = PNG_FILTER_VALUE_NONE; filter < PNG_FILTER_VALUE_LAST; filter++) {
+            if (fFilters & (PNG_FILTER_NONE << filter)) {
+                filter_row(filter, row, prev, rowBytes, bpp, filtered);
+                costs[filter] += filtered_row_cost(filtered, rowBytes);
+            }
+        }
+    }
+
+    int best = -1;
+    for (int filter = PNG_FILTER_VALUE_NONE; filter < PNG_FILTER_VALUE_LAST; filter++) {
+        if ((fFilters & (PNG_FILTER_NONE << filter)) && (best < 0 || costs[filter] < costs[best])) {
+            best = filter;
+        }
+    }
+    return best;
+}
+
+void SkPngEncoderMgr::setFiltersForRow(const SkPixmap& src, int y) {
+    // libpng only allocates what it needs for the filters set when it writes the first row, so
+    // that row keeps them all, and the first band's choice takes effect from its second row.
+    if (fSampleFilters && (y % kRowsPerFilterBand == 0 ? y > 0 : y == 1)) {
+        png_set_filter(fPngPtr, PNG_FILTER_TYPE_BASE,
+                       PNG_FILTER_NONE << this->chooseBandFilter(src, y));
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Filtering and compressing rows in parallel
+///////////////////////////////////////////////////////////////////////////////
+
+// Rows are compressed in independent blocks of about this many bytes, each primed with the
+// last window of the data before it, as pigz does.  They're big enough that starting each one
+// fresh costs little compression.
+static constexpr size_t kParallelBlockBytes = 128 * 1024;
+static constexpr size_t kDeflateWindowBytes = 32 * 1024;
+
+bool SkPngEncoderMgr::canWriteRowsInParallel(const SkPixmap& src) {
+    // libpng strips a filler channel from F16 rows with no alpha, so those rows aren't ready
+    // to compress as they are.
+    return fExecutor && fProc &&
+           png_get_rowbytes(fPngPtr, fInfoPtr) == (size_t)fPngBytesPerPixel * src.width();
+}
+
+bool SkPngEncoderMgr::writeRowsInParallel(const SkPixmap& src) {
+    SkASSERT(this->canWriteRowsInParallel(src));
+    const int width = src.width(),
+              height = src.height(),
+              bpp = fPngBytesPerPixel;
+    const size_t rowBytes = (size_t)bpp * width,
+                 filteredRowBytes = rowBytes + 1;  // Each row starts with its filter type.
+    const int rowsPerBlock = (int)std::max<size_t>(1, kParallelBlockBytes / filteredRowBytes),
+              blockCount = (height + rowsPerBlock - 1) / rowsPerBlock;
+
+    // Filter every row.  Each row's filter depends only on the image, not on how it's split up.
+    std::vector<uint8_t> filtered(filteredRowBytes * height);
+    const bool oneFilter = !(fFilters & (fFilters - 1));
+
+    SkTaskGroup tasks(*fExecutor);
+    tasks.batch(blockCount, [&](int block) {
+        const int startRow = block * rowsPerBlock,
+                  endRow = std::min(height, startRow + rowsPerBlock);
+
+        // The current and previous rows as PNG pixels, each preceded by a pixel of zeros, and
+        // space to try each filter when choosing one per row.
+        const size_t paddedRowBytes = bpp + rowBytes;
+        const bool filterPerRow = !oneFilter && !fSampleFilters;
+        skia_private::AutoTMalloc<uint8_t> storage(2 * paddedRowBytes +
+                                                   (filterPerRow ? 2 * rowBytes : 0));
+        sk_bzero(storage.get(), 2 * paddedRowBytes);
+        uint8_t* row = storage.get() + bpp;
+        uint8_t* prev = row + paddedRowBytes;
+        uint8_t* candidate = prev + rowBytes;
+        uint8_t* best = candidate + rowBytes;
+
+        if (startRow > 0) {
+            this->transformRow(src, startRow - 1, prev);
+        }
+        for (int y = startRow; y < endRow; y++) {
+            this->transformRow(src, y, row);
+            uint8_t* dst = filtered.data() + filteredRowBytes * y;
+            if (oneFilter) {
+                dst[0] = SkCTZ(fFilters) - SkCTZ(PNG_FILTER_NONE);
+                filter_row(dst[0], row, prev, rowBytes, bpp, dst + 1);
+            } else if (fSampleFilters) {
+                if (y == startRow || y % kRowsPerFilterBand == 0) {
+                    dst[0] = this->chooseBandFilter(src, y);
+                } else {
+                    dst[0] = dst[-(int)filteredRowBytes];
+                }
+                filter_row(dst[0], row, prev, rowBytes, bpp, dst + 1);
+            } else {
+                uint32_t bestCost = UINT32_MAX;
+                for (int filter = PNG_FILTER_VALUE_NONE; filter < PNG_FILTER_VALUE_LAST; filter++) {
+                    if (!(fFilters & (PNG_FILTER_NONE << filter))) {
+                        continue;
+                    }
+                    filter_row(filter, row, prev, rowBytes, bpp, candidate);
+                    const uint32_t cost = filtered_row_cost(candidate, rowBytes);
+                    if (cost < bestCost) {
+                        bestCost = cost;
+                        dst[0] = filter;
+                        std::swap(candidate, best);
+                    }
+                }
+                memcpy(dst + 1, best, rowBytes);
+            }
+            std::swap(row, prev);
+        }
+    });
+    tasks.wait();
+
+    // Compress each block as raw deflate data, ending all but the last with a sync flush so
+    // that they can be concatenated.
+    struct Block {
+        std::vector<uint8_t> compressed;
+        uLong                adler;
+        size_t               size;
+        bool                 ok;
+    };
+    std::vector<Block> blocks(blockCount);
+    // Like libpng, use Z_FILTERED for filtered rows.
+    const int strategy = fFilters == PNG_FILTER_NONE ? Z_DEFAULT_STRATEGY : Z_FILTERED;
+    tasks.batch(blockCount, [&](int i) {
+        Block& block = blocks[i];
+        const size_t start = filteredRowBytes * i * rowsPerBlock;
+        const uint8_t* data = filtered.data() + start;
+        block.size = std::min(filteredRowBytes * rowsPerBlock, filtered.size() - start);
+        block.adler = adler32(adler32(0, nullptr, 0), data, SkToUInt(block.size));
+        block.ok = false;
+
+        z_stream zs = {};
+        if (deflateInit2(&zs, fZLibLevel, Z_DEFLATED, -MAX_WBITS, 8, strategy) != Z_OK) {
+            return;
+        }
+        if (start > 0) {
+            const size_t dictionarySize = std::min(start, kDeflateWindowBytes);
+            deflateSetDictionary(&zs, data - dictionarySize, SkToUInt(dictionarySize));
+        }
+        // deflateBound() doesn't include the empty stored block a sync flush adds.
+        block.compressed.resize(deflateBound(&zs, block.size) + 8);
+        zs.next_in = const_cast<uint8_t*>(data);
+        zs.avail_in = SkToUInt(block.size);
+        zs.next_out = block.compressed.data();
+        zs.avail_out = SkToUInt(block.compressed.size());
+        const bool last = i == blockCount - 1;
+        const int ret = deflate(&zs, last ? Z_FINISH : Z_SYNC_FLUSH);
+        block.ok = (last ? ret == Z_STREAM_END : ret == Z_OK) && zs.avail_in == 0;
+        block.compressed.resize(zs.total_out);
+        deflateEnd(&zs);
+    });
+    tasks.wait();
+
+    // Wrap the blocks in a zlib header and an Adler-32 checksum of all the data.
+    const int cmf = (MAX_WBITS - 8) << 4 | Z_DEFLATED;
+    const int level = fZLibLevel < 2 ? 0 : fZLibLevel < 6 ? 1 : fZLibLevel == 6 ? 2 : 3;
+    const int flg = (level << 6) + 31 - ((cmf << 8) + (level << 6)) % 31;
+    const uint8_t header[] = {(uint8_t)cmf, (uint8_t)flg};
+    uLong adler = adler32(0, nullptr, 0);
+    for (const Block& block : blocks) {
+        if (!block.ok) {
+            return false;
+        }
+        adler = adler32_combine(adler, block.adler, block.size);
+    }
+    const uint8_t trailer[] = {(uint8_t)(adler >> 24), (uint8_t)(adler >> 16),
+                               (uint8_t)(adler >> 8),  (uint8_t)adler};
+    blocks.front().compressed.insert(blocks.front().compressed.begin(),
+                                     std::begin(header), std::end(header));
+    blocks.back().compressed.insert(blocks.back().compressed.end(),
+                                    std::begin(trailer), std::end(trailer));
+
+    // Write each block as its own IDAT chunk, followed by IEND in place of png_write_end().
+    if (setjmp(png_jmpbuf(fPngPtr))) {
+        return false;
+    }
+    for (const Block& block : blocks) {
+        png_write_chunk(fPngPtr, (png_const_bytep)"IDAT", block.compressed.data(),
+                        block.compressed.size());
+    }
+    png_write_chunk(fPngPtr, (png_const_bytep)"IEND", nullptr, 0);
+    return true;
+}
+
 SkPngEncoderImpl::SkPngEncoderImpl(std::unique_ptr<SkPngEncoderMgr> encoderMgr, const SkPixmap& src)
         : SkEncoder(src, encoderMgr->pngBytesPerPixel() * src.width())
         , fEncoderMgr(std::move(encoderMgr)) {}
@@ -434,12 +767,19 @@ SkPngEncoderImpl::SkPngEncoderImpl(std::unique_ptr<SkPngEncoderMgr> encoderMgr,
 SkPngEncoderImpl::~SkPngEncoderImpl() {}
 
 bool SkPngEncoderImpl::onEncodeRows(int numRows) {
+    if (fCurrRow == 0 && numRows == fSrc.height() &&
+        fEncoderMgr->canWriteRowsInParallel(fSrc)) {
+        fCurrRow = numRows;
+        return fEncoderMgr->writeRowsInParallel(fSrc);
+    }
+
     if (setjmp(png_jmpbuf(fEncoderMgr->pngPtr()))) {
         return false;
     }
 
     const void* srcRow = fSrc.addr(0, fCurrRow);
     for (int y = 0; y < numRows; y++) {
+        fEncoderMgr->setFiltersForRow(fSrc, fCurrRow + y);
         sk_msan_assert_initialized(srcRow,
                                    (const uint8_t*)srcRow + (fSrc.width() << fSrc.shiftPerPixel()));
         fEncoderMgr->proc()((char*)fStorage.get(),
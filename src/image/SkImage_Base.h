@@ -128,6 +128,12 @@ public:
     virtual bool getROPixels(GrDirectContext*, SkBitmap*,
                              CachingHint = kAllow_CachingHint) const = 0;
 
+    // Like getROPixels(), but the pixels may be a smaller version of the image, at least minSize,
+    // if producing that is much cheaper than producing all of the image (e.g. a JPEG decoded
+    // with DCT scaling).  Returns false if there is no such smaller version.
+    virtual bool getScaledROPixels(SkISize /*minSize*/, SkBitmap*,
+                                   CachingHint = kAllow_CachingHint) const { return false; }
+
     virtual sk_sp<SkImage> onMakeSubset(GrDirectContext*, const SkIRect&) const = 0;
 
     virtual sk_sp<SkData> onRefEncoded() const { return nullptr; }
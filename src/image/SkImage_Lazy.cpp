@@ -150,6 +150,45 @@ bool SkImage_Lazy::getROPixels(GrDirectContext* ctx, SkBitmap* bitmap,
     return true;
 }
 
+bool SkImage_Lazy::getScaledROPixels(SkISize minSize, SkBitmap* bitmap,
+                                     SkImage::CachingHint chint) const {
+    SkISize size;
+    {
+        ScopedGenerator generator(fSharedGenerator);
+        if (generator->getInfo().dimensions() != this->dimensions()) {
+            return false;
+        }
+        size = generator->getScaledDimensionsAtLeast(minSize);
+    }
+    if (size == this->dimensions()) {
+        return false;
+    }
+
+    // Cached under our ID, so it's purged along with our other pixels.
+    const auto desc = SkBitmapCacheDesc::MakeScaled(this->uniqueID(), size);
+    if (SkBitmapCache::Find(desc, bitmap)) {
+        return true;
+    }
+
+    const SkImageInfo info = this->imageInfo().makeDimensions(size);
+    if (SkImage::kAllow_CachingHint == chint) {
+        SkPixmap pmap;
+        SkBitmapCache::RecPtr cacheRec = SkBitmapCache::Alloc(desc, info, &pmap);
+        if (!cacheRec || !ScopedGenerator(fSharedGenerator)->getPixels(pmap)) {
+            return false;
+        }
+        SkBitmapCache::Add(std::move(cacheRec), bitmap);
+        this->notifyAddedToRasterCache();
+    } else {
+        if (!bitmap->tryAllocPixels(info) ||
+            !ScopedGenerator(fSharedGenerator)->getPixels(bitmap->pixmap())) {
+            return false;
+        }
+        bitmap->setImmutable();
+    }
+    return true;
+}
+
 sk_sp<SharedGenerator> SkImage_Lazy::generator() const {
     return fSharedGenerator;
 }
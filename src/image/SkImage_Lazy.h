@@ -68,6 +68,7 @@ public:
                                 RequiredProperties) const override;
 
     bool getROPixels(GrDirectContext*, SkBitmap*, CachingHint) const override;
+    bool getScaledROPixels(SkISize minSize, SkBitmap*, CachingHint) const override;
     SkImage_Base::Type type() const override { return SkImage_Base::Type::kLazy; }
     sk_sp<SkImage> onMakeColorTypeAndColorSpace(SkColorType, sk_sp<SkColorSpace>,
                                                 GrDirectContext*) const override;
@@ -135,11 +135,11 @@ void SkSurface::draw(SkCanvas* canvas, SkScalar x, SkScalar y, const SkSamplingO
 }
 
 bool SkSurface::peekPixels(SkPixmap* pmap) {
-    return this->getCanvas()->peekPixels(pmap);
+    return asSB(this)->onPeekPixels(pmap);
 }
 
 bool SkSurface::readPixels(const SkPixmap& pm, int srcX, int srcY) {
-    return this->getCanvas()->readPixels(pm, srcX, srcY);
+    return asSB(this)->onReadPixels(pm, srcX, srcY);
 }
 
 bool SkSurface::readPixels(const SkImageInfo& dstInfo, void* dstPixels, size_t dstRowBytes,
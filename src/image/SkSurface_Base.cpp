@@ -54,6 +54,14 @@ void SkSurface_Base::onDraw(SkCanvas* canvas, SkScalar x, SkScalar y,
     }
 }
 
+bool SkSurface_Base::onPeekPixels(SkPixmap* pmap) {
+    return this->getCachedCanvas()->peekPixels(pmap);
+}
+
+bool SkSurface_Base::onReadPixels(const SkPixmap& dst, int srcX, int srcY) {
+    return this->getCachedCanvas()->readPixels(dst, srcX, srcY);
+}
+
 void SkSurface_Base::onAsyncRescaleAndReadPixels(const SkImageInfo& info,
                                                  SkIRect origSrcRect,
                                                  SkSurface::RescaleGamma rescaleGamma,
@@ -124,6 +124,12 @@ public:
 
     virtual void onWritePixels(const SkPixmap&, int x, int y) = 0;
 
+    /**
+     *  Default implementations peek and read through this surface's canvas.
+     */
+    virtual bool onPeekPixels(SkPixmap*);
+    virtual bool onReadPixels(const SkPixmap& dst, int srcX, int srcY);
+
     /**
      * Default implementation does a rescale/read and then calls the callback.
      */
@@ -49,6 +49,9 @@ public:
     void onRestoreBackingMutability() override;
     sk_sp<const SkCapabilities> onCapabilities() override;
 
+protected:
+    const SkBitmap& bitmap() const { return fBitmap; }
+
 private:
     SkBitmap    fBitmap;
     bool        fWeOwnThePixels;
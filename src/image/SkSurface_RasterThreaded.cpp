@@ -0,0 +1,244 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkBBHFactory.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkMallocPixelRef.h"
+#include "include/core/SkPixelRef.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkSurface.h"
+#include "include/private/base/SkTArray.h"
+#include "include/private/base/SkTemplates.h"
+#include "src/core/SkBigPicture.h"
+#include "src/core/SkRecord.h"
+#include "src/core/SkRecordDraw.h"
+#include "src/core/SkRecorder.h"
+#include "src/core/SkRecords.h"
+#include "src/core/SkSurfacePriv.h"
+#include "src/image/SkSurface_Raster.h"
+
+#include <memory>
+#include <utility>
+
+using namespace skia_private;
+using SkRecords::OpKind;
+
+namespace {
+
+// Tiles are square, and small enough that a few large draws still spread across all threads.
+constexpr int kTileSize = 256;
+
+// A raster surface that records draws and rasterizes them in parallel, one tile per task.
+//
+// Draws are recorded into an SkRecord until something needs the pixels (a snapshot, a read,
+// a write, or drawing this surface).  Then we compute bounds for each op just like an
+// SkPicture's SkBBoxHierarchy does, bin the draws by the tiles they touch, and play each tile
+// back on the executor into its own SkCanvas, limited to writing that tile
+// (SkRecordDrawTiled()).  Each tile canvas shares our pixels but has its own device and
+// SkRasterClip, and draws are rasterized in device space exactly as an SkSurface_Raster would,
+// so the results are identical.  The cost is that a draw spanning several tiles is scan
+// converted once per tile; only the shading and blending is split between them.
+//
+// Any matrix, clip, or save state still active when we flush stays recorded, and is replayed
+// ahead of the next batch of draws.  Layers don't split into tiles, so each outermost
+// saveLayer() through its restore() is drawn on one thread, with the draws around it still
+// tiled, and a layer still open when we flush is left recorded, along with everything after it,
+// until it's restored.  Its contents aren't in our pixels yet, just as with an SkSurface_Raster.
+class SkSurface_RasterThreaded final : public SkSurface_Raster {
+public:
+    SkSurface_RasterThreaded(const SkImageInfo& info,
+                             sk_sp<SkPixelRef> pr,
+                             SkExecutor& executor,
+                             const SkSurfaceProps* props)
+            : INHERITED(info, std::move(pr), props)
+            , fExecutor(executor)
+            , fRecord(sk_make_sp<SkRecord>()) {}
+
+    SkCanvas* onNewCanvas() override {
+        SkASSERT(!fRecorder);
+        fRecorder = new SkRecorder(fRecord.get(), SkRect::Make(this->bitmap().dimensions()));
+        return fRecorder;
+    }
+
+    sk_sp<SkSurface> onNewSurface(const SkImageInfo& info) override {
+        return SkSurfaces::RasterThreaded(info, fExecutor, &this->props());
+    }
+
+    sk_sp<SkImage> onNewImageSnapshot(const SkIRect* subset) override {
+        this->flushRecordedDraws();
+        return this->INHERITED::onNewImageSnapshot(subset);
+    }
+
+    void onWritePixels(const SkPixmap& src, int x, int y) override {
+        this->flushRecordedDraws();
+        this->INHERITED::onWritePixels(src, x, y);
+    }
+
+    bool onPeekPixels(SkPixmap* pm) override {
+        this->flushRecordedDraws();
+        return this->bitmap().peekPixels(pm);
+    }
+
+    bool onReadPixels(const SkPixmap& dst, int srcX, int srcY) override {
+        this->flushRecordedDraws();
+        return this->bitmap().readPixels(dst, srcX, srcY);
+    }
+
+    void onDraw(SkCanvas* canvas, SkScalar x, SkScalar y,
+                const SkSamplingOptions& sampling, const SkPaint* paint) override {
+        this->flushRecordedDraws();
+        this->INHERITED::onDraw(canvas, x, y, sampling, paint);
+    }
+
+    void onDiscard() override {
+        // Whatever we haven't drawn yet is about to be overwritten anyway.
+        if (fRecorder) {
+            this->advanceFlushedOps(fRecord->count());
+        }
+    }
+
+    // SkSurface_Raster::onCopyOnWrite() works for us as-is: it forks our bitmap, and our canvas
+    // is an SkRecorder that ignores being told about the new one.
+
+private:
+    // Rasterize every op recorded since the last flush into our bitmap.
+    void flushRecordedDraws() {
+        if (!fRecorder) {
+            return;
+        }
+        const SkRecord& record = *fRecord;
+        const int count = this->firstOpenLayer();
+        if (count == fFlushedOps) {
+            return;
+        }
+        const SkRect cull = SkRect::Make(this->bitmap().dimensions());
+
+        // These are the same bounds SkPictureRecorder feeds to an SkBBoxHierarchy.
+        AutoTMalloc<SkRect>                   bounds(record.count());
+        AutoTMalloc<SkBBoxHierarchy::Metadata> meta(record.count());
+        SkRecordFillBounds(cull, record, bounds, meta);
+
+        SkDrawableList* drawableList = fRecorder->getDrawableList();
+        std::unique_ptr<SkBigPicture::SnapshotArray> drawablePicts{
+            drawableList ? drawableList->newDrawableSnapshot() : nullptr
+        };
+
+        SkRecordDrawTiled(record, fFlushedOps, count, fLiveStateOps, bounds,
+                          drawablePicts ? drawablePicts->begin() : nullptr,
+                          drawablePicts ? drawablePicts->count() : 0,
+                          this->bitmap(), this->props(), SkM44(),
+                          SkIRect::MakeSize(this->bitmap().dimensions()),
+                          {kTileSize, kTileSize}, fExecutor);
+
+        this->advanceFlushedOps(count);
+    }
+
+    // The index of the outermost saveLayer() that hasn't been restored yet, or the number of
+    // recorded ops if there isn't one.
+    int firstOpenLayer() const {
+        TArray<int> saves;  // Indices of the unrestored saves since fFlushedOps.
+        int firstLayer = fRecord->count();
+        for (int i = fFlushedOps; i < fRecord->count(); i++) {
+            switch (SkRecords::Classify(*fRecord, i)) {
+                case OpKind::kSave:
+                case OpKind::kSaveLayer:
+                    saves.push_back(i);
+                    break;
+                case OpKind::kRestore:
+                    if (!saves.empty()) {
+                        saves.pop_back();
+                    }
+                    break;
+                case OpKind::kState:
+                case OpKind::kDraw:
+                    break;
+            }
+        }
+        for (int i : saves) {
+            if (SkRecords::Classify(*fRecord, i) == OpKind::kSaveLayer) {
+                firstLayer = i;
+                break;
+            }
+        }
+        return firstLayer;
+    }
+
+    // Advance fFlushedOps to upTo, keeping track of which state ops are still in effect there.
+    void advanceFlushedOps(int upTo) {
+        for (int i = fFlushedOps; i < upTo; i++) {
+            switch (OpKind kind = SkRecords::Classify(*fRecord, i)) {
+                case OpKind::kSave:
+                case OpKind::kSaveLayer:
+                    fLiveSaves.push_back(fLiveStateOps.size());
+                    fLiveStateOps.push_back(i);
+                    break;
+                case OpKind::kRestore:
+                    if (!fLiveSaves.empty()) {
+                        fLiveStateOps.resize(fLiveSaves.back());
+                        fLiveSaves.pop_back();
+                    }
+                    break;
+                case OpKind::kState:
+                    fLiveStateOps.push_back(i);
+                    break;
+                case OpKind::kDraw:
+                    break;
+            }
+        }
+        fFlushedOps = upTo;
+
+        // When the recording canvas is back to its initial state, nothing recorded so far can
+        // affect future draws, so we can start over with an empty record.
+        if (fFlushedOps == fRecord->count() &&
+            fRecorder->getSaveCount() == 1 &&
+            fRecorder->getTotalMatrix().isIdentity() &&
+            fRecorder->isClipRect() &&
+            fRecorder->getDeviceClipBounds() == SkIRect::MakeSize(this->bitmap().dimensions())) {
+            fRecord = sk_make_sp<SkRecord>();
+            fRecorder->reset(fRecord.get(), SkRect::Make(this->bitmap().dimensions()));
+            fFlushedOps = 0;
+            fLiveStateOps.clear();
+            fLiveSaves.clear();
+        }
+    }
+
+    SkExecutor&     fExecutor;
+    sk_sp<SkRecord> fRecord;
+    SkRecorder*     fRecorder = nullptr;  // Owned by SkSurface_Base as our cached canvas.
+
+    // Ops before fFlushedOps have already been drawn into our bitmap.  fLiveStateOps are the state
+    // ops among them still in effect, and fLiveSaves indexes the saves in fLiveStateOps.
+    int              fFlushedOps = 0;
+    TArray<int>      fLiveStateOps;
+    TArray<int>      fLiveSaves;
+
+    using INHERITED = SkSurface_Raster;
+};
+
+}  // namespace
+
+namespace SkSurfaces {
+
+sk_sp<SkSurface> RasterThreaded(const SkImageInfo& info,
+                                SkExecutor& executor,
+                                const SkSurfaceProps* props) {
+    if (!SkSurfaceValidateRasterInfo(info)) {
+        return nullptr;
+    }
+
+    sk_sp<SkPixelRef> pr = SkMallocPixelRef::MakeAllocate(info, 0);
+    if (!pr) {
+        return nullptr;
+    }
+    return sk_make_sp<SkSurface_RasterThreaded>(info, std::move(pr), executor, props);
+}
+
+}  // namespace SkSurfaces
@@ -48,6 +48,12 @@ namespace SkOpts {
         start_pipeline_lowp = SK_OPTS_NS::lowp::start_pipeline;
     #undef M
 
+    #define M(st) ops_lowp_hsw[(int)SkRasterPipelineOp::st] = (StageFn)SK_OPTS_NS::lowp::st;
+        SK_RASTER_PIPELINE_OPS_LOWP(M)
+        just_return_lowp_hsw = (StageFn)SK_OPTS_NS::lowp::just_return;
+        start_pipeline_lowp_hsw = SK_OPTS_NS::lowp::start_pipeline;
+    #undef M
+
     #if defined(SK_ENABLE_SKVM)
         interpret_skvm = SK_OPTS_NS::interpret_skvm;
     #endif
@@ -10,10 +10,23 @@
 #if !defined(SK_ENABLE_OPTIMIZE_SIZE)
 
 #define SK_OPTS_NS skx
+// Init_skx() only takes the lowp stages, so don't build the highp ones.
+#define SK_RASTER_PIPELINE_LOWP_ONLY
+#include "src/opts/SkRasterPipeline_opts.h"
 #include "src/opts/SkVM_opts.h"
 
 namespace SkOpts {
     void Init_skx() {
+        // Only lowp gets wider on SKX; the highp stages set by Init_hsw() are already the best
+        // we have.
+        raster_pipeline_lowp_stride = SK_OPTS_NS::raster_pipeline_lowp_stride();
+
+    #define M(st) ops_lowp[(int)SkRasterPipelineOp::st] = (StageFn)SK_OPTS_NS::lowp::st;
+        SK_RASTER_PIPELINE_OPS_LOWP(M)
+        just_return_lowp = (StageFn)SK_OPTS_NS::lowp::just_return;
+        start_pipeline_lowp = SK_OPTS_NS::lowp::start_pipeline;
+    #undef M
+
 #if defined(SK_ENABLE_SKVM)
         interpret_skvm = SK_OPTS_NS::interpret_skvm;
 #endif
@@ -64,6 +64,11 @@ using NoCtx = const void*;
     #define JUMPER_IS_SCALAR
 #endif
 
+// AVX-512 gets its own double-width lowp pipeline; highp keeps using the HSW float code.
+#if defined(JUMPER_IS_HSW) && SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SKX
+    #define JUMPER_IS_SKX
+#endif
+
 // Older Clangs seem to crash when generating non-optimized NEON code for ARMv7.
 #if defined(__clang__) && !defined(__OPTIMIZE__) && defined(SK_CPU_ARM32)
     // Apple Clang 9 and vanilla Clang 5 are fine, and may even be conservative.
@@ -1171,6 +1176,10 @@ static constexpr size_t N = sizeof(F) / sizeof(float);
                              std::byte* base, F,F,F,F, F,F,F,F);
 #endif
 
+// A TU that only wants the lowp stages (e.g. SkOpts_skx.cpp, whose highp stages would never be
+// used) can define SK_RASTER_PIPELINE_LOWP_ONLY to skip compiling everything from here to lowp.
+#if !defined(SK_RASTER_PIPELINE_LOWP_ONLY)
+
 static void start_pipeline(size_t dx, size_t dy,
                            size_t xlimit, size_t ylimit,
                            SkRasterPipelineStage* program) {
@@ -4487,6 +4496,8 @@ STAGE(swizzle, void* ctx) {
     }
 }
 
+#endif//!defined(SK_RASTER_PIPELINE_LOWP_ONLY)
+
 namespace lowp {
 #if defined(JUMPER_IS_SCALAR) || defined(SK_DISABLE_LOWP_RASTER_PIPELINE)
     // If we're not compiled by Clang, or otherwise switched into scalar mode (old Clang, manually),
@@ -4501,7 +4512,16 @@ namespace lowp {
 
 #else  // We are compiling vector code with Clang... let's make some lowp stages!
 
-#if defined(JUMPER_IS_HSW)
+#if defined(JUMPER_IS_SKX)
+    using U8  = uint8_t  __attribute__((ext_vector_type(32)));
+    using U16 = uint16_t __attribute__((ext_vector_type(32)));
+    using I16 =  int16_t __attribute__((ext_vector_type(32)));
+    using I32 =  int32_t __attribute__((ext_vector_type(32)));
+    using U32 = uint32_t __attribute__((ext_vector_type(32)));
+    using I64 =  int64_t __attribute__((ext_vector_type(32)));
+    using U64 = uint64_t __attribute__((ext_vector_type(32)));
+    using F   = float    __attribute__((ext_vector_type(32)));
+#elif defined(JUMPER_IS_HSW)
     using U8  = uint8_t  __attribute__((ext_vector_type(16)));
     using U16 = uint16_t __attribute__((ext_vector_type(16)));
     using I16 =  int16_t __attribute__((ext_vector_type(16)));
@@ -4774,7 +4794,15 @@ SI U32 trunc_(F x) { return (U32)cast<I32>(x); }
 
 // Use approximate instructions and one Newton-Raphson step to calculate 1/x.
 SI F rcp_precise(F x) {
-#if defined(JUMPER_IS_HSW)
+#if defined(JUMPER_IS_SKX)
+    auto rcp = [](__m512 v) {
+        __m512 est = _mm512_rcp14_ps(v);  // 14-bit estimate, then one refinement step.
+        return _mm512_mul_ps(est, _mm512_fnmadd_ps(v, est, _mm512_set1_ps(2.0f)));
+    };
+    __m512 lo,hi;
+    split(x, &lo,&hi);
+    return join<F>(rcp(lo), rcp(hi));
+#elif defined(JUMPER_IS_HSW)
     __m256 lo,hi;
     split(x, &lo,&hi);
     return join<F>(SK_OPTS_NS::rcp_precise(lo), SK_OPTS_NS::rcp_precise(hi));
@@ -4791,7 +4819,11 @@ SI F rcp_precise(F x) {
 #endif
 }
 SI F sqrt_(F x) {
-#if defined(JUMPER_IS_HSW)
+#if defined(JUMPER_IS_SKX)
+    __m512 lo,hi;
+    split(x, &lo,&hi);
+    return join<F>(_mm512_sqrt_ps(lo), _mm512_sqrt_ps(hi));
+#elif defined(JUMPER_IS_HSW)
     __m256 lo,hi;
     split(x, &lo,&hi);
     return join<F>(_mm256_sqrt_ps(lo), _mm256_sqrt_ps(hi));
@@ -4826,6 +4858,10 @@ SI F floor_(F x) {
     float32x4_t lo,hi;
     split(x, &lo,&hi);
     return join<F>(vrndmq_f32(lo), vrndmq_f32(hi));
+#elif defined(JUMPER_IS_SKX)
+    __m512 lo,hi;
+    split(x, &lo,&hi);
+    return join<F>(_mm512_floor_ps(lo), _mm512_floor_ps(hi));
 #elif defined(JUMPER_IS_HSW)
     __m256 lo,hi;
     split(x, &lo,&hi);
@@ -4846,7 +4882,9 @@ SI F floor_(F x) {
 // The result is a number on [-1, 1).
 // Note: on neon this is a saturating multiply while the others are not.
 SI I16 scaled_mult(I16 a, I16 b) {
-#if defined(JUMPER_IS_HSW)
+#if defined(JUMPER_IS_SKX)
+    return _mm512_mulhrs_epi16(a, b);
+#elif defined(JUMPER_IS_HSW)
     return _mm256_mulhrs_epi16(a, b);
 #elif defined(JUMPER_IS_SSE41) || defined(JUMPER_IS_AVX)
     return _mm_mulhrs_epi16(a, b);
@@ -4887,6 +4925,8 @@ STAGE_GG(seed_shader, NoCtx) {
     static constexpr float iota[] = {
         0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f,
         8.5f, 9.5f,10.5f,11.5f,12.5f,13.5f,14.5f,15.5f,
+       16.5f,17.5f,18.5f,19.5f,20.5f,21.5f,22.5f,23.5f,
+       24.5f,25.5f,26.5f,27.5f,28.5f,29.5f,30.5f,31.5f,
     };
     x = cast<F>(I32(dx)) + sk_unaligned_load<F>(iota);
     y = cast<F>(I32(dy)) + 0.5f;
@@ -5097,6 +5137,24 @@ SI V load(const T* ptr, size_t tail) {
     V v = 0;
     switch (tail & (N-1)) {
         case  0: memcpy(&v, ptr, sizeof(v)); break;
+    #if defined(JUMPER_IS_SKX)
+        case 31: v[30] = ptr[30]; [[fallthrough]];
+        case 30: v[29] = ptr[29]; [[fallthrough]];
+        case 29: v[28] = ptr[28]; [[fallthrough]];
+        case 28: memcpy(&v, ptr, 28*sizeof(T)); break;
+        case 27: v[26] = ptr[26]; [[fallthrough]];
+        case 26: v[25] = ptr[25]; [[fallthrough]];
+        case 25: v[24] = ptr[24]; [[fallthrough]];
+        case 24: memcpy(&v, ptr, 24*sizeof(T)); break;
+        case 23: v[22] = ptr[22]; [[fallthrough]];
+        case 22: v[21] = ptr[21]; [[fallthrough]];
+        case 21: v[20] = ptr[20]; [[fallthrough]];
+        case 20: memcpy(&v, ptr, 20*sizeof(T)); break;
+        case 19: v[18] = ptr[18]; [[fallthrough]];
+        case 18: v[17] = ptr[17]; [[fallthrough]];
+        case 17: v[16] = ptr[16]; [[fallthrough]];
+        case 16: memcpy(&v, ptr, 16*sizeof(T)); break;
+    #endif
     #if defined(JUMPER_IS_HSW)
         case 15: v[14] = ptr[14]; [[fallthrough]];
         case 14: v[13] = ptr[13]; [[fallthrough]];
@@ -5121,6 +5179,24 @@ template <typename V, typename T>
 SI void store(T* ptr, size_t tail, V v) {
     switch (tail & (N-1)) {
         case  0: memcpy(ptr, &v, sizeof(v)); break;
+    #if defined(JUMPER_IS_SKX)
+        case 31: ptr[30] = v[30]; [[fallthrough]];
+        case 30: ptr[29] = v[29]; [[fallthrough]];
+        case 29: ptr[28] = v[28]; [[fallthrough]];
+        case 28: memcpy(ptr, &v, 28*sizeof(T)); break;
+        case 27: ptr[26] = v[26]; [[fallthrough]];
+        case 26: ptr[25] = v[25]; [[fallthrough]];
+        case 25: ptr[24] = v[24]; [[fallthrough]];
+        case 24: memcpy(ptr, &v, 24*sizeof(T)); break;
+        case 23: ptr[22] = v[22]; [[fallthrough]];
+        case 22: ptr[21] = v[21]; [[fallthrough]];
+        case 21: ptr[20] = v[20]; [[fallthrough]];
+        case 20: memcpy(ptr, &v, 20*sizeof(T)); break;
+        case 19: ptr[18] = v[18]; [[fallthrough]];
+        case 18: ptr[17] = v[17]; [[fallthrough]];
+        case 17: ptr[16] = v[16]; [[fallthrough]];
+        case 16: memcpy(ptr, &v, 16*sizeof(T)); break;
+    #endif
     #if defined(JUMPER_IS_HSW)
         case 15: ptr[14] = v[14]; [[fallthrough]];
         case 14: ptr[13] = v[13]; [[fallthrough]];
@@ -5141,7 +5217,37 @@ SI void store(T* ptr, size_t tail, V v) {
     }
 }
 
-#if defined(JUMPER_IS_HSW)
+#if defined(JUMPER_IS_SKX)
+    template <typename V, typename T>
+    SI V gather(const T* ptr, U32 ix) {
+        return V{ ptr[ix[ 0]], ptr[ix[ 1]], ptr[ix[ 2]], ptr[ix[ 3]],
+                  ptr[ix[ 4]], ptr[ix[ 5]], ptr[ix[ 6]], ptr[ix[ 7]],
+                  ptr[ix[ 8]], ptr[ix[ 9]], ptr[ix[10]], ptr[ix[11]],
+                  ptr[ix[12]], ptr[ix[13]], ptr[ix[14]], ptr[ix[15]],
+                  ptr[ix[16]], ptr[ix[17]], ptr[ix[18]], ptr[ix[19]],
+                  ptr[ix[20]], ptr[ix[21]], ptr[ix[22]], ptr[ix[23]],
+                  ptr[ix[24]], ptr[ix[25]], ptr[ix[26]], ptr[ix[27]],
+                  ptr[ix[28]], ptr[ix[29]], ptr[ix[30]], ptr[ix[31]], };
+    }
+
+    template<>
+    F gather(const float* ptr, U32 ix) {
+        __m512i lo, hi;
+        split(ix, &lo, &hi);
+
+        return join<F>(_mm512_i32gather_ps(lo, ptr, 4),
+                       _mm512_i32gather_ps(hi, ptr, 4));
+    }
+
+    template<>
+    U32 gather(const uint32_t* ptr, U32 ix) {
+        __m512i lo, hi;
+        split(ix, &lo, &hi);
+
+        return join<U32>(_mm512_i32gather_epi32(lo, ptr, 4),
+                         _mm512_i32gather_epi32(hi, ptr, 4));
+    }
+#elif defined(JUMPER_IS_HSW)
     template <typename V, typename T>
     SI V gather(const T* ptr, U32 ix) {
         return V{ ptr[ix[ 0]], ptr[ix[ 1]], ptr[ix[ 2]], ptr[ix[ 3]],
@@ -5179,7 +5285,14 @@ SI void store(T* ptr, size_t tail, V v) {
 // ~~~~~~ 32-bit memory loads and stores ~~~~~~ //
 
 SI void from_8888(U32 rgba, U16* r, U16* g, U16* b, U16* a) {
-#if defined(JUMPER_IS_HSW)
+#if defined(JUMPER_IS_SKX)
+    // AVX-512 can narrow 32-bit lanes to 16-bit in order, so there's no need to shuffle first.
+    auto cast_U16 = [](U32 v) -> U16 {
+        __m512i lo,hi;
+        split(v, &lo,&hi);
+        return join<U16>(_mm512_cvtepi32_epi16(lo), _mm512_cvtepi32_epi16(hi));
+    };
+#elif defined(JUMPER_IS_HSW)
     // Swap the middle 128-bit lanes to make _mm256_packus_epi32() in cast_U16() work out nicely.
     __m256i _01,_23;
     split(rgba, &_01, &_23);
@@ -5660,7 +5773,27 @@ SI void gradient_lookup(const SkRasterPipeline_GradientCtx* c, U32 idx, F t,
                         U16* r, U16* g, U16* b, U16* a) {
 
     F fr, fg, fb, fa, br, bg, bb, ba;
-#if defined(JUMPER_IS_HSW)
+#if defined(JUMPER_IS_SKX)
+    if (c->stopCount <= 16) {
+        // The masked load won't touch anything past the stops that were actually allocated.
+        const __mmask16 stops = (__mmask16)((1u << c->stopCount) - 1);
+        __m512i lo, hi;
+        split(idx, &lo, &hi);
+
+        auto lookup = [&](const float* table) {
+            __m512 t = _mm512_maskz_loadu_ps(stops, table);
+            return join<F>(_mm512_permutexvar_ps(lo, t), _mm512_permutexvar_ps(hi, t));
+        };
+        fr = lookup(c->fs[0]);
+        br = lookup(c->bs[0]);
+        fg = lookup(c->fs[1]);
+        bg = lookup(c->bs[1]);
+        fb = lookup(c->fs[2]);
+        bb = lookup(c->bs[2]);
+        fa = lookup(c->fs[3]);
+        ba = lookup(c->bs[3]);
+    } else
+#elif defined(JUMPER_IS_HSW)
     if (c->stopCount <=8) {
         __m256i lo, hi;
         split(idx, &lo, &hi);
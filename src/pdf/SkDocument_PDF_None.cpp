@@ -13,6 +13,8 @@ class SkPDFArray {};
 
 sk_sp<SkDocument> SkPDF::MakeDocument(SkWStream*, const SkPDF::Metadata&) { return nullptr; }
 
+sk_sp<SkPDF::ImageCache> SkPDF::ImageCache::Make(size_t) { return nullptr; }
+
 void SkPDF::SetNodeId(SkCanvas* c, int n) {
     c->drawAnnotation({0, 0, 0, 0}, "PDF_Node_Key", SkData::MakeWithCopy(&n, sizeof(n)).get());
 }
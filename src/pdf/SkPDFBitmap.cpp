@@ -17,9 +17,11 @@
 #include "include/private/SkColorData.h"
 #include "include/private/base/SkTo.h"
 #include "src/core/SkImageInfoPriv.h"
+#include "src/core/SkMD5.h"
 #include "src/pdf/SkDeflate.h"
 #include "src/pdf/SkJpegInfo.h"
 #include "src/pdf/SkPDFDocumentPriv.h"
+#include "src/pdf/SkPDFImageCache.h"
 #include "src/pdf/SkPDFTypes.h"
 #include "src/pdf/SkPDFUtils.h"
 
@@ -68,10 +70,6 @@ static SkColor get_neighbor_avg_color(const SkPixmap& bm, int xOrig, int yOrig)
                  : SK_ColorTRANSPARENT;
 }
 
-namespace {
-enum class SkPDFStreamFormat { DCT, Flate, Uncompressed };
-}
-
 template <typename T>
 static void emit_image_stream(SkPDFDocument* doc,
                               SkPDFIndirectReference ref,
@@ -113,18 +111,49 @@ static void emit_image_stream(SkPDFDocument* doc,
     doc->emitStream(pdfDict, std::move(writeStream), ref);
 }
 
-static void do_deflated_alpha(const SkPixmap& pm, SkPDFDocument* doc, SkPDFIndirectReference ref) {
-    SkPDF::Metadata::CompressionLevel compressionLevel = doc->metadata().fCompressionLevel;
-    SkPDFStreamFormat format = compressionLevel == SkPDF::Metadata::CompressionLevel::None
-                             ? SkPDFStreamFormat::Uncompressed
-                             : SkPDFStreamFormat::Flate;
+// Returns the stream to write an image's pixels to.  These are usually deflated as they are
+// written, but a document's own Metadata::fDeflate is given them all at once, in
+// finish_pixel_stream().
+static SkWStream* begin_pixel_stream(const SkPDFDocument* doc,
+                                     SkPDFStreamFormat format,
+                                     SkDynamicMemoryWStream* buffer,
+                                     std::optional<SkDeflateWStream>* deflateWStream) {
+    if (format == SkPDFStreamFormat::Flate && !doc->metadata().fDeflate) {
+        deflateWStream->emplace(buffer, SkToInt(doc->metadata().fCompressionLevel));
+        return &**deflateWStream;
+    }
+    return buffer;
+}
+
+// Returns the image's pixels written to |buffer|, in |format|.
+static sk_sp<SkData> finish_pixel_stream(const SkPDFDocument* doc,
+                                         SkPDFStreamFormat format,
+                                         SkDynamicMemoryWStream* buffer,
+                                         std::optional<SkDeflateWStream>* deflateWStream) {
+    if (*deflateWStream) {
+        (*deflateWStream)->finalize();
+    } else if (format == SkPDFStreamFormat::Flate) {
+        sk_sp<SkData> pixels = buffer->detachAsData();
+        sk_sp<SkData> compressed = SkPDFDeflate(doc, pixels->data(), pixels->size());
+        buffer->write(compressed->data(), compressed->size());
+    }
+    #ifdef SK_PDF_BASE85_BINARY
+    SkPDFUtils::Base85Encode(buffer->detachAsStream(), buffer);
+    #endif
+    return buffer->detachAsData();
+}
+
+static SkPDFStreamFormat deflated_format(const SkPDFDocument* doc) {
+    return doc->metadata().fCompressionLevel == SkPDF::Metadata::CompressionLevel::None
+           ? SkPDFStreamFormat::Uncompressed
+           : SkPDFStreamFormat::Flate;
+}
+
+static sk_sp<SkData> do_deflated_alpha(const SkPixmap& pm, const SkPDFDocument* doc) {
+    SkPDFStreamFormat format = deflated_format(doc);
     SkDynamicMemoryWStream buffer;
-    SkWStream* stream = &buffer;
     std::optional<SkDeflateWStream> deflateWStream;
-    if (format == SkPDFStreamFormat::Flate) {
-        deflateWStream.emplace(&buffer, SkToInt(compressionLevel));
-        stream = &*deflateWStream;
-    }
+    SkWStream* stream = begin_pixel_stream(doc, format, &buffer, &deflateWStream);
     if (kAlpha_8_SkColorType == pm.colorType()) {
         SkASSERT(pm.rowBytes() == (size_t)pm.width());
         stream->write(pm.addr8(), pm.width() * pm.height());
@@ -147,45 +176,23 @@ static void do_deflated_alpha(const SkPixmap& pm, SkPDFDocument* doc, SkPDFIndir
         }
         stream->write(byteBuffer, dst - byteBuffer);
     }
-    if (deflateWStream) {
-        deflateWStream->finalize();
-    }
-
-    #ifdef SK_PDF_BASE85_BINARY
-    SkPDFUtils::Base85Encode(buffer.detachAsStream(), &buffer);
-    #endif
-    int length = SkToInt(buffer.bytesWritten());
-    emit_image_stream(doc, ref, [&buffer](SkWStream* stream) { buffer.writeToAndReset(stream); },
-                      pm.info().dimensions(), "DeviceGray", SkPDFIndirectReference(),
-                      length, format);
+    return finish_pixel_stream(doc, format, &buffer, &deflateWStream);
 }
 
-static void do_deflated_image(const SkPixmap& pm,
-                              SkPDFDocument* doc,
-                              bool isOpaque,
-                              SkPDFIndirectReference ref) {
-    SkPDFIndirectReference sMask;
-    if (!isOpaque) {
-        sMask = doc->reserveRef();
-    }
-    SkPDF::Metadata::CompressionLevel compressionLevel = doc->metadata().fCompressionLevel;
-    SkPDFStreamFormat format = compressionLevel == SkPDF::Metadata::CompressionLevel::None
-                             ? SkPDFStreamFormat::Uncompressed
-                             : SkPDFStreamFormat::Flate;
+static sk_sp<SkPDFEncodedImage> do_deflated_image(const SkPixmap& pm,
+                                                  const SkPDFDocument* doc,
+                                                  bool isOpaque) {
+    SkPDFStreamFormat format = deflated_format(doc);
     SkDynamicMemoryWStream buffer;
-    SkWStream* stream = &buffer;
     std::optional<SkDeflateWStream> deflateWStream;
-    if (format == SkPDFStreamFormat::Flate) {
-        deflateWStream.emplace(&buffer, SkToInt(compressionLevel));
-        stream = &*deflateWStream;
-    }
+    SkWStream* stream = begin_pixel_stream(doc, format, &buffer, &deflateWStream);
     const char* colorSpace = "DeviceGray";
     switch (pm.colorType()) {
         case kAlpha_8_SkColorType:
             fill_stream(stream, '\x00', pm.width() * pm.height());
             break;
         case kGray_8_SkColorType:
-            SkASSERT(sMask.fValue = -1);
+            SkASSERT(isOpaque);
             SkASSERT(pm.rowBytes() == (size_t)pm.width());
             stream->write(pm.addr8(), pm.width() * pm.height());
             break;
@@ -216,35 +223,31 @@ static void do_deflated_image(const SkPixmap& pm,
             }
             stream->write(byteBuffer, dst - byteBuffer);
     }
-    if (deflateWStream) {
-        deflateWStream->finalize();
-    }
-    #ifdef SK_PDF_BASE85_BINARY
-    SkPDFUtils::Base85Encode(buffer.detachAsStream(), &buffer);
-    #endif
-    int length = SkToInt(buffer.bytesWritten());
-    emit_image_stream(doc, ref, [&buffer](SkWStream* stream) { buffer.writeToAndReset(stream); },
-                      pm.info().dimensions(), colorSpace, sMask, length, format);
+    auto image = sk_make_sp<SkPDFEncodedImage>();
+    image->fSize = pm.info().dimensions();
+    image->fColorSpace = colorSpace;
+    image->fFormat = format;
+    image->fData = finish_pixel_stream(doc, format, &buffer, &deflateWStream);
     if (!isOpaque) {
-        do_deflated_alpha(pm, doc, sMask);
+        image->fAlpha = do_deflated_alpha(pm, doc);
     }
+    return image;
 }
 
-static bool do_jpeg(sk_sp<SkData> data, SkPDFDocument* doc, SkISize size,
-                    SkPDFIndirectReference ref) {
+static sk_sp<SkPDFEncodedImage> do_jpeg(sk_sp<SkData> data, SkISize size) {
     SkISize jpegSize;
     SkEncodedInfo::Color jpegColorType;
     SkEncodedOrigin exifOrientation;
     if (!SkGetJpegInfo(data->data(), data->size(), &jpegSize,
                        &jpegColorType, &exifOrientation)) {
-        return false;
+        return nullptr;
     }
     bool yuv = jpegColorType == SkEncodedInfo::kYUV_Color;
     bool goodColorType = yuv || jpegColorType == SkEncodedInfo::kGray_Color;
     if (jpegSize != size  // Safety check.
             || !goodColorType
             || kTopLeft_SkEncodedOrigin != exifOrientation) {
-        return false;
+        return nullptr;
     }
     #ifdef SK_PDF_BASE85_BINARY
     SkDynamicMemoryWStream buffer;
@@ -252,11 +255,12 @@ static bool do_jpeg(sk_sp<SkData> data, SkPDFDocument* doc, SkISize size,
     data = buffer.detachAsData();
     #endif
 
-    emit_image_stream(doc, ref,
-                      [&data](SkWStream* dst) { dst->write(data->data(), data->size()); },
-                      jpegSize, yuv ? "DeviceRGB" : "DeviceGray",
-                      SkPDFIndirectReference(), SkToInt(data->size()), SkPDFStreamFormat::DCT);
-    return true;
+    auto image = sk_make_sp<SkPDFEncodedImage>();
+    image->fSize = jpegSize;
+    image->fColorSpace = yuv ? "DeviceRGB" : "DeviceGray";
+    image->fFormat = SkPDFStreamFormat::DCT;
+    image->fData = std::move(data);
+    return image;
 }
 
 static SkBitmap to_pixels(const SkImage* image) {
@@ -283,20 +287,22 @@ static SkBitmap to_pixels(const SkImage* image) {
     return bm;
 }
 
-void serialize_image(const SkImage* img,
-                     int encodingQuality,
-                     SkPDFDocument* doc,
-                     SkPDFIndirectReference ref) {
-    SkASSERT(img);
-    SkASSERT(doc);
-    SkASSERT(encodingQuality >= 0);
+// Encodes |img|, whose encoded data is |encoded| (if any), and whose pixels are in |bm| if they
+// have already been read.
+static sk_sp<SkPDFEncodedImage> encode_image(const SkImage* img,
+                                             sk_sp<SkData> encoded,
+                                             SkBitmap bm,
+                                             int encodingQuality,
+                                             const SkPDFDocument* doc) {
     SkISize dimensions = img->dimensions();
-    if (sk_sp<SkData> data = img->refEncodedData()) {
-        if (do_jpeg(std::move(data), doc, dimensions, ref)) {
-            return;
+    if (encoded) {
+        if (sk_sp<SkPDFEncodedImage> jpeg = do_jpeg(std::move(encoded), dimensions)) {
+            return jpeg;
         }
     }
-    SkBitmap bm = to_pixels(img);
+    if (bm.isNull()) {
+        bm = to_pixels(img);
+    }
     const SkPixmap& pm = bm.pixmap();
     bool isOpaque = pm.isOpaque() || pm.computeIsOpaque();
     if (encodingQuality <= 100 && isOpaque) {
@@ -304,12 +310,88 @@ void serialize_image(const SkImage* img,
         jOpts.fQuality = encodingQuality;
         SkDynamicMemoryWStream stream;
         if (SkJpegEncoder::Encode(&stream, pm, jOpts)) {
-            if (do_jpeg(stream.detachAsData(), doc, dimensions, ref)) {
-                return;
+            if (sk_sp<SkPDFEncodedImage> jpeg = do_jpeg(stream.detachAsData(), dimensions)) {
+                return jpeg;
             }
         }
     }
-    do_deflated_image(pm, doc, isOpaque, ref);
+    return do_deflated_image(pm, doc, isOpaque);
+}
+
+// The key for an image in an SkPDFImageCache: a hash of its contents, and of whatever else
+// changes how it is encoded.  We use its encoded data if it has any, so that finding it in the
+// cache does not need to decode it.
+static SkMD5::Digest image_cache_key(const SkImage* img,
+                                     const sk_sp<SkData>& encoded,
+                                     const SkBitmap& bm,
+                                     int encodingQuality,
+                                     const SkPDFDocument* doc) {
+    SkMD5 md5;
+    const int32_t header[] = {
+        encoded ? 0 : 1 + bm.colorType(),
+        img->width(),
+        img->height(),
+        encodingQuality,
+        SkToInt(doc->metadata().fCompressionLevel),
+    };
+    md5.write(header, sizeof(header));
+    if (encoded) {
+        md5.write(encoded->data(), encoded->size());
+    } else {
+        SkASSERT(bm.rowBytes() == bm.info().minRowBytes());
+        md5.write(bm.getPixels(), bm.computeByteSize());
+    }
+    return md5.finish();
+}
+
+static void emit_encoded_image(const SkPDFEncodedImage& image,
+                               SkPDFDocument* doc,
+                               SkPDFIndirectReference ref) {
+    SkPDFIndirectReference sMask;
+    if (image.fAlpha) {
+        sMask = doc->reserveRef();
+    }
+    emit_image_stream(doc, ref,
+                      [&image](SkWStream* dst) { dst->write(image.fData->data(),
+                                                            image.fData->size()); },
+                      image.fSize, image.fColorSpace, sMask,
+                      SkToInt(image.fData->size()), image.fFormat);
+    if (image.fAlpha) {
+        emit_image_stream(doc, sMask,
+                          [&image](SkWStream* dst) { dst->write(image.fAlpha->data(),
+                                                                image.fAlpha->size()); },
+                          image.fSize, "DeviceGray", SkPDFIndirectReference(),
+                          SkToInt(image.fAlpha->size()), image.fFormat);
+    }
+}
+
+void serialize_image(const SkImage* img,
+                     int encodingQuality,
+                     SkPDFDocument* doc,
+                     SkPDFIndirectReference ref) {
+    SkASSERT(img);
+    SkASSERT(doc);
+    SkASSERT(encodingQuality >= 0);
+    sk_sp<SkData> encoded = img->refEncodedData();
+    SkBitmap bm;
+    auto cache = static_cast<SkPDFImageCache*>(doc->metadata().fImageCache.get());
+    SkMD5::Digest key;
+    if (cache) {
+        if (!encoded) {
+            bm = to_pixels(img);
+        }
+        key = image_cache_key(img, encoded, bm, encodingQuality, doc);
+        if (sk_sp<SkPDFEncodedImage> image = cache->find(key)) {
+            emit_encoded_image(*image, doc, ref);
+            return;
+        }
+    }
+    sk_sp<SkPDFEncodedImage> image =
+            encode_image(img, std::move(encoded), std::move(bm), encodingQuality, doc);
+    emit_encoded_image(*image, doc, ref);
+    if (cache) {
+        cache->add(key, std::move(image));
+    }
 }
 
 SkPDFIndirectReference SkPDFSerializeImage(const SkImage* img,
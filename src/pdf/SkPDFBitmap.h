@@ -7,10 +7,29 @@
 #ifndef SkPDFBitmap_DEFINED
 #define SkPDFBitmap_DEFINED
 
+#include "include/core/SkData.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkSize.h"
+
 class SkImage;
 class SkPDFDocument;
 struct SkPDFIndirectReference;
 
+enum class SkPDFStreamFormat { DCT, Flate, Uncompressed };
+
+/**
+ * The streams of an encoded Image XObject, independent of any one document.
+ */
+struct SkPDFEncodedImage : public SkNVRefCnt<SkPDFEncodedImage> {
+    SkISize fSize;
+    const char* fColorSpace;    // "DeviceRGB" or "DeviceGray"
+    SkPDFStreamFormat fFormat;
+    sk_sp<SkData> fData;
+    sk_sp<SkData> fAlpha;       // The soft mask, also in fFormat, or null if opaque.
+
+    size_t bytesUsed() const { return fData->size() + (fAlpha ? fAlpha->size() : 0); }
+};
+
 /**
  * Serialize a SkImage as an Image Xobject.
  *  quality > 100 means lossless
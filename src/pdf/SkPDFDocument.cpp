@@ -12,6 +12,9 @@
 #include "include/docs/SkPDFDocument.h"
 #include "include/private/base/SkTo.h"
 #include "src/base/SkUTF.h"
+#include "src/core/SkAdvancedTypefaceMetrics.h"
+#include "src/pdf/SkDeflate.h"
+#include "src/pdf/SkPDFBitmap.h"
 #include "src/pdf/SkPDFDevice.h"
 #include "src/pdf/SkPDFFont.h"
 #include "src/pdf/SkPDFGradientShader.h"
@@ -20,6 +23,7 @@
 #include "src/pdf/SkPDFTag.h"
 #include "src/pdf/SkPDFUtils.h"
 
+#include <algorithm>
 #include <utility>
 
 // For use in SkCanvas::drawAnnotation
@@ -83,6 +87,56 @@ int SkPDFOffsetMap::emitCrossReferenceTable(SkWStream* s) const {
     }
     return xRefFileOffset;
 }
+
+static void write_big_endian(SkWStream* s, uint32_t value, int bytes) {
+    for (int i = bytes; i-- > 0;) {
+        s->write8((value >> (8 * i)) & 0xFF);
+    }
+}
+
+int SkPDFOffsetMap::emitCrossReferenceStream(SkWStream* s,
+                                             SkPDFIndirectReference ref,
+                                             SkPDFDict* trailer,
+                                             int compressionLevel) {
+    // The cross-reference stream is an object with an entry of its own.
+    this->markStartOfObject(ref.fValue, s);
+    int xRefFileOffset = fOffsets[SkToSizeT(ref.fValue - 1)];
+
+    // Each entry is a type (0 for free, 1 for in use), a four byte offset, and a two byte
+    // generation number.
+    auto writeEntries = [this](SkWStream* entries) {
+        entries->write8(0);
+        write_big_endian(entries, 0, 4);
+        write_big_endian(entries, 65535, 2);
+        for (int offset : fOffsets) {
+            SkASSERT(offset > 0);  // Offset was set.
+            entries->write8(1);
+            write_big_endian(entries, SkToU32(offset), 4);
+            write_big_endian(entries, 0, 2);
+        }
+    };
+    SkDynamicMemoryWStream entries;
+    trailer->insertInt("Size", this->objectCount());
+    trailer->insertObject("W", SkPDFMakeArray(1, 4, 2));
+    // SkDeflateWStream doesn't handle a compression level of zero.
+    if (compressionLevel != 0) {
+        SkDeflateWStream deflate(&entries, compressionLevel);
+        writeEntries(&deflate);
+        deflate.finalize();
+        trailer->insertName("Filter", "FlateDecode");
+    } else {
+        writeEntries(&entries);
+    }
+    trailer->insertInt("Length", SkToInt(entries.bytesWritten()));
+
+    s->writeDecAsText(ref.fValue);
+    s->writeText(" 0 obj\n");
+    trailer->emitObject(s);
+    s->writeText(" stream\n");
+    entries.writeToAndReset(s);
+    s->writeText("\nendstream\nendobj\n");
+    return xRefFileOffset;
+}
 //
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -93,9 +147,11 @@ static_assert((SKPDF_MAGIC[1] & 0x7F) == "Skia"[1], "");
 static_assert((SKPDF_MAGIC[2] & 0x7F) == "Skia"[2], "");
 static_assert((SKPDF_MAGIC[3] & 0x7F) == "Skia"[3], "");
 #endif
-static void serializeHeader(SkPDFOffsetMap* offsetMap, SkWStream* wStream) {
+static void serializeHeader(SkPDFOffsetMap* offsetMap, SkWStream* wStream, bool streaming) {
     offsetMap->markStartOfDocument(wStream);
-    wStream->writeText("%PDF-1.4\n%" SKPDF_MAGIC "\n");
+    // Cross-reference streams, which we write when streaming, are new in PDF 1.5.
+    wStream->writeText(streaming ? "%PDF-1.5\n%" SKPDF_MAGIC "\n"
+                                 : "%PDF-1.4\n%" SKPDF_MAGIC "\n");
     // The PDF spec recommends including a comment with four
     // bytes, all with their high bits set.  "\xD3\xEB\xE9\xE1" is
     // "Skia" with the high bits set.
@@ -112,15 +168,20 @@ static void begin_indirect_object(SkPDFOffsetMap* offsetMap,
 
 static void end_indirect_object(SkWStream* s) { s->writeText("\nendobj\n"); }
 
-// Xref table and footer
-static void serialize_footer(const SkPDFOffsetMap& offsetMap,
+// Xref table and footer.  If |xrefStream| is set, the xref table and trailer are written as
+// a compressed cross-reference stream with that reference instead.
+static void serialize_footer(SkPDFOffsetMap* offsetMap,
                              SkWStream* wStream,
                              SkPDFIndirectReference infoDict,
                              SkPDFIndirectReference docCatalog,
-                             SkUUID uuid) {
-    int xRefFileOffset = offsetMap.emitCrossReferenceTable(wStream);
-    SkPDFDict trailerDict;
-    trailerDict.insertInt("Size", offsetMap.objectCount());
+                             SkUUID uuid,
+                             SkPDFIndirectReference xrefStream,
+                             int compressionLevel) {
+    const bool writeXrefStream = xrefStream != SkPDFIndirectReference();
+    SkPDFDict trailerDict(writeXrefStream ? "XRef" : nullptr);
+    if (!writeXrefStream) {
+        trailerDict.insertInt("Size", offsetMap->objectCount());
+    }
     SkASSERT(docCatalog != SkPDFIndirectReference());
     trailerDict.insertRef("Root", docCatalog);
     SkASSERT(infoDict != SkPDFIndirectReference());
@@ -128,75 +189,116 @@ static void serialize_footer(const SkPDFOffsetMap& offsetMap,
     if (SkUUID() != uuid) {
         trailerDict.insertObject("ID", SkPDFMetadata::MakePdfId(uuid, uuid));
     }
-    wStream->writeText("trailer\n");
-    trailerDict.emitObject(wStream);
-    wStream->writeText("\nstartxref\n");
+    int xRefFileOffset;
+    if (writeXrefStream) {
+        xRefFileOffset = offsetMap->emitCrossReferenceStream(wStream, xrefStream, &trailerDict,
+                                                             compressionLevel);
+    } else {
+        xRefFileOffset = offsetMap->emitCrossReferenceTable(wStream);
+        wStream->writeText("trailer\n");
+        trailerDict.emitObject(wStream);
+        wStream->writeText("\n");
+    }
+    wStream->writeText("startxref\n");
     wStream->writeBigDecAsText(xRefFileOffset);
     wStream->writeText("\n%%EOF\n");
 }
 
+// PDF wants a tree describing all the pages in the document.  We arbitrary
+// choose 8 (kMaxPageTreeNodeSize) as the number of allowed children.  The internal
+// nodes have type "Pages" with an array of children, a parent pointer, and
+// the number of leaves below the node as "Count."  The leaves have type "Page"
+// and need a parent pointer.
+static constexpr size_t kMaxPageTreeNodeSize = 8;
+
+namespace {
+struct PageTreeNode {
+    std::unique_ptr<SkPDFDict> fNode;
+    SkPDFIndirectReference fReservedRef;
+    int fPageObjectDescendantCount;
+
+    static std::vector<PageTreeNode> Layer(std::vector<PageTreeNode> vec, SkPDFDocument* doc) {
+        std::vector<PageTreeNode> result;
+        const size_t n = vec.size();
+        SkASSERT(n >= 1);
+        const size_t result_len = (n - 1) / kMaxPageTreeNodeSize + 1;
+        SkASSERT(result_len >= 1);
+        SkASSERT(n == 1 || result_len < n);
+        result.reserve(result_len);
+        size_t index = 0;
+        for (size_t i = 0; i < result_len; ++i) {
+            if (n != 1 && index + 1 == n) {  // No need to create a new node.
+                result.push_back(std::move(vec[index++]));
+                continue;
+            }
+            SkPDFIndirectReference parent = doc->reserveRef();
+            auto kids_list = SkPDFMakeArray();
+            int descendantCount = 0;
+            for (size_t j = 0; j < kMaxPageTreeNodeSize && index < n; ++j) {
+                PageTreeNode& node = vec[index++];
+                node.fNode->insertRef("Parent", parent);
+                kids_list->appendRef(doc->emit(*node.fNode, node.fReservedRef));
+                descendantCount += node.fPageObjectDescendantCount;
+            }
+            auto next = SkPDFMakeDict("Pages");
+            next->insertInt("Count", descendantCount);
+            next->insertObject("Kids", std::move(kids_list));
+            result.push_back(PageTreeNode{std::move(next), parent, descendantCount});
+        }
+        return result;
+    }
+};
+}  // namespace
+
+static SkPDFIndirectReference emit_page_tree(SkPDFDocument* doc,
+                                             std::vector<PageTreeNode> currentLayer) {
+    while (currentLayer.size() > 1) {
+        currentLayer = PageTreeNode::Layer(std::move(currentLayer), doc);
+    }
+    SkASSERT(currentLayer.size() == 1);
+    const PageTreeNode& root = currentLayer[0];
+    return doc->emit(*root.fNode, root.fReservedRef);
+}
+
+// Builds the tree bottom up from the pages passed in, skipping internal nodes
+// that would have only one child.
 static SkPDFIndirectReference generate_page_tree(
         SkPDFDocument* doc,
         std::vector<std::unique_ptr<SkPDFDict>> pages,
         const std::vector<SkPDFIndirectReference>& pageRefs) {
-    // PDF wants a tree describing all the pages in the document.  We arbitrary
-    // choose 8 (kNodeSize) as the number of allowed children.  The internal
-    // nodes have type "Pages" with an array of children, a parent pointer, and
-    // the number of leaves below the node as "Count."  The leaves are passed
-    // into the method, have type "Page" and need a parent pointer. This method
-    // builds the tree bottom up, skipping internal nodes that would have only
-    // one child.
     SkASSERT(pages.size() > 0);
-    struct PageTreeNode {
-        std::unique_ptr<SkPDFDict> fNode;
-        SkPDFIndirectReference fReservedRef;
-        int fPageObjectDescendantCount;
-
-        static std::vector<PageTreeNode> Layer(std::vector<PageTreeNode> vec, SkPDFDocument* doc) {
-            std::vector<PageTreeNode> result;
-            static constexpr size_t kMaxNodeSize = 8;
-            const size_t n = vec.size();
-            SkASSERT(n >= 1);
-            const size_t result_len = (n - 1) / kMaxNodeSize + 1;
-            SkASSERT(result_len >= 1);
-            SkASSERT(n == 1 || result_len < n);
-            result.reserve(result_len);
-            size_t index = 0;
-            for (size_t i = 0; i < result_len; ++i) {
-                if (n != 1 && index + 1 == n) {  // No need to create a new node.
-                    result.push_back(std::move(vec[index++]));
-                    continue;
-                }
-                SkPDFIndirectReference parent = doc->reserveRef();
-                auto kids_list = SkPDFMakeArray();
-                int descendantCount = 0;
-                for (size_t j = 0; j < kMaxNodeSize && index < n; ++j) {
-                    PageTreeNode& node = vec[index++];
-                    node.fNode->insertRef("Parent", parent);
-                    kids_list->appendRef(doc->emit(*node.fNode, node.fReservedRef));
-                    descendantCount += node.fPageObjectDescendantCount;
-                }
-                auto next = SkPDFMakeDict("Pages");
-                next->insertInt("Count", descendantCount);
-                next->insertObject("Kids", std::move(kids_list));
-                result.push_back(PageTreeNode{std::move(next), parent, descendantCount});
-            }
-            return result;
-        }
-    };
     std::vector<PageTreeNode> currentLayer;
     currentLayer.reserve(pages.size());
     SkASSERT(pages.size() == pageRefs.size());
     for (size_t i = 0; i < pages.size(); ++i) {
         currentLayer.push_back(PageTreeNode{std::move(pages[i]), pageRefs[i], 1});
     }
-    currentLayer = PageTreeNode::Layer(std::move(currentLayer), doc);
-    while (currentLayer.size() > 1) {
-        currentLayer = PageTreeNode::Layer(std::move(currentLayer), doc);
+    return emit_page_tree(doc, PageTreeNode::Layer(std::move(currentLayer), doc));
+}
+
+// When streaming, each page has already been written with the parent reserved for it,
+// one for every kMaxPageTreeNodeSize pages, so we build the tree up from those parents.
+static SkPDFIndirectReference generate_streamed_page_tree(
+        SkPDFDocument* doc,
+        const std::vector<SkPDFIndirectReference>& pageRefs,
+        const std::vector<SkPDFIndirectReference>& pageParents) {
+    SkASSERT(pageParents.size() == (pageRefs.size() - 1) / kMaxPageTreeNodeSize + 1);
+    std::vector<PageTreeNode> currentLayer;
+    currentLayer.reserve(pageParents.size());
+    for (size_t i = 0; i < pageParents.size(); ++i) {
+        size_t first = i * kMaxPageTreeNodeSize,
+               last = std::min(first + kMaxPageTreeNodeSize, pageRefs.size());
+        auto kids_list = SkPDFMakeArray();
+        for (size_t j = first; j < last; ++j) {
+            kids_list->appendRef(pageRefs[j]);
+        }
+        auto node = SkPDFMakeDict("Pages");
+        node->insertInt("Count", SkToInt(last - first));
+        node->insertObject("Kids", std::move(kids_list));
+        currentLayer.push_back(PageTreeNode{std::move(node), pageParents[i],
+                                            SkToInt(last - first)});
     }
-    SkASSERT(currentLayer.size() == 1);
-    const PageTreeNode& root = currentLayer[0];
-    return doc->emit(*root.fNode, root.fReservedRef);
+    return emit_page_tree(doc, std::move(currentLayer));
 }
 
 template<typename T, typename... Args>
@@ -248,11 +350,11 @@ static SkSize operator*(SkSize u, SkScalar s) { return SkSize{u.width() * s, u.h
 
 SkCanvas* SkPDFDocument::onBeginPage(SkScalar width, SkScalar height) {
     SkASSERT(fCanvas.imageInfo().dimensions().isZero());
-    if (fPages.empty()) {
+    if (fPageRefs.empty()) {
         // if this is the first page if the document.
         {
             SkAutoMutexExclusive autoMutexAcquire(fMutex);
-            serializeHeader(&fOffsetMap, this->getStream());
+            serializeHeader(&fOffsetMap, this->getStream(), this->streaming());
 
         }
 
@@ -351,6 +453,19 @@ std::unique_ptr<SkPDFArray> SkPDFDocument::getAnnotations() {
     return array;
 }
 
+static std::vector<const SkPDFFont*> get_fonts(const SkPDFDocument& canon) {
+    std::vector<const SkPDFFont*> fonts;
+    fonts.reserve(canon.fFontMap.count());
+    // Sort so the output PDF is reproducible.
+    for (const auto& [unused, font] : canon.fFontMap) {
+        fonts.push_back(&font);
+    }
+    std::sort(fonts.begin(), fonts.end(), [](const SkPDFFont* u, const SkPDFFont* v) {
+        return u->indirectReference().fValue < v->indirectReference().fValue;
+    });
+    return fonts;
+}
+
 void SkPDFDocument::onEndPage() {
     SkASSERT(!fCanvas.imageInfo().dimensions().isZero());
     reset_object(&fCanvas);
@@ -376,9 +491,70 @@ void SkPDFDocument::onEndPage() {
     // The StructParents unique identifier for each page is just its
     // 0-based page index.
     page->insertInt("StructParents", SkToInt(this->currentPageIndex()));
+
+    if (this->streaming()) {
+        if (this->currentPageIndex() % kMaxPageTreeNodeSize == 0) {
+            fStreamedPageParents.push_back(this->reserveRef());
+        }
+        page->insertRef("Parent", fStreamedPageParents.back());
+        this->emit(*page, this->currentPage());
+        if (this->sharedResourceBytes() > fMetadata.fStreamingMemoryBudget) {
+            this->flushSharedResources();
+        }
+        return;
+    }
     fPages.emplace_back(std::move(page));
 }
 
+size_t SkPDFDocument::sharedResourceBytes() const {
+    // A rough estimate of the hash tables, and of the parts of what they hold that grow with
+    // the document.
+    size_t bytes = fImageShaderMap.approxBytesUsed() +
+                   fGradientPatternMap.approxBytesUsed() +
+                   fPDFBitmapMap.approxBytesUsed() +
+                   fTypefaceMetrics.approxBytesUsed() +
+                   fType1GlyphNames.approxBytesUsed() +
+                   fToUnicodeMap.approxBytesUsed() +
+                   fFontMap.approxBytesUsed() +
+                   fStrokeGSMap.approxBytesUsed() +
+                   fFillGSMap.approxBytesUsed();
+    for (const auto& [unused, metrics] : fTypefaceMetrics) {
+        if (metrics) {
+            bytes += sizeof(SkAdvancedTypefaceMetrics) + metrics->fPostScriptName.size() +
+                     metrics->fFontName.size();
+        }
+    }
+    for (const auto& [unused, glyphNames] : fType1GlyphNames) {
+        bytes += glyphNames.size() * sizeof(SkString);
+    }
+    for (const auto& [unused, glyphToUnicode] : fToUnicodeMap) {
+        bytes += glyphToUnicode.size() * sizeof(SkUnichar);
+    }
+    for (const auto& [unused, font] : fFontMap) {
+        bytes += (font.lastGlyphID() - font.firstGlyphID() + 2) / 8;
+    }
+    return bytes;
+}
+
+void SkPDFDocument::flushSharedResources() {
+    // Write out the fonts used so far, and forget everything we've been sharing between pages.
+    // Anything later pages use again is written again.
+    std::vector<const SkPDFFont*> fonts = get_fonts(*this);
+    SkPDFFont::EmitSubsets(fonts, this);
+    // Also bound the memory held by jobs still writing streams out.
+    this->waitForJobs();
+
+    fImageShaderMap.reset();
+    fGradientPatternMap.reset();
+    fPDFBitmapMap.reset();
+    fTypefaceMetrics.reset();
+    fType1GlyphNames.reset();
+    fToUnicodeMap.reset();
+    fFontMap.reset();
+    fStrokeGSMap.reset();
+    fFillGSMap.reset();
+}
+
 void SkPDFDocument::onAbort() {
     this->waitForJobs();
 }
@@ -535,18 +711,6 @@ int SkPDFDocument::createStructParentKeyForNodeId(int nodeId) {
     return fTagTree.createStructParentKeyForNodeId(nodeId, SkToUInt(this->currentPageIndex()));
 }
 
-static std::vector<const SkPDFFont*> get_fonts(const SkPDFDocument& canon) {
-    std::vector<const SkPDFFont*> fonts;
-    fonts.reserve(canon.fFontMap.count());
-    // Sort so the output PDF is reproducible.
-    for (const auto& [unused, font] : canon.fFontMap) {
-        fonts.push_back(&font);
-    }
-    std::sort(fonts.begin(), fonts.end(), [](const SkPDFFont* u, const SkPDFFont* v) {
-        return u->indirectReference().fValue < v->indirectReference().fValue;
-    });
-    return fonts;
-}
 
 SkString SkPDFDocument::nextFontSubsetTag() {
     // PDF 32000-1:2008 Section 9.6.4 FontSubsets "The tag shall consist of six uppercase letters"
@@ -567,7 +731,7 @@ SkString SkPDFDocument::nextFontSubsetTag() {
 
 void SkPDFDocument::onClose(SkWStream* stream) {
     SkASSERT(fCanvas.imageInfo().dimensions().isZero());
-    if (fPages.empty()) {
+    if (fPageRefs.empty()) {
         this->waitForJobs();
         return;
     }
@@ -580,7 +744,11 @@ void SkPDFDocument::onClose(SkWStream* stream) {
         docCatalog->insertObject("OutputIntents", make_srgb_output_intents(this));
     }
 
-    docCatalog->insertRef("Pages", generate_page_tree(this, std::move(fPages), fPageRefs));
+    docCatalog->insertRef("Pages",
+                          this->streaming()
+                                  ? generate_streamed_page_tree(this, fPageRefs,
+                                                                fStreamedPageParents)
+                                  : generate_page_tree(this, std::move(fPages), fPageRefs));
 
     if (!fNamedDestinations.empty()) {
         docCatalog->insertRef("Dests", append_destinations(this, fNamedDestinations));
@@ -598,14 +766,15 @@ void SkPDFDocument::onClose(SkWStream* stream) {
 
     auto docCatalogRef = this->emit(*docCatalog);
 
-    for (const SkPDFFont* f : get_fonts(*this)) {
-        f->emitSubset(this);
-    }
+    std::vector<const SkPDFFont*> fonts = get_fonts(*this);
+    SkPDFFont::EmitSubsets(fonts, this);
 
     this->waitForJobs();
     {
         SkAutoMutexExclusive autoMutexAcquire(fMutex);
-        serialize_footer(fOffsetMap, this->getStream(), fInfoDict, docCatalogRef, fUUID);
+        serialize_footer(&fOffsetMap, this->getStream(), fInfoDict, docCatalogRef, fUUID,
+                         this->streaming() ? this->reserveRef() : SkPDFIndirectReference(),
+                         SkToInt(fMetadata.fCompressionLevel));
     }
 }
 
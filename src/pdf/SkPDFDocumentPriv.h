@@ -41,6 +41,12 @@ public:
     void markStartOfObject(int referenceNumber, const SkWStream*);
     int objectCount() const;
     int emitCrossReferenceTable(SkWStream* s) const;
+    // Emits a compressed cross-reference stream as object |ref|, whose dictionary is |trailer|
+    // (of type XRef) with the entries for the stream added.  Returns its offset.
+    int emitCrossReferenceStream(SkWStream* s,
+                                 SkPDFIndirectReference ref,
+                                 SkPDFDict* trailer,
+                                 int compressionLevel);
 private:
     std::vector<int> fOffsets;
     size_t fBaseOffset = SIZE_MAX;
@@ -134,7 +140,7 @@ public:
     SkExecutor* executor() const { return fExecutor; }
     void incrementJobCount();
     void signalJobComplete();
-    size_t currentPageIndex() { return fPages.size(); }
+    size_t currentPageIndex() { return SkASSERT(!fPageRefs.empty()), fPageRefs.size() - 1; }
     size_t pageCount() { return fPageRefs.size(); }
 
     const SkMatrix& currentPageTransform() const;
@@ -169,6 +175,8 @@ private:
     SkCanvas fCanvas;
     std::vector<std::unique_ptr<SkPDFDict>> fPages;
     std::vector<SkPDFIndirectReference> fPageRefs;
+    // When streaming, the parent of each run of pages in the page tree.
+    std::vector<SkPDFIndirectReference> fStreamedPageParents;
 
     sk_sp<SkPDFDevice> fPageDevice;
     std::atomic<int> fNextObjectNumber = {1};
@@ -189,6 +197,9 @@ private:
     SkSemaphore fSemaphore;
 
     void waitForJobs();
+    bool streaming() const { return fMetadata.fStreamingMemoryBudget > 0; }
+    size_t sharedResourceBytes() const;
+    void flushSharedResources();
     SkWStream* beginObject(SkPDFIndirectReference);
     void endObject();
 };
@@ -33,6 +33,7 @@
 #include "src/core/SkScalerContext.h"
 #include "src/core/SkStrike.h"
 #include "src/core/SkStrikeSpec.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkTHash.h"
 #include "src/pdf/SkPDFBitmap.h"
 #include "src/pdf/SkPDFDevice.h"
@@ -296,20 +297,32 @@ static sk_sp<SkData> stream_to_data(std::unique_ptr<SkStreamAsset> stream) {
     return SkData::MakeFromStream(stream.get(), size);
 }
 
-static void emit_subset_type0(const SkPDFFont& font, SkPDFDocument* doc) {
-    const SkAdvancedTypefaceMetrics* metricsPtr =
-        SkPDFFont::GetMetrics(font.typeface(), doc);
-    SkASSERT(metricsPtr);
-    if (!metricsPtr) { return; }
-    const SkAdvancedTypefaceMetrics& metrics = *metricsPtr;
-    SkASSERT(can_embed(metrics));
+namespace {
+// The parts of a Type0 font that take the most work to make, like its subset font program, but
+// which don't touch the document. This lets us make them for many fonts in parallel.
+struct Type0Contents {
+    const char*                    fFontFileKey = nullptr;
+    std::unique_ptr<SkPDFDict>     fFontFileDict;
+    std::unique_ptr<SkStreamAsset> fFontFile;
+    std::unique_ptr<SkPDFArray>    fWidths;
+    SkScalar                       fDefaultWidth = 0;
+    std::unique_ptr<SkStreamAsset> fToUnicode;
+};
+}  // namespace
+
+static bool is_type0(SkAdvancedTypefaceMetrics::FontType type) {
+    return type == SkAdvancedTypefaceMetrics::kType1CID_Font ||
+           type == SkAdvancedTypefaceMetrics::kTrueType_Font;
+}
+
+static Type0Contents make_type0_contents(const SkPDFFont& font,
+                                         const SkAdvancedTypefaceMetrics& metrics,
+                                         const std::vector<SkUnichar>& glyphToUnicode,
+                                         SkPDF::Metadata::Subsetter subsetter) {
     SkAdvancedTypefaceMetrics::FontType type = font.getType();
     SkTypeface* face = font.typeface();
     SkASSERT(face);
-
-    auto descriptor = SkPDFMakeDict("FontDescriptor");
-    uint16_t emSize = SkToU16(font.typeface()->getUnitsPerEm());
-    SkPDFFont::PopulateCommonFontDescriptor(descriptor.get(), metrics, emSize, 0);
+    Type0Contents contents;
 
     int ttcIndex;
     std::unique_ptr<SkStreamAsset> fontAsset = face->openStream(&ttcIndex);
@@ -321,42 +334,39 @@ static void emit_subset_type0(const SkPDFFont& font, SkPDFDocument* doc) {
     } else {
         switch (type) {
             case SkAdvancedTypefaceMetrics::kTrueType_Font: {
+                contents.fFontFileKey = "FontFile2";
                 if (!SkToBool(metrics.fFlags &
                               SkAdvancedTypefaceMetrics::kNotSubsettable_FontFlag)) {
                     SkASSERT(font.firstGlyphID() == 1);
                     sk_sp<SkData> subsetFontData = SkPDFSubsetFont(
                             stream_to_data(std::move(fontAsset)), font.glyphUsage(),
-                            doc->metadata().fSubsetter,
-                            metrics.fFontName.c_str(), ttcIndex);
+                            subsetter, metrics.fFontName.c_str(), ttcIndex);
                     if (subsetFontData) {
-                        std::unique_ptr<SkPDFDict> tmp = SkPDFMakeDict();
-                        tmp->insertInt("Length1", SkToInt(subsetFontData->size()));
-                        descriptor->insertRef(
-                                "FontFile2",
-                                SkPDFStreamOut(std::move(tmp),
-                                               SkMemoryStream::Make(std::move(subsetFontData)),
-                                               doc, SkPDFSteamCompressionEnabled::Yes));
+                        contents.fFontFileDict = SkPDFMakeDict();
+                        contents.fFontFileDict->insertInt("Length1",
+                                                          SkToInt(subsetFontData->size()));
+                        contents.fFontFile = SkMemoryStream::Make(std::move(subsetFontData));
                         break;
                     }
                     // If subsetting fails, fall back to original font data.
                     fontAsset = face->openStream(&ttcIndex);
                     SkASSERT(fontAsset);
                     SkASSERT(fontAsset->getLength() == fontSize);
-                    if (!fontAsset || fontAsset->getLength() == 0) { break; }
+                    if (!fontAsset || fontAsset->getLength() == 0) {
+                        contents.fFontFileKey = nullptr;
+                        break;
+                    }
                 }
-                std::unique_ptr<SkPDFDict> tmp = SkPDFMakeDict();
-                tmp->insertInt("Length1", fontSize);
-                descriptor->insertRef("FontFile2",
-                                      SkPDFStreamOut(std::move(tmp), std::move(fontAsset),
-                                                     doc, SkPDFSteamCompressionEnabled::Yes));
+                contents.fFontFileDict = SkPDFMakeDict();
+                contents.fFontFileDict->insertInt("Length1", fontSize);
+                contents.fFontFile = std::move(fontAsset);
                 break;
             }
             case SkAdvancedTypefaceMetrics::kType1CID_Font: {
-                std::unique_ptr<SkPDFDict> tmp = SkPDFMakeDict();
-                tmp->insertName("Subtype", "CIDFontType0C");
-                descriptor->insertRef("FontFile3",
-                                      SkPDFStreamOut(std::move(tmp), std::move(fontAsset),
-                                                     doc, SkPDFSteamCompressionEnabled::Yes));
+                contents.fFontFileKey = "FontFile3";
+                contents.fFontFileDict = SkPDFMakeDict();
+                contents.fFontFileDict->insertName("Subtype", "CIDFontType0C");
+                contents.fFontFile = std::move(fontAsset);
                 break;
             }
             default:
@@ -364,6 +374,34 @@ static void emit_subset_type0(const SkPDFFont& font, SkPDFDocument* doc) {
         }
     }
 
+    contents.fWidths = SkPDFMakeCIDGlyphWidthsArray(*face, font.glyphUsage(),
+                                                    &contents.fDefaultWidth);
+
+    SkASSERT(SkToSizeT(face->countGlyphs()) == glyphToUnicode.size());
+    contents.fToUnicode = SkPDFMakeToUnicodeCmap(glyphToUnicode.data(),
+                                                 &font.glyphUsage(),
+                                                 font.multiByteGlyphs(),
+                                                 font.firstGlyphID(),
+                                                 font.lastGlyphID());
+    return contents;
+}
+
+static void emit_subset_type0(const SkPDFFont& font, SkPDFDocument* doc,
+                              const SkAdvancedTypefaceMetrics& metrics,
+                              Type0Contents contents) {
+    SkASSERT(can_embed(metrics));
+    SkAdvancedTypefaceMetrics::FontType type = font.getType();
+
+    auto descriptor = SkPDFMakeDict("FontDescriptor");
+    uint16_t emSize = SkToU16(font.typeface()->getUnitsPerEm());
+    SkPDFFont::PopulateCommonFontDescriptor(descriptor.get(), metrics, emSize, 0);
+    if (contents.fFontFileKey) {
+        descriptor->insertRef(contents.fFontFileKey,
+                              SkPDFStreamOut(std::move(contents.fFontFileDict),
+                                             std::move(contents.fFontFile),
+                                             doc, SkPDFSteamCompressionEnabled::Yes));
+    }
+
     auto newCIDFont = SkPDFMakeDict("Font");
     newCIDFont->insertRef("FontDescriptor", doc->emit(*descriptor));
     newCIDFont->insertName("BaseFont", metrics.fPostScriptName);
@@ -386,15 +424,10 @@ static void emit_subset_type0(const SkPDFFont& font, SkPDFDocument* doc) {
     sysInfo->insertInt("Supplement", 0);
     newCIDFont->insertObject("CIDSystemInfo", std::move(sysInfo));
 
-    SkScalar defaultWidth = 0;
-    {
-        std::unique_ptr<SkPDFArray> widths = SkPDFMakeCIDGlyphWidthsArray(
-                *face, font.glyphUsage(), &defaultWidth);
-        if (widths && widths->size() > 0) {
-            newCIDFont->insertObject("W", std::move(widths));
-        }
-        newCIDFont->insertScalar("DW", defaultWidth);
+    if (contents.fWidths && contents.fWidths->size() > 0) {
+        newCIDFont->insertObject("W", std::move(contents.fWidths));
     }
+    newCIDFont->insertScalar("DW", contents.fDefaultWidth);
 
     ////////////////////////////////////////////////////////////////////////////
 
@@ -406,20 +439,24 @@ static void emit_subset_type0(const SkPDFFont& font, SkPDFDocument* doc) {
     descendantFonts->appendRef(doc->emit(*newCIDFont));
     fontDict.insertObject("DescendantFonts", std::move(descendantFonts));
 
-    const std::vector<SkUnichar>& glyphToUnicode =
-        SkPDFFont::GetUnicodeMap(font.typeface(), doc);
-    SkASSERT(SkToSizeT(font.typeface()->countGlyphs()) == glyphToUnicode.size());
-    std::unique_ptr<SkStreamAsset> toUnicode =
-            SkPDFMakeToUnicodeCmap(glyphToUnicode.data(),
-                                   &font.glyphUsage(),
-                                   font.multiByteGlyphs(),
-                                   font.firstGlyphID(),
-                                   font.lastGlyphID());
-    fontDict.insertRef("ToUnicode", SkPDFStreamOut(nullptr, std::move(toUnicode), doc));
+    fontDict.insertRef("ToUnicode",
+                       SkPDFStreamOut(nullptr, std::move(contents.fToUnicode), doc));
 
     doc->emit(fontDict, font.indirectReference());
 }
 
+static void emit_subset_type0(const SkPDFFont& font, SkPDFDocument* doc) {
+    const SkAdvancedTypefaceMetrics* metricsPtr =
+        SkPDFFont::GetMetrics(font.typeface(), doc);
+    SkASSERT(metricsPtr);
+    if (!metricsPtr) { return; }
+    const std::vector<SkUnichar>& glyphToUnicode =
+        SkPDFFont::GetUnicodeMap(font.typeface(), doc);
+    emit_subset_type0(font, doc, *metricsPtr,
+                      make_type0_contents(font, *metricsPtr, glyphToUnicode,
+                                          doc->metadata().fSubsetter));
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // PDFType3Font
 ///////////////////////////////////////////////////////////////////////////////
@@ -715,6 +752,57 @@ void SkPDFFont::emitSubset(SkPDFDocument* doc) const {
     }
 }
 
+void SkPDFFont::EmitSubsets(SkSpan<const SkPDFFont* const> fonts, SkPDFDocument* doc) {
+    SkExecutor* executor = doc->executor();
+    if (!executor) {
+        for (const SkPDFFont* font : fonts) {
+            font->emitSubset(doc);
+        }
+        return;
+    }
+
+    // Subsetting, widths, and ToUnicode CMaps for Type0 fonts don't touch the document, so we
+    // make them for all fonts in parallel. The metrics and unicode maps they need are cached
+    // on the document, so we look those up here first. Then we emit each font in order, just
+    // as we would serially, so the object numbers stay the same.
+    struct Type0Font {
+        const SkAdvancedTypefaceMetrics* fMetrics = nullptr;
+        const std::vector<SkUnichar>*    fGlyphToUnicode = nullptr;
+        Type0Contents                    fContents;
+    };
+    std::vector<Type0Font> type0Fonts(fonts.size());
+    const SkPDF::Metadata::Subsetter subsetter = doc->metadata().fSubsetter;
+
+    SkTaskGroup tasks(*executor);
+    for (size_t i = 0; i < fonts.size(); i++) {
+        const SkPDFFont& font = *fonts[i];
+        if (!is_type0(font.getType())) {
+            continue;
+        }
+        Type0Font& type0 = type0Fonts[i];
+        type0.fMetrics = SkPDFFont::GetMetrics(font.typeface(), doc);
+        SkASSERT(type0.fMetrics);
+        if (!type0.fMetrics) {
+            continue;
+        }
+        type0.fGlyphToUnicode = &SkPDFFont::GetUnicodeMap(font.typeface(), doc);
+        tasks.add([&font, &type0, subsetter] {
+            type0.fContents = make_type0_contents(font, *type0.fMetrics, *type0.fGlyphToUnicode,
+                                                  subsetter);
+        });
+    }
+    tasks.wait();
+
+    for (size_t i = 0; i < fonts.size(); i++) {
+        if (type0Fonts[i].fMetrics) {
+            emit_subset_type0(*fonts[i], doc, *type0Fonts[i].fMetrics,
+                              std::move(type0Fonts[i].fContents));
+        } else if (!is_type0(fonts[i]->getType())) {
+            fonts[i]->emitSubset(doc);
+        }
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 bool SkPDFFont::CanEmbedTypeface(SkTypeface* typeface, SkPDFDocument* doc) {
@@ -8,6 +8,7 @@
 #define SkPDFFont_DEFINED
 
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkSpan.h"
 #include "include/core/SkTypeface.h"
 #include "include/core/SkTypes.h"
 #include "src/core/SkAdvancedTypefaceMetrics.h"
@@ -108,6 +109,12 @@ public:
 
     void emitSubset(SkPDFDocument*) const;
 
+    /** Calls emitSubset() for each of the fonts, in order. If the document has an executor,
+     *  the work for each font that doesn't touch the document (e.g. subsetting its font
+     *  program) is done in parallel, without changing the objects emitted or their numbers.
+     */
+    static void EmitSubsets(SkSpan<const SkPDFFont* const>, SkPDFDocument*);
+
     /**
      *  Return false iff the typeface has its NotEmbeddable flag set.
      *  typeface is not nullptr
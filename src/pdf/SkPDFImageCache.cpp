@@ -0,0 +1,71 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/pdf/SkPDFImageCache.h"
+
+#include "src/core/SkChecksum.h"
+
+#include <utility>
+
+sk_sp<SkPDF::ImageCache> SkPDF::ImageCache::Make(size_t byteLimit) {
+    return sk_make_sp<SkPDFImageCache>(byteLimit);
+}
+
+uint32_t SkPDFImageCache::Traits::Hash(const SkMD5::Digest& key) {
+    return SkGoodHash()(key);
+}
+
+SkPDFImageCache::SkPDFImageCache(size_t byteLimit) : fByteLimit(byteLimit) {}
+
+SkPDFImageCache::~SkPDFImageCache() {
+    SkAutoMutexExclusive lock(fMutex);
+    while (Entry* entry = fLRU.head()) {
+        this->remove(entry);
+    }
+}
+
+size_t SkPDFImageCache::bytesUsed() const {
+    SkAutoMutexExclusive lock(fMutex);
+    return fBytesUsed;
+}
+
+sk_sp<SkPDFEncodedImage> SkPDFImageCache::find(const SkMD5::Digest& key) {
+    SkAutoMutexExclusive lock(fMutex);
+    Entry** found = fMap.find(key);
+    if (!found) {
+        return nullptr;
+    }
+    Entry* entry = *found;
+    if (entry != fLRU.head()) {
+        fLRU.remove(entry);
+        fLRU.addToHead(entry);
+    }
+    return entry->fImage;
+}
+
+void SkPDFImageCache::add(const SkMD5::Digest& key, sk_sp<SkPDFEncodedImage> image) {
+    SkASSERT(image);
+    const size_t bytes = image->bytesUsed();
+    SkAutoMutexExclusive lock(fMutex);
+    if (bytes > fByteLimit || fMap.find(key)) {
+        return;
+    }
+    Entry* entry = new Entry{key, std::move(image)};
+    fMap.set(entry);
+    fLRU.addToHead(entry);
+    fBytesUsed += bytes;
+    while (fBytesUsed > fByteLimit) {
+        this->remove(fLRU.tail());
+    }
+}
+
+void SkPDFImageCache::remove(Entry* entry) {
+    fBytesUsed -= entry->fImage->bytesUsed();
+    fMap.remove(entry->fKey);
+    fLRU.remove(entry);
+    delete entry;
+}
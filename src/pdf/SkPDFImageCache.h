@@ -0,0 +1,58 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#ifndef SkPDFImageCache_DEFINED
+#define SkPDFImageCache_DEFINED
+
+#include "include/core/SkRefCnt.h"
+#include "include/docs/SkPDFDocument.h"
+#include "include/private/base/SkMutex.h"
+#include "include/private/base/SkThreadAnnotations.h"
+#include "src/base/SkTInternalLList.h"
+#include "src/core/SkMD5.h"
+#include "src/core/SkTHash.h"
+#include "src/pdf/SkPDFBitmap.h"
+
+#include <cstddef>
+
+/**
+ * The implementation of SkPDF::ImageCache: encoded images keyed by an MD5 of their contents and
+ * of the settings they were encoded with, dropping the least recently used past a byte limit.
+ */
+class SkPDFImageCache final : public SkPDF::ImageCache {
+public:
+    explicit SkPDFImageCache(size_t byteLimit);
+    ~SkPDFImageCache() override;
+
+    size_t bytesUsed() const override;
+
+    sk_sp<SkPDFEncodedImage> find(const SkMD5::Digest& key);
+
+    // If another thread added an image with the same key first, this keeps that one.
+    void add(const SkMD5::Digest& key, sk_sp<SkPDFEncodedImage> image);
+
+private:
+    struct Entry {
+        SkMD5::Digest fKey;
+        sk_sp<SkPDFEncodedImage> fImage;
+
+        SK_DECLARE_INTERNAL_LLIST_INTERFACE(Entry);
+    };
+    struct Traits {
+        static const SkMD5::Digest& GetKey(const Entry* e) { return e->fKey; }
+        static uint32_t Hash(const SkMD5::Digest& key);
+    };
+
+    void remove(Entry*) SK_REQUIRES(fMutex);
+
+    const size_t fByteLimit;
+    mutable SkMutex fMutex;
+    size_t fBytesUsed SK_GUARDED_BY(fMutex) = 0;
+    skia_private::THashTable<Entry*, SkMD5::Digest, Traits> fMap SK_GUARDED_BY(fMutex);
+    SkTInternalLList<Entry> fLRU SK_GUARDED_BY(fMutex);
+};
+
+#endif  // SkPDFImageCache_DEFINED
@@ -531,6 +531,23 @@ void SkPDFDict::insertTextString(const char key[], SkString value) {
 
 
 
+sk_sp<SkData> SkPDFDeflate(const SkPDFDocument* doc, const void* src, size_t size) {
+    const SkPDF::Metadata& metadata = doc->metadata();
+    SkASSERT(metadata.fCompressionLevel != SkPDF::Metadata::CompressionLevel::None);
+    if (metadata.fDeflate) {
+        SkDynamicMemoryWStream dst;
+        if (metadata.fDeflate(&dst, src, size, metadata.fCompressionLevel)) {
+            return dst.detachAsData();
+        }
+    }
+    SkDynamicMemoryWStream dst;
+    {
+        SkDeflateWStream deflate(&dst, SkToInt(metadata.fCompressionLevel));
+        deflate.write(src, size);
+    }
+    return dst.detachAsData();
+}
+
 static void serialize_stream(SkPDFDict* origDict,
                              SkStreamAsset* stream,
                              SkPDFSteamCompressionEnabled compress,
@@ -547,13 +564,26 @@ static void serialize_stream(SkPDFDict* origDict,
         compress == SkPDFSteamCompressionEnabled::Yes &&
         stream->getLength() > kMinimumSavings)
     {
-        SkDynamicMemoryWStream compressedData;
-        SkDeflateWStream deflateWStream(&compressedData,SkToInt(doc->metadata().fCompressionLevel));
-        SkStreamCopy(&deflateWStream, stream);
-        deflateWStream.finalize();
+        const size_t length = stream->getLength();
+        std::unique_ptr<SkStreamAsset> compressed;
+        if (doc->metadata().fDeflate) {
+            // fDeflate takes the whole stream at once.
+            const void* base = stream->getMemoryBase();
+            sk_sp<SkData> data = base ? SkData::MakeWithoutCopy(base, length)
+                                      : SkData::MakeFromStream(stream, length);
+            compressed = SkMemoryStream::Make(SkPDFDeflate(doc, data->data(), data->size()));
+        } else {
+            SkDynamicMemoryWStream compressedData;
+            SkDeflateWStream deflateWStream(&compressedData,
+                                            SkToInt(doc->metadata().fCompressionLevel));
+            SkStreamCopy(&deflateWStream, stream);
+            deflateWStream.finalize();
+            compressed = compressedData.detachAsStream();
+        }
         #ifdef SK_PDF_BASE85_BINARY
         {
-            SkPDFUtils::Base85Encode(compressedData.detachAsStream(), &compressedData);
+            SkDynamicMemoryWStream compressedData;
+            SkPDFUtils::Base85Encode(std::move(compressed), &compressedData);
             tmp = compressedData.detachAsStream();
             stream = tmp.get();
             auto filters = SkPDFMakeArray();
@@ -562,8 +592,8 @@ static void serialize_stream(SkPDFDict* origDict,
             dict.insertObject("Filter", std::move(filters));
         }
         #else
-        if (stream->getLength() > compressedData.bytesWritten() + kMinimumSavings) {
-            tmp = compressedData.detachAsStream();
+        if (length > compressed->getLength() + kMinimumSavings) {
+            tmp = std::move(compressed);
             stream = tmp.get();
             dict.insertName("Filter", "FlateDecode");
         } else {
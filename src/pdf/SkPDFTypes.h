@@ -215,4 +215,8 @@ SkPDFIndirectReference SkPDFStreamOut(
     std::unique_ptr<SkStreamAsset> stream,
     SkPDFDocument* doc,
     SkPDFSteamCompressionEnabled compress = SkPDFSteamCompressionEnabled::Default);
+
+// Compresses |size| bytes from |src| all at once, with the document's Metadata::fDeflate if it
+// has one, and zlib otherwise.  The document's compression level must not be None.
+sk_sp<SkData> SkPDFDeflate(const SkPDFDocument* doc, const void* src, size_t size);
 #endif
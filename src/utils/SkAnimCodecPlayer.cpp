@@ -13,6 +13,7 @@
 #include "include/core/SkBlendMode.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMatrix.h"
@@ -21,7 +22,13 @@
 #include "include/core/SkSamplingOptions.h"
 #include "include/core/SkSize.h"
 #include "include/core/SkTypes.h"
+#include "include/private/base/SkMutex.h"
+#include "include/private/base/SkSemaphore.h"
+#include "include/private/base/SkTo.h"
 #include "src/codec/SkCodecImageGenerator.h"
+#include "src/core/SkLRUCache.h"
+#include "src/core/SkTHash.h"
+#include "src/core/SkTaskGroup.h"
 
 #include <algorithm>
 #include <cstddef>
@@ -29,10 +36,126 @@
 #include <utility>
 #include <vector>
 
-SkAnimCodecPlayer::SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec) : fCodec(std::move(codec)) {
+// With an executor, we decode up to this many frames past the current one ahead of time.
+static constexpr int kFramesAhead = 8;
+
+// The most recently used decoded frames, and what's needed to decode frames ahead of time: the
+// tasks doing it, the frames they've yet to finish, and SkCodecs for them to use.  Those tasks
+// run alongside the player, so this is all guarded by fMutex.
+class SkAnimCodecPlayer::FrameCache {
+public:
+    FrameCache(int maxFrames, sk_sp<SkData> data, SkExecutor* executor)
+            : fMaxFrames(maxFrames)
+            , fData(std::move(data))
+            , fFrames(maxFrames)
+            , fTasks(executor ? std::make_unique<SkTaskGroup>(*executor) : nullptr) {}
+
+    int maxFrames() const { return fMaxFrames; }
+
+    // Null if frames are only decoded when they're needed.
+    SkTaskGroup* tasks() { return fTasks.get(); }
+
+    sk_sp<SkImage> find(int index) {
+        SkAutoMutexExclusive lock(fMutex);
+        sk_sp<SkImage>* image = fFrames.find(index);
+        return image ? *image : nullptr;
+    }
+
+    void insert(int index, sk_sp<SkImage> image) {
+        SkAutoMutexExclusive lock(fMutex);
+        fFrames.insert_or_update(index, std::move(image));
+    }
+
+    // Returns false if the frame is already decoded or being decoded.
+    bool startDecoding(int index) {
+        SkAutoMutexExclusive lock(fMutex);
+        if (fFrames.find(index) || fDecoding.contains(index)) {
+            return false;
+        }
+        fDecoding.add(index);
+        return true;
+    }
+
+    void finishDecoding(int index, sk_sp<SkImage> image) {
+        SkAutoMutexExclusive lock(fMutex);
+        fDecoding.remove(index);
+        if (image) {
+            fFrames.insert_or_update(index, std::move(image));
+        }
+        // Wake anyone waiting, so they can check whether it was their frame.
+        fFinished.signal(fWaiters);
+        fWaiters = 0;
+    }
+
+    // Blocks until |index| is no longer being decoded ahead of time, and returns it if it was
+    // decoded.  Unlike waiting for all of tasks(), this doesn't wait for the rest of the frames.
+    sk_sp<SkImage> waitFor(int index) {
+        fMutex.acquire();
+        while (fDecoding.contains(index)) {
+            fWaiters++;
+            fMutex.release();
+            fFinished.wait();
+            fMutex.acquire();
+        }
+        sk_sp<SkImage>* image = fFrames.find(index);
+        sk_sp<SkImage> result = image ? *image : nullptr;
+        fMutex.release();
+        return result;
+    }
+
+    // SkCodecs aren't thread safe, so each task decoding ahead of time gets its own.
+    std::unique_ptr<SkCodec> takeCodec() {
+        {
+            SkAutoMutexExclusive lock(fMutex);
+            if (!fIdleCodecs.empty()) {
+                std::unique_ptr<SkCodec> codec = std::move(fIdleCodecs.back());
+                fIdleCodecs.pop_back();
+                return codec;
+            }
+        }
+        return SkCodec::MakeFromData(fData);
+    }
+
+    void returnCodec(std::unique_ptr<SkCodec> codec) {
+        if (codec) {
+            SkAutoMutexExclusive lock(fMutex);
+            fIdleCodecs.push_back(std::move(codec));
+        }
+    }
+
+private:
+    const int           fMaxFrames;
+    const sk_sp<SkData> fData;
+
+    SkMutex                                    fMutex;
+    SkLRUCache<int, sk_sp<SkImage>>            fFrames      SK_GUARDED_BY(fMutex);
+    skia_private::THashSet<int>                fDecoding    SK_GUARDED_BY(fMutex);
+    std::vector<std::unique_ptr<SkCodec>>      fIdleCodecs  SK_GUARDED_BY(fMutex);
+
+    // Signaled once for each waitFor() call blocked when a frame finishes decoding.
+    SkSemaphore fFinished;
+    int         fWaiters SK_GUARDED_BY(fMutex) = 0;
+
+    // Declared last, so that its tasks finish before the rest of this goes away.
+    std::unique_ptr<SkTaskGroup> fTasks;
+};
+
+SkAnimCodecPlayer::SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec)
+        : SkAnimCodecPlayer(std::move(codec), nullptr, nullptr, SIZE_MAX) {}
+
+SkAnimCodecPlayer::SkAnimCodecPlayer(sk_sp<SkData> data, SkExecutor* executor, size_t cacheBytes)
+        : SkAnimCodecPlayer(SkCodec::MakeFromData(data), data, executor, cacheBytes) {}
+
+SkAnimCodecPlayer::SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec,
+                                     sk_sp<SkData> data,
+                                     SkExecutor* executor,
+                                     size_t cacheBytes)
+        : fCodec(std::move(codec)) {
+    if (!fCodec) {
+        return;
+    }
     fImageInfo = fCodec->getInfo();
     fFrameInfos = fCodec->getFrameInfo();
-    fImages.resize(fFrameInfos.size());
 
     // change the interpretation of fDuration to a end-time for that frame
     size_t dur = 0;
@@ -45,18 +168,28 @@ SkAnimCodecPlayer::SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec) : fCodec(st
     if (!fTotalDuration) {
         // Static image -- may or may not have returned a single frame info.
         fFrameInfos.clear();
-        fImages.clear();
-        fImages.push_back(SkImages::DeferredFromGenerator(
-                SkCodecImageGenerator::MakeFromCodec(std::move(fCodec))));
+        fStaticImage = SkImages::DeferredFromGenerator(
+                SkCodecImageGenerator::MakeFromCodec(std::move(fCodec)));
+        return;
     }
+
+    // Every frame takes the same number of bytes, so our budget is a number of frames.
+    const size_t frameBytes = std::max<size_t>(1, fImageInfo.computeMinByteSize());
+    const int maxFrames = SkToInt(std::clamp<size_t>(cacheBytes / frameBytes, 1,
+                                                     fFrameInfos.size()));
+    fFrameCache = std::make_unique<FrameCache>(maxFrames, std::move(data), executor);
 }
 
-SkAnimCodecPlayer::~SkAnimCodecPlayer() {}
+SkAnimCodecPlayer::~SkAnimCodecPlayer() {
+    // Frames still being decoded ahead of time need the rest of the player.
+    if (fFrameCache && fFrameCache->tasks()) {
+        fFrameCache->tasks()->wait();
+    }
+}
 
 SkISize SkAnimCodecPlayer::dimensions() const {
     if (!fCodec) {
-        auto image = fImages.front();
-        return image ? image->dimensions() : SkISize::MakeEmpty();
+        return fStaticImage ? fStaticImage->dimensions() : SkISize::MakeEmpty();
     }
     if (SkEncodedOriginSwapsWidthHeight(fCodec->getOrigin())) {
         return { fImageInfo.height(), fImageInfo.width() };
@@ -67,10 +200,20 @@ SkISize SkAnimCodecPlayer::dimensions() const {
 sk_sp<SkImage> SkAnimCodecPlayer::getFrameAt(int index) {
     SkASSERT((unsigned)index < fFrameInfos.size());
 
-    if (fImages[index]) {
-        return fImages[index];
+    // If this frame is being decoded ahead of time, wait for it rather than decode it again.
+    if (sk_sp<SkImage> image = fFrameCache->waitFor(index)) {
+        return image;
+    }
+
+    sk_sp<SkImage> image = this->decodeFrame(fCodec.get(), index);
+    if (image) {
+        fFrameCache->insert(index, image);
     }
+    return image;
+}
 
+// Decodes every frame with the given codec, which may be fCodec or one of the FrameCache's.
+sk_sp<SkImage> SkAnimCodecPlayer::decodeFrame(SkCodec* codec, int index) const {
     size_t rb = fImageInfo.minRowBytes();
     size_t size = fImageInfo.computeByteSize(rb);
     auto data = SkData::MakeUninitialized(size);
@@ -78,7 +221,7 @@ sk_sp<SkImage> SkAnimCodecPlayer::getFrameAt(int index) {
     SkCodec::Options opts;
     opts.fFrameIndex = index;
 
-    const auto origin = fCodec->getOrigin();
+    const auto origin = codec->getOrigin();
     const auto orientedDims = this->dimensions();
     const auto originMatrix = SkEncodedOriginToMatrix(origin, orientedDims.width(),
                                                               orientedDims.height());
@@ -91,8 +234,12 @@ sk_sp<SkImage> SkAnimCodecPlayer::getFrameAt(int index) {
         imageInfo = imageInfo.makeAlphaType(kPremul_SkAlphaType);
     }
     const int requiredFrame = fFrameInfos[index].fRequiredFrame;
-    if (requiredFrame != SkCodec::kNoFrame && fImages[requiredFrame]) {
-        auto requiredImage = fImages[requiredFrame];
+    sk_sp<SkImage> requiredImage;
+    if (requiredFrame != SkCodec::kNoFrame) {
+        // Without the required frame, the codec decodes it (and anything it requires) itself.
+        requiredImage = fFrameCache->find(requiredFrame);
+    }
+    if (requiredImage) {
         auto canvas = SkCanvas::MakeRasterDirect(imageInfo, data->writable_data(), rb);
         if (origin != kDefault_SkEncodedOrigin) {
             // The required frame is stored after applying the origin. Undo that,
@@ -110,7 +257,7 @@ sk_sp<SkImage> SkAnimCodecPlayer::getFrameAt(int index) {
         opts.fPriorFrame = requiredFrame;
     }
 
-    if (SkCodec::kSuccess != fCodec->getPixels(imageInfo, data->writable_data(), rb, &opts)) {
+    if (SkCodec::kSuccess != codec->getPixels(imageInfo, data->writable_data(), rb, &opts)) {
         return nullptr;
     }
 
@@ -125,15 +272,61 @@ sk_sp<SkImage> SkAnimCodecPlayer::getFrameAt(int index) {
         canvas->drawImage(image, 0, 0, SkSamplingOptions(), &paint);
         image = SkImages::RasterFromData(imageInfo, std::move(data), rb);
     }
-    return fImages[index] = image;
+    return image;
 }
 
-sk_sp<SkImage> SkAnimCodecPlayer::getFrame() {
-    SkASSERT(fTotalDuration > 0 || fImages.size() == 1);
+void SkAnimCodecPlayer::prefetchFrames() {
+    SkTaskGroup* tasks = fFrameCache->tasks();
+    // Frames we'd start decoding now may need ones still being decoded, so wait until those are
+    // done, rather than have the codec decode them again.
+    if (!tasks || !tasks->done()) {
+        return;
+    }
+    const int frameCount = SkToInt(fFrameInfos.size());
+    const int ahead = std::min({kFramesAhead, fFrameCache->maxFrames() - 1, frameCount - 1});
 
-    return fTotalDuration > 0
-        ? this->getFrameAt(fCurrIndex)
-        : fImages.front();
+    // Split the upcoming frames we don't have into runs, each starting with a frame that
+    // doesn't need an earlier one or that follows a frame we do have.  Each run is decoded in
+    // order by one task, so that its frames can build on each other, and the runs in parallel.
+    std::vector<int> run;
+    auto decodeRun = [&] {
+        if (run.empty()) {
+            return;
+        }
+        tasks->add([this, run = std::move(run)] {
+            std::unique_ptr<SkCodec> codec = fFrameCache->takeCodec();
+            for (int index : run) {
+                fFrameCache->finishDecoding(index,
+                                            codec ? this->decodeFrame(codec.get(), index)
+                                                  : nullptr);
+            }
+            fFrameCache->returnCodec(std::move(codec));
+        });
+        run.clear();
+    };
+    for (int i = 1; i <= ahead; i++) {
+        const int index = (fCurrIndex + i) % frameCount;
+        if (fFrameInfos[index].fRequiredFrame == SkCodec::kNoFrame) {
+            decodeRun();
+        }
+        if (fFrameCache->startDecoding(index)) {
+            run.push_back(index);
+        } else {
+            decodeRun();
+        }
+    }
+    decodeRun();
+}
+
+sk_sp<SkImage> SkAnimCodecPlayer::getFrame() {
+    if (!fTotalDuration) {
+        return fStaticImage;
+    }
+    if (!fCurrImage) {
+        fCurrImage = this->getFrameAt(fCurrIndex);
+        this->prefetchFrames();
+    }
+    return fCurrImage;
 }
 
 bool SkAnimCodecPlayer::seek(uint32_t msec) {
@@ -149,7 +342,11 @@ bool SkAnimCodecPlayer::seek(uint32_t msec) {
                                   });
     int prevIndex = fCurrIndex;
     fCurrIndex = lower - fFrameInfos.begin();
-    return fCurrIndex != prevIndex;
+    if (fCurrIndex == prevIndex) {
+        return false;
+    }
+    fCurrImage = nullptr;
+    return true;
 }
 
 
@@ -182,6 +182,13 @@ class CachedTessellations : public SkRefCnt {
 public:
     size_t size() const { return fAmbientSet.size() + fSpotSet.size(); }
 
+    sk_sp<CachedTessellations> makeCopy() const {
+        auto copy = sk_make_sp<CachedTessellations>();
+        copy->fAmbientSet = fAmbientSet;
+        copy->fSpotSet = fSpotSet;
+        return copy;
+    }
+
     sk_sp<SkVertices> find(const AmbientVerticesFactory& ambient, const SkMatrix& matrix,
                            SkVector* translate) const {
         return fAmbientSet.find(ambient, matrix, translate);
@@ -286,7 +293,7 @@ public:
 
     const char* getCategory() const override { return "tessellated shadow masks"; }
 
-    sk_sp<CachedTessellations> refTessellations() const { return fTessellations; }
+    const CachedTessellations& tessellations() const { return *fTessellations; }
 
     template <typename FACTORY>
     sk_sp<SkVertices> find(const FACTORY& factory, const SkMatrix& matrix,
@@ -336,9 +343,10 @@ bool FindVisitor(const SkResourceCache::Rec& baseRec, void* ctx) {
     if (findContext->fVertices) {
         return true;
     }
-    // We ref the tessellations and let the cache destroy the Rec. Once the tessellations have been
-    // manipulated we will add a new Rec.
-    findContext->fTessellationsOnFailure = rec.refTessellations();
+    // We copy the tessellations and let the cache destroy the Rec. Once the copy has been
+    // manipulated we will add a new Rec. (Other threads may be visiting the same Rec, so we can't
+    // take the tessellations themselves to manipulate.)
+    findContext->fTessellationsOnFailure = rec.tessellations().makeCopy();
     return false;
 }
 
@@ -8,6 +8,7 @@
 #include "include/codec/SkAndroidCodec.h"
 #include "include/codec/SkCodec.h"
 #include "include/codec/SkEncodedImageFormat.h"
+#include "include/core/SkBitmap.h"
 #include "include/core/SkColorSpace.h"
 #include "include/core/SkData.h"
 #include "include/core/SkImageInfo.h"
@@ -272,3 +273,68 @@ DEF_TEST(AndroidCodec_PQ, r) {
     static constexpr skcms_Matrix3x3 kExpected = SkNamedGamut::kRec2020;
     REPORTER_ASSERT(r, 0 == memcmp(&matrix, &kExpected, sizeof(skcms_Matrix3x3)));
 }
+
+DEF_TEST(AndroidCodec_boxFilter, r) {
+    static constexpr struct {
+        const char* fFile;
+        SkColorType fColorType;
+    } gTests[] = {
+        { "images/yellow_rose.png"     , kN32_SkColorType  },  // Streamed by SkPngCodec.
+        { "images/plane_interlaced.png", kN32_SkColorType  },  // Decoded whole, then averaged.
+        { "images/color_wheel.jpg"     , kN32_SkColorType  },  // Streamed as scanlines.
+        { "images/grayscale.jpg"       , kGray_8_SkColorType },
+        { "images/randPixels.bmp"      , kN32_SkColorType  },  // Bottom-up.
+    };
+
+    for (const auto& test : gTests) {
+        auto codec = SkAndroidCodec::MakeFromData(GetResourceAsData(test.fFile));
+        if (!codec) {
+            ERRORF(r, "Could not create codec for %s", test.fFile);
+            continue;
+        }
+        const SkImageInfo fullInfo = codec->getInfo().makeColorType(test.fColorType)
+                                                     .makeAlphaType(kPremul_SkAlphaType);
+        SkBitmap full;
+        full.allocPixels(fullInfo);
+        REPORTER_ASSERT(r, codec->getAndroidPixels(fullInfo, full.getPixels(), full.rowBytes()) ==
+                           SkCodec::kSuccess);
+
+        // Odd sample sizes, so that no codec does any of the scaling natively.
+        for (int sampleSize : {3, 5, 7}) {
+            const SkImageInfo info = fullInfo.makeDimensions(
+                    codec->getSampledDimensions(sampleSize));
+            SkAndroidCodec::AndroidOptions options;
+            options.fSampleSize = sampleSize;
+            options.fBoxFilter = true;
+            SkBitmap bm;
+            bm.allocPixels(info);
+            REPORTER_ASSERT(r, codec->getAndroidPixels(info, bm.getPixels(), bm.rowBytes(),
+                                                       &options) == SkCodec::kSuccess);
+
+            // Average the full size decode ourselves.
+            const int sampleX = full.width() / info.width(),
+                      sampleY = full.height() / info.height(),
+                      bpp = info.bytesPerPixel();
+            for (int y = 0; y < info.height(); y++)
+            for (int x = 0; x < info.width(); x++) {
+                for (int c = 0; c < bpp; c++) {
+                    uint32_t sum = 0;
+                    for (int j = 0; j < sampleY; j++)
+                    for (int i = 0; i < sampleX; i++) {
+                        auto src = static_cast<const uint8_t*>(
+                                full.getAddr(x * sampleX + i, y * sampleY + j));
+                        sum += src[c];
+                    }
+                    const uint32_t area = sampleX * sampleY;
+                    const uint8_t expected = (sum + area / 2) / area,
+                                  actual = static_cast<const uint8_t*>(bm.getAddr(x, y))[c];
+                    if (actual != expected) {
+                        ERRORF(r, "%s, sample size %d: (%d, %d) channel %d is %d, expected %d",
+                               test.fFile, sampleSize, x, y, c, actual, expected);
+                        return;
+                    }
+                }
+            }
+        }
+    }
+}
@@ -12,6 +12,7 @@
 #include "include/core/SkColor.h"
 #include "include/core/SkColorPriv.h"
 #include "include/core/SkColorType.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMaskFilter.h"
 #include "include/core/SkPaint.h"
@@ -33,9 +34,11 @@
 #include "include/private/base/SkFloatBits.h"
 #include "include/private/base/SkTPin.h"
 #include "src/base/SkMathPriv.h"
+#include "src/base/SkRandom.h"
 #include "src/core/SkBlurMask.h"
 #include "src/core/SkGpuBlurUtils.h"
 #include "src/core/SkMask.h"
+#include "src/core/SkMaskBlurFilter.h"
 #include "src/core/SkMaskFilterBase.h"
 #include "src/effects/SkEmbossMaskFilter.h"
 #include "tests/CtsEnforcement.h"
@@ -48,6 +51,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <initializer_list>
+#include <memory>
 
 struct GrContextOptions;
 
@@ -358,6 +362,58 @@ DEF_TEST(BlurSigmaRange, reporter) {
     }
 }
 
+// Large blurs split across an executor should match blurring on one thread exactly, and A8 masks
+// (which blur several rows at once) should match the same alpha in an ARGB32 mask.
+DEF_TEST(BlurMaskThreaded, reporter) {
+    auto executor = SkExecutor::MakeFIFOThreadPool(4);
+    SkRandom rand;
+
+    // Include odd sizes, so some rows and columns are left over after the lanes.
+    for (SkISize size : {SkISize{1003, 601}, SkISize{517, 300}, SkISize{61, 37}, SkISize{5, 9}}) {
+        SkMask a8, argb;
+        a8.fBounds = argb.fBounds = SkIRect::MakeXYWH(7, 11, size.width(), size.height());
+        a8.fFormat = SkMask::kA8_Format;
+        argb.fFormat = SkMask::kARGB32_Format;
+        a8.fRowBytes = a8.fBounds.width();
+        argb.fRowBytes = 4 * argb.fBounds.width();
+        a8.fImage = SkMask::AllocImage(a8.computeTotalImageSize());
+        argb.fImage = SkMask::AllocImage(argb.computeTotalImageSize());
+        SkAutoMaskFreeImage freeA8(a8.fImage), freeARGB(argb.fImage);
+
+        // Some noise, and a few solid blocks so the blurred values cover the whole range.
+        for (int y = 0; y < size.height(); ++y) {
+            for (int x = 0; x < size.width(); ++x) {
+                uint8_t alpha = ((x / 64 + y / 64) & 1) ? 0xFF : rand.nextU() & 0xFF;
+                a8.fImage[y * a8.fRowBytes + x] = alpha;
+                reinterpret_cast<uint32_t*>(argb.fImage)[y * size.width() + x] =
+                        SkPackARGB32(alpha, 0, 0, 0);
+            }
+        }
+
+        for (double sigma : {2.5, 24.0, 100.0}) {
+            SkMaskBlurFilter filter(sigma, sigma),
+                             scalarFilter(sigma, sigma);
+            scalarFilter.setUseScalarScansForTesting(true);
+            SkMask serial, threaded, fromARGB, scalar;
+            filter.blur(a8, &serial);
+            filter.blur(a8, &threaded, executor.get());
+            filter.blur(argb, &fromARGB, executor.get());
+            scalarFilter.blur(a8, &scalar);
+            SkAutoMaskFreeImage freeSerial(serial.fImage),
+                                freeThreaded(threaded.fImage),
+                                freeFromARGB(fromARGB.fImage),
+                                freeScalar(scalar.fImage);
+
+            for (const SkMask* mask : {&threaded, &fromARGB, &scalar}) {
+                REPORTER_ASSERT(reporter, mask->fBounds == serial.fBounds);
+                REPORTER_ASSERT(reporter, mask->fRowBytes == serial.fRowBytes);
+                REPORTER_ASSERT(reporter, 0 == memcmp(mask->fImage, serial.fImage,
+                                                      serial.computeTotalImageSize()));
+            }
+        }
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 
 DEF_TEST(BlurAsABlur, reporter) {
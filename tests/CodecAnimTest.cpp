@@ -13,6 +13,7 @@
 #include "include/core/SkBitmap.h"
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMatrix.h"
@@ -626,3 +627,84 @@ DEF_TEST(AnimCodecPlayer, r) {
                         "Mismatched size for frame at 500 ms of %s", test.fFile);
     }
 }
+
+DEF_TEST(AnimCodecPlayer_prefetch, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    for (const char* file : {"images/alphabetAnim.gif",
+                             "images/required.gif",
+                             "images/required.webp",
+                             "images/stoplight_h.webp",
+                             "images/randPixels.png"}) {
+        sk_sp<SkData> data = GetResourceAsData(file);
+        std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(data);
+        if (!codec) {
+            ERRORF(r, "Could not create codec for %s", file);
+            continue;
+        }
+        auto expected = std::make_unique<SkAnimCodecPlayer>(std::move(codec));
+        const SkISize size = expected->dimensions();
+        const size_t frameBytes = SkImageInfo::MakeN32Premul(size).computeMinByteSize();
+
+        // Keep every frame, just a couple, or only the current one.
+        for (size_t cacheBytes : {SIZE_MAX, 2 * frameBytes, (size_t)0}) {
+            for (SkExecutor* exec : {executor.get(), (SkExecutor*)nullptr}) {
+                auto player = std::make_unique<SkAnimCodecPlayer>(data, exec, cacheBytes);
+                REPORTER_ASSERT(r, player->duration() == expected->duration());
+                REPORTER_ASSERT(r, player->dimensions() == size);
+
+                // Play through twice, a few times per frame, and then skip around.
+                std::vector<uint32_t> times;
+                for (uint32_t msec = 0; msec < 2 * expected->duration(); msec += 37) {
+                    times.push_back(msec);
+                }
+                for (uint32_t msec : {1000u, 30u, 777u, 2222u, 5u}) {
+                    times.push_back(msec);
+                }
+                for (uint32_t msec : times) {
+                    REPORTER_ASSERT(r, player->seek(msec) == expected->seek(msec));
+                    sk_sp<SkImage> frame = player->getFrame();
+                    REPORTER_ASSERT(r, frame && frame == player->getFrame());
+                    REPORTER_ASSERT(r, ToolUtils::equal_pixels(frame.get(),
+                                                               expected->getFrame().get()),
+                                    "%s differs at %u ms, with %zu byte cache", file, msec,
+                                    cacheBytes);
+                }
+            }
+        }
+    }
+}
+
+// Steps through real animations one frame at a time, so that most frames are requested while
+// they, or the frames after them, are still being decoded ahead of time.
+DEF_TEST(AnimCodecPlayer_prefetchEachFrame, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(2);
+
+    for (const char* file : {"images/alphabetAnim.gif", "images/stoplight.webp"}) {
+        sk_sp<SkData> data = GetResourceAsData(file);
+        std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(data);
+        if (!codec) {
+            ERRORF(r, "Could not create codec for %s", file);
+            continue;
+        }
+        const std::vector<SkCodec::FrameInfo> frameInfos = codec->getFrameInfo();
+        REPORTER_ASSERT(r, frameInfos.size() > 1, "%s is not animated", file);
+
+        auto expected = std::make_unique<SkAnimCodecPlayer>(std::move(codec));
+        const size_t frameBytes =
+                SkImageInfo::MakeN32Premul(expected->dimensions()).computeMinByteSize();
+        auto player = std::make_unique<SkAnimCodecPlayer>(data, executor.get(), 3 * frameBytes);
+
+        for (int loop = 0; loop < 2; loop++) {
+            uint32_t msec = 0;
+            for (const SkCodec::FrameInfo& info : frameInfos) {
+                player->seek(msec);
+                expected->seek(msec);
+                REPORTER_ASSERT(r, ToolUtils::equal_pixels(player->getFrame().get(),
+                                                           expected->getFrame().get()),
+                                "%s differs at %u ms", file, msec);
+                msec += info.fDuration;
+            }
+        }
+    }
+}
@@ -171,6 +171,54 @@ DEF_TEST(Codec_partialWuffs, r) {
     }
 }
 
+DEF_TEST(Codec_partialWebp, r) {
+    test_partial(r, "images/baby_tux.webp");                        // lossy, with alpha
+    test_partial(r, "images/color_wheel.webp");                     // lossless
+    test_partial(r, "images/yellow_rose.webp");
+    // The large ALPH chunk comes before the VP8 chunk, and the codec cannot be created until
+    // the first frame's header has arrived.
+    test_partial(r, "images/webp-color-profile-lossy-alpha.webp", 11700);
+
+    // Rows should show up as their data arrives, rather than all at once at the end.
+    const char* path = "images/yellow_rose.webp";
+    sk_sp<SkData> file = GetResourceAsData(path);
+    if (!file) {
+        ERRORF(r, "missing %s", path);
+        return;
+    }
+    HaltingStream* stream = new HaltingStream(file, file->size() / 4);
+    auto codec = SkCodec::MakeFromStream(std::unique_ptr<SkStream>(stream));
+    if (!codec) {
+        ERRORF(r, "Failed to create codec for %s", path);
+        return;
+    }
+    const SkImageInfo info = standardize_info(codec.get());
+    SkBitmap bm;
+    bm.allocPixels(info);
+    REPORTER_ASSERT(r, SkCodec::kSuccess == codec->startIncrementalDecode(info, bm.getPixels(),
+                                                                          bm.rowBytes()));
+    int prevRows = 0;
+    bool sawPartialRows = false;
+    while (true) {
+        int rows = 0;
+        const SkCodec::Result result = codec->incrementalDecode(&rows);
+        if (result == SkCodec::kSuccess) {
+            break;
+        }
+        REPORTER_ASSERT(r, result == SkCodec::kIncompleteInput);
+        REPORTER_ASSERT(r, prevRows <= rows && rows <= info.height(), "%d, %d", prevRows, rows);
+        sawPartialRows |= 0 < rows && rows < info.height();
+        prevRows = rows;
+
+        if (stream->isAllDataReceived()) {
+            ERRORF(r, "Failed to completely decode %s", path);
+            return;
+        }
+        stream->addNewData(1000);
+    }
+    REPORTER_ASSERT(r, sawPartialRows);
+}
+
 // Verify that when decoding an animated gif byte by byte we report the correct
 // fRequiredFrame as soon as getFrameInfo reports the frame.
 DEF_TEST(Codec_requiredFrame, r) {
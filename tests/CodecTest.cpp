@@ -13,16 +13,22 @@
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkColorPriv.h"
 #include "include/core/SkColorSpace.h"
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
 #include "include/core/SkDataTable.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageGenerator.h"
 #include "include/core/SkImageInfo.h"
+#include "include/core/SkMatrix.h"
+#include "include/core/SkPaint.h"
 #include "include/core/SkPixmap.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkSamplingOptions.h"
+#include "include/core/SkShader.h"
 #include "include/core/SkSize.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkString.h"
@@ -38,9 +44,12 @@
 #include "src/base/SkAutoMalloc.h"
 #include "src/base/SkRandom.h"
 #include "src/codec/SkCodecImageGenerator.h"
+#include "src/core/SkBitmapCache.h"
 #include "src/core/SkColorSpacePriv.h"
 #include "src/core/SkMD5.h"
+#include "src/core/SkMipmap.h"
 #include "src/core/SkStreamPriv.h"
+#include "src/image/SkImage_Base.h"
 #include "tests/FakeStreams.h"
 #include "tests/Test.h"
 #include "tools/Resources.h"
@@ -57,6 +66,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <cstring>
+#include <functional>
 #include <initializer_list>
 #include <memory>
 #include <utility>
@@ -1959,3 +1969,274 @@ DEF_TEST(Codec_kBGR_101010x_XR_SkColorType_supported, r) {
     bool success = codec->getPixels(dstInfo, dstBm.getPixels(), dstBm.rowBytes());
     REPORTER_ASSERT(r, SkCodec::kSuccess == success);
 }
+
+DEF_TEST(Codec_JpegRestartIntervalsInParallel, r) {
+    // Big enough to split into a few bands, with a partial row of MCUs at the bottom.
+    SkBitmap src;
+    src.allocN32Pixels(2050, 1539, /*isOpaque=*/true);
+    SkRandom rand;
+    for (int y = 0; y < src.height(); y++) {
+        for (int x = 0; x < src.width(); x++) {
+            *src.getAddr32(x, y) = SkPackARGB32(0xFF, (x + y) / 16 & 0xFF, x * 255 / src.width(),
+                                                rand.nextU() & 0x3F);
+        }
+    }
+    SkBitmap gray;
+    gray.allocPixels(src.info().makeColorType(kGray_8_SkColorType));
+    src.readPixels(gray.pixmap());
+
+    // Runs work as it's added, and counts it.
+    class CountingExecutor final : public SkExecutor {
+    public:
+        void add(std::function<void(void)> work) override {
+            fCount++;
+            work();
+        }
+        int fCount = 0;
+    };
+    std::unique_ptr<SkExecutor> threads = SkExecutor::MakeFIFOThreadPool(4);
+
+    const struct {
+        const SkBitmap* src;
+        SkJpegEncoder::Downsample downsample;
+        int restartInterval;
+        bool parallel;
+    } kRecs[] = {
+        {&src,  SkJpegEncoder::Downsample::k420,   0, false},
+        {&src,  SkJpegEncoder::Downsample::k420, 129,  true},  // one per row of MCUs
+        {&src,  SkJpegEncoder::Downsample::k420,  43,  true},
+        {&src,  SkJpegEncoder::Downsample::k420, 258,  true},
+        {&src,  SkJpegEncoder::Downsample::k420,   7,  true},  // rows line up every 7 rows
+        {&src,  SkJpegEncoder::Downsample::k422,  32,  true},
+        {&src,  SkJpegEncoder::Downsample::k444, 257,  true},
+        {&gray, SkJpegEncoder::Downsample::k420, 100,  true},
+    };
+    for (const auto& rec : kRecs) {
+        SkJpegEncoder::Options options;
+        options.fQuality = 90;
+        options.fDownsample = rec.downsample;
+        options.fRestartInterval = rec.restartInterval;
+        SkDynamicMemoryWStream stream;
+        if (!SkJpegEncoder::Encode(&stream, rec.src->pixmap(), options)) {
+            ERRORF(r, "Failed to encode");
+            continue;
+        }
+        sk_sp<SkData> data = stream.detachAsData();
+
+        for (SkColorType ct : {kN32_SkColorType, kRGBA_F16_SkColorType}) {
+            auto codec = SkCodec::MakeFromData(data);
+            SkImageInfo info = codec->getInfo().makeColorType(ct).makeColorSpace(
+                    ct == kRGBA_F16_SkColorType ? SkColorSpace::MakeSRGBLinear() : nullptr);
+            SkBitmap serial, parallel, threaded;
+            serial.allocPixels(info);
+            parallel.allocPixels(info);
+            threaded.allocPixels(info);
+            REPORTER_ASSERT(r, codec->getPixels(serial.pixmap()) == SkCodec::kSuccess);
+
+            CountingExecutor executor;
+            SkCodec::Options codecOptions;
+            codecOptions.fExecutor = &executor;
+            REPORTER_ASSERT(r, codec->getPixels(parallel.pixmap(), &codecOptions) ==
+                               SkCodec::kSuccess);
+            REPORTER_ASSERT(r, (executor.fCount > 1) == rec.parallel,
+                            "interval %d: %d tasks", rec.restartInterval, executor.fCount);
+
+            codecOptions.fExecutor = threads.get();
+            REPORTER_ASSERT(r, codec->getPixels(threaded.pixmap(), &codecOptions) ==
+                               SkCodec::kSuccess);
+
+            for (int y = 0; y < info.height(); y++) {
+                if (memcmp(serial.getAddr(0, y), parallel.getAddr(0, y), info.minRowBytes()) ||
+                    memcmp(serial.getAddr(0, y), threaded.getAddr(0, y), info.minRowBytes())) {
+                    ERRORF(r, "interval %d: row %d differs from a serial decode",
+                           rec.restartInterval, y);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// Unless it has an SkPngChunkReader, SkPngCodec reads the image data of non-interlaced 8-bit PNGs
+// itself, rather than through libpng.  Both ways should decode exactly the same rows.
+DEF_TEST(Codec_PngReadIdatDirectly, r) {
+    class NoopChunkReader : public SkPngChunkReader {
+        bool readChunk(const char[], const void*, size_t) override { return true; }
+    };
+    auto chunkReader = sk_make_sp<NoopChunkReader>();
+
+    auto decode = [](sk_sp<SkData> data, SkPngChunkReader* reader, const SkIRect* subset,
+                     SkBitmap* dst, int* rowsDecoded) {
+        std::unique_ptr<SkCodec> codec =
+                SkCodec::MakeFromStream(SkMemoryStream::Make(std::move(data)), nullptr, reader);
+        if (!codec) {
+            return SkCodec::kInvalidInput;
+        }
+        dst->allocPixels(codec->getInfo().makeColorType(kN32_SkColorType));
+        dst->eraseColor(SK_ColorTRANSPARENT);
+        SkCodec::Options options;
+        options.fSubset = subset;
+        SkCodec::Result result = codec->startIncrementalDecode(dst->info(), dst->getPixels(),
+                                                               dst->rowBytes(), &options);
+        *rowsDecoded = dst->height();
+        return result == SkCodec::kSuccess ? codec->incrementalDecode(rowsDecoded) : result;
+    };
+
+    SkRandom random;
+    for (SkISize size : {SkISize{37, 23}, SkISize{301, 67}}) {
+        for (SkColorType colorType : {kGray_8_SkColorType, kRGB_888x_SkColorType,
+                                      kRGBA_8888_SkColorType}) {
+            SkBitmap src;
+            src.allocPixels(SkImageInfo::Make(size, colorType,
+                                              colorType == kRGBA_8888_SkColorType
+                                                      ? kUnpremul_SkAlphaType
+                                                      : kOpaque_SkAlphaType));
+            // Smooth gradients with some noise, so that each filter has something to do.
+            for (int y = 0; y < size.height(); y++) {
+                for (int x = 0; x < size.width(); x++) {
+                    const int noise = random.nextULessThan(16);
+                    const SkColor c = SkColorSetARGB(255 - 3 * y, (5 * x + noise) & 0xff,
+                                                     (7 * y) & 0xff, (x + y) & 0xff);
+                    if (colorType == kGray_8_SkColorType) {
+                        *src.getAddr8(x, y) = SkColorGetR(c);
+                    } else {
+                        src.erase(c, SkIRect::MakeXYWH(x, y, 1, 1));
+                    }
+                }
+            }
+
+            using SkPngEncoder::FilterFlag;
+            for (FilterFlag filter : {FilterFlag::kNone, FilterFlag::kSub, FilterFlag::kUp,
+                                      FilterFlag::kAvg, FilterFlag::kPaeth, FilterFlag::kAll}) {
+                SkPngEncoder::Options options;
+                options.fFilterFlags = filter;
+                SkDynamicMemoryWStream stream;
+                REPORTER_ASSERT(r, SkPngEncoder::Encode(&stream, src.pixmap(), options));
+                sk_sp<SkData> png = stream.detachAsData();
+
+                const SkIRect middle = SkIRect::MakeLTRB(0, size.height() / 3,
+                                                         size.width(), size.height() * 2 / 3);
+                struct {
+                    sk_sp<SkData>  data;
+                    const SkIRect* subset;
+                } cases[] = {
+                    {png, nullptr},
+                    {png, &middle},
+                    {SkData::MakeSubset(png.get(), 0, png->size() * 2 / 3), nullptr},
+                };
+                for (const auto& c : cases) {
+                    SkBitmap direct, viaLibpng;
+                    int directRows, libpngRows;
+                    SkCodec::Result directResult = decode(c.data, nullptr, c.subset, &direct,
+                                                          &directRows);
+                    SkCodec::Result libpngResult = decode(c.data, chunkReader.get(), c.subset,
+                                                          &viaLibpng, &libpngRows);
+                    REPORTER_ASSERT(r, directResult == libpngResult,
+                                    "%d != %d", directResult, libpngResult);
+                    // libpng holds on to a little more of the data before handing over rows.
+                    REPORTER_ASSERT(r, directRows >= libpngRows,
+                                    "%d < %d", directRows, libpngRows);
+                    for (int y = 0; y < libpngRows; y++) {
+                        REPORTER_ASSERT(r, !memcmp(direct.getAddr(0, y), viaLibpng.getAddr(0, y),
+                                                   direct.info().minRowBytes()),
+                                        "row %d differs", y);
+                    }
+                }
+            }
+        }
+    }
+}
+
+DEF_TEST(Codec_scaledDimensionsAtLeast, r) {
+    sk_sp<SkData> data = GetResourceAsData("images/mandrill_512_q075.jpg");
+    if (!data) {
+        return;
+    }
+    std::unique_ptr<SkImageGenerator> gen = SkCodecImageGenerator::MakeFromEncodedCodec(data);
+    REPORTER_ASSERT(r, gen);
+    const SkISize full = gen->getInfo().dimensions();
+
+    const struct {
+        SkISize minSize;
+        SkISize expected;
+    } recs[] = {
+        {full,         full},
+        {{600, 600},   full},
+        {{256, 256},   {256, 256}},
+        {{257, 100},   {320, 320}},  // 5/8
+        {{100, 257},   {320, 320}},
+        {{64, 64},     {64, 64}},    // 1/8, the smallest libjpeg-turbo can do
+        {{1, 1},       {64, 64}},
+        {{0, -5},      {64, 64}},
+    };
+    for (const auto& rec : recs) {
+        const SkISize size = gen->getScaledDimensionsAtLeast(rec.minSize);
+        REPORTER_ASSERT(r, size == rec.expected, "{%d, %d} -> {%d, %d}, expected {%d, %d}",
+                        rec.minSize.width(), rec.minSize.height(), size.width(), size.height(),
+                        rec.expected.width(), rec.expected.height());
+    }
+
+    // A lazy image drawn small enough to use mipmaps decodes at a smaller scale, and caches that.
+    sk_sp<SkImage> lazy = SkImages::DeferredFromEncodedData(data);
+    SkBitmap scaled, scaledAgain;
+    REPORTER_ASSERT(r, as_IB(lazy)->getScaledROPixels({100, 100}, &scaled));
+    REPORTER_ASSERT(r, scaled.dimensions() == SkISize::Make(128, 128));
+    REPORTER_ASSERT(r, as_IB(lazy)->getScaledROPixels({100, 100}, &scaledAgain));
+    REPORTER_ASSERT(r, scaled.getPixels() == scaledAgain.getPixels());
+    REPORTER_ASSERT(r, !as_IB(lazy)->getScaledROPixels(full, &scaled));
+
+    // ... unless asked not to.
+    {
+        sk_sp<SkImage> uncached = SkImages::DeferredFromEncodedData(data);
+        SkBitmap bm;
+        REPORTER_ASSERT(r, as_IB(uncached)->getScaledROPixels({100, 100}, &bm,
+                                                              SkImage::kDisallow_CachingHint));
+        REPORTER_ASSERT(r, bm.dimensions() == SkISize::Make(128, 128));
+        REPORTER_ASSERT(r, !SkBitmapCache::Find(
+                SkBitmapCacheDesc::MakeScaled(uncached->uniqueID(), bm.dimensions()), &bm));
+    }
+
+    // That should look much the same as building mipmaps from the fully decoded image, whether
+    // drawn directly or through a shader.
+    sk_sp<SkImage> raster = lazy->makeRasterImage();
+    REPORTER_ASSERT(r, raster);
+    const SkSamplingOptions sampling(SkFilterMode::kLinear, SkMipmapMode::kLinear);
+    for (int dstSize : {40, 64, 100, 200}) {
+        const SkRect dst = SkRect::MakeWH(dstSize, dstSize);
+        for (bool useShader : {false, true}) {
+            auto draw = [&](const sk_sp<SkImage>& image) {
+                SkBitmap bm;
+                bm.allocN32Pixels(dstSize, dstSize);
+                SkCanvas canvas(bm);
+                if (useShader) {
+                    SkPaint paint;
+                    paint.setShader(image->makeShader(
+                            sampling, SkMatrix::RectToRect(SkRect::Make(image->bounds()), dst)));
+                    canvas.drawRect(dst, paint);
+                } else {
+                    canvas.drawImageRect(image, dst, sampling);
+                }
+                return bm;
+            };
+            const SkBitmap expected = draw(raster),
+                           actual   = draw(lazy);
+            int maxDiff = 0;
+            for (int y = 0; y < dstSize; y++)
+            for (int x = 0; x < dstSize; x++) {
+                const SkColor e = expected.getColor(x, y),
+                              a = actual.getColor(x, y);
+                for (int shift : {0, 8, 16}) {
+                    maxDiff = std::max(maxDiff, std::abs((int)((e >> shift) & 0xff) -
+                                                         (int)((a >> shift) & 0xff)));
+                }
+            }
+            REPORTER_ASSERT(r, maxDiff <= 32, "%d: max diff %d", dstSize, maxDiff);
+        }
+    }
+
+    // The shader drawn into 40x40 needed mipmaps built from the 64x64 decode; those are cached
+    // too, rather than rebuilt for every draw.
+    sk_sp<const SkMipmap> mips(SkMipmapCache::FindAndRef(
+            SkBitmapCacheDesc::MakeScaled(lazy->uniqueID(), {64, 64})));
+    REPORTER_ASSERT(r, mips);
+}
@@ -15,6 +15,7 @@
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
 #include "include/core/SkDataTable.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkPixmap.h"
@@ -343,6 +344,171 @@ DEF_TEST(Encode_PngOptions, r) {
     REPORTER_ASSERT(r, almost_equals(bm0, bm2, 0));
 }
 
+static SkBitmap decode_png(skiatest::Reporter* r, sk_sp<SkData> data) {
+    SkBitmap bm;
+    std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(std::move(data));
+    REPORTER_ASSERT(r, codec);
+    if (codec) {
+        bm.allocPixels(codec->getInfo());
+        REPORTER_ASSERT(r, SkCodec::kSuccess == codec->getPixels(bm.pixmap()));
+    }
+    return bm;
+}
+
+static bool pixels_equal(const SkBitmap& a, const SkBitmap& b) {
+    if (a.info() != b.info()) {
+        return false;
+    }
+    for (int y = 0; y < a.height(); y++) {
+        if (memcmp(a.getAddr(0, y), b.getAddr(0, y), a.info().minRowBytes())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+DEF_TEST(Encode_PngExecutor, r) {
+    SkBitmap mandrill;
+    if (!GetResourceAsBitmap("images/mandrill_256.png", &mandrill)) {
+        return;
+    }
+    // A copy with some detail in its alpha channel too.
+    SkBitmap translucent;
+    translucent.allocPixels(mandrill.info().makeColorType(kRGBA_8888_SkColorType)
+                                           .makeAlphaType(kUnpremul_SkAlphaType));
+    mandrill.readPixels(translucent.pixmap());
+    for (int y = 0; y < translucent.height(); y++) {
+        for (int x = 0; x < translucent.width(); x++) {
+            *translucent.getAddr32(x, y) &= 0x00ffffff;
+            *translucent.getAddr32(x, y) |= (uint32_t)((x ^ y) & 0xff) << 24;
+        }
+    }
+
+    std::unique_ptr<SkExecutor> oneThread = SkExecutor::MakeFIFOThreadPool(1),
+                                fourThreads = SkExecutor::MakeFIFOThreadPool(4);
+
+    // Cover each PNG color type and bit depth.
+    for (SkColorType ct : {kN32_SkColorType, kGray_8_SkColorType, kRGB_565_SkColorType,
+                           kRGBA_F16_SkColorType, kARGB_4444_SkColorType}) {
+        for (SkAlphaType at : {kOpaque_SkAlphaType, kPremul_SkAlphaType}) {
+            if (at != kOpaque_SkAlphaType && SkColorTypeIsAlwaysOpaque(ct)) {
+                continue;
+            }
+            SkBitmap src;
+            src.allocPixels(mandrill.info().makeColorType(ct).makeAlphaType(at));
+            REPORTER_ASSERT(r, (at == kOpaque_SkAlphaType ? mandrill : translucent)
+                                       .readPixels(src.pixmap()));
+
+            for (auto filters : {SkPngEncoder::FilterFlag::kZero,
+                                 SkPngEncoder::FilterFlag::kNone,
+                                 SkPngEncoder::FilterFlag::kAvg,
+                                 SkPngEncoder::FilterFlag::kPaeth,
+                                 SkPngEncoder::FilterFlag::kAll}) {
+                for (int zlibLevel : {0, 6, 9}) {
+                    SkPngEncoder::Options options;
+                    options.fFilterFlags = filters;
+                    options.fZLibLevel = zlibLevel;
+                    SkDynamicMemoryWStream serial, parallel1, parallel4;
+                    REPORTER_ASSERT(r, SkPngEncoder::Encode(&serial, src.pixmap(), options));
+                    options.fExecutor = oneThread.get();
+                    REPORTER_ASSERT(r, SkPngEncoder::Encode(&parallel1, src.pixmap(), options));
+                    options.fExecutor = fourThreads.get();
+                    REPORTER_ASSERT(r, SkPngEncoder::Encode(&parallel4, src.pixmap(), options));
+
+                    sk_sp<SkData> serialData = serial.detachAsData(),
+                                  parallel1Data = parallel1.detachAsData(),
+                                  parallel4Data = parallel4.detachAsData();
+                    // The output doesn't depend on how many threads made it.
+                    REPORTER_ASSERT(r, parallel1Data->equals(parallel4Data.get()),
+                                    "ct %d at %d filters %d level %d",
+                                    ct, at, (int)filters, zlibLevel);
+                    // It decodes to exactly what the serial encoder's output does...
+                    REPORTER_ASSERT(r, pixels_equal(decode_png(r, serialData),
+                                                    decode_png(r, parallel4Data)),
+                                    "ct %d at %d filters %d level %d",
+                                    ct, at, (int)filters, zlibLevel);
+                    // ...and is not much larger.
+                    REPORTER_ASSERT(r, parallel4Data->size() <= serialData->size() * 1.05 + 64,
+                                    "ct %d at %d filters %d level %d: %zu vs %zu",
+                                    ct, at, (int)filters, zlibLevel,
+                                    parallel4Data->size(), serialData->size());
+                }
+            }
+        }
+    }
+
+    // libpng treats asking for no filters on an 8-bit image as asking for all of them, and so
+    // should we when we filter the rows ourselves.
+    for (SkExecutor* executor : {(SkExecutor*)nullptr, fourThreads.get()}) {
+        SkPngEncoder::Options options;
+        options.fExecutor = executor;
+        SkDynamicMemoryWStream zero, all;
+        options.fFilterFlags = SkPngEncoder::FilterFlag::kZero;
+        REPORTER_ASSERT(r, SkPngEncoder::Encode(&zero, mandrill.pixmap(), options));
+        options.fFilterFlags = SkPngEncoder::FilterFlag::kAll;
+        REPORTER_ASSERT(r, SkPngEncoder::Encode(&all, mandrill.pixmap(), options));
+        REPORTER_ASSERT(r, zero.detachAsData()->equals(all.detachAsData().get()));
+    }
+}
+
+DEF_TEST(Encode_PngSampleFilters, r) {
+    using Flag = SkPngEncoder::FilterFlag;
+    std::unique_ptr<SkExecutor> threads = SkExecutor::MakeFIFOThreadPool(4);
+
+    for (const char* path : {"images/mandrill_256.png", "images/text.png", "images/ducky.png"}) {
+        SkBitmap bitmap;
+        if (!GetResourceAsBitmap(path, &bitmap)) {
+            continue;
+        }
+        // Include sizes that aren't a multiple of the bands, and ones libpng limits the filters
+        // of.
+        for (SkIRect subset : {SkIRect::MakeSize(bitmap.dimensions()),
+                               SkIRect::MakeXYWH(3, 5, 101, 37),
+                               SkIRect::MakeXYWH(7, 0, 1, 50),
+                               SkIRect::MakeXYWH(0, 9, 50, 1)}) {
+            SkPixmap src;
+            REPORTER_ASSERT(r, bitmap.pixmap().extractSubset(&src, subset));
+
+            SkPngEncoder::Options options;
+            options.fFilterFlags = Flag::kNone;
+            SkDynamicMemoryWStream noneStream;
+            REPORTER_ASSERT(r, SkPngEncoder::Encode(&noneStream, src, options));
+            sk_sp<SkData> none = noneStream.detachAsData();
+            const SkBitmap expected = decode_png(r, none);
+
+            for (Flag filters : {Flag::kAll, Flag::kSub | Flag::kPaeth, Flag::kNone | Flag::kSub}) {
+                options.fFilterFlags = filters;
+                options.fSampleFilters = true;
+
+                SkDynamicMemoryWStream serial, incremental, parallel;
+                REPORTER_ASSERT(r, SkPngEncoder::Encode(&serial, src, options));
+                std::unique_ptr<SkEncoder> encoder = SkPngEncoder::Make(&incremental, src, options);
+                REPORTER_ASSERT(r, encoder);
+                for (int y = 0; encoder && y < src.height(); y += 7) {
+                    REPORTER_ASSERT(r, encoder->encodeRows(7));
+                }
+                options.fExecutor = threads.get();
+                REPORTER_ASSERT(r, SkPngEncoder::Encode(&parallel, src, options));
+                options.fExecutor = nullptr;
+
+                sk_sp<SkData> serialData = serial.detachAsData(),
+                              incrementalData = incremental.detachAsData(),
+                              parallelData = parallel.detachAsData();
+                REPORTER_ASSERT(r, serialData->equals(incrementalData.get()), "%s", path);
+                REPORTER_ASSERT(r, pixels_equal(expected, decode_png(r, serialData)), "%s", path);
+                REPORTER_ASSERT(r, pixels_equal(expected, decode_png(r, parallelData)), "%s", path);
+
+                // Sampling should compress nearly as well as trying each filter on every row.
+                SkDynamicMemoryWStream perRow;
+                options.fSampleFilters = false;
+                REPORTER_ASSERT(r, SkPngEncoder::Encode(&perRow, src, options));
+                REPORTER_ASSERT(r, serialData->size() <= perRow.bytesWritten() * 1.1 + 64,
+                                "%s: %zu vs %zu", path, serialData->size(), perRow.bytesWritten());
+            }
+        }
+    }
+}
+
 #ifndef SK_BUILD_FOR_GOOGLE3
 DEF_TEST(Encode_WebpQuality, r) {
     SkBitmap bm;
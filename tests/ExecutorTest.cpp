@@ -0,0 +1,62 @@
+/*
+ * Copyright 2023 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkExecutor.h"
+#include "src/core/SkTaskGroup.h"
+#include "tests/Test.h"
+
+#include <atomic>
+#include <memory>
+
+DEF_TEST(Executor_WorkStealing_Batch, r) {
+    auto executor = SkExecutor::MakeWorkStealingPool(4);
+
+    std::atomic<int> sum{0};
+    SkTaskGroup group(*executor);
+    group.batch(1000, [&](int i) { sum.fetch_add(i, std::memory_order_relaxed); });
+    group.wait();
+
+    REPORTER_ASSERT(r, sum.load() == 999 * 1000 / 2);
+}
+
+DEF_TEST(Executor_WorkStealing_Nested, r) {
+    auto executor = SkExecutor::MakeWorkStealingPool(4);
+
+    // Tasks added from pool threads land on those threads' own deques,
+    // and must still all run whether they're popped locally or stolen.
+    std::atomic<int> leaves{0};
+    SkTaskGroup root(*executor);
+    root.batch(32, [&](int) {
+        SkTaskGroup inner(*executor);
+        inner.batch(100, [&](int) { leaves.fetch_add(1, std::memory_order_relaxed); });
+        inner.wait();
+    });
+    root.wait();
+
+    REPORTER_ASSERT(r, leaves.load() == 32 * 100);
+}
+
+DEF_TEST(Executor_WorkStealing_DeepRecursion, r) {
+    auto executor = SkExecutor::MakeWorkStealingPool(2);
+
+    // Each level adds two children and waits on them from a pool thread.
+    std::atomic<int> nodes{0};
+    std::function<void(int)> visit = [&](int depth) {
+        nodes.fetch_add(1, std::memory_order_relaxed);
+        if (depth > 0) {
+            SkTaskGroup children(*executor);
+            children.add([&, depth] { visit(depth - 1); });
+            children.add([&, depth] { visit(depth - 1); });
+            children.wait();
+        }
+    };
+    SkTaskGroup root(*executor);
+    root.add([&] { visit(10); });
+    root.wait();
+
+    REPORTER_ASSERT(r, nodes.load() == (1 << 11) - 1);
+}
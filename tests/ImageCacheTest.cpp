@@ -5,15 +5,19 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkExecutor.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkTypes.h"
 #include "include/private/chromium/SkDiscardableMemory.h"
 #include "src/core/SkResourceCache.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/lazy/SkDiscardableMemoryPool.h"
 #include "tests/Test.h"
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 
 namespace {
 static void* gGlobalAddress;
@@ -154,3 +158,57 @@ DEF_TEST(ImageCache_doubleAdd, r) {
     REPORTER_ASSERT(r, cache.find(key, TestingRec::Visitor, &value));
     REPORTER_ASSERT(r, 2 == value || 3 == value);
 }
+
+DEF_TEST(ImageCache_findKeepsRec, r) {
+    // Room for 20 of our Recs. Recs that keep being found should never be purged, wherever
+    // they are in the cache.
+    const size_t recBytes = TestingRec(TestingKey(0), 0).bytesUsed();
+    SkResourceCache cache(20 * recBytes);
+
+    cache.add(new TestingRec(TestingKey(0), 0));
+    for (int i = 1; i < COUNT * 100; ++i) {
+        cache.add(new TestingRec(TestingKey(i), i));
+        intptr_t value = -1;
+        REPORTER_ASSERT(r, cache.find(TestingKey(0), TestingRec::Visitor, &value));
+        REPORTER_ASSERT(r, 0 == value);
+        REPORTER_ASSERT(r, cache.getTotalBytesUsed() < 20 * recBytes);
+    }
+}
+
+DEF_TEST(ImageCache_threaded, r) {
+    // Room for 100 of our Recs, with 4 times as many keys being added and found.
+    const size_t recBytes = TestingRec(TestingKey(0), 0).bytesUsed();
+    const size_t limit = 100 * recBytes;
+    SkResourceCache cache(limit);
+
+    constexpr int kThreads = 8;
+    std::atomic<int> wrongValues{0};
+    auto executor = SkExecutor::MakeFIFOThreadPool(kThreads);
+    SkTaskGroup(*executor).batch(kThreads, [&](int thread) {
+        for (int i = 0; i < 2000; ++i) {
+            const intptr_t key = (thread * 31 + i * 7) % 400;
+            intptr_t value = -1;
+            if (!cache.find(TestingKey(key), TestingRec::Visitor, &value)) {
+                cache.add(new TestingRec(TestingKey(key), key));
+            } else if (value != key) {
+                wrongValues++;
+            }
+        }
+    });
+    REPORTER_ASSERT(r, wrongValues == 0);
+
+    // Threads can leave the cache a little over budget while they race, but once they're done,
+    // the next add gets it back under.
+    cache.add(new TestingRec(TestingKey(400), 400));
+    REPORTER_ASSERT(r, cache.getTotalBytesUsed() < limit);
+    REPORTER_ASSERT(r, cache.getTotalBytesUsed() > 0);
+
+    intptr_t value = -1;
+    REPORTER_ASSERT(r, cache.find(TestingKey(400), TestingRec::Visitor, &value));
+    REPORTER_ASSERT(r, 400 == value);
+
+    // Shrinking the budget purges every shard.
+    cache.setTotalByteLimit(0);
+    REPORTER_ASSERT(r, cache.getTotalBytesUsed() == 0);
+    REPORTER_ASSERT(r, !cache.find(TestingKey(400), TestingRec::Visitor, &value));
+}
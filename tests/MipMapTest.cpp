@@ -10,6 +10,7 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkColorType.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkPixmap.h"
@@ -21,12 +22,17 @@
 #include "include/core/SkSurface.h"
 #include "include/core/SkTypes.h"
 #include "include/private/base/SkMalloc.h"
+#include "src/base/SkHalf.h"
 #include "src/base/SkRandom.h"
 #include "src/core/SkMipmap.h"
 #include "src/core/SkMipmapBuilder.h"
 #include "tests/Test.h"
 #include "tools/Resources.h"
 
+#include <cmath>
+#include <cstring>
+#include <memory>
+
 static void make_bitmap(SkBitmap* bm, int width, int height) {
     bm->allocN32Pixels(width, height);
     bm->eraseColor(SK_ColorWHITE);
@@ -227,6 +233,90 @@ DEF_TEST(MipMap_F16, reporter) {
     sk_sp<SkMipmap> mipmap(SkMipmap::Build(bmp, nullptr));
 }
 
+// Checks the first level against a straightforward box or triangle filter, one channel at a time.
+static void check_first_level(skiatest::Reporter* reporter, const SkPixmap& src,
+                              const SkPixmap& dst) {
+    const int fw = (src.width()  & 1) && src.width()  > 1 ? 3 : src.width()  > 1 ? 2 : 1,
+              fh = (src.height() & 1) && src.height() > 1 ? 3 : src.height() > 1 ? 2 : 1;
+    const float kWeights[4][3] = {{}, {1, 0, 0}, {0.5f, 0.5f, 0}, {0.25f, 0.5f, 0.25f}};
+    const bool isF16 = src.colorType() == kRGBA_F16_SkColorType;
+    const int channels = isF16 ? 4 : src.info().bytesPerPixel();
+
+    for (int y = 0; y < dst.height(); ++y)
+    for (int x = 0; x < dst.width(); ++x)
+    for (int ch = 0; ch < channels; ++ch) {
+        auto channel = [&](const SkPixmap& pm, int px, int py) -> float {
+            if (isF16) {
+                uint64_t half4 = *pm.addr64(px, py);
+                return SkHalfToFloat_finite_ftz(half4)[ch];
+            }
+            return static_cast<const uint8_t*>(pm.addr(px, py))[ch];
+        };
+
+        float expected = 0;
+        for (int j = 0; j < fh; ++j)
+        for (int i = 0; i < fw; ++i) {
+            expected += kWeights[fw][i] * kWeights[fh][j] * channel(src, 2*x + i, 2*y + j);
+        }
+        const float actual = channel(dst, x, y);
+        // The integer filters truncate; F16 rounds through half floats.
+        const bool ok = isF16 ? std::fabs(actual - expected) <= 1.0f / 512
+                              : actual == std::floor(expected);
+        if (!ok) {
+            ERRORF(reporter, "(%d,%d)[%d]: %g, expected %g", x, y, ch, actual, expected);
+            return;
+        }
+    }
+}
+
+// The widest filters and the row bands used with an SkExecutor should both produce exactly the
+// same levels as one pixel and one row at a time.
+DEF_TEST(MipMap_WideAndThreaded, reporter) {
+    auto executor = SkExecutor::MakeFIFOThreadPool(4);
+    SkRandom rand;
+
+    for (SkColorType ct : {kN32_SkColorType, kRGBA_F16_SkColorType, kAlpha_8_SkColorType}) {
+        // Odd and even dimensions pick the 3x3 and 2x2 filters; the odd sizes also leave
+        // leftover pixels after the widest steps.
+        for (SkISize size : {SkISize{1201, 803}, SkISize{1200, 802}, SkISize{1031, 7}}) {
+            SkBitmap bm;
+            bm.allocPixels(SkImageInfo::Make(size, ct, kPremul_SkAlphaType));
+            for (int y = 0; y < bm.height(); ++y) {
+                if (ct == kRGBA_F16_SkColorType) {
+                    for (int x = 0; x < bm.width(); ++x) {
+                        skvx::float4 c = {rand.nextF(), rand.nextF(), rand.nextF(), 1};
+                        SkFloatToHalf_finite_ftz(c).store(bm.pixmap().writable_addr64(x, y));
+                    }
+                } else {
+                    auto row = static_cast<uint8_t*>(bm.pixmap().writable_addr(0, y));
+                    for (size_t i = 0; i < bm.info().minRowBytes(); ++i) {
+                        row[i] = rand.nextU() & 0xFF;
+                    }
+                }
+            }
+
+            sk_sp<SkMipmap> serial(SkMipmap::Build(bm, nullptr)),
+                            threaded(SkMipmap::Build(bm, nullptr, executor.get()));
+            REPORTER_ASSERT(reporter, serial && threaded);
+            REPORTER_ASSERT(reporter, serial->countLevels() == threaded->countLevels());
+
+            SkPixmap prev = bm.pixmap();
+            for (int i = 0; i < serial->countLevels(); ++i) {
+                SkMipmap::Level a, b;
+                REPORTER_ASSERT(reporter, serial->getLevel(i, &a) && threaded->getLevel(i, &b));
+                for (int y = 0; y < a.fPixmap.height(); ++y) {
+                    REPORTER_ASSERT(reporter, 0 == memcmp(a.fPixmap.addr(0, y),
+                                                          b.fPixmap.addr(0, y),
+                                                          a.fPixmap.info().minRowBytes()));
+                }
+                if (i == 0) {
+                    check_first_level(reporter, prev, a.fPixmap);
+                }
+            }
+        }
+    }
+}
+
 static void fill_in_mips(SkMipmapBuilder* builder, sk_sp<SkImage> img) {
     int count = builder->countLevels();
     for (int i = 0; i < count; ++i) {
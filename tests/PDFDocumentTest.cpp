@@ -16,14 +16,28 @@
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkString.h"
+#include "include/core/SkTypeface.h"
 #include "include/docs/SkPDFDocument.h"
+#include "src/core/SkTaskGroup.h"
+#include "src/pdf/SkDeflate.h"
 #include "src/utils/SkOSPath.h"
 #include "tests/Test.h"
+#include "tools/Resources.h"
 
+#include "zlib.h"
+
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <functional>
+#include <map>
 #include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
 
 static void test_empty(skiatest::Reporter* reporter) {
     SkDynamicMemoryWStream stream;
@@ -264,3 +278,287 @@ DEF_TEST(SkPDF_abort_jobs, rep) {
     doc->abort();
 }
 
+// Returns a PDF made with |metadata|, of |pageCount| letter-size pages each drawn by |drawPage|.
+static sk_sp<SkData> make_pdf(const SkPDF::Metadata& metadata, int pageCount,
+                              const std::function<void(SkCanvas*, int page)>& drawPage) {
+    SkDynamicMemoryWStream stream;
+    auto doc = SkPDF::MakeDocument(&stream, metadata);
+    for (int page = 0; page < pageCount; page++) {
+        drawPage(doc->beginPage(612, 792), page);
+        doc->endPage();
+    }
+    doc->close();
+    return stream.detachAsData();
+}
+
+// Returns each indirect object in |pdf|, keyed by its object number.
+static std::map<int, std::string> pdf_objects(const SkData& pdf) {
+    std::map<int, std::string> objects;
+    std::string_view rest(static_cast<const char*>(pdf.data()), pdf.size());
+    for (size_t end; (end = rest.find("\nendobj\n")) != std::string_view::npos;) {
+        std::string_view object = rest.substr(0, end);
+        rest.remove_prefix(end + strlen("\nendobj\n"));
+        size_t start = object.rfind(" 0 obj\n");
+        if (start == std::string_view::npos) {
+            continue;
+        }
+        size_t number = object.find_last_not_of("0123456789", start - 1);
+        number = number == std::string_view::npos ? 0 : number + 1;
+        objects[atoi(std::string(object.substr(number, start - number)).c_str())] =
+                std::string(object.substr(start));
+    }
+    return objects;
+}
+
+// With an executor, fonts are subset in parallel and objects may be written in a different
+// order, but each object should still have the same number and contents.
+DEF_TEST(SkPDF_fonts_with_executor, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_fonts_with_executor, r);
+    std::vector<sk_sp<SkTypeface>> typefaces;
+    for (const char* resource : {"fonts/Roboto-Regular.ttf", "fonts/Distortable.ttf",
+                                 "fonts/ahem.ttf", "fonts/Em.ttf", "fonts/hintgasp.ttf"}) {
+        if (sk_sp<SkTypeface> typeface = MakeResourceAsTypeface(resource)) {
+            typefaces.push_back(std::move(typeface));
+        }
+    }
+    if (typefaces.empty()) {
+        return;
+    }
+
+    auto makePDF = [&](SkExecutor* executor) {
+        SkPDF::Metadata metadata;
+        metadata.fExecutor = executor;
+        return make_pdf(metadata, 2, [&](SkCanvas* canvas, int page) {
+            SkScalar y = 40;
+            for (const sk_sp<SkTypeface>& typeface : typefaces) {
+                SkFont font(typeface, 24);
+                canvas->drawString(page ? "The quick brown fox" : "jumps over the lazy dog",
+                                   20, y, font, SkPaint());
+                y += 40;
+            }
+        });
+    };
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    std::map<int, std::string> serial = pdf_objects(*makePDF(nullptr)),
+                               parallel = pdf_objects(*makePDF(executor.get()));
+    REPORTER_ASSERT(r, !serial.empty());
+    REPORTER_ASSERT(r, serial == parallel);
+}
+
+static int count_occurrences(const SkData& data, std::string_view needle) {
+    std::string_view haystack(static_cast<const char*>(data.data()), data.size());
+    int count = 0;
+    for (size_t i = 0; (i = haystack.find(needle, i)) != std::string_view::npos; i++) {
+        count++;
+    }
+    return count;
+}
+
+// Decodes the cross-reference stream at the end of |pdf| and checks that each object it lists
+// starts at the offset it gives.
+static void check_xref_stream(skiatest::Reporter* r, const SkData& pdf) {
+    std::string_view file(static_cast<const char*>(pdf.data()), pdf.size());
+    size_t startxref = file.rfind("startxref\n");
+    REPORTER_ASSERT(r, startxref != std::string_view::npos);
+    if (startxref == std::string_view::npos) {
+        return;
+    }
+    size_t offset = std::strtoul(file.data() + startxref + strlen("startxref\n"), nullptr, 10);
+    std::string_view xref = file.substr(std::min(offset, startxref), startxref - offset);
+    size_t dictEnd = xref.find(" stream\n");
+    REPORTER_ASSERT(r, xref.find(" 0 obj\n<</Type /XRef") < dictEnd);
+    if (dictEnd == std::string_view::npos) {
+        return;
+    }
+    std::string_view dict = xref.substr(0, dictEnd);
+    auto intValue = [&](std::string_view key) {
+        size_t at = dict.find(key);
+        return at == std::string_view::npos ? -1 : atoi(dict.data() + at + key.size());
+    };
+    const int size = intValue("/Size "),
+              length = intValue("/Length ");
+    REPORTER_ASSERT(r, size > 1 && length > 0);
+    REPORTER_ASSERT(r, dict.find("/W [1 4 2]") != std::string_view::npos);
+    if (size <= 1 || length <= 0) {
+        return;
+    }
+
+    // Each entry is a type byte, a four byte offset, and a two byte generation number.
+    constexpr size_t kEntrySize = 7;
+    std::string_view data = xref.substr(dictEnd + strlen(" stream\n"), length);
+    std::string entries(size * kEntrySize, '\0');
+    if (dict.find("/FlateDecode") != std::string_view::npos) {
+        uLongf entriesLength = entries.size();
+        REPORTER_ASSERT(r, Z_OK == uncompress(reinterpret_cast<Bytef*>(entries.data()),
+                                              &entriesLength,
+                                              reinterpret_cast<const Bytef*>(data.data()),
+                                              data.size()));
+        REPORTER_ASSERT(r, entriesLength == entries.size());
+    } else {
+        REPORTER_ASSERT(r, data.size() == entries.size());
+        entries.assign(data.substr(0, entries.size()));
+    }
+
+    const uint8_t* entry = reinterpret_cast<const uint8_t*>(entries.data());
+    REPORTER_ASSERT(r, entry[0] == 0);  // Object 0 is always free.
+    for (int object = 1; object < size; object++) {
+        entry += kEntrySize;
+        uint32_t objectOffset = (uint32_t)entry[1] << 24 | (uint32_t)entry[2] << 16 |
+                                (uint32_t)entry[3] <<  8 | (uint32_t)entry[4];
+        SkString expected = SkStringPrintf("%d 0 obj\n", object);
+        REPORTER_ASSERT(r, entry[0] == 1 &&
+                           file.substr(objectOffset, expected.size()) == expected.c_str(),
+                        "object %d at %u", object, objectOffset);
+    }
+}
+
+DEF_TEST(SkPDF_streaming, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_streaming, r);
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(20, 20);
+    bitmap.eraseColor(SK_ColorBLUE);
+    sk_sp<SkImage> image = bitmap.asImage();
+    constexpr int kPageCount = 20;
+
+    using CompressionLevel = SkPDF::Metadata::CompressionLevel;
+    auto makePDF = [&](size_t budget, CompressionLevel level = CompressionLevel::Default) {
+        SkPDF::Metadata metadata;
+        metadata.fStreamingMemoryBudget = budget;
+        metadata.fCompressionLevel = level;
+        return make_pdf(metadata, kPageCount, [&](SkCanvas* canvas, int) {
+            canvas->drawString("Hello", 20, 40, SkFont(nullptr, 24), SkPaint());
+            canvas->drawImage(image, 20, 80);
+        });
+    };
+
+    sk_sp<SkData> normal = makePDF(0),
+                  streamed = makePDF(SIZE_MAX),
+                  bounded = makePDF(1),  // Forget all shared resources after every page.
+                  uncompressed = makePDF(SIZE_MAX, CompressionLevel::None);
+    REPORTER_ASSERT(r, normal->size() > 0 && streamed->size() > 0 && bounded->size() > 0);
+
+    REPORTER_ASSERT(r, count_occurrences(*normal, "%PDF-1.4\n") == 1);
+    REPORTER_ASSERT(r, count_occurrences(*normal, "/Type /XRef") == 0);
+    for (const sk_sp<SkData>& pdf : {streamed, bounded, uncompressed}) {
+        REPORTER_ASSERT(r, count_occurrences(*pdf, "%PDF-1.5\n") == 1);
+        REPORTER_ASSERT(r, count_occurrences(*pdf, "/Type /XRef") == 1);
+        REPORTER_ASSERT(r, count_occurrences(*pdf, "\ntrailer\n") == 0);
+        REPORTER_ASSERT(r, count_occurrences(*pdf, "/Type /Page\n") == kPageCount);
+    }
+
+    // startxref should point at the cross-reference stream, and it at each object.
+    for (const sk_sp<SkData>& pdf : {streamed, bounded, uncompressed}) {
+        check_xref_stream(r, *pdf);
+    }
+
+    REPORTER_ASSERT(r, count_occurrences(*uncompressed, "/FlateDecode") == 0);
+
+    // With a budget, the image is written again for each page rather than shared.
+    REPORTER_ASSERT(r, count_occurrences(*streamed, "/Subtype /Image") == 1);
+    REPORTER_ASSERT(r, count_occurrences(*bounded, "/Subtype /Image") == kPageCount);
+}
+
+static std::atomic<int> gDeflateCalls{0};
+
+static bool test_deflate(SkWStream* dst, const void* src, size_t size,
+                         SkPDF::Metadata::CompressionLevel level) {
+    gDeflateCalls++;
+    SkDeflateWStream deflate(dst, (int)level);
+    return deflate.write(src, size);
+}
+
+static bool decline_deflate(SkWStream*, const void*, size_t, SkPDF::Metadata::CompressionLevel) {
+    gDeflateCalls++;
+    return false;
+}
+
+DEF_TEST(SkPDF_custom_deflate, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_custom_deflate, r);
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(64, 64);
+    bitmap.eraseColor(0x80FF0000);
+    sk_sp<SkImage> image = bitmap.asImage();
+
+    auto makePDF = [&](SkPDF::Metadata::DeflateProc deflate) {
+        SkPDF::Metadata metadata;
+        metadata.fDeflate = deflate;
+        return make_pdf(metadata, 1, [&](SkCanvas* canvas, int) {
+            for (int i = 0; i < 20; i++) {
+                canvas->drawString("Hello, world", 20, 40 + 20 * i, SkFont(nullptr, 12),
+                                   SkPaint());
+            }
+            canvas->drawImage(image, 20, 500);
+        });
+    };
+
+    sk_sp<SkData> expected = makePDF(nullptr);
+    for (SkPDF::Metadata::DeflateProc deflate : {test_deflate, decline_deflate}) {
+        gDeflateCalls = 0;
+        sk_sp<SkData> pdf = makePDF(deflate);
+        // At least the page's content stream, the image, and its soft mask.
+        REPORTER_ASSERT(r, gDeflateCalls >= 3);
+        REPORTER_ASSERT(r, pdf->equals(expected.get()));
+    }
+}
+
+DEF_TEST(SkPDF_image_cache, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_image_cache, r);
+    // Make new images for each document, so that only their contents match.
+    auto makeImages = [] {
+        SkBitmap opaque, translucent;
+        opaque.allocN32Pixels(64, 64);
+        opaque.eraseColor(SK_ColorGREEN);
+        translucent.allocN32Pixels(64, 64);
+        translucent.eraseColor(0x80FF0000);
+        return std::vector<sk_sp<SkImage>>{
+            opaque.asImage(),
+            translucent.asImage(),
+            GetResourceAsImage("images/color_wheel.jpg"),
+        };
+    };
+    auto makePDF = [&](sk_sp<SkPDF::ImageCache> cache) {
+        SkPDF::Metadata metadata;
+        metadata.fImageCache = std::move(cache);
+        metadata.fDeflate = test_deflate;
+        return make_pdf(metadata, 1, [&](SkCanvas* canvas, int) {
+            float x = 0;
+            for (const sk_sp<SkImage>& image : makeImages()) {
+                canvas->drawImage(image, x, 0);
+                x += image->width();
+            }
+        });
+    };
+
+    sk_sp<SkData> expected = makePDF(nullptr);
+    REPORTER_ASSERT(r, count_occurrences(*expected, "/Subtype /Image") == 4);
+
+    sk_sp<SkPDF::ImageCache> cache = SkPDF::ImageCache::Make(1 << 20);
+    gDeflateCalls = 0;
+    sk_sp<SkData> first = makePDF(cache);
+    const int uncachedCalls = gDeflateCalls;
+    REPORTER_ASSERT(r, first->equals(expected.get()));
+    REPORTER_ASSERT(r, cache->bytesUsed() > 0);
+
+    // The second document finds its images in the cache, and so only compresses its page.
+    const size_t bytesUsed = cache->bytesUsed();
+    gDeflateCalls = 0;
+    sk_sp<SkData> second = makePDF(cache);
+    REPORTER_ASSERT(r, second->equals(expected.get()));
+    REPORTER_ASSERT(r, gDeflateCalls == uncachedCalls - 3, "%d %d", (int)gDeflateCalls,
+                    uncachedCalls);
+    REPORTER_ASSERT(r, cache->bytesUsed() == bytesUsed);
+
+    // Images that don't fit aren't cached.
+    sk_sp<SkPDF::ImageCache> tiny = SkPDF::ImageCache::Make(1);
+    REPORTER_ASSERT(r, makePDF(tiny)->equals(expected.get()));
+    REPORTER_ASSERT(r, tiny->bytesUsed() == 0);
+
+    // Many documents may share a cache at once.
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    std::atomic<int> matches{0};
+    SkTaskGroup tasks(*executor);
+    tasks.batch(8, [&](int) { matches += makePDF(cache)->equals(expected.get()); });
+    tasks.wait();
+    REPORTER_ASSERT(r, matches == 8);
+}
@@ -11,6 +11,7 @@
 #include "include/core/SkClipOp.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkFont.h"
 #include "include/core/SkFontStyle.h"
 #include "include/core/SkImage.h" // IWYU pragma: keep
@@ -22,13 +23,16 @@
 #include "include/core/SkPicture.h"
 #include "include/core/SkPictureRecorder.h"
 #include "include/core/SkPixelRef.h"
+#include "include/core/SkPixmap.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkSamplingOptions.h"
 #include "include/core/SkScalar.h"
 #include "include/core/SkStream.h"
+#include "include/core/SkSurface.h"
 #include "include/core/SkTypeface.h"
 #include "include/core/SkTypes.h"
+#include "include/effects/SkImageFilters.h"
 #include "src/base/SkRandom.h"
 #include "src/core/SkBigPicture.h"
 #include "src/core/SkPicturePriv.h"
@@ -36,6 +40,7 @@
 #include "tests/Test.h"
 
 #include <cstddef>
+#include <cstring>
 #include <memory>
 #include <vector>
 
@@ -945,3 +950,108 @@ DEF_TEST(Picture_nested_op_count, r) {
     check(make_pic(10, leaf1),  10,  10);
     check(make_pic(10, leaf10), 10, 100);
 }
+
+static sk_sp<SkPicture> make_parallel_test_picture() {
+    SkPictureRecorder rec;
+    SkCanvas* c = rec.beginRecording({0, 0, 400, 300});
+
+    // drawPaint() reaches past the cull rect, and so must any band drawing it.
+    SkPaint paint;
+    paint.setColor(0xFFF0F0E0);
+    c->drawPaint(paint);
+
+    // AA geometry spanning many bands.
+    paint.setAntiAlias(true);
+    SkRandom rand;
+    for (int i = 0; i < 40; i++) {
+        paint.setColor(rand.nextU() | 0x80000000);
+        SkPath path;
+        path.moveTo(rand.nextRangeF(0, 400), rand.nextRangeF(0, 300));
+        path.quadTo(rand.nextRangeF(0, 400), rand.nextRangeF(0, 300),
+                    rand.nextRangeF(0, 400), rand.nextRangeF(0, 300));
+        path.lineTo(rand.nextRangeF(0, 400), rand.nextRangeF(0, 300));
+        c->drawPath(path, paint);
+    }
+
+    c->save();
+        c->rotate(13);
+        c->clipRect({50.5f, 20.25f, 300, 280}, true);
+        paint.setStyle(SkPaint::kStroke_Style);
+        paint.setStrokeWidth(5);
+        paint.setColor(SK_ColorBLUE);
+        c->drawCircle(200, 150, 120, paint);
+        paint.setStyle(SkPaint::kFill_Style);
+    c->restore();
+
+    // A layer whose filter reaches across bands, around a nested picture.
+    SkPictureRecorder nested;
+    SkCanvas* n = nested.beginRecording({0, 0, 100, 100});
+    paint.setColor(SK_ColorMAGENTA);
+    n->drawOval({10, 10, 90, 90}, paint);
+    sk_sp<SkPicture> nestedPic = nested.finishRecordingAsPicture();
+
+    SkPaint layerPaint;
+    layerPaint.setImageFilter(SkImageFilters::Blur(6, 6, nullptr));
+    c->saveLayer(nullptr, &layerPaint);
+        c->translate(150, 100);
+        c->drawPicture(nestedPic);
+    c->restore();
+
+    // Draws between layers are banded again, still under the matrix and clip from before.
+    c->save();
+        c->translate(20, 30);
+        c->clipRect({0, 0, 350, 250}, true);
+        c->saveLayerAlpha(nullptr, 0x80);
+            c->save();
+                c->scale(1.5f, 1.5f);
+                paint.setColor(SK_ColorGREEN);
+                c->drawRect({10, 10, 120, 90}, paint);
+            c->restore();
+        c->restore();
+        paint.setColor(SK_ColorCYAN);
+        c->drawCircle(300, 200, 60, paint);
+    c->restore();
+    paint.setColor(SK_ColorYELLOW);
+    c->drawRect({0, 260, 400, 300}, paint);
+
+    return rec.finishRecordingAsPicture();
+}
+
+DEF_TEST(Picture_PlaybackParallel, r) {
+    sk_sp<SkPicture> pic = make_parallel_test_picture();
+    auto executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    auto draw = [&](SkCanvas* canvas, const SkMatrix& m, bool parallel) {
+        canvas->clear(SK_ColorWHITE);
+        canvas->save();
+        canvas->clipRect({7, 13, 590, 470});
+        canvas->concat(m);
+        parallel ? pic->playbackParallel(canvas, *executor) : pic->playback(canvas);
+        canvas->restore();
+    };
+
+    SkMatrix perspective;
+    perspective.setAll(1, 0, 0, 0, 1, 0, 0.0005f, 0.0002f, 1);
+    for (const SkMatrix& m : {SkMatrix::I(),
+                              SkMatrix::Translate(11.5f, -20.25f),
+                              SkMatrix::RotateDeg(20, {200, 150}).postScale(1.4f, 1.3f),
+                              perspective}) {
+        SkBitmap expected, actual;
+        expected.allocN32Pixels(600, 500);
+        actual.allocN32Pixels(600, 500);
+        SkCanvas e(expected), a(actual);
+        draw(&e, m, false);
+        draw(&a, m, true);
+        REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                       expected.computeByteSize()));
+    }
+
+    // Drawing into a surface should not change any snapshot taken before.
+    sk_sp<SkSurface> surface = SkSurfaces::Raster(SkImageInfo::MakeN32Premul(400, 300));
+    surface->getCanvas()->clear(SK_ColorGREEN);
+    sk_sp<SkImage> before = surface->makeImageSnapshot();
+    pic->playbackParallel(surface->getCanvas(), *executor);
+    SkPixmap pm;
+    REPORTER_ASSERT(r, before->peekPixels(&pm) && pm.getColor(0, 0) == SK_ColorGREEN);
+    REPORTER_ASSERT(r, surface->peekPixels(&pm) && pm.getColor(0, 0) != SK_ColorGREEN);
+}
@@ -0,0 +1,212 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkBlendMode.h"
+#include "include/core/SkBlurTypes.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkColor.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkMaskFilter.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkPixmap.h"
+#include "include/core/SkRRect.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkShader.h"
+#include "include/core/SkSurface.h"
+#include "include/effects/SkGradientShader.h"
+#include "include/effects/SkImageFilters.h"
+#include "src/core/SkCanvasPriv.h"
+#include "tests/Test.h"
+
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <memory>
+
+static bool pixels_equal(const SkPixmap& a, const SkPixmap& b) {
+    if (a.info() != b.info()) {
+        return false;
+    }
+    for (int y = 0; y < a.height(); y++) {
+        if (0 != memcmp(a.addr(0, y), b.addr(0, y), a.info().minRowBytes())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Draws the same thing into a plain raster surface and a threaded one, snapshotting between
+// each step, and checks that every snapshot matches exactly.
+static void check_matches_raster(skiatest::Reporter* r,
+                                 const SkImageInfo& info,
+                                 std::initializer_list<std::function<void(SkCanvas*)>> steps) {
+    auto executor = SkExecutor::MakeFIFOThreadPool(4);
+    sk_sp<SkSurface> expected = SkSurfaces::Raster(info),
+                     actual   = SkSurfaces::RasterThreaded(info, *executor);
+    REPORTER_ASSERT(r, actual);
+
+    for (const auto& step : steps) {
+        step(expected->getCanvas());
+        step(actual->getCanvas());
+
+        sk_sp<SkImage> e = expected->makeImageSnapshot(),
+                       a = actual  ->makeImageSnapshot();
+        SkPixmap ep, ap;
+        REPORTER_ASSERT(r, e->peekPixels(&ep) && a->peekPixels(&ap));
+        REPORTER_ASSERT(r, pixels_equal(ep, ap));
+    }
+
+    // Reading through the surface should see the same pixels too.
+    SkBitmap bm;
+    bm.allocPixels(info);
+    REPORTER_ASSERT(r, actual->readPixels(bm, 0, 0));
+    SkPixmap ep;
+    REPORTER_ASSERT(r, expected->peekPixels(&ep));
+    REPORTER_ASSERT(r, pixels_equal(ep, bm.pixmap()));
+}
+
+DEF_TEST(RasterThreadedSurface_MatchesRaster, r) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(700, 530);
+
+    check_matches_raster(r, info, {
+        [](SkCanvas* canvas) {
+            canvas->clear(SK_ColorWHITE);
+
+            // Large AA geometry that crosses many tiles.
+            SkPaint paint;
+            paint.setAntiAlias(true);
+            paint.setColor(0x80FF4000);
+            SkPath star;
+            for (int i = 0; i < 11; i++) {
+                float t = i * 4 * SK_ScalarPI / 5;
+                SkPoint p = {350 + 300 * cosf(t), 265 + 250 * sinf(t)};
+                i == 0 ? star.moveTo(p) : star.lineTo(p);
+            }
+            canvas->drawPath(star, paint);
+
+            const SkPoint pts[] = {{0, 0}, {700, 530}};
+            const SkColor colors[] = {SK_ColorBLUE, SK_ColorYELLOW};
+            paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 2,
+                                                         SkTileMode::kClamp));
+            paint.setDither(true);
+            canvas->drawRRect(SkRRect::MakeOval(SkRect::MakeXYWH(100, 80, 480, 300)), paint);
+        },
+        [](SkCanvas* canvas) {
+            // State that stays open across a snapshot.
+            canvas->save();
+            canvas->translate(37.5f, 12.25f);
+            canvas->rotate(17);
+            canvas->clipRRect(SkRRect::MakeRectXY(SkRect::MakeWH(500, 400), 60, 60), true);
+
+            SkPaint paint;
+            paint.setAntiAlias(true);
+            paint.setStyle(SkPaint::kStroke_Style);
+            paint.setStrokeWidth(9);
+            paint.setMaskFilter(SkMaskFilter::MakeBlur(kNormal_SkBlurStyle, 6));
+            for (int i = 0; i < 20; i++) {
+                paint.setColor(SkColorSetARGB(0xFF, 13 * i, 255 - 11 * i, 7 * i));
+                canvas->drawCircle(250, 200, 10 + 12 * i, paint);
+            }
+        },
+        [](SkCanvas* canvas) {
+            SkPaint paint;
+            paint.setColor(0x6000FF00);
+            paint.setBlendMode(SkBlendMode::kMultiply);
+            canvas->drawRect(SkRect::MakeXYWH(-50, 150, 900, 40), paint);
+            canvas->restore();
+
+            // A filtered layer whose blur reaches across tile edges.
+            SkPaint layerPaint;
+            layerPaint.setImageFilter(SkImageFilters::Blur(8, 3, nullptr));
+            canvas->saveLayer(nullptr, &layerPaint);
+            SkPaint dots;
+            dots.setAntiAlias(true);
+            for (int x = 0; x < 700; x += 90) {
+                canvas->drawCircle(x + 20.5f, 480, 18, dots);
+            }
+            canvas->restore();
+        },
+        [](SkCanvas* canvas) {
+            // A translucent layer that stays open across a snapshot: it must be composited once,
+            // at its restore(), and a draw filling it must not discard the pixels under it.
+            canvas->saveLayerAlpha(nullptr, 0x80);
+            canvas->drawColor(SK_ColorBLUE);
+        },
+        [](SkCanvas* canvas) {
+            SkPaint paint;
+            paint.setAntiAlias(true);
+            paint.setColor(SK_ColorRED);
+            canvas->drawCircle(350, 265, 200, paint);
+            canvas->restore();
+        },
+    });
+}
+
+DEF_TEST(RasterThreadedSurface_CopyOnWrite, r) {
+    auto executor = SkExecutor::MakeFIFOThreadPool(2);
+    sk_sp<SkSurface> surface =
+            SkSurfaces::RasterThreaded(SkImageInfo::MakeN32Premul(300, 300), *executor);
+
+    surface->getCanvas()->clear(SK_ColorRED);
+    sk_sp<SkImage> red = surface->makeImageSnapshot();
+
+    surface->getCanvas()->clear(SK_ColorBLUE);
+    sk_sp<SkImage> blue = surface->makeImageSnapshot();
+
+    SkPixmap pm;
+    REPORTER_ASSERT(r, red->peekPixels(&pm) && pm.getColor(299, 299) == SK_ColorRED);
+    REPORTER_ASSERT(r, blue->peekPixels(&pm) && pm.getColor(299, 299) == SK_ColorBLUE);
+
+    // Nothing has been drawn since the last snapshot, so we should get it back.
+    REPORTER_ASSERT(r, surface->makeImageSnapshot() == blue);
+
+    // Writes land after any draws still pending.
+    surface->getCanvas()->clear(SK_ColorGREEN);
+    SkBitmap white;
+    white.allocN32Pixels(10, 10);
+    white.eraseColor(SK_ColorWHITE);
+    surface->writePixels(white, 0, 0);
+    REPORTER_ASSERT(r, surface->peekPixels(&pm));
+    REPORTER_ASSERT(r, pm.getColor(5, 5) == SK_ColorWHITE);
+    REPORTER_ASSERT(r, pm.getColor(20, 20) == SK_ColorGREEN);
+}
+
+DEF_TEST(RasterThreadedSurface_DrawBehind, r) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(700, 530);
+
+    check_matches_raster(r, info, {
+        [](SkCanvas* canvas) {
+            canvas->clear(SK_ColorWHITE);
+            SkPaint paint;
+            paint.setAntiAlias(true);
+            paint.setColor(0xFF2060C0);
+            canvas->drawOval(SkRect::MakeXYWH(40, 30, 620, 470), paint);
+
+            // SaveBehind() snapshots and clears its whole subset, which spans many tiles, and
+            // drawBehind() draws under what was there at its restore().
+            SkRect subset = SkRect::MakeXYWH(100, 60, 500, 400);
+            SkCanvasPriv::SaveBehind(canvas, &subset);
+            paint.setColor(0x8000C040);
+            for (int i = 0; i < 8; i++) {
+                canvas->drawCircle(120 + 60 * i, 80 + 50 * i, 70, paint);
+            }
+            SkPaint behind;
+            behind.setColor(0xC0FF8000);
+            SkCanvasPriv::DrawBehind(canvas, behind);
+            canvas->restore();
+        },
+        [](SkCanvas* canvas) {
+            SkPaint paint;
+            paint.setColor(SK_ColorBLACK);
+            canvas->drawRect(SkRect::MakeXYWH(300, 0, 20, 530), paint);
+        },
+    });
+}
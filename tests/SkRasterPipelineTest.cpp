@@ -5,8 +5,12 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkColorPriv.h"
+#include "include/core/SkMatrix.h"
 #include "include/private/base/SkTo.h"
+#include "src/base/SkArenaAlloc.h"
 #include "src/base/SkHalf.h"
+#include "src/base/SkRandom.h"
 #include "src/base/SkUtils.h"
 #include "src/core/SkOpts.h"
 #include "src/core/SkRasterPipeline.h"
@@ -3280,6 +3284,100 @@ DEF_TEST(SkRasterPipeline_lowp_clamp01, r) {
     p.run(0,0,1,1);
 }
 
+DEF_TEST(SkRasterPipeline_lowp_skx_matches_hsw, r) {
+    // On SKX machines, the default lowp stages are 32 pixels wide and have their own versions of
+    // tail loads and stores, gathers, and gradient lookups. Make sure they agree with the 16-pixel
+    // HSW lowp stages.
+    if (SkOpts::raster_pipeline_lowp_stride != 32 || !SkOpts::just_return_lowp_hsw) {
+        INFOF(r, "SKX lowp stages unavailable; skipping");
+        return;
+    }
+
+    // Wide enough to cover a full 32-pixel step and a tail, with room for a 2x upscale.
+    constexpr int kW = 53,
+                  kH = 5;
+    uint32_t src[kW * kH];
+    SkRandom random;
+    for (uint32_t& px : src) {
+        px = SkPreMultiplyColor(random.nextU());
+    }
+
+    SkRasterPipeline_MemoryCtx srcCtx = {src, kW};
+    SkRasterPipeline_GatherCtx gatherCtx;
+    gatherCtx.pixels = src;
+    gatherCtx.stride = kW;
+    gatherCtx.width  = kW;
+    gatherCtx.height = kH;
+
+    float fs[4][5], bs[4][5], ts[5] = {0, 0.1f, 0.35f, 0.7f, 1};
+    for (int c = 0; c < 4; c++) {
+        for (int i = 0; i < 5; i++) {
+            fs[c][i] = random.nextF() - 0.5f;
+            bs[c][i] = random.nextF();
+        }
+    }
+    SkRasterPipeline_GradientCtx gradientCtx;
+    gradientCtx.stopCount = 5;
+    for (int c = 0; c < 4; c++) {
+        gradientCtx.fs[c] = fs[c];
+        gradientCtx.bs[c] = bs[c];
+    }
+    gradientCtx.ts = ts;
+
+    enum class Source { kLoad, kGather, kBilerp, kGradient };
+    for (Source source : {Source::kLoad, Source::kGather, Source::kBilerp, Source::kGradient}) {
+        uint32_t results[2][kW * kH];
+        for (int hsw = 0; hsw < 2; hsw++) {
+            for (int i = 0; i < kW * kH; i++) {
+                results[hsw][i] = SkPreMultiplyColor(~src[i]);
+            }
+            SkRasterPipeline_MemoryCtx dstCtx = {results[hsw], kW};
+
+            SkSTArenaAlloc<256> alloc;
+            SkRasterPipeline p(&alloc);
+            p.setUseHSWLowpStagesForTesting(hsw);
+            switch (source) {
+                case Source::kLoad:
+                    p.append(SkRasterPipelineOp::load_8888, &srcCtx);
+                    break;
+                case Source::kGather:
+                    p.append(SkRasterPipelineOp::seed_shader);
+                    p.append(SkRasterPipelineOp::gather_8888, &gatherCtx);
+                    break;
+                case Source::kBilerp:
+                    p.append(SkRasterPipelineOp::seed_shader);
+                    p.append_matrix(&alloc, SkMatrix::Scale(0.5f, 0.5f));
+                    p.append(SkRasterPipelineOp::bilerp_clamp_8888, &gatherCtx);
+                    break;
+                case Source::kGradient:
+                    p.append(SkRasterPipelineOp::seed_shader);
+                    p.append_matrix(&alloc, SkMatrix::Scale(1.0f / kW, 1.0f / kW));
+                    p.append(SkRasterPipelineOp::gradient, &gradientCtx);
+                    p.append(SkRasterPipelineOp::clamp_01);
+                    p.append(SkRasterPipelineOp::premul);
+                    break;
+            }
+            p.append(SkRasterPipelineOp::load_8888_dst, &dstCtx);
+            p.append(SkRasterPipelineOp::srcover);
+            p.append(SkRasterPipelineOp::store_8888, &dstCtx);
+            // Run a column in from the left edge, so that the tail is at an odd offset.
+            p.run(1,0, kW-1,kH);
+        }
+
+        for (int i = 0; i < kW * kH; i++) {
+            for (int shift = 0; shift < 32; shift += 8) {
+                int skx = (results[0][i] >> shift) & 0xff,
+                    hsw = (results[1][i] >> shift) & 0xff;
+                if (std::abs(skx - hsw) > 1) {
+                    ERRORF(r, "source %d, pixel %d: SKX %08x, HSW %08x",
+                           (int)source, i, results[0][i], results[1][i]);
+                    break;
+                }
+            }
+        }
+    }
+}
+
 // Helper struct that can be used to scrape stack addresses at different points in a pipeline
 class StackCheckerCtx : SkRasterPipeline_CallbackCtx {
 public:
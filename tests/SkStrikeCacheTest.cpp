@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkExecutor.h"
 #include "include/core/SkFont.h"
 #include "include/core/SkFontStyle.h"
 #include "include/core/SkMatrix.h"
@@ -16,6 +17,7 @@
 #include "src/core/SkStrike.h"  // IWYU pragma: keep
 #include "src/core/SkStrikeCache.h"
 #include "src/core/SkStrikeSpec.h"
+#include "src/core/SkTaskGroup.h"
 #include "tests/Test.h"
 #include "tools/ToolUtils.h"
 
@@ -60,3 +62,43 @@ DEF_TEST(SkStrikeCache_CachePurge, Reporter) {
 
 
 }
+
+DEF_TEST(SkStrikeCache_ConcurrentBudget, Reporter) {
+    SkStrikeCache cache;
+    cache.setCacheCountLimit(20);
+
+    sk_sp<SkTypeface> typeface =
+            ToolUtils::create_portable_typeface("serif", SkFontStyle::Normal());
+    SkPaint defaultPaint;
+    auto specForSize = [&](int size) {
+        SkFont font(typeface, size);
+        return SkStrikeSpec::MakeMask(
+                font, defaultPaint, SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+                SkScalerContextFlags::kNone, SkMatrix::I());
+    };
+
+    // Many threads looking up strikes spread across all the shards, often the same ones.
+    auto executor = SkExecutor::MakeFIFOThreadPool(8);
+    SkTaskGroup(*executor).batch(8, [&](int i) {
+        for (int size = 1; size < 200; size++) {
+            sk_sp<SkStrike> strike = specForSize((size * (i + 1)) % 100 + 1)
+                                             .findOrCreateStrike(&cache);
+            REPORTER_ASSERT(Reporter, strike);
+        }
+    });
+
+    // Once the threads are done, any lookup brings every shard back under the global budget.
+    SkStrikeSpec spec = specForSize(123);
+    spec.findOrCreateStrike(&cache);
+    REPORTER_ASSERT(Reporter, cache.getCacheCountUsed() <= 20);
+    REPORTER_ASSERT(Reporter, cache.getCacheCountUsed() > 0);
+
+    cache.purgeAll();
+    REPORTER_ASSERT(Reporter, cache.getCacheCountUsed() == 0);
+    REPORTER_ASSERT(Reporter, cache.getTotalMemoryUsed() == 0);
+    REPORTER_ASSERT(Reporter, cache.findStrike(spec.descriptor()) == nullptr);
+
+    sk_sp<SkStrike> strike = spec.findOrCreateStrike(&cache);
+    REPORTER_ASSERT(Reporter, cache.findStrike(spec.descriptor()) == strike);
+    REPORTER_ASSERT(Reporter, cache.getCacheCountUsed() == 1);
+}
@@ -11,6 +11,7 @@
 
 #include "include/core/SkColorType.h"
 #include "include/core/SkScalar.h"
+#include "include/core/SkString.h"
 #include "include/private/base/SkDebug.h"
 #include "include/private/base/SkFloatingPoint.h"
 #include "src/base/SkMSAN.h"
@@ -25,6 +26,8 @@
 #include <initializer_list>
 #include <vector>
 
+extern bool gSkVMAllowJIT;
+
 template <typename Fn>
 static void test_jit_and_interpreter(const skvm::Builder& b, Fn&& test) {
     skvm::Program p = b.done();
@@ -120,6 +123,112 @@ DEF_TEST(SkVM_allow_jit, r) {
     }
 }
 
+DEF_TEST(SkVM_JITCache, r) {
+    SkString dir = skiatest::GetTmpDir();
+    if (dir.isEmpty()) {
+        return;
+    }
+
+    // buf[i] = buf[i]*3 + 7
+    skvm::Builder b;
+    {
+        skvm::Ptr arg = b.varying<int>();
+        b.store32(arg, b.add(b.mul(b.load32(arg), b.splat(3)), b.splat(7)));
+    }
+
+    // The cache only comes into play when we JIT, which is off unless SkGraphics::AllowJIT() has
+    // been called, so turn it on for the length of this test.  Other tests are fine either way.
+    const bool allowedJIT = gSkVMAllowJIT;
+    gSkVMAllowJIT = true;
+
+    const skvm::JITCacheStats before = skvm::GetJITCacheStats();
+    skvm::SetJITCacheDirectory(dir.c_str());
+    skvm::Program first  = b.done("test-jit-cache", /*allow_jit=*/true),
+                  second = b.done("test-jit-cache", /*allow_jit=*/true);
+    skvm::SetJITCacheDirectory(nullptr);
+    const skvm::JITCacheStats after = skvm::GetJITCacheStats();
+
+    if (!first.hasJIT()) {
+        gSkVMAllowJIT = allowedJIT;
+        INFOF(r, "SkVM can't JIT on this CPU or build; SkVM_JITCache skipped.\n");
+        return;
+    }
+    // The first Program may or may not find code left by an earlier run, but the second must.
+    REPORTER_ASSERT(r, second.hasJIT());
+    REPORTER_ASSERT(r, after.hits   - before.hits >= 1);
+    REPORTER_ASSERT(r, after.hits   - before.hits
+                     + after.misses - before.misses == 2);
+
+    for (const skvm::Program* p : {&first, &second}) {
+        int buf[37];
+        for (int i = 0; i < (int)std::size(buf); i++) {
+            buf[i] = i;
+        }
+        p->eval(std::size(buf), buf);
+        for (int i = 0; i < (int)std::size(buf); i++) {
+            REPORTER_ASSERT(r, buf[i] == i*3 + 7);
+        }
+    }
+    gSkVMAllowJIT = allowedJIT;
+}
+
+DEF_TEST(SkVM_JITCacheStrides, r) {
+    SkString dir = skiatest::GetTmpDir();
+    if (dir.isEmpty()) {
+        return;
+    }
+
+    // Two programs with the same instructions, buf[i] += 7, whose argument steps 4 or 8 bytes
+    // per element.  jit() bakes the stride into the code, so they must not share a cache entry.
+    auto build = [](int stride) {
+        skvm::Builder b;
+        skvm::Ptr arg = b.varying(stride);
+        b.store32(arg, b.add(b.load32(arg), b.splat(7)));
+        return b;
+    };
+
+    // eval() only runs JIT'd code while JIT is allowed, so leave it on until we're done.
+    const bool allowedJIT = gSkVMAllowJIT;
+    gSkVMAllowJIT = true;
+
+    // The uncached programs are what each cached one must behave like.
+    skvm::Program narrowRef = build(4).done("test-jit-cache-stride", /*allow_jit=*/true),
+                  wideRef   = build(8).done("test-jit-cache-stride", /*allow_jit=*/true);
+
+    skvm::SetJITCacheDirectory(dir.c_str());
+    skvm::Program narrow = build(4).done("test-jit-cache-stride", /*allow_jit=*/true),
+                  wide   = build(8).done("test-jit-cache-stride", /*allow_jit=*/true);
+    skvm::SetJITCacheDirectory(nullptr);
+
+    if (!narrow.hasJIT() || !wide.hasJIT() || !narrowRef.hasJIT() || !wideRef.hasJIT()) {
+        gSkVMAllowJIT = allowedJIT;
+        INFOF(r, "SkVM can't JIT on this CPU or build; SkVM_JITCacheStrides skipped.\n");
+        return;
+    }
+
+    constexpr int N = 37;
+    auto run = [&](const skvm::Program& program, int* buf) {
+        for (int i = 0; i < 2*N; i++) {
+            buf[i] = i;
+        }
+        program.eval(N, buf);
+    };
+
+    int got[2*N], want[2*N];
+    run(narrow, got);
+    run(narrowRef, want);
+    REPORTER_ASSERT(r, 0 == memcmp(got, want, sizeof(got)));
+
+    run(wide, got);
+    run(wideRef, want);
+    REPORTER_ASSERT(r, 0 == memcmp(got, want, sizeof(got)));
+
+    // Make sure the two strides really do produce different code.
+    run(narrowRef, got);
+    REPORTER_ASSERT(r, 0 != memcmp(got, want, sizeof(got)));
+    gSkVMAllowJIT = allowedJIT;
+}
+
 DEF_TEST(SkVM_LoopCounts, r) {
     // Make sure we cover all the exact N we want.
 
@@ -52,6 +52,7 @@ CPU_ONLY_TESTS = [
     "DrawPathTest.cpp",
     "DrawTextTest.cpp",
     "EmptyPathTest.cpp",
+    "ExecutorTest.cpp",
     "F16StagesTest.cpp",
     "FillPathTest.cpp",
     "FitsInTest.cpp",
@@ -121,6 +122,7 @@ CPU_ONLY_TESTS = [
     "RRectInPathTest.cpp",
     "RTreeTest.cpp",
     "RandomTest.cpp",
+    "RasterThreadedSurfaceTest.cpp",
     "ReadPixelsTest.cpp",
     "RecordDrawTest.cpp",
     "RecordOptsTest.cpp",
@@ -42,7 +42,8 @@ bool CollectImages(CommandLineFlags::StringArray dir, skia_private::TArray<SkStr
 void SetCtxOptions(struct GrContextOptions*);
 
 /**
- *  Enable, disable, or force analytic anti-aliasing using --analyticAA and --forceAnalyticAA.
+ *  Enable, disable, or force analytic anti-aliasing using --analyticAA and --forceAnalyticAA,
+ *  or switch to the accumulation buffer scan converter with --accumulationAA.
  */
 void SetAnalyticAA();
 
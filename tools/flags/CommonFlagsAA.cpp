@@ -11,10 +11,14 @@ static DEFINE_bool(forceAnalyticAA, false,
             "Force analytic anti-aliasing even if the path is complicated: "
             "whether it's concave or convex, we consider a path complicated"
             "if its number of points is comparable to its resolution.");
+static DEFINE_bool(accumulationAA, false,
+            "Fill anti-aliased paths with the accumulation buffer scan converter "
+            "instead of analytic AA or supersampling.");
 
 void SetAnalyticAA() {
-    gSkUseAnalyticAA   = FLAGS_analyticAA;
-    gSkForceAnalyticAA = FLAGS_forceAnalyticAA;
+    gSkUseAnalyticAA     = FLAGS_analyticAA;
+    gSkForceAnalyticAA   = FLAGS_forceAnalyticAA;
+    gSkUseAccumulationAA = FLAGS_accumulationAA;
 }
 
 }